@@ -9,14 +9,33 @@ module rip_core_wrapper #(
     parameter int DATA_WIDTH = 32,
     parameter int AXI_ID_WIDTH = 4,
     parameter int AXI_ADDR_WIDTH = 32,
-    parameter int AXI_DATA_WIDTH = 32
+    parameter int AXI_DATA_WIDTH = 128, // the width of the UltraScale+ S_AXI_HP ports
+    // the AXI ports run on axi_clk, so the core clock can exceed the interconnect's
+    parameter bit AXI_ASYNC = 1'b0
 ) (
     input wire sys_rst_n,
     input wire clk,
+    // the AXI clock domain and its reset, asserted with sys_rst_n; tie them to
+    // clk and sys_rst_n unless AXI_ASYNC
+    input wire axi_clk,
+    input wire axi_rst_n,
     input wire run,
     output wire busy,
     input wire [AXI_ADDR_WIDTH-1:0] mem_head,
     input wire [AXI_ADDR_WIDTH-1:0] ret_head,
+    // Interrupts: PL to core, and core to PS (one-cycle pulse when busy falls)
+    input wire irq_external,
+    output wire done_irq,
+    // Mailbox doorbells (e.g. AXI GPIO); mbox_irq is high while results are unread
+    input wire [DATA_WIDTH-1:0] mbox_cmd_tail,
+    input wire [DATA_WIDTH-1:0] mbox_res_head,
+    output wire [DATA_WIDTH-1:0] mbox_cmd_head,
+    output wire [DATA_WIDTH-1:0] mbox_res_tail,
+    output wire mbox_irq,
+`ifdef VERILATOR
+    // x3 of the core, which riscv-tests set to 1 on success
+    output wire [DATA_WIDTH-1:0] riscv_tests_passed,
+`endif  // VERILATOR
     // Write address channel signals
     output wire [AXI_ID_WIDTH-1:0] AWID,
     output wire [AXI_ADDR_WIDTH-1:0] AWADDR,
@@ -76,7 +95,8 @@ module rip_core_wrapper #(
         .DATA_WIDTH(DATA_WIDTH),
         .AXI_ID_WIDTH(AXI_ID_WIDTH),
         .AXI_ADDR_WIDTH(AXI_ADDR_WIDTH),
-        .AXI_DATA_WIDTH(AXI_DATA_WIDTH)
+        .AXI_DATA_WIDTH(AXI_DATA_WIDTH),
+        .AXI_ASYNC(AXI_ASYNC)
     ) rip (
         .sys_rst_n(sys_rst_n),
         .clk(clk),
@@ -84,9 +104,37 @@ module rip_core_wrapper #(
         .busy(busy),
         .mem_head(mem_head),
         .ret_head(ret_head),
+        .irq_external(irq_external),
+        .mbox_cmd_tail(mbox_cmd_tail),
+        .mbox_res_head(mbox_res_head),
+        .mbox_cmd_head(mbox_cmd_head),
+        .mbox_res_tail(mbox_res_tail),
+`ifdef VERILATOR
+        .dbg_csr_num('0),
+        .dbg_csr_rdata(),
+        .dbg_bp_clear(1'b0),
+        .riscv_tests_passed(riscv_tests_passed),
+`endif  // VERILATOR
+        .axi_clk(axi_clk),
+        .axi_rst_n(axi_rst_n),
         .M_AXI(axi_if)
     );
 
+    // lets the PS wait on IRQ_F2P instead of polling busy
+    logic busy_prev;
+
+    always_ff @(posedge clk) begin
+        if (!sys_rst_n) begin
+            busy_prev <= 1'b0;
+        end
+        else begin
+            busy_prev <= busy;
+        end
+    end
+
+    assign done_irq = busy_prev & !busy;
+    assign mbox_irq = mbox_res_tail != mbox_res_head;
+
     assign AWID = axi_if.AWID;
     assign AWADDR = axi_if.AWADDR;
     assign AWLEN = axi_if.AWLEN;
@@ -6,14 +6,29 @@ module rip_core_wrapper_wrapper #(
     parameter DATA_WIDTH = 32,
     parameter AXI_ID_WIDTH = 4,
     parameter AXI_ADDR_WIDTH = 32,
-    parameter AXI_DATA_WIDTH = 32
+    parameter AXI_DATA_WIDTH = 128, // the width of the UltraScale+ S_AXI_HP ports
+    // the AXI ports run on axi_clk, so the core clock can exceed the interconnect's
+    parameter AXI_ASYNC = 0
 ) (
     input wire sys_rst_n,
     input wire clk,
+    // the AXI clock domain and its reset, asserted with sys_rst_n; tie them to
+    // clk and sys_rst_n unless AXI_ASYNC
+    input wire axi_clk,
+    input wire axi_rst_n,
     input wire run,
     output wire busy,
     input wire [AXI_ADDR_WIDTH-1:0] mem_head,
     input wire [AXI_ADDR_WIDTH-1:0] ret_head,
+    // Interrupts: PL to core, and core to PS (one-cycle pulse when busy falls)
+    input wire irq_external,
+    output wire done_irq,
+    // Mailbox doorbells (e.g. AXI GPIO); mbox_irq is high while results are unread
+    input wire [DATA_WIDTH-1:0] mbox_cmd_tail,
+    input wire [DATA_WIDTH-1:0] mbox_res_head,
+    output wire [DATA_WIDTH-1:0] mbox_cmd_head,
+    output wire [DATA_WIDTH-1:0] mbox_res_tail,
+    output wire mbox_irq,
     // Write address channel signals
     output wire [AXI_ID_WIDTH-1:0] AWID,
     output wire [AXI_ADDR_WIDTH-1:0] AWADDR,
@@ -66,14 +81,24 @@ module rip_core_wrapper_wrapper #(
         .DATA_WIDTH(DATA_WIDTH),
         .AXI_ID_WIDTH(AXI_ID_WIDTH),
         .AXI_ADDR_WIDTH(AXI_ADDR_WIDTH),
-        .AXI_DATA_WIDTH(AXI_DATA_WIDTH)
+        .AXI_DATA_WIDTH(AXI_DATA_WIDTH),
+        .AXI_ASYNC(AXI_ASYNC)
     ) rip_wrapper (
         .sys_rst_n(sys_rst_n),
         .clk(clk),
+        .axi_clk(axi_clk),
+        .axi_rst_n(axi_rst_n),
         .run(run),
         .busy(busy),
         .mem_head(mem_head),
         .ret_head(ret_head),
+        .irq_external(irq_external),
+        .done_irq(done_irq),
+        .mbox_cmd_tail(mbox_cmd_tail),
+        .mbox_res_head(mbox_res_head),
+        .mbox_cmd_head(mbox_cmd_head),
+        .mbox_res_tail(mbox_res_tail),
+        .mbox_irq(mbox_irq),
         .AWID(AWID),
         .AWADDR(AWADDR),
         .AWLEN(AWLEN),
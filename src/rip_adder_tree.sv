@@ -0,0 +1,138 @@
+/*
+ * Module `rip_adder_tree`
+ *
+ * Sums `NUM` rows modulo 2^`WIDTH` with a Wallace tree: each level replaces
+ * every three rows by a sum row and a carry row (3:2 carry-save compressors,
+ * no carry propagation), until two rows are left for one carry-propagate
+ * adder. With `NUM` rows that is about log1.5(NUM / 2) compressor levels and
+ * the adder, instead of the `NUM - 1` chained adders of a running sum.
+ *
+ * `STAGES` registers are spread evenly over the levels, so `sum` is valid
+ * `STAGES` cycles after `rows` and a new set of rows can enter every cycle.
+ * Stages beyond the number of levels register the output.
+ */
+
+`default_nettype none
+`timescale 1ns / 1ps
+
+module rip_adder_tree #(
+    parameter int WIDTH = 8,
+    parameter int NUM = 3,
+    parameter int STAGES = 0
+) (
+    input wire clk,
+    input wire [NUM-1:0][WIDTH-1:0] rows,
+    output logic [WIDTH-1:0] sum
+);
+    // rows left after `levels` compressor levels
+    function automatic int rows_after(input int levels);
+        int n = NUM;
+        for (int l = 0; l < levels; l++) begin
+            n = n / 3 * 2 + n % 3;
+        end
+        return n;
+    endfunction
+
+    function automatic int csa_levels();
+        int n = NUM;
+        int l = 0;
+        while (n > 2) begin
+            n = n / 3 * 2 + n % 3;
+            l++;
+        end
+        return l;
+    endfunction
+
+    localparam int CSA_LEVELS = csa_levels();
+    localparam int LEVELS = CSA_LEVELS + 1;  // and the carry-propagate adder
+    localparam int INNER_STAGES = STAGES < LEVELS - 1 ? STAGES : LEVELS - 1;
+    localparam int OUTER_STAGES = STAGES - INNER_STAGES;
+
+    // a register between level `l` and level `l + 1`
+    function automatic bit cut_after(input int l);
+        for (int j = 1; j <= INNER_STAGES; j++) begin
+            if (j * LEVELS / (INNER_STAGES + 1) == l + 1) begin
+                return 1'b1;
+            end
+        end
+        return 1'b0;
+    endfunction
+
+    /* carry-save levels */
+    generate
+        for (genvar l = 0; l < CSA_LEVELS; l++) begin : g_level
+            localparam int N_IN = rows_after(l);
+            localparam int N_OUT = rows_after(l + 1);
+            localparam int GROUPS = N_IN / 3;
+
+            logic [N_IN-1:0][WIDTH-1:0] in_rows;
+            logic [N_OUT-1:0][WIDTH-1:0] csa_rows;
+            logic [N_OUT-1:0][WIDTH-1:0] out_rows;
+
+            if (l == 0) begin : g_first
+                assign in_rows = rows;
+            end
+            else begin : g_next
+                assign in_rows = g_level[l-1].out_rows;
+            end
+
+            for (genvar g = 0; g < GROUPS; g++) begin : g_csa
+                logic [WIDTH-1:0] a, b, c;
+                assign a = in_rows[3*g];
+                assign b = in_rows[3*g+1];
+                assign c = in_rows[3*g+2];
+                assign csa_rows[2*g] = a ^ b ^ c;
+                assign csa_rows[2*g+1] = ((a & b) | (a & c) | (b & c)) << 1;
+            end
+            for (genvar r = 0; r < N_IN % 3; r++) begin : g_pass
+                assign csa_rows[2*GROUPS+r] = in_rows[3*GROUPS+r];
+            end
+
+            if (cut_after(l)) begin : g_reg
+                always_ff @(posedge clk) begin
+                    out_rows <= csa_rows;
+                end
+            end
+            else begin : g_wire
+                assign out_rows = csa_rows;
+            end
+        end
+    endgenerate
+
+    /* carry-propagate adder */
+    logic [WIDTH-1:0] row_0;
+    logic [WIDTH-1:0] row_1;
+    generate
+        if (CSA_LEVELS == 0) begin : g_short
+            assign row_0 = rows[0];
+            if (NUM > 1) begin : g_two
+                assign row_1 = rows[1];
+            end
+            else begin : g_one
+                assign row_1 = '0;
+            end
+        end
+        else begin : g_tree
+            assign row_0 = g_level[CSA_LEVELS-1].out_rows[0];
+            assign row_1 = g_level[CSA_LEVELS-1].out_rows[1];
+        end
+    endgenerate
+
+    generate
+        if (OUTER_STAGES == 0) begin : g_comb
+            assign sum = row_0 + row_1;
+        end
+        else begin : g_out
+            logic [WIDTH-1:0] sum_reg [OUTER_STAGES];
+            always_ff @(posedge clk) begin
+                sum_reg[0] <= row_0 + row_1;
+                for (int s = 1; s < OUTER_STAGES; s++) begin
+                    sum_reg[s] <= sum_reg[s-1];
+                end
+            end
+            assign sum = sum_reg[OUTER_STAGES-1];
+        end
+    endgenerate
+endmodule : rip_adder_tree
+
+`default_nettype wire
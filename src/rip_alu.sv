@@ -15,6 +15,7 @@ module rip_alu
 
     input wire [ DATA_WIDTH-1:0] rs1,
     input wire [ DATA_WIDTH-1:0] rs2,
+    input wire [ DATA_WIDTH-1:0] rs3,  // rd as accumulator (P extension)
     input wire [ DATA_WIDTH-1:0] pc,
     input wire [ DATA_WIDTH-1:0] csr,
     input wire [ DATA_WIDTH-1:0] imm,
@@ -27,8 +28,8 @@ module rip_alu
     logic [ DATA_WIDTH-1:0] b;
     logic [SHAMT_WIDTH-1:0] shamt;
 
-    assign shamt = inst.SLL | inst.SRL | inst.SRA | inst.SLLI | inst.SRLI | inst.SRAI ?
-        b[SHAMT_WIDTH-1:0] : 0;
+    assign shamt = inst.SLL | inst.SRL | inst.SRA | inst.SLLI | inst.SRLI | inst.SRAI | inst.ROL |
+        inst.ROR | inst.RORI ? b[SHAMT_WIDTH-1:0] : 0;
 
     always_comb begin
         if (inst.AUIPC | inst.JAL | inst.JALR) begin
@@ -42,11 +43,11 @@ module rip_alu
         end
 
         if (inst.JAL | inst.JALR) begin
-            b = 32'h4;
+            b = inst.COMPRESSED ? 32'h2 : 32'h4;
         end
         else if (inst.LUI | inst.AUIPC | inst.LB | inst.LH | inst.LW | inst.LBU | inst.LHU |
                  inst.SB | inst.SH | inst.SW | inst.ADDI | inst.SLTI | inst.SLTIU | inst.XORI |
-                 inst.SLLI | inst.SRLI | inst.SRAI | inst.ORI | inst.ANDI) begin
+                 inst.SLLI | inst.SRLI | inst.SRAI | inst.ORI | inst.ANDI | inst.RORI) begin
             b = imm;
         end
         else if (inst.CSRRW | inst.CSRRS | inst.CSRRC | inst.CSRRWI | inst.CSRRSI |
@@ -126,6 +127,177 @@ module rip_alu
         end
     end
 
+    // bit manipulation (Zba, Zbb)
+    logic [DATA_WIDTH-1:0] zb_shadd;
+    logic [DATA_WIDTH-1:0] zb_andn;
+    logic [DATA_WIDTH-1:0] zb_orn;
+    logic [DATA_WIDTH-1:0] zb_xnor;
+    logic [DATA_WIDTH-1:0] zb_clz;
+    logic [DATA_WIDTH-1:0] zb_ctz;
+    logic [DATA_WIDTH-1:0] zb_cpop;
+    logic [DATA_WIDTH-1:0] zb_max;
+    logic [DATA_WIDTH-1:0] zb_maxu;
+    logic [DATA_WIDTH-1:0] zb_min;
+    logic [DATA_WIDTH-1:0] zb_minu;
+    logic [DATA_WIDTH-1:0] zb_sext_b;
+    logic [DATA_WIDTH-1:0] zb_sext_h;
+    logic [DATA_WIDTH-1:0] zb_zext_h;
+    logic [DATA_WIDTH-1:0] zb_rol;
+    logic [DATA_WIDTH-1:0] zb_ror;
+    logic [DATA_WIDTH-1:0] zb_orc_b;
+    logic [DATA_WIDTH-1:0] zb_rev8;
+
+    logic [2*DATA_WIDTH-1:0] zb_rol_wide;
+    logic [2*DATA_WIDTH-1:0] zb_ror_wide;
+    logic zb_clz_done;
+    logic zb_ctz_done;
+
+    always_comb begin
+        if (inst.SH1ADD) begin
+            zb_shadd = (a << 1) + b;
+        end
+        else if (inst.SH2ADD) begin
+            zb_shadd = (a << 2) + b;
+        end
+        else begin
+            zb_shadd = (a << 3) + b;
+        end
+        zb_andn = a & ~b;
+        zb_orn  = a | ~b;
+        zb_xnor = ~(a ^ b);
+
+        // leading/trailing zero count and population count
+        zb_clz = DATA_WIDTH'(DATA_WIDTH);
+        zb_clz_done = 1'b0;
+        for (int i = DATA_WIDTH - 1; i >= 0; i--) begin
+            if (a[i] && !zb_clz_done) begin
+                zb_clz = DATA_WIDTH'(DATA_WIDTH - 1 - i);
+                zb_clz_done = 1'b1;
+            end
+        end
+        zb_ctz = DATA_WIDTH'(DATA_WIDTH);
+        zb_ctz_done = 1'b0;
+        for (int i = 0; i < DATA_WIDTH; i++) begin
+            if (a[i] && !zb_ctz_done) begin
+                zb_ctz = DATA_WIDTH'(i);
+                zb_ctz_done = 1'b1;
+            end
+        end
+        zb_cpop = '0;
+        for (int i = 0; i < DATA_WIDTH; i++) begin
+            zb_cpop = zb_cpop + DATA_WIDTH'(a[i]);
+        end
+
+        zb_max    = alu_lt ? b : a;
+        zb_maxu   = alu_ltu ? b : a;
+        zb_min    = alu_lt ? a : b;
+        zb_minu   = alu_ltu ? a : b;
+        zb_sext_b = {{24{a[7]}}, a[7:0]};
+        zb_sext_h = {{16{a[15]}}, a[15:0]};
+        zb_zext_h = {16'h0, a[15:0]};
+
+        // rotate through a doubled copy of `a`
+        zb_rol_wide = {a, a} << shamt;
+        zb_ror_wide = {a, a} >> shamt;
+        zb_rol = zb_rol_wide[2*DATA_WIDTH-1:DATA_WIDTH];
+        zb_ror = zb_ror_wide[DATA_WIDTH-1:0];
+
+        for (int i = 0; i < DATA_WIDTH / 8; i++) begin
+            zb_orc_b[8*i+:8] = {8{|a[8*i+:8]}};
+            zb_rev8[8*i+:8]  = a[DATA_WIDTH-8*(i+1)+:8];
+        end
+    end
+
+    // packed SIMD (P extension subset): 4x8 and 2x16 lanes; K* saturate signed, UK* unsigned
+    logic simd_sub;
+    logic [DATA_WIDTH-1:0] simd_add8;
+    logic [DATA_WIDTH-1:0] simd_kadd8;
+    logic [DATA_WIDTH-1:0] simd_ukadd8;
+    logic [DATA_WIDTH-1:0] simd_add16;
+    logic [DATA_WIDTH-1:0] simd_kadd16;
+    logic [DATA_WIDTH-1:0] simd_ukadd16;
+    logic [DATA_WIDTH-1:0] simd_smaqa;
+    logic [DATA_WIDTH-1:0] simd_umaqa;
+    logic [DATA_WIDTH-1:0] simd_kmada;
+
+    logic signed [8:0] lane8_s;
+    logic [8:0] lane8_u;
+    logic signed [16:0] lane16_s;
+    logic [16:0] lane16_u;
+    logic signed [15:0] prod8_s;
+    logic [15:0] prod8_u;
+    logic signed [31:0] prod16_hi;
+    logic signed [31:0] prod16_lo;
+    logic signed [33:0] dot16;
+
+    always_comb begin
+        simd_sub = inst.SUB8 | inst.KSUB8 | inst.UKSUB8 | inst.SUB16 | inst.KSUB16 | inst.UKSUB16;
+
+        for (int i = 0; i < 4; i++) begin
+            lane8_s = simd_sub ? $signed(a[8*i+:8]) - $signed(b[8*i+:8]) :
+                $signed(a[8*i+:8]) + $signed(b[8*i+:8]);
+            lane8_u = simd_sub ? {1'b0, a[8*i+:8]} - {1'b0, b[8*i+:8]} :
+                {1'b0, a[8*i+:8]} + {1'b0, b[8*i+:8]};
+            simd_add8[8*i+:8] = lane8_u[7:0];
+            if (lane8_s[8] != lane8_s[7]) begin
+                simd_kadd8[8*i+:8] = lane8_s[8] ? 8'h80 : 8'h7F;
+            end
+            else begin
+                simd_kadd8[8*i+:8] = lane8_s[7:0];
+            end
+            if (lane8_u[8]) begin
+                simd_ukadd8[8*i+:8] = simd_sub ? 8'h00 : 8'hFF;
+            end
+            else begin
+                simd_ukadd8[8*i+:8] = lane8_u[7:0];
+            end
+        end
+
+        for (int i = 0; i < 2; i++) begin
+            lane16_s = simd_sub ? $signed(a[16*i+:16]) - $signed(b[16*i+:16]) :
+                $signed(a[16*i+:16]) + $signed(b[16*i+:16]);
+            lane16_u = simd_sub ? {1'b0, a[16*i+:16]} - {1'b0, b[16*i+:16]} :
+                {1'b0, a[16*i+:16]} + {1'b0, b[16*i+:16]};
+            simd_add16[16*i+:16] = lane16_u[15:0];
+            if (lane16_s[16] != lane16_s[15]) begin
+                simd_kadd16[16*i+:16] = lane16_s[16] ? 16'h8000 : 16'h7FFF;
+            end
+            else begin
+                simd_kadd16[16*i+:16] = lane16_s[15:0];
+            end
+            if (lane16_u[16]) begin
+                simd_ukadd16[16*i+:16] = simd_sub ? 16'h0000 : 16'hFFFF;
+            end
+            else begin
+                simd_ukadd16[16*i+:16] = lane16_u[15:0];
+            end
+        end
+
+        // quad 8-bit multiply-accumulate, wraps like ADD
+        simd_smaqa = rs3;
+        simd_umaqa = rs3;
+        for (int i = 0; i < 4; i++) begin
+            prod8_s = $signed(a[8*i+:8]) * $signed(b[8*i+:8]);
+            prod8_u = a[8*i+:8] * b[8*i+:8];
+            simd_smaqa = simd_smaqa + DATA_WIDTH'(prod8_s);
+            simd_umaqa = simd_umaqa + DATA_WIDTH'(prod8_u);
+        end
+
+        // dual 16-bit multiply-add, saturated to 32 bits
+        prod16_hi = $signed(a[31:16]) * $signed(b[31:16]);
+        prod16_lo = $signed(a[15:0]) * $signed(b[15:0]);
+        dot16 = 34'(prod16_hi) + 34'(prod16_lo) + (inst.KMADA ? 34'($signed(rs3)) : 34'sd0);
+        if (dot16 > 34'sh07FFFFFFF) begin
+            simd_kmada = 32'h7FFFFFFF;
+        end
+        else if (dot16 < -34'sh080000000) begin
+            simd_kmada = 32'h80000000;
+        end
+        else begin
+            simd_kmada = dot16[31:0];
+        end
+    end
+
     always_comb begin
         if (inst.BEQ) begin
             branch_result = alu_eq;
@@ -176,6 +348,9 @@ module rip_alu
             else if (inst.LUI) begin
                 rslt <= imm;
             end
+            else if (inst.LR_W | inst.SC_W | inst.AMOSWAP_W | inst.AMOADD_W | inst.AMOOR_W) begin
+                rslt <= a;  // address
+            end
             else if (inst.AUIPC | inst.JAL | inst.JALR | inst.LB | inst.LH | inst.LW | inst.LBU |
                      inst.LHU | inst.SB | inst.SH | inst.SW | inst.ADDI | inst.ADD | inst.SUB) begin
                 rslt <= alu_add_sub;
@@ -228,6 +403,87 @@ module rip_alu
             else if (inst.REMU) begin
                 rslt <= alu_rem_u;
             end
+            else if (inst.SH1ADD | inst.SH2ADD | inst.SH3ADD) begin
+                rslt <= zb_shadd;
+            end
+            else if (inst.ANDN) begin
+                rslt <= zb_andn;
+            end
+            else if (inst.ORN) begin
+                rslt <= zb_orn;
+            end
+            else if (inst.XNOR) begin
+                rslt <= zb_xnor;
+            end
+            else if (inst.CLZ) begin
+                rslt <= zb_clz;
+            end
+            else if (inst.CTZ) begin
+                rslt <= zb_ctz;
+            end
+            else if (inst.CPOP) begin
+                rslt <= zb_cpop;
+            end
+            else if (inst.MAX) begin
+                rslt <= zb_max;
+            end
+            else if (inst.MAXU) begin
+                rslt <= zb_maxu;
+            end
+            else if (inst.MIN) begin
+                rslt <= zb_min;
+            end
+            else if (inst.MINU) begin
+                rslt <= zb_minu;
+            end
+            else if (inst.SEXT_B) begin
+                rslt <= zb_sext_b;
+            end
+            else if (inst.SEXT_H) begin
+                rslt <= zb_sext_h;
+            end
+            else if (inst.ZEXT_H) begin
+                rslt <= zb_zext_h;
+            end
+            else if (inst.ROL) begin
+                rslt <= zb_rol;
+            end
+            else if (inst.ROR | inst.RORI) begin
+                rslt <= zb_ror;
+            end
+            else if (inst.ORC_B) begin
+                rslt <= zb_orc_b;
+            end
+            else if (inst.REV8) begin
+                rslt <= zb_rev8;
+            end
+            else if (inst.ADD8 | inst.SUB8) begin
+                rslt <= simd_add8;
+            end
+            else if (inst.KADD8 | inst.KSUB8) begin
+                rslt <= simd_kadd8;
+            end
+            else if (inst.UKADD8 | inst.UKSUB8) begin
+                rslt <= simd_ukadd8;
+            end
+            else if (inst.ADD16 | inst.SUB16) begin
+                rslt <= simd_add16;
+            end
+            else if (inst.KADD16 | inst.KSUB16) begin
+                rslt <= simd_kadd16;
+            end
+            else if (inst.UKADD16 | inst.UKSUB16) begin
+                rslt <= simd_ukadd16;
+            end
+            else if (inst.SMAQA) begin
+                rslt <= simd_smaqa;
+            end
+            else if (inst.UMAQA) begin
+                rslt <= simd_umaqa;
+            end
+            else if (inst.KMDA | inst.KMADA) begin
+                rslt <= simd_kmada;
+            end
             else begin
                 rslt <= 0;
             end
@@ -0,0 +1,235 @@
+`default_nettype none
+`timescale 1ns / 1ps
+
+//
+// N:1 AXI4 interconnect
+// - arbitrates the read and write address channels independently
+// - grants the highest `qos` first and round-robin among equal `qos`
+// - replaces AxQOS of the upstream requests with the port's `qos`
+// - keeps W with the granted AW until WLAST (no write interleaving)
+// - prepends the port index to AxID, so R and B are routed back by ID and
+//   several ports may have transactions outstanding at once
+//
+
+module rip_axi_interconnect #(
+    parameter int NUM_PORTS = 2,
+    parameter int ID_WIDTH = 4, // upstream; M_AXI has ID_WIDTH + INDEX_WIDTH
+    parameter int ADDR_WIDTH = 32,
+    parameter int DATA_WIDTH = 32
+) (
+    input wire clk,
+    input wire rstn,
+    input wire [NUM_PORTS-1:0][3:0] qos,
+    rip_axi_interface.slave S_AXI[NUM_PORTS],
+    rip_axi_interface.master M_AXI
+);
+    localparam int INDEX_WIDTH = NUM_PORTS > 1 ? $clog2(NUM_PORTS) : 1;
+    typedef logic [INDEX_WIDTH-1:0] index_t;
+
+    typedef struct packed {
+        logic [ID_WIDTH-1:0] id;
+        logic [ADDR_WIDTH-1:0] addr;
+        logic [7:0] len;
+        logic [2:0] size;
+        logic [1:0] burst;
+        logic lock;
+        logic [3:0] cache;
+        logic [2:0] prot;
+        logic [3:0] region;
+    } addr_req_t;
+
+    typedef struct packed {
+        logic [ID_WIDTH-1:0] id;
+        logic [DATA_WIDTH-1:0] data;
+        logic [DATA_WIDTH/8-1:0] strb;
+        logic last;
+    } wdata_t;
+
+    // highest qos wins; among equal qos the first requester after `last` wins
+    function automatic index_t arbitrate(input logic [NUM_PORTS-1:0] req, input index_t last);
+        index_t winner = last;
+        logic found = 1'b0;
+        for (int k = 1; k <= NUM_PORTS; k++) begin
+            int i = (int'(last) + k) % NUM_PORTS;
+            if (req[i] && (!found || qos[i] > qos[winner])) begin
+                winner = index_t'(i);
+                found = 1'b1;
+            end
+        end
+        return winner;
+    endfunction
+
+    // interface arrays only take constant indices, so the upstream channels
+    // are gathered into plain arrays first
+    logic [NUM_PORTS-1:0] awvalid;
+    logic [NUM_PORTS-1:0] wvalid;
+    logic [NUM_PORTS-1:0] bready;
+    logic [NUM_PORTS-1:0] arvalid;
+    logic [NUM_PORTS-1:0] rready;
+    addr_req_t aw [NUM_PORTS];
+    addr_req_t ar [NUM_PORTS];
+    wdata_t w [NUM_PORTS];
+
+    // write channel state
+    logic w_busy;    // the AW and W of w_sel are passing through
+    index_t w_sel_reg;
+    index_t w_last;  // last write grant, for round-robin
+    logic aw_done;
+    logic w_done;
+    index_t w_sel;
+    logic w_active;
+    logic aw_fire;
+    logic wlast_fire;
+
+    // read address channel state
+    logic ar_hold;   // ARVALID is up and must stay with ar_sel until ARREADY
+    index_t ar_sel_reg;
+    index_t ar_last;
+    index_t ar_sel;
+
+    // response routing
+    index_t b_index;
+    index_t r_index;
+
+    assign b_index = M_AXI.BID[ID_WIDTH +: INDEX_WIDTH];
+    assign r_index = M_AXI.RID[ID_WIDTH +: INDEX_WIDTH];
+
+    generate
+        for (genvar i = 0; i < NUM_PORTS; i++) begin : gen_port
+            assign awvalid[i] = S_AXI[i].AWVALID;
+            assign aw[i] = {S_AXI[i].AWID, S_AXI[i].AWADDR, S_AXI[i].AWLEN, S_AXI[i].AWSIZE,
+                            S_AXI[i].AWBURST, S_AXI[i].AWLOCK, S_AXI[i].AWCACHE, S_AXI[i].AWPROT,
+                            S_AXI[i].AWREGION};
+            assign S_AXI[i].AWREADY = M_AXI.AWREADY && w_active && !aw_done && w_sel == index_t'(i);
+
+            assign wvalid[i] = S_AXI[i].WVALID;
+            assign w[i] = {S_AXI[i].WID, S_AXI[i].WDATA, S_AXI[i].WSTRB, S_AXI[i].WLAST};
+            assign S_AXI[i].WREADY = M_AXI.WREADY && w_active && !w_done && w_sel == index_t'(i);
+
+            assign bready[i] = S_AXI[i].BREADY;
+            assign S_AXI[i].BID = M_AXI.BID[ID_WIDTH-1:0];
+            assign S_AXI[i].BRESP = M_AXI.BRESP;
+            assign S_AXI[i].BVALID = M_AXI.BVALID && b_index == index_t'(i);
+
+            assign arvalid[i] = S_AXI[i].ARVALID;
+            assign ar[i] = {S_AXI[i].ARID, S_AXI[i].ARADDR, S_AXI[i].ARLEN, S_AXI[i].ARSIZE,
+                            S_AXI[i].ARBURST, S_AXI[i].ARLOCK, S_AXI[i].ARCACHE, S_AXI[i].ARPROT,
+                            S_AXI[i].ARREGION};
+            assign S_AXI[i].ARREADY = M_AXI.ARREADY && ar_sel == index_t'(i);
+
+            assign rready[i] = S_AXI[i].RREADY;
+            assign S_AXI[i].RID = M_AXI.RID[ID_WIDTH-1:0];
+            assign S_AXI[i].RDATA = M_AXI.RDATA;
+            assign S_AXI[i].RRESP = M_AXI.RRESP;
+            assign S_AXI[i].RLAST = M_AXI.RLAST;
+            assign S_AXI[i].RVALID = M_AXI.RVALID && r_index == index_t'(i);
+        end
+    endgenerate
+
+    /* -------------------------------- *
+     * Write address and data           *
+     * -------------------------------- */
+
+    always_comb begin
+        if (w_busy) begin
+            w_sel = w_sel_reg;
+            w_active = 1'b1;
+        end
+        else begin
+            w_sel = arbitrate(awvalid, w_last);
+            w_active = |awvalid;
+        end
+    end
+
+    assign M_AXI.AWID = {w_sel, aw[w_sel].id};
+    assign M_AXI.AWADDR = aw[w_sel].addr;
+    assign M_AXI.AWLEN = aw[w_sel].len;
+    assign M_AXI.AWSIZE = aw[w_sel].size;
+    assign M_AXI.AWBURST = aw[w_sel].burst;
+    assign M_AXI.AWLOCK = aw[w_sel].lock;
+    assign M_AXI.AWCACHE = aw[w_sel].cache;
+    assign M_AXI.AWPROT = aw[w_sel].prot;
+    assign M_AXI.AWQOS = qos[w_sel];
+    assign M_AXI.AWREGION = aw[w_sel].region;
+    assign M_AXI.AWVALID = w_active && !aw_done && awvalid[w_sel];
+
+    assign M_AXI.WID = {w_sel, w[w_sel].id};
+    assign M_AXI.WDATA = w[w_sel].data;
+    assign M_AXI.WSTRB = w[w_sel].strb;
+    assign M_AXI.WLAST = w[w_sel].last;
+    assign M_AXI.WVALID = w_active && !w_done && wvalid[w_sel];
+
+    assign aw_fire = M_AXI.AWVALID && M_AXI.AWREADY;
+    assign wlast_fire = M_AXI.WVALID && M_AXI.WREADY && M_AXI.WLAST;
+
+    always_ff @(posedge clk) begin
+        if (~rstn) begin
+            w_busy <= '0;
+            w_sel_reg <= '0;
+            w_last <= '0;
+            aw_done <= '0;
+            w_done <= '0;
+        end else if (w_active) begin
+            if ((aw_done || aw_fire) && (w_done || wlast_fire)) begin
+                w_busy <= '0;
+                w_last <= w_sel;
+                aw_done <= '0;
+                w_done <= '0;
+            end else begin
+                w_busy <= 1'b1;
+                w_sel_reg <= w_sel;
+                aw_done <= aw_done || aw_fire;
+                w_done <= w_done || wlast_fire;
+            end
+        end
+    end
+
+    /* -------------------------------- *
+     * Write response                   *
+     * -------------------------------- */
+
+    assign M_AXI.BREADY = bready[b_index];
+
+    /* -------------------------------- *
+     * Read address                     *
+     * -------------------------------- */
+
+    assign ar_sel = ar_hold ? ar_sel_reg : arbitrate(arvalid, ar_last);
+
+    assign M_AXI.ARID = {ar_sel, ar[ar_sel].id};
+    assign M_AXI.ARADDR = ar[ar_sel].addr;
+    assign M_AXI.ARLEN = ar[ar_sel].len;
+    assign M_AXI.ARSIZE = ar[ar_sel].size;
+    assign M_AXI.ARBURST = ar[ar_sel].burst;
+    assign M_AXI.ARLOCK = ar[ar_sel].lock;
+    assign M_AXI.ARCACHE = ar[ar_sel].cache;
+    assign M_AXI.ARPROT = ar[ar_sel].prot;
+    assign M_AXI.ARQOS = qos[ar_sel];
+    assign M_AXI.ARREGION = ar[ar_sel].region;
+    assign M_AXI.ARVALID = arvalid[ar_sel];
+
+    always_ff @(posedge clk) begin
+        if (~rstn) begin
+            ar_hold <= '0;
+            ar_sel_reg <= '0;
+            ar_last <= '0;
+        end else if (M_AXI.ARVALID) begin
+            if (M_AXI.ARREADY) begin
+                ar_hold <= '0;
+                ar_last <= ar_sel;
+            end else begin
+                ar_hold <= 1'b1;
+                ar_sel_reg <= ar_sel;
+            end
+        end
+    end
+
+    /* -------------------------------- *
+     * Read data                        *
+     * -------------------------------- */
+
+    assign M_AXI.RREADY = rready[r_index];
+
+endmodule
+
+`default_nettype wire
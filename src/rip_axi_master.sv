@@ -5,9 +5,14 @@
 // AXI4 master implementation
 // - supports independent write/read access
 // - uses handshake signals for state control
-// - assumes the burst length to be fixed
+// - transfers either a line of BURST_LEN beats (xline) or a single beat
+// - returns a line in address order in rdata; with WRAP_BURST the read starts at
+//   the requested beat and wraps, otherwise it starts at the line head, and
+//   rcrit pulses once the beat at raddr has arrived
 // - omits some AXI4-only signals
-// - does not check transaction responses
+// - issues exclusive accesses on request (xlock) with a fixed ID, so that the
+//   read and write of an exclusive pair match
+// - does not check transaction responses; xresp is passed to the parent
 // - does not support outstandings
 //
 
@@ -17,7 +22,8 @@ module rip_axi_master
     parameter ID_WIDTH = 4,
     parameter ADDR_WIDTH = 32,
     parameter DATA_WIDTH = 32, // Burst size
-    parameter BURST_LEN = 1
+    parameter BURST_LEN = 1, // beats per line (power of two)
+    parameter WRAP_BURST = 0 // critical-beat-first line reads
 ) (
     input wire clk,
     input wire rstn,
@@ -27,21 +33,32 @@ module rip_axi_master
     input wire [DATA_WIDTH*BURST_LEN-1:0] wdata,
     input wire [DATA_WIDTH*BURST_LEN/B_WIDTH-1:0] wstrb,
     input wire wvalid,
+    input wire wlock,
+    input wire wline, // the whole line, otherwise one beat at waddr from wdata[0]
     output logic wdone,
+    output logic [1:0] wresp,
     // Read access
     output logic rready,
     input wire [ADDR_WIDTH-1:0] raddr,
     input wire rvalid,
+    input wire rlock,
+    input wire rline, // the whole line, otherwise one beat at raddr into rdata[0]
     output logic [DATA_WIDTH*BURST_LEN-1:0] rdata,
+    output logic rcrit,
     output logic rdone,
+    output logic [1:0] rresp,
     // AXI interface
     rip_axi_interface.master M_AXI
 );
     import rip_axi_interface_const::*;
 
     // not crossing a 4KB address boundary is ensured by the parent module
-    localparam AXLEN = BURST_LEN - 1;
-    localparam AXSIZE = $clog2(DATA_WIDTH / B_WIDTH);
+    localparam logic [7:0] AXLEN = 8'(BURST_LEN - 1);
+    localparam logic [2:0] AXSIZE = 3'($clog2(DATA_WIDTH / B_WIDTH));
+    localparam logic [ID_WIDTH-1:0] EXCLUSIVE_ID = '0;
+    localparam LINE_BYTES = DATA_WIDTH / B_WIDTH * BURST_LEN;
+    localparam logic [ADDR_WIDTH-1:0] BEAT_MASK = ADDR_WIDTH'(DATA_WIDTH / B_WIDTH - 1);
+    localparam logic [ADDR_WIDTH-1:0] LINE_MASK = ADDR_WIDTH'(LINE_BYTES - 1);
 
     // buffers
     logic [DATA_WIDTH*BURST_LEN-1:0] wdata_buf;
@@ -50,7 +67,13 @@ module rip_axi_master
     // burst counters
     localparam BURST_CNT_WIDTH = (BURST_LEN > 1) ? $clog2(BURST_LEN) : 1;
     logic [BURST_CNT_WIDTH-1:0] wcnt;
-    logic [BURST_CNT_WIDTH-1:0] rcnt;
+    logic [BURST_CNT_WIDTH-1:0] rpos; // line position of the next beat
+    logic [BURST_CNT_WIDTH-1:0] rcrit_pos;
+
+    // line position of the beat at addr
+    function automatic logic [BURST_CNT_WIDTH-1:0] beat_of(input logic [ADDR_WIDTH-1:0] addr);
+        return (BURST_LEN > 1) ? BURST_CNT_WIDTH'(addr >> AXSIZE) : '0;
+    endfunction
 
     // Write channels
     always_ff @(posedge clk) begin
@@ -75,6 +98,7 @@ module rip_axi_master
             M_AXI.WVALID <= '0;
             wready <= '0;
             wdone <= '0;
+            wresp <= '0;
             wdata_buf <= '0;
             wstrb_buf <= '0;
             wcnt <= '0;
@@ -83,17 +107,18 @@ module rip_axi_master
         end else begin
             if (wready && wvalid) begin : WriteInit
                 // Write address channel signals
-                M_AXI.AWID <= M_AXI.AWID + 1'b1;
-                M_AXI.AWADDR <= waddr;
-                M_AXI.AWLEN <= AXLEN;
+                M_AXI.AWID <= wlock ? EXCLUSIVE_ID : M_AXI.AWID + 1'b1;
+                M_AXI.AWADDR <= waddr & ~(wline ? LINE_MASK : BEAT_MASK);
+                M_AXI.AWLEN <= wline ? AXLEN : '0;
                 M_AXI.AWSIZE <= AXSIZE;
                 M_AXI.AWBURST <= INCR;
+                M_AXI.AWLOCK <= wlock;
                 M_AXI.AWVALID <= 1'b1;
                 // Write data channel signals
-                M_AXI.WID <= M_AXI.WID + 1'b1;
+                M_AXI.WID <= wlock ? EXCLUSIVE_ID : M_AXI.WID + 1'b1;
                 M_AXI.WDATA <= wdata[0 +: DATA_WIDTH];
                 M_AXI.WSTRB <= wstrb[0 +: DATA_WIDTH/B_WIDTH];
-                M_AXI.WLAST <= (AXLEN == 0) ? 1'b1 : '0;
+                M_AXI.WLAST <= (AXLEN == 0 || !wline) ? 1'b1 : '0;
                 M_AXI.WVALID <= 1'b1;
                 wready <= '0;
                 wdone <= '0;
@@ -115,7 +140,7 @@ module rip_axi_master
                         M_AXI.WDATA <= wdata_buf[DATA_WIDTH*wcnt +: DATA_WIDTH];
                         M_AXI.WSTRB <= wstrb_buf[DATA_WIDTH*wcnt/B_WIDTH +: DATA_WIDTH/B_WIDTH];
                         wcnt <= wcnt + 1'b1;
-                        if (wcnt == AXLEN) begin
+                        if (wcnt == BURST_CNT_WIDTH'(M_AXI.AWLEN)) begin
                             M_AXI.WLAST <= 1'b1;
                         end
                     end
@@ -125,6 +150,7 @@ module rip_axi_master
                     M_AXI.BREADY <= '0;
                     wready <= 1'b1;
                     wdone <= 1'b1;
+                    wresp <= M_AXI.BRESP;
                 end
             end else begin
                 wready <= 1'b1;
@@ -152,23 +178,35 @@ module rip_axi_master
             M_AXI.RREADY <= '0;
             rready <= '0;
             rdata <= '0;
+            rcrit <= '0;
             rdone <= '0;
-            rcnt <= '0;
+            rresp <= '0;
+            rpos <= '0;
+            rcrit_pos <= '0;
         end else begin
+            rcrit <= '0;
             if (rready && rvalid) begin : ReadInit
                 // Read address channel signals
-                M_AXI.ARID <= M_AXI.ARID + 1'b1;
-                M_AXI.ARADDR <= raddr;
-                M_AXI.ARLEN <= AXLEN;
+                M_AXI.ARID <= rlock ? EXCLUSIVE_ID : M_AXI.ARID + 1'b1;
+                M_AXI.ARLEN <= rline ? AXLEN : '0;
                 M_AXI.ARSIZE <= AXSIZE;
-                M_AXI.ARBURST <= INCR;
+                if (rline && WRAP_BURST && BURST_LEN > 1) begin
+                    M_AXI.ARADDR <= raddr & ~BEAT_MASK;
+                    M_AXI.ARBURST <= WRAP;
+                    rpos <= beat_of(raddr);
+                end else begin
+                    M_AXI.ARADDR <= raddr & ~(rline ? LINE_MASK : BEAT_MASK);
+                    M_AXI.ARBURST <= INCR;
+                    rpos <= '0;
+                end
+                rcrit_pos <= rline ? beat_of(raddr) : '0;
+                M_AXI.ARLOCK <= rlock;
                 M_AXI.ARVALID <= 1'b1;
                 // Read data channel signals
                 M_AXI.RREADY <= 1'b1;
                 rready <= '0;
                 rdata <= '0;
                 rdone <= '0;
-                rcnt <= '0;
             end else if (M_AXI.ARVALID) begin : WaitAddrRead
                 if (M_AXI.ARREADY) begin
                     M_AXI.ARVALID <= '0;
@@ -176,8 +214,10 @@ module rip_axi_master
             end else if (M_AXI.RREADY) begin : ReadingData
                 // RVALID is asserted AFTER both ARVALID and ARREADY are asserted
                 if (M_AXI.RVALID) begin // read one beat
-                    rdata <= rdata | (M_AXI.RDATA << (DATA_WIDTH * rcnt));
-                    rcnt <= rcnt + 1'b1;
+                    rdata[DATA_WIDTH*rpos +: DATA_WIDTH] <= M_AXI.RDATA;
+                    rresp <= M_AXI.RRESP;
+                    rpos <= rpos + 1'b1;
+                    rcrit <= rpos == rcrit_pos;
                     if (M_AXI.RLAST) begin
                         M_AXI.RREADY <= '0;
                         rready <= 1'b1;
@@ -0,0 +1,288 @@
+`default_nettype none
+`timescale 1ns / 1ps
+
+//
+// AXI4 master in its own clock domain
+// - has the ports of rip_axi_master on clk and runs rip_axi_master on axi_clk,
+//   so the core is not limited to the interconnect clock
+// - passes requests and responses through rip_fifo_async queues: one request
+//   per channel is in flight, and a line read answers with up to two entries,
+//   the critical beat (rcrit) and the whole line (rdone)
+// - cdc_rstn and axi_rstn reset the two ends of the queues and must be
+//   asserted together, each synchronous to its own clock. They are kept out
+//   of the per-run core reset (rstn), which may be too short to reach
+//   axi_clk: a read still in flight when a run ends drains into its queue
+//   and its response is dropped
+//
+
+module rip_axi_master_async
+    import rip_const::*;
+#(
+    parameter ID_WIDTH = 4,
+    parameter ADDR_WIDTH = 32,
+    parameter DATA_WIDTH = 32, // Burst size
+    parameter BURST_LEN = 1, // beats per line (power of two)
+    parameter WRAP_BURST = 0 // critical-beat-first line reads
+) (
+    input wire clk,
+    input wire rstn, // the core's reset, which may last a single cycle
+    input wire cdc_rstn, // the clk side of the crossing
+    input wire axi_clk,
+    input wire axi_rstn,
+    // Write access (clk)
+    output logic wready,
+    input wire [ADDR_WIDTH-1:0] waddr,
+    input wire [DATA_WIDTH*BURST_LEN-1:0] wdata,
+    input wire [DATA_WIDTH*BURST_LEN/B_WIDTH-1:0] wstrb,
+    input wire wvalid,
+    input wire wlock,
+    input wire wline,
+    output logic wdone,
+    output logic [1:0] wresp,
+    // Read access (clk)
+    output logic rready,
+    input wire [ADDR_WIDTH-1:0] raddr,
+    input wire rvalid,
+    input wire rlock,
+    input wire rline,
+    output logic [DATA_WIDTH*BURST_LEN-1:0] rdata,
+    output logic rcrit,
+    output logic rdone,
+    output logic [1:0] rresp,
+    // AXI interface (axi_clk)
+    rip_axi_interface.master M_AXI
+);
+    localparam LINE_WIDTH = DATA_WIDTH * BURST_LEN;
+    localparam STRB_WIDTH = LINE_WIDTH / B_WIDTH;
+    // 4 entries; the full flag lags the other side by the synchronizer
+    localparam QUEUE_ADDR_WIDTH = 2;
+
+    typedef struct packed {
+        logic [ADDR_WIDTH-1:0] addr;
+        logic [LINE_WIDTH-1:0] data;
+        logic [STRB_WIDTH-1:0] strb;
+        logic lock;
+        logic line;
+    } wreq_t;
+
+    typedef struct packed {
+        logic [ADDR_WIDTH-1:0] addr;
+        logic lock;
+        logic line;
+    } rreq_t;
+
+    typedef struct packed {
+        logic crit;
+        logic done;
+        logic [1:0] resp;
+        logic [LINE_WIDTH-1:0] data;
+    } rres_t;
+
+    // queues: *_req from clk to axi_clk, *_res back
+    wreq_t wreq_in, wreq_out;
+    logic wreq_empty;
+    logic [1:0] wres_out;
+    logic wres_empty;
+    rreq_t rreq_in, rreq_out;
+    logic rreq_empty;
+    rres_t rres_in, rres_out;
+    logic rres_empty;
+
+    // rip_axi_master control signals (axi_clk)
+    logic m_wready;
+    logic m_wdone;
+    logic [1:0] m_wresp;
+    logic m_rready;
+    logic [LINE_WIDTH-1:0] m_rdata;
+    logic m_rcrit;
+    logic m_rdone;
+    logic [1:0] m_rresp;
+
+    // a request in flight, and whether the core has reset since it was issued (clk)
+    logic wpending;
+    logic wstale;
+    logic rpending;
+    logic rstale;
+
+    /* -------------------------------- *
+     * clk side                         *
+     * -------------------------------- */
+
+    assign wreq_in = '{addr: waddr, data: wdata, strb: wstrb, lock: wlock, line: wline};
+    assign rreq_in = '{addr: raddr, lock: rlock, line: rline};
+
+    // wready and rready stay low while a request is in flight, so the queues
+    // never fill up and the handshakes are those of rip_axi_master. A request
+    // in flight when the core resets (rstn) still completes, but its response
+    // is dropped: the MMU may already wait on the ready of its next request
+    always_ff @(posedge clk) begin
+        if (~cdc_rstn) begin
+            wready <= '0;
+            wdone <= '0;
+            wresp <= '0;
+            wpending <= '0;
+            wstale <= '0;
+        end else begin
+            wdone <= '0;
+            if (wpending) begin
+                if (!wres_empty) begin
+                    wready <= '1;
+                    wdone <= rstn && !wstale;
+                    wresp <= wres_out;
+                    wpending <= '0;
+                    wstale <= '0;
+                end else if (~rstn) begin
+                    wstale <= '1;
+                end
+            end else if (wready && wvalid) begin
+                wready <= '0;
+                wpending <= '1;
+            end else begin
+                wready <= '1;
+            end
+        end
+    end
+
+    always_ff @(posedge clk) begin
+        if (~cdc_rstn) begin
+            rready <= '0;
+            rdata <= '0;
+            rcrit <= '0;
+            rdone <= '0;
+            rresp <= '0;
+            rpending <= '0;
+            rstale <= '0;
+        end else begin
+            rcrit <= '0;
+            rdone <= '0;
+            if (rpending) begin
+                if (!rres_empty) begin
+                    rdata <= rres_out.data;
+                    rresp <= rres_out.resp;
+                    rcrit <= rres_out.crit && rstn && !rstale;
+                    rdone <= rres_out.done && rstn && !rstale;
+                end
+                if (!rres_empty && rres_out.done) begin
+                    rready <= '1;
+                    rpending <= '0;
+                    rstale <= '0;
+                end else if (~rstn) begin
+                    rstale <= '1;
+                end
+            end else if (rready && rvalid) begin
+                rready <= '0;
+                rpending <= '1;
+            end else begin
+                rready <= '1;
+            end
+        end
+    end
+
+    /* -------------------------------- *
+     * queues                           *
+     * -------------------------------- */
+
+    rip_fifo_async #(
+        .DATA_WIDTH($bits(wreq_t)),
+        .ADDR_WIDTH(QUEUE_ADDR_WIDTH)
+    ) wreq_queue (
+        .w_clk(clk),
+        .r_clk(axi_clk),
+        .w_rst(~cdc_rstn),
+        .r_rst(~axi_rstn),
+        .w_en(wready && wvalid),
+        .r_en(m_wready),
+        .w_data(wreq_in),
+        .r_data(wreq_out),
+        .w_full(),
+        .r_empty(wreq_empty)
+    );
+
+    rip_fifo_async #(
+        .DATA_WIDTH(2),
+        .ADDR_WIDTH(QUEUE_ADDR_WIDTH)
+    ) wres_queue (
+        .w_clk(axi_clk),
+        .r_clk(clk),
+        .w_rst(~axi_rstn),
+        .r_rst(~cdc_rstn),
+        .w_en(m_wdone),
+        .r_en(wpending),
+        .w_data(m_wresp),
+        .r_data(wres_out),
+        .w_full(),
+        .r_empty(wres_empty)
+    );
+
+    rip_fifo_async #(
+        .DATA_WIDTH($bits(rreq_t)),
+        .ADDR_WIDTH(QUEUE_ADDR_WIDTH)
+    ) rreq_queue (
+        .w_clk(clk),
+        .r_clk(axi_clk),
+        .w_rst(~cdc_rstn),
+        .r_rst(~axi_rstn),
+        .w_en(rready && rvalid),
+        .r_en(m_rready),
+        .w_data(rreq_in),
+        .r_data(rreq_out),
+        .w_full(),
+        .r_empty(rreq_empty)
+    );
+
+    assign rres_in = '{crit: m_rcrit, done: m_rdone, resp: m_rresp, data: m_rdata};
+
+    rip_fifo_async #(
+        .DATA_WIDTH($bits(rres_t)),
+        .ADDR_WIDTH(QUEUE_ADDR_WIDTH)
+    ) rres_queue (
+        .w_clk(axi_clk),
+        .r_clk(clk),
+        .w_rst(~axi_rstn),
+        .r_rst(~cdc_rstn),
+        .w_en(m_rcrit || m_rdone),
+        .r_en(rpending),
+        .w_data(rres_in),
+        .r_data(rres_out),
+        .w_full(),
+        .r_empty(rres_empty)
+    );
+
+    /* -------------------------------- *
+     * axi_clk side                     *
+     * -------------------------------- */
+
+    // a request leaves its queue on the edge rip_axi_master accepts it
+    rip_axi_master #(
+        .ID_WIDTH(ID_WIDTH),
+        .ADDR_WIDTH(ADDR_WIDTH),
+        .DATA_WIDTH(DATA_WIDTH),
+        .BURST_LEN(BURST_LEN),
+        .WRAP_BURST(WRAP_BURST)
+    ) AXIM (
+        .clk(axi_clk),
+        .rstn(axi_rstn),
+        .wready(m_wready),
+        .waddr(wreq_out.addr),
+        .wdata(wreq_out.data),
+        .wstrb(wreq_out.strb),
+        .wvalid(!wreq_empty),
+        .wlock(wreq_out.lock),
+        .wline(wreq_out.line),
+        .wdone(m_wdone),
+        .wresp(m_wresp),
+        .rready(m_rready),
+        .raddr(rreq_out.addr),
+        .rvalid(!rreq_empty),
+        .rlock(rreq_out.lock),
+        .rline(rreq_out.line),
+        .rdata(m_rdata),
+        .rcrit(m_rcrit),
+        .rdone(m_rdone),
+        .rresp(m_rresp),
+        .M_AXI(M_AXI)
+    );
+
+endmodule
+
+`default_nettype wire
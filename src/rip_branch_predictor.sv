@@ -5,6 +5,11 @@
 // branch predictor implementation
 // - Bimodal predictor
 // - define 'GSHARE' to use as Gshare predictor
+// - define 'PERCEPTRON' or 'PERCEPTRON_RO' to use as perceptron predictor,
+//   pipelined by BP_PIPELINE_DEPTH and optionally indexed one fetch ahead
+//   (BP_AHEAD_INDEX); the answer comes PRED_LATENCY cycles after the fetch
+// - the table and the history outlive the core's reset between runs, and the
+//   access ports let the bpidx/bpdat/bphist CSRs dump and load them
 //
 
 module rip_branch_predictor
@@ -13,94 +18,243 @@ module rip_branch_predictor
 #(
 ) (
     input wire clk,
-    input wire rstn,
+    input wire rstn, // clears the history; the table keeps its contents
+    input wire core_rstn, // the core between runs: drops what is in flight
     input wire [31:0] pc,
+    input wire fetch, // pc is fetched this cycle
     output bp_index_t pred_index,
     output bp_weight_t pred_weight,
     output logic pred,
+    input wire spec_push, // a branch leaves IF with prediction spec_taken
+    input wire spec_taken,
+    input wire repair, // IF and DE are flushed
     input wire update, // deasserted when stall
     input wire bp_index_t update_index,
     input wire bp_weight_t update_weight,
-    input wire actual
+    input wire actual,
+    // table and history access
+    input wire freeze, // branches neither train the table nor shift the history
+    input wire bp_index_t access_index,
+    input wire [7:0] access_word, // 32-bit word of the entry
+    input wire access_load, // access_index changes: read the entry again
+    input wire access_we, // write access_wdata into the word, then the entry into the table
+    input wire [31:0] access_wdata,
+    output logic [31:0] access_rdata,
+    output logic access_valid, // access_rdata is the entry at access_index
+    input wire history_we,
+    input wire [31:0] history_wdata,
+    output logic [31:0] history_rdata
     `ifdef VERILATOR
         , output logic [HISTORY_LEN-1:0] global_histroy_dbg
+        // zeroes one table entry per cycle while held, out of rstn: 2 **
+        // TABLE_DEPTH cycles give a job the table of a new model
+        , input wire clear
     `endif
 );
 
-    /* predict */
+    /* history */
+    // global_histroy holds the predictions of branches not resolved yet, so a
+    // fetch sees the branches just before it (BP_SPECULATIVE_HISTORY). Branches resolve in order, so the
+    // resolved history is the checkpoint of the oldest one in flight: a flush
+    // restores it together with the outcome of the branch resolving now.
     logic [HISTORY_LEN-1:0] global_histroy;
+    logic [HISTORY_LEN-1:0] global_histroy_next;
+    logic [HISTORY_LEN-1:0] resolved_history;
+    logic [HISTORY_LEN-1:0] resolved_history_next;
+
+    function automatic logic [HISTORY_LEN-1:0] shift_in(input logic [HISTORY_LEN-1:0] history,
+                                                        input logic taken);
+        return HISTORY_LEN'({history, taken});
+    endfunction
+
+    logic learn;
+    assign learn = update & !freeze;
+
+    always_comb begin
+        resolved_history_next = learn ? shift_in(resolved_history, actual) : resolved_history;
+        if (history_we) begin
+            resolved_history_next = HISTORY_LEN'(history_wdata);
+            global_histroy_next = HISTORY_LEN'(history_wdata);
+        end else if (repair || !BP_SPECULATIVE_HISTORY) begin
+            global_histroy_next = resolved_history_next;
+        end else if (spec_push & !freeze) begin
+            global_histroy_next = shift_in(global_histroy, spec_taken);
+        end else begin
+            global_histroy_next = global_histroy;
+        end
+    end
+
+    assign history_rdata = 32'(resolved_history);
+
+    /* predict */
     logic [TABLE_DEPTH-1:0] current_index;
     weight_t current_weight;
+    bp_index_t lookup_index;  // current_index, as the table outputs current_weight
+    logic lookup_valid;       // current_weight is a fetch's lookup
 
     `ifdef PERCEPTRON
         assign current_index = pc[BP_PC_MSB:BP_PC_LSB];
-        logic [WEIGHT_WIDTH-1:0] pred_y;
-        always_comb begin
-            pred_y = current_weight[WEIGHT_NUM-1];
-            for (int i = 0; i < WEIGHT_NUM - 1; i++) begin
-                if (global_histroy[i]) begin
-                    pred_y += current_weight[i];
-                end else begin
-                    pred_y -= current_weight[i];
-                end
-            end
-        end
-        assign pred_weight.history = global_histroy;
-        assign pred_weight.weights = current_weight;
-        assign pred_weight.y = pred_y;
-        assign pred = ~ pred_y[WEIGHT_WIDTH-1]; // sign (>= 0 ?)
+        logic [WEIGHT_NUM-2:0] bp_x;
+        assign bp_x = global_histroy;
     `elsif PERCEPTRON_RO
         assign current_index = pc[BP_PC_MSB:BP_PC_LSB];
 
-        logic [BP_RO_NUM-1:0] ro_sdelta; // second delta (delta of delta)
+        logic [RO_FEATURE_NUM-1:0] ro_feature;
         logic [WEIGHT_NUM - 2: 0] bp_x;
-        assign bp_x = {global_histroy, ro_sdelta};
+        assign bp_x = {global_histroy, ro_feature};
+    `else /* BIMODAL || GSHARE */
+        `ifdef BIMODAL
+            assign current_index = pc[BP_PC_MSB:BP_PC_LSB];
+        `else
+            // the registered history, which keeps the repair mux and the
+            // branch unit off the table's address path: the fetch issued as a
+            // branch leaves IF does not see that branch, the next one does
+            assign current_index = pc[BP_PC_MSB:BP_PC_LSB] ^ global_histroy;
+        `endif
+        assign pred_weight = bp_weight_t'(current_weight);
+        assign pred = pred_weight >= WEAKLY_TAKEN;
+        assign pred_index = lookup_index;
+    `endif
 
-        logic [WEIGHT_WIDTH-1:0] pred_y;
+    `ifndef BIMODAL
+    `ifndef GSHARE
+        /*
+        * y = bias + sum(x[i] ? w[i] : -w[i]), with -w = ~w + 1: the rows are the
+        * bias, w[i] or ~w[i], and the number of +1s, summed by an adder tree with
+        * BP_PIPELINE_DEPTH stages. The index and the inputs travel beside it.
+        */
+        logic [WEIGHT_NUM:0][WEIGHT_WIDTH-1:0] sum_rows;
         always_comb begin
-            pred_y = current_weight[WEIGHT_NUM-1];
+            sum_rows[WEIGHT_NUM-1] = current_weight[WEIGHT_NUM-1];
             for (int i = 0; i < WEIGHT_NUM - 1; i++) begin
-                if (bp_x[i]) begin
-                    pred_y += current_weight[i];
-                end else begin
-                    pred_y -= current_weight[i];
+                sum_rows[i] = bp_x[i] ? current_weight[i] : ~current_weight[i];
+            end
+            sum_rows[WEIGHT_NUM] = WEIGHT_WIDTH'($countones(~bp_x));
+        end
+
+        logic [WEIGHT_WIDTH-1:0] sum_y;
+        rip_adder_tree #(
+            .WIDTH(WEIGHT_WIDTH),
+            .NUM(WEIGHT_NUM + 1),
+            .STAGES(BP_PIPELINE_DEPTH)
+        ) sum_tree (
+            .clk(clk),
+            .rows(sum_rows),
+            .sum(sum_y)
+        );
+
+        // DE takes a fetch's prediction three cycles after the fetch at the
+        // earliest; from a deeper tree it would take the previous fetch's
+        generate
+            if (BP_AHEAD_INDEX ? BP_PIPELINE_DEPTH > 3 : BP_PIPELINE_DEPTH > 1) begin : g_depth_check
+                $error("BP_TREE_STAGES=%0d: at most 1 stage, or 3 with BP_AHEAD",
+                       BP_PIPELINE_DEPTH);
+            end
+        endgenerate
+
+        bp_weight_t lookup_weight;
+        assign lookup_weight.history = global_histroy;
+        `ifdef PERCEPTRON_RO
+            assign lookup_weight.ro_feature = ro_feature;
+        `endif
+        assign lookup_weight.weights = current_weight;
+        assign lookup_weight.y = '0;
+
+        bp_index_t y_index;
+        bp_weight_t y_weight;
+        logic y_valid;  // a fetch's lookup leaves the tree
+        generate
+            if (BP_PIPELINE_DEPTH == 0) begin : g_sum_comb
+                assign y_index = lookup_index;
+                assign y_weight = lookup_weight;
+                assign y_valid = lookup_valid;
+            end else begin : g_sum_pipe
+                bp_index_t pipe_index [BP_PIPELINE_DEPTH];
+                bp_weight_t pipe_weight [BP_PIPELINE_DEPTH];
+                logic [BP_PIPELINE_DEPTH-1:0] pipe_valid;
+
+                always_ff @(posedge clk) begin
+                    pipe_index[0] <= lookup_index;
+                    pipe_weight[0] <= lookup_weight;
+                    pipe_valid[0] <= core_rstn & lookup_valid;
+                    for (int i = 1; i < BP_PIPELINE_DEPTH; i++) begin
+                        pipe_index[i] <= pipe_index[i-1];
+                        pipe_weight[i] <= pipe_weight[i-1];
+                        pipe_valid[i] <= core_rstn & pipe_valid[i-1];
+                    end
                 end
+
+                assign y_index = pipe_index[BP_PIPELINE_DEPTH-1];
+                assign y_weight = pipe_weight[BP_PIPELINE_DEPTH-1];
+                assign y_valid = pipe_valid[BP_PIPELINE_DEPTH-1];
             end
+        endgenerate
+
+        bp_weight_t sum_weight;
+        logic sum_pred;
+        always_comb begin
+            sum_weight = y_weight;
+            sum_weight.y = sum_y;
+            sum_pred = ~ sum_y[WEIGHT_WIDTH-1]; // sign (>= 0 ?)
         end
 
-        assign pred_weight.history = global_histroy;
-        assign pred_weight.ro_sdelta = ro_sdelta;
-        assign pred_weight.weights = current_weight;
-        assign pred_weight.y = pred_y;
-        assign pred = ~ pred_y[WEIGHT_WIDTH-1]; // sign (>= 0 ?)
-    `else /* BIMODAL || GSHARE */
-        assign current_index = pc[BP_PC_MSB:BP_PC_LSB] ^ global_histroy;
-        assign pred_weight = bp_weight_t'(current_weight);
-        assign pred = pred_weight >= WEAKLY_TAKEN;
+        generate
+            if (BP_AHEAD_INDEX) begin : g_ahead
+                // the lookup of one fetch predicts the next one. The core samples
+                // the answer the cycle after the fetch; with a pipelined tree the
+                // previous fetch's sum may leave the tree just then.
+                logic bypass;
+                bp_index_t ahead_index;
+                bp_weight_t ahead_weight;
+                logic ahead_pred;
+
+                always_ff @(posedge clk) begin
+                    if (~core_rstn) begin
+                        ahead_index <= '0;
+                        ahead_weight <= '0;
+                        ahead_pred <= 1'b0;
+                    end else if (y_valid) begin
+                        ahead_index <= y_index;
+                        ahead_weight <= sum_weight;
+                        ahead_pred <= sum_pred;
+                    end
+                end
+
+                assign bypass = BP_PIPELINE_DEPTH != 0 && y_valid;
+                assign pred_index = bypass ? y_index : ahead_index;
+                assign pred_weight = bypass ? sum_weight : ahead_weight;
+                assign pred = bypass ? sum_pred : ahead_pred;
+            end else begin : g_direct
+                assign pred_index = y_index;
+                assign pred_weight = sum_weight;
+                assign pred = sum_pred;
+            end
+        endgenerate
+    `endif
     `endif
 
-    logic [HISTORY_LEN-1:0] new_global_history;
-    generate
-        if (HISTORY_LEN == 1) begin
-            assign new_global_history = actual;
+    always_ff @(posedge clk) begin
+        if (~core_rstn) begin
+            lookup_index <= '0;
+            lookup_valid <= 1'b0;
         end else begin
-            assign new_global_history = {global_histroy[HISTORY_LEN-2:0], actual};
+            lookup_index <= current_index;
+            lookup_valid <= fetch;
         end
-    endgenerate
+    end
 
     always_ff @(posedge clk) begin
         if (~rstn) begin
-            pred_index <= '0;
             global_histroy <= '0;
+            resolved_history <= '0;
+        end else if (~core_rstn) begin
+            // predictions of the last run that never resolved
+            global_histroy <= resolved_history;
         end else begin
-            pred_index <= current_index;
-            if (update) begin
-                `ifndef BIMODAL
-                    global_histroy <= new_global_history;
-                `endif
-            end else begin
-                global_histroy <= global_histroy;
-            end
+            `ifndef BIMODAL
+                global_histroy <= global_histroy_next;
+                resolved_history <= resolved_history_next;
+            `endif
             `ifdef VERILATOR
                 global_histroy_dbg <= global_histroy;
             `endif
@@ -117,7 +271,7 @@ module rip_branch_predictor
         assign update_pred = ~ update_weight.y[WEIGHT_WIDTH-1]; // sign (>= 0 ?)
         assign update_y_abs = update_pred ? update_weight.y : (~update_weight.y + 1'b1);
 
-        assign update_we = (update_pred ^ actual) || (update_y_abs <= WEIGHT_WIDTH'(THETA));
+        assign update_we = learn && ((update_pred ^ actual) || (update_y_abs <= WEIGHT_WIDTH'(THETA)));
         assign updated_weight_value[WEIGHT_NUM-1] =
                 update_weight.weights[WEIGHT_NUM-1] + (actual ? 1 : -1);
         generate
@@ -133,11 +287,11 @@ module rip_branch_predictor
         assign update_pred = ~ update_weight.y[WEIGHT_WIDTH-1]; // sign (>= 0 ?)
         assign update_y_abs = update_pred ? update_weight.y : (~update_weight.y + 1'b1);
 
-        assign update_we = (update_pred ^ actual) || (update_y_abs <= WEIGHT_WIDTH'(THETA));
+        assign update_we = learn && ((update_pred ^ actual) || (update_y_abs <= WEIGHT_WIDTH'(THETA)));
         assign updated_weight_value[WEIGHT_NUM-1] =
                 update_weight.weights[WEIGHT_NUM-1] + (actual ? 1 : -1);
         logic [WEIGHT_NUM - 2 : 0] update_bp_x;
-        assign update_bp_x = {update_weight.history, update_weight.ro_sdelta};
+        assign update_bp_x = {update_weight.history, update_weight.ro_feature};
         generate
             for (genvar i = 0; i < WEIGHT_NUM - 1; i++) begin
                 assign updated_weight_value[i] =
@@ -146,7 +300,7 @@ module rip_branch_predictor
             end
         endgenerate
     `else /* BIMODAL || GSHARE */
-        assign update_we = update;
+        assign update_we = learn;
         always_comb begin
             case (update_weight)
                 STRONGLY_UNTAKEN:
@@ -164,7 +318,90 @@ module rip_branch_predictor
     `endif
 
     /* table */
-    logic [TABLE_WIDTH-1:0] dout_1_dummy;
+    // port 1 trains the table; when it does not, it reads or writes the entry
+    // at access_index for the CSRs
+    logic [ACCESS_WORDS*32-1:0] access_entry;
+    logic access_entry_valid;
+    logic access_read_pending;
+    logic access_reading;  // dout_1 is the entry at access_index
+    logic access_write_pending;
+    bp_index_t access_write_index;
+
+    logic table_we_1;
+    bp_index_t table_addr_1;
+    logic [TABLE_WIDTH-1:0] table_din_1;
+    logic [TABLE_WIDTH-1:0] table_dout_1;
+    logic access_read_now;
+
+    `ifdef VERILATOR
+        bp_index_t clear_index;
+        always_ff @(posedge clk) begin
+            clear_index <= clear ? clear_index + 1'b1 : '0;
+        end
+    `endif
+
+    always_comb begin
+        table_we_1 = update_we;
+        table_addr_1 = update_index;
+        table_din_1 = updated_weight_value;
+        access_read_now = 1'b0;
+        if (!update_we) begin
+            if (access_write_pending) begin
+                table_we_1 = 1'b1;
+                table_addr_1 = access_write_index;
+                table_din_1 = access_entry[TABLE_WIDTH-1:0];
+            end else begin
+                table_addr_1 = access_index;
+                access_read_now = access_read_pending;
+            end
+        end
+        `ifdef VERILATOR
+            if (clear) begin
+                table_we_1 = 1'b1;
+                table_addr_1 = clear_index;
+                table_din_1 = '0;
+            end
+        `endif
+    end
+
+    always_ff @(posedge clk) begin
+        if (~core_rstn) begin
+            access_entry_valid <= 1'b0;
+            access_read_pending <= 1'b1;
+            access_reading <= 1'b0;
+            access_write_pending <= 1'b0;
+        end else begin
+            access_reading <= access_read_now;
+            if (access_read_now) begin
+                access_read_pending <= 1'b0;
+            end
+            if (access_reading) begin
+                access_entry <= (ACCESS_WORDS*32)'(table_dout_1);
+                access_entry_valid <= 1'b1;
+            end
+
+            if (!update_we & access_write_pending) begin
+                access_write_pending <= 1'b0;
+            end
+            if (access_we) begin
+                if (access_word < ACCESS_WORDS) begin
+                    access_entry[access_word*32 +: 32] <= access_wdata;
+                end
+                access_write_pending <= 1'b1;
+                access_write_index <= access_index;
+            end
+
+            if (access_load) begin
+                access_entry_valid <= 1'b0;
+                access_read_pending <= 1'b1;
+                access_reading <= 1'b0;
+            end
+        end
+    end
+
+    assign access_rdata = access_word < ACCESS_WORDS ? access_entry[access_word*32 +: 32] : 32'h0;
+    assign access_valid = access_entry_valid & !access_load;
+
     rip_2r1w_bram #(
         .DATA_WIDTH(TABLE_WIDTH),
         .ADDR_WIDTH(TABLE_DEPTH)
@@ -172,25 +409,20 @@ module rip_branch_predictor
         .clk(clk),
         .enable_1(rstn),
         .enable_2(rstn),
-        .addr_1(update_index),
+        .addr_1(table_addr_1),
         .addr_2(current_index),
-        .we_1(update_we),
-        .din_1(updated_weight_value),
-        .dout_1(dout_1_dummy), // ignored
+        .we_1(table_we_1),
+        .din_1(table_din_1),
+        .dout_1(table_dout_1),
         .dout_2(current_weight)
     );
 
     /* ring oscillators for PERCEPTRON_RO */
     `ifdef PERCEPTRON_RO
-        rip_ring_oscillator_monitor #(
-            .INVERTER_DELAY(1),
-            .RO_SIZE(3),
-            .RO_DATAWIDTH(32),
-            .RO_SAMPLE_CYCLE(100)
-        ) ro_monitor_0 (
+        rip_ring_oscillator_bank ro_bank (
             .clk(clk),
             .rstn(rstn),
-            .sdelta(ro_sdelta[0])
+            .feature(ro_feature)
         );
     `endif
 
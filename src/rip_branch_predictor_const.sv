@@ -13,11 +13,18 @@ package rip_branch_predictor_const;
     * bp_index_t: branch predictor table index public type
     * bp_weight_t: branch predictor weight public type
     * weight_t: branch predictor weight private type
+    * PRED_LATENCY: cycles from a fetch until its prediction is on the outputs
+    * ACCESS_WORDS: 32-bit words of a table entry, as the bpdat CSR sees it
+    * RO_FEATURE_BITS: perceptron inputs from each ring oscillator monitor
+    * RO_FEATURE_NUM: perceptron inputs from the ring oscillator bank
     */
 
     localparam int TABLE_DEPTH = BP_PC_MSB - BP_PC_LSB + 1;
     typedef logic [TABLE_DEPTH-1 : 0] bp_index_t;
 
+    localparam int RO_FEATURE_BITS = BP_RO_FEATURE == RO_QUANT ? BP_RO_QUANT_BITS : 1;
+    localparam int RO_FEATURE_NUM = BP_RO_NUM * RO_FEATURE_BITS;
+
     `ifdef PERCEPTRON
         localparam int HISTORY_LEN = BP_HISTORY_LEN;
 
@@ -37,6 +44,8 @@ package rip_branch_predictor_const;
             weight_t weights;
             logic [WEIGHT_WIDTH-1:0] y;
         } bp_weight_t;
+
+        localparam int PRED_LATENCY = BP_AHEAD_INDEX ? 1 : 1 + BP_PIPELINE_DEPTH;
     `elsif PERCEPTRON_RO
         localparam int HISTORY_LEN = BP_HISTORY_LEN;
 
@@ -45,7 +54,7 @@ package rip_branch_predictor_const;
         * WEIGHT_WIDTH: width of each weight
         * WEIGHT_NUM: the number of weights (+1 for bias)
         */
-        localparam int WEIGHT_NUM = HISTORY_LEN + BP_RO_NUM + 1;
+        localparam int WEIGHT_NUM = HISTORY_LEN + RO_FEATURE_NUM + 1;
         localparam int THETA = $floor(1.93 * real'(WEIGHT_NUM - 1) + 14);
         localparam int WEIGHT_WIDTH = $clog2(THETA+1) + 1;
 
@@ -53,10 +62,12 @@ package rip_branch_predictor_const;
         typedef logic [WEIGHT_NUM-1:0][WEIGHT_WIDTH-1:0] weight_t;
         typedef struct packed {
             logic [HISTORY_LEN-1:0] history;
-            logic [BP_RO_NUM-1:0] ro_sdelta; // second delta (delta of delta)
+            logic [RO_FEATURE_NUM-1:0] ro_feature;
             weight_t weights;
             logic [WEIGHT_WIDTH-1:0] y;
         } bp_weight_t;
+
+        localparam int PRED_LATENCY = BP_AHEAD_INDEX ? 1 : 1 + BP_PIPELINE_DEPTH;
     `else /* BIMODAL || GSHARE */
         localparam int HISTORY_LEN = TABLE_DEPTH;
 
@@ -69,8 +80,12 @@ package rip_branch_predictor_const;
             STRONGLY_TAKEN   = 'b11,
             NONE = 'x
         } bp_weight_t;
+
+        localparam int PRED_LATENCY = 1;
     `endif
 
+    localparam int ACCESS_WORDS = (TABLE_WIDTH + 31) / 32;
+
 endpackage
 
 `endif
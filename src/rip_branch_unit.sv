@@ -0,0 +1,74 @@
+/*
+ * Module `rip_branch_unit`
+ *
+ * Resolves the instruction in DE that is about to enter EX: whether a
+ * BEQ/BNE/BLT/BGE/BLTU/BGEU is taken, and where a branch or JAL goes next.
+ * The operands are the forwarded `de_rs1`/`de_rs2`, so the result is ready in
+ * the same cycle as the ALU's, but it does not go through the ALU's operand
+ * and result muxes: one XOR-reduce for equality and one 33-bit subtraction for
+ * both orderings. `rip_core` uses `taken` to check the prediction and, with
+ * `BP_RESOLVE_IN_DE`, `target` as the fetch address after a misprediction.
+ */
+
+`default_nettype none
+`timescale 1ns / 1ps
+
+module rip_branch_unit
+    import rip_type::*;
+#(
+    parameter int DATA_WIDTH = 32
+) (
+    input inst_t inst,
+
+    input wire [DATA_WIDTH-1:0] rs1,
+    input wire [DATA_WIDTH-1:0] rs2,
+    input wire [DATA_WIDTH-1:0] pc,
+    input wire [DATA_WIDTH-1:0] imm,
+
+    output logic taken,
+    output logic [DATA_WIDTH-1:0] target
+);
+    logic eq;
+    logic ltu;
+    logic lt;
+    logic [DATA_WIDTH:0] diff;
+
+    assign eq = ~|(rs1 ^ rs2);
+    assign diff = {1'b0, rs1} - {1'b0, rs2};
+    assign ltu = diff[DATA_WIDTH];
+    // the signs differ: the negative one is less; otherwise as unsigned
+    assign lt = rs1[DATA_WIDTH-1] ^ rs2[DATA_WIDTH-1] ? rs1[DATA_WIDTH-1] : ltu;
+
+    always_comb begin
+        if (inst.BEQ) begin
+            taken = eq;
+        end
+        else if (inst.BNE) begin
+            taken = !eq;
+        end
+        else if (inst.BLT) begin
+            taken = lt;
+        end
+        else if (inst.BGE) begin
+            taken = !lt;
+        end
+        else if (inst.BLTU) begin
+            taken = ltu;
+        end
+        else if (inst.BGEU) begin
+            taken = !ltu;
+        end
+        else begin
+            taken = 1'b0;
+        end
+
+        if (inst.JAL | taken) begin
+            target = pc + imm;
+        end
+        else begin
+            target = pc + (inst.COMPRESSED ? 32'h2 : 32'h4);
+        end
+    end
+endmodule : rip_branch_unit
+
+`default_nettype wire
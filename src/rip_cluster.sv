@@ -0,0 +1,185 @@
+`default_nettype none
+`timescale 1ns / 1ps
+
+// Module: rip_cluster
+// Description: NUM_CORES independent rip_core instances sharing one AXI master
+//              through rip_axi_interconnect. Each core has its own control,
+//              CMA partition (mem_head/ret_head), interrupt and mailbox ports;
+//              port i of every array belongs to core i.
+//              Verilator builds need RIP_AXI_MEMORY so that the cores use the
+//              AXI path instead of the DPI memory stub.
+module rip_cluster #(
+    parameter int NUM_CORES = 4,
+    parameter int REG_ADDR_WIDTH = 5,
+    parameter int CSR_ADDR_WIDTH = 12,
+    parameter int DATA_WIDTH = 32,
+    parameter int AXI_ID_WIDTH = 4, // per core
+    parameter int AXI_ADDR_WIDTH = 32,
+    parameter int AXI_DATA_WIDTH = 32,
+    // the interconnect prepends the core index to the ID
+    localparam int M_AXI_ID_WIDTH = AXI_ID_WIDTH + (NUM_CORES > 1 ? $clog2(NUM_CORES) : 1)
+) (
+    input wire sys_rst_n,
+    input wire clk,
+    input wire [NUM_CORES-1:0] run,
+    output wire [NUM_CORES-1:0] busy,
+    input wire [NUM_CORES-1:0][AXI_ADDR_WIDTH-1:0] mem_head,
+    input wire [NUM_CORES-1:0][AXI_ADDR_WIDTH-1:0] ret_head,
+    // AXI QoS of each core; higher wins, equal ones are served round-robin
+    input wire [NUM_CORES-1:0][3:0] qos,
+    input wire [NUM_CORES-1:0] irq_external,
+    input wire [NUM_CORES-1:0][DATA_WIDTH-1:0] mbox_cmd_tail,
+    input wire [NUM_CORES-1:0][DATA_WIDTH-1:0] mbox_res_head,
+    output wire [NUM_CORES-1:0][DATA_WIDTH-1:0] mbox_cmd_head,
+    output wire [NUM_CORES-1:0][DATA_WIDTH-1:0] mbox_res_tail,
+    // Write address channel signals
+    output wire [M_AXI_ID_WIDTH-1:0] AWID,
+    output wire [AXI_ADDR_WIDTH-1:0] AWADDR,
+    output wire [7:0] AWLEN,
+    output wire [2:0] AWSIZE,
+    output wire [1:0] AWBURST,
+    output wire AWLOCK,
+    output wire [3:0] AWCACHE,
+    output wire [2:0] AWPROT,
+    output wire [3:0] AWQOS,
+    output wire [3:0] AWREGION,
+    output wire AWVALID,
+    input wire AWREADY,
+    // Write data channel signals
+    output wire [M_AXI_ID_WIDTH-1:0] WID, // for debug
+    output wire [AXI_DATA_WIDTH-1:0] WDATA,
+    output wire [AXI_DATA_WIDTH/8-1:0] WSTRB,
+    output wire WLAST,
+    output wire WVALID,
+    input wire WREADY,
+    // Write response channel signals
+    input wire [M_AXI_ID_WIDTH-1:0] BID,
+    input wire [1:0] BRESP,
+    input wire BVALID,
+    output wire BREADY,
+    // Read address channel signals
+    output wire [M_AXI_ID_WIDTH-1:0] ARID,
+    output wire [AXI_ADDR_WIDTH-1:0] ARADDR,
+    output wire [7:0] ARLEN,
+    output wire [2:0] ARSIZE,
+    output wire [1:0] ARBURST,
+    output wire ARLOCK,
+    output wire [3:0] ARCACHE,
+    output wire [2:0] ARPROT,
+    output wire [3:0] ARQOS,
+    output wire [3:0] ARREGION,
+    output wire ARVALID,
+    input wire ARREADY,
+    // Read data channel signals
+    input wire [M_AXI_ID_WIDTH-1:0] RID,
+    input wire [AXI_DATA_WIDTH-1:0] RDATA,
+    input wire [1:0] RRESP,
+    input wire RLAST,
+    input wire RVALID,
+    output wire RREADY
+);
+
+    rip_axi_interface #(
+        .ID_WIDTH(AXI_ID_WIDTH),
+        .ADDR_WIDTH(AXI_ADDR_WIDTH),
+        .DATA_WIDTH(AXI_DATA_WIDTH)
+    ) core_axi[NUM_CORES] ();
+
+    rip_axi_interface #(
+        .ID_WIDTH(M_AXI_ID_WIDTH),
+        .ADDR_WIDTH(AXI_ADDR_WIDTH),
+        .DATA_WIDTH(AXI_DATA_WIDTH)
+    ) axi_if ();
+
+    generate
+        for (genvar i = 0; i < NUM_CORES; i++) begin : gen_core
+            rip_core #(
+                .REG_ADDR_WIDTH(REG_ADDR_WIDTH),
+                .CSR_ADDR_WIDTH(CSR_ADDR_WIDTH),
+                .DATA_WIDTH(DATA_WIDTH),
+                .AXI_ID_WIDTH(AXI_ID_WIDTH),
+                .AXI_ADDR_WIDTH(AXI_ADDR_WIDTH),
+                .AXI_DATA_WIDTH(AXI_DATA_WIDTH)
+            ) rip (
+                .sys_rst_n(sys_rst_n),
+                .clk(clk),
+                .run(run[i]),
+                .busy(busy[i]),
+                .mem_head(mem_head[i]),
+                .ret_head(ret_head[i]),
+                .irq_external(irq_external[i]),
+                .mbox_cmd_tail(mbox_cmd_tail[i]),
+                .mbox_res_head(mbox_res_head[i]),
+                .mbox_cmd_head(mbox_cmd_head[i]),
+                .mbox_res_tail(mbox_res_tail[i]),
+`ifdef VERILATOR
+                .dbg_csr_num('0),
+                .dbg_csr_rdata(),
+                .dbg_bp_clear(1'b0),
+                .riscv_tests_passed(),
+`endif  // VERILATOR
+                // the interconnect shares the cores' clock
+                .axi_clk(clk),
+                .axi_rst_n(sys_rst_n),
+                .M_AXI(core_axi[i])
+            );
+        end
+    endgenerate
+
+    rip_axi_interconnect #(
+        .NUM_PORTS(NUM_CORES),
+        .ID_WIDTH(AXI_ID_WIDTH),
+        .ADDR_WIDTH(AXI_ADDR_WIDTH),
+        .DATA_WIDTH(AXI_DATA_WIDTH)
+    ) interconnect (
+        .clk(clk),
+        .rstn(sys_rst_n),
+        .qos(qos),
+        .S_AXI(core_axi),
+        .M_AXI(axi_if)
+    );
+
+    assign AWID = axi_if.AWID;
+    assign AWADDR = axi_if.AWADDR;
+    assign AWLEN = axi_if.AWLEN;
+    assign AWSIZE = axi_if.AWSIZE;
+    assign AWBURST = axi_if.AWBURST;
+    assign AWLOCK = axi_if.AWLOCK;
+    assign AWCACHE = axi_if.AWCACHE;
+    assign AWPROT = axi_if.AWPROT;
+    assign AWQOS = axi_if.AWQOS;
+    assign AWREGION = axi_if.AWREGION;
+    assign AWVALID = axi_if.AWVALID;
+    assign axi_if.AWREADY = AWREADY;
+    assign WID = axi_if.WID;
+    assign WDATA = axi_if.WDATA;
+    assign WSTRB = axi_if.WSTRB;
+    assign WLAST = axi_if.WLAST;
+    assign WVALID = axi_if.WVALID;
+    assign axi_if.WREADY = WREADY;
+    assign axi_if.BID = BID;
+    assign axi_if.BRESP = BRESP;
+    assign axi_if.BVALID = BVALID;
+    assign BREADY = axi_if.BREADY;
+    assign ARID = axi_if.ARID;
+    assign ARADDR = axi_if.ARADDR;
+    assign ARLEN = axi_if.ARLEN;
+    assign ARSIZE = axi_if.ARSIZE;
+    assign ARBURST = axi_if.ARBURST;
+    assign ARLOCK = axi_if.ARLOCK;
+    assign ARCACHE = axi_if.ARCACHE;
+    assign ARPROT = axi_if.ARPROT;
+    assign ARQOS = axi_if.ARQOS;
+    assign ARREGION = axi_if.ARREGION;
+    assign ARVALID = axi_if.ARVALID;
+    assign axi_if.ARREADY = ARREADY;
+    assign axi_if.RID = RID;
+    assign axi_if.RDATA = RDATA;
+    assign axi_if.RRESP = RRESP;
+    assign axi_if.RLAST = RLAST;
+    assign axi_if.RVALID = RVALID;
+    assign RREADY = axi_if.RREADY;
+
+endmodule: rip_cluster
+
+`default_nettype wire
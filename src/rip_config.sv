@@ -8,24 +8,73 @@ package rip_config;
 
     localparam bit [31:0] SP_ADDR = 32'h1 << 25;
 
+    localparam bit [11:0] MSTATUS = 12'h300;
+    localparam bit [11:0] MIE = 12'h304;
     localparam bit [11:0] MTVEC = 12'h305;
     localparam bit [11:0] MEPC = 12'h341;
     localparam bit [11:0] MCAUSE = 12'h342;
+    localparam bit [11:0] MIP = 12'h344;
     localparam bit [11:0] CYCLE = 12'hC00;
+    localparam bit [11:0] TIME = 12'hC01;
+    localparam bit [11:0] TIMEH = 12'hC81;
+    // mtimecmp is a CSR rather than memory mapped (custom machine read/write range)
+    localparam bit [11:0] MTIMECMP = 12'h7C0;
+    localparam bit [11:0] MTIMECMPH = 12'h7C1;
+    // mailbox ring indices written by the core
+    localparam bit [11:0] MBOX_CMD_HEAD = 12'h7C2;
+    localparam bit [11:0] MBOX_RES_TAIL = 12'h7C3;
+    // branch predictor table and history access, see README
+    localparam bit [11:0] BPIDX = 12'h7C4;
+    localparam bit [11:0] BPDAT = 12'h7C5;
+    localparam bit [11:0] BPHIST = 12'h7C6;
     localparam bit [11:0] BPTP = 12'hFC0;
     localparam bit [11:0] BPTN = 12'hFC1;
     localparam bit [11:0] BPFP = 12'hFC2;
     localparam bit [11:0] BPFN = 12'hFC3;
+    // mailbox doorbells written by the host (read only)
+    localparam bit [11:0] MBOX_CMD_TAIL = 12'hFC4;
+    localparam bit [11:0] MBOX_RES_HEAD = 12'hFC5;
+    // hazard unit counters (read only)
+    localparam bit [11:0] HZST = 12'hFC6;
+    localparam bit [11:0] HZAV = 12'hFC7;
+    // cycles from a branch misprediction until its target reaches DE (read only)
+    localparam bit [11:0] BPMC = 12'hFC8;
 
     localparam int CAUSE_ILLEGAL_INST = 2;
     localparam int CAUSE_ECALL = 11;
 
+    // interrupts: mcause = CAUSE_INTERRUPT | code, and mie/mip bit = code
+    localparam bit [31:0] CAUSE_INTERRUPT = 32'h80000000;
+    localparam int IRQ_M_TIMER = 7;
+    localparam int IRQ_M_EXT = 11;
+    localparam int IRQ_MBOX = 16;  // platform defined: the command ring is not empty
+
+    // writable bits
+    localparam int MSTATUS_MIE = 3;
+    localparam int MSTATUS_MPIE = 7;
+    localparam bit [31:0] MSTATUS_MASK = (32'h1 << MSTATUS_MIE) | (32'h1 << MSTATUS_MPIE);
+    localparam bit [31:0] MIE_MASK =
+        (32'h1 << IRQ_M_TIMER) | (32'h1 << IRQ_M_EXT) | (32'h1 << IRQ_MBOX);
+    // mtvec[1:0]: 0 = direct, 1 = vectored (interrupts jump to base + 4 * code)
+    localparam bit [31:0] MTVEC_MASK = 32'hFFFFFFFD;
+    // bpidx: [15:0] table entry, [23:16] word of the entry, [30] freeze,
+    // [31] bpdat holds the word (read only)
+    localparam int BPIDX_FREEZE = 30;
+    localparam int BPIDX_VALID = 31;
+    localparam bit [31:0] BPIDX_MASK = 32'h40FFFFFF;
+
     /*
     branch predictor configurations
     */
 
-    /* define one of below models */
+    /* define one of below models (synth/ passes its own with -D) */
+    `ifndef GSHARE
+    `ifndef PERCEPTRON
+    `ifndef PERCEPTRON_RO
     `define BIMODAL
+    `endif  // PERCEPTRON_RO
+    `endif  // PERCEPTRON
+    `endif  // GSHARE
     // `define GSHARE
     // `define PERCEPTRON
     // `define PERCEPTRON_RO
@@ -37,8 +86,87 @@ package rip_config;
     /// ignored for BIMODAL and GSHARE
     localparam int BP_HISTORY_LEN = 10;
 
-    /// PERCEPTRON_RO ring oscillator configurations
+    /// GSHARE and the perceptrons: 1 = a branch shifts its prediction into the
+    /// global history when it leaves IF, and a flush repairs it; 0 = only
+    /// resolved outcomes enter the history (define BP_RESOLVED_HISTORY)
+    `ifdef BP_RESOLVED_HISTORY
+    localparam bit BP_SPECULATIVE_HISTORY = 1'b0;
+    `else
+    localparam bit BP_SPECULATIVE_HISTORY = 1'b1;
+    `endif
+
+    /// PERCEPTRON_RO ring oscillator feature bank: BP_RO_NUM monitors, each with
+    /// its own ring size (odd, >= 3) and sample period in cycles
     localparam int BP_RO_NUM = 1;
+    localparam int BP_RO_SIZE [BP_RO_NUM] = '{3};
+    localparam int BP_RO_SAMPLE_CYCLE [BP_RO_NUM] = '{100};
+
+    /// what a monitor feeds the perceptron from the edges counted in a sample:
+    /// RO_SDELTA: the count grew since the previous sample (one input)
+    /// RO_DELTA_SIGN: the count is above its running mean (one input)
+    /// RO_QUANT: thermometer code of the count around its running mean,
+    ///   BP_RO_QUANT_BITS inputs with thresholds BP_RO_QUANT_STEP edges apart
+    typedef enum int {
+        RO_SDELTA,
+        RO_DELTA_SIGN,
+        RO_QUANT
+    } ro_feature_t;
+    localparam ro_feature_t BP_RO_FEATURE = RO_SDELTA;
+    localparam int BP_RO_QUANT_BITS = 3;
+    localparam int BP_RO_QUANT_STEP = 4;
+
+    /// Verilator ring oscillator model (src/stub/rip_ring_oscillator_stub.sv):
+    /// seed of its jitter, overridden at run time by +bp_ro_seed=<n>
+    localparam int BP_RO_SEED = 1;
+
+    /// PERCEPTRON and PERCEPTRON_RO: register stages in the adder tree that sums
+    /// the weights (0 = the sum settles in the cycle after the lookup). A fetch
+    /// takes at least three cycles, so one stage costs nothing; more would make
+    /// the prediction arrive after its branch has been decoded, and are an
+    /// elaboration error unless BP_AHEAD_INDEX is set (define BP_TREE_STAGES=<n>)
+    `ifdef BP_TREE_STAGES
+    localparam int BP_PIPELINE_DEPTH = `BP_TREE_STAGES;
+    `else
+    localparam int BP_PIPELINE_DEPTH = 0;
+    `endif
+
+    /// PERCEPTRON and PERCEPTRON_RO: predict each fetch with the weights looked
+    /// up for the fetch before it, so the sum overlaps the gap between fetches
+    /// and up to three stages are hidden; more are an elaboration error (define
+    /// BP_AHEAD)
+    `ifdef BP_AHEAD
+    localparam bit BP_AHEAD_INDEX = 1'b1;
+    `else
+    localparam bit BP_AHEAD_INDEX = 1'b0;
+    `endif
+
+    /// where a mispredicted branch or a JAL redirects the fetch: 1 = in DE, from
+    /// `rip_branch_unit` in the cycle it resolves; 0 = from MA one cycle later,
+    /// which keeps the comparator off the fetch address path (define
+    /// BP_RESOLVE_IN_MA)
+    `ifdef BP_RESOLVE_IN_MA
+    localparam bit BP_RESOLVE_IN_DE = 1'b0;
+    `else
+    localparam bit BP_RESOLVE_IN_DE = 1'b1;
+    `endif
+
+    /*
+    memory system configurations
+    */
+
+    /// bytes per instruction fetch line (a power of two; 4 reads single words)
+    localparam int MMU_LINE_SIZE = 32;
+    /// the AXI slave accepts WRAP bursts, so line reads start at the requested word
+    localparam bit MMU_WRAP_BURST = 1'b1;
+
+    /*
+    reservoir coprocessor configurations
+    */
+
+    /// state scratchpad depth (reservoir units and input slots)
+    localparam int RC_STATE_ADDR_WIDTH = 10;
+    /// weight scratchpad depth (nonzero entries of the reservoir and readout rows)
+    localparam int RC_WEIGHT_ADDR_WIDTH = 12;
 
 endpackage : rip_config
 
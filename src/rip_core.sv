@@ -1,6 +1,12 @@
 `default_nettype none
 `timescale 1ns / 1ps
 
+`ifdef VERILATOR
+`ifndef RIP_AXI_MEMORY
+`define RIP_MMU_STUB
+`endif  // RIP_AXI_MEMORY
+`endif  // VERILATOR
+
 module rip_core
     import rip_type::*;
     import rip_const::*;
@@ -12,7 +18,8 @@ module rip_core
     parameter int DATA_WIDTH = 32,
     parameter int AXI_ID_WIDTH = 4,
     parameter int AXI_ADDR_WIDTH = 32,
-    parameter int AXI_DATA_WIDTH = 32
+    parameter int AXI_DATA_WIDTH = 32,
+    parameter bit AXI_ASYNC = 1'b0 // M_AXI on axi_clk (see rip_axi_master_async)
 ) (
     input wire sys_rst_n,
     input wire clk,
@@ -23,10 +30,31 @@ module rip_core
     // CMA region start addresses
     input wire [AXI_ADDR_WIDTH-1:0] mem_head, // program data
     input wire [AXI_ADDR_WIDTH-1:0] ret_head, // return data
+    // machine external interrupt (level, cleared by the source)
+    input wire irq_external,
+    // mailbox doorbells: ring indices, each written by one side only
+    input wire [DATA_WIDTH-1:0] mbox_cmd_tail,
+    input wire [DATA_WIDTH-1:0] mbox_res_head,
+    output logic [DATA_WIDTH-1:0] mbox_cmd_head,
+    output logic [DATA_WIDTH-1:0] mbox_res_tail,
 
 `ifdef VERILATOR
+    // testbench read port of the CSRs, e.g. the counters of a finished run
+    input wire [CSR_ADDR_WIDTH-1:0] dbg_csr_num,
+    output wire [DATA_WIDTH-1:0] dbg_csr_rdata,
+    // clears the branch predictor table while the core is idle (rip_branch_predictor)
+    input wire dbg_bp_clear,
     output wire [DATA_WIDTH-1:0] riscv_tests_passed
+`ifdef RIP_AXI_MEMORY
+    ,
+    // the AXI clock domain; unused unless AXI_ASYNC
+    input wire axi_clk,
+    input wire axi_rst_n,
+    rip_axi_interface.master M_AXI
+`endif  // RIP_AXI_MEMORY
 `else
+    input wire axi_clk,
+    input wire axi_rst_n,
     rip_axi_interface.master M_AXI
 `endif  // VERILATOR
 );
@@ -88,23 +116,44 @@ module rip_core
     logic [DATA_WIDTH-1:0] pc_if_taken;
     logic [DATA_WIDTH-1:0] pc_with_pred;
     logic [DATA_WIDTH-1:0] pc_next_for_pred;
+    logic pc_buf_fetch;  // IF kept waiting for a redirect fetches the buffered target
+
+    assign pc_buf_fetch = BP_RESOLVE_IN_DE & pc_next_buf_valid & if_state.READY;
 
     always_comb begin
         pc_pred_taken = de_state.READY & if_b_type & if_pred;
         pc_if_taken = if_pc + if_imm;
-        pc_with_pred = pc_pred_taken ? pc_if_taken : pc;
+        // pc was advanced by 4 when the instruction in IF was requested
+        if (de_redirect) begin
+            pc_with_pred = de_target;
+        end
+        else if (pc_buf_fetch) begin
+            pc_with_pred = pc_next_buf;
+        end
+        else if (pc_pred_taken) begin
+            pc_with_pred = pc_if_taken;
+        end
+        else if (de_state.READY & if_compressed) begin
+            pc_with_pred = if_pc + 32'h2;
+        end
+        else begin
+            pc_with_pred = pc;
+        end
 
         if (pc_state_reg.INVALID) begin
             pc_state = 3'b100;
         end
-        else if (busy_1 | busy_2) begin
+        else if (front_busy) begin
             pc_state = 3'b010;
         end
         else begin
             pc_state = pc_state_reg;
         end
 
-        if (ma_state.READY & ex_inst.UPDATE_PC) begin
+        if (ma_state.READY & ex_irq) begin
+            pc_next = irq_vector;
+        end
+        else if (ma_state.READY & ex_inst.UPDATE_PC & ex_jmp) begin
             if (ex_inst.JALR) begin
                 pc_next = (ex_rs1 + ex_imm) & 32'hFFFFFFFE;
             end
@@ -114,20 +163,20 @@ module rip_core
                 pc_next = ex_pc + ex_imm;
             end
             else if (ex_inst.ECALL) begin
-                pc_next = csr.mtvec;
+                pc_next = trap_base;
             end
             else if (ex_inst.MRET) begin
-                pc_next = csr.mepc;
+                pc_next = mepc_fwd;
             end
             else begin
-                pc_next = ex_pc + 32'h4;
+                pc_next = ex_pc + (ex_inst.COMPRESSED ? 32'h2 : 32'h4);
             end
         end
         else begin
             pc_next = pc_with_pred + 32'h4;
         end
 
-        if (pc_state.READY & pc_next_buf_valid) begin
+        if (pc_state.READY & pc_next_buf_valid & !de_redirect & !pc_buf_fetch) begin
             pc_next_for_pred = pc_next_buf;
         end
         else begin
@@ -141,7 +190,7 @@ module rip_core
             pc       <= -32'h4;
         end
         else begin
-            if (ex_stall_by_load) begin
+            if (ex_stall_by_hazard) begin
                 pc_state_reg <= 3'b010;
             end
             else begin
@@ -155,48 +204,17 @@ module rip_core
                 pc <= pc_next_for_pred;
             end
 
-            if (pc_state.STALL & !if_state.STALL & !pc_next_buf_valid) begin
+            // a redirect waiting in EX behind a busy MA is taken when MA is ready
+            if (pc_state.STALL & !if_state.STALL & !pc_next_buf_valid &
+                !(ma_state.STALL & (ex_jmp | ex_irq))) begin
                 pc_next_buf <= pc_next;
                 pc_next_buf_valid <= 1'b1;
             end
-        end
-    end
-
-    // 3 signals below are latched by pc_state.READY delayed by 1 cycle
-    bp_index_t pc_pred_index;
-    bp_weight_t pc_pred_weight;
-    logic pc_pred;
-
-    logic pc_ready_buf;
-    bp_index_t pc_pred_index_buf;
-    bp_weight_t pc_pred_weight_buf;
-    logic pc_pred_buf;
-
-    `ifdef VERILATOR
-        logic [HISTORY_LEN-1:0] pc_global_histroy;
-        logic [HISTORY_LEN-1:0] pc_global_histroy_buf;
-        assign pc_global_histroy = pc_ready_buf ? global_histroy : pc_global_histroy_buf;
-    `endif
-
-    assign pc_pred_index = pc_ready_buf ? pred_index : pc_pred_index_buf;
-    assign pc_pred_weight = pc_ready_buf ? pred_weight : pc_pred_weight_buf;
-    assign pc_pred = pc_ready_buf ? pred : pc_pred_buf;
-
-    always_ff @(posedge clk) begin
-        if (!rst_n) begin
-            pc_ready_buf <= 1'b0;
-        end
-        else begin
-            pc_ready_buf <= pc_state.READY;
-        end
-
-        if (pc_ready_buf) begin
-            pc_pred_index_buf <= pred_index;
-            pc_pred_weight_buf <= pred_weight;
-            pc_pred_buf <= pred;
-            `ifdef VERILATOR
-                pc_global_histroy_buf <= global_histroy;
-            `endif
+            // IF is busy or empty: its next fetch goes to the target
+            if (de_redirect & !if_state.READY) begin
+                pc_next_buf <= de_target;
+                pc_next_buf_valid <= 1'b1;
+            end
         end
     end
 
@@ -210,30 +228,39 @@ module rip_core
 
     wire [REG_ADDR_WIDTH-1:0] if_rs1_num;
     wire [REG_ADDR_WIDTH-1:0] if_rs2_num;
+    wire [REG_ADDR_WIDTH-1:0] if_rs3_num;
     wire [REG_ADDR_WIDTH-1:0] if_rd_num;
+    wire if_rs1_used;
+    wire if_rs2_used;
+    wire if_rs3_used;
+    wire if_rs2_store;
     wire [CSR_ADDR_WIDTH-1:0] if_csr_num;
 
     wire [DATA_WIDTH-1:0] if_dout;
+    wire if_compressed;
 
     wire if_b_type;
     wire [DATA_WIDTH-1:0] if_imm;
     bp_index_t if_pred_index;
     bp_weight_t if_pred_weight;
     logic if_pred;
-    logic if_pred_taken;
+    logic [PRED_LATENCY-1:0] if_ready_buf;
 
     `ifdef VERILATOR
         logic [HISTORY_LEN-1:0] if_global_histroy;
     `endif
 
-    // assign if_inst_code = (de_state.READY & !ex_state.STALL) ? if_dout : 32'h0;
-    assign if_inst_code = if_dout;
+    rip_rvc_expander rvc_expander (
+        .fetch_code(if_dout),
+        .compressed(if_compressed),
+        .inst_code(if_inst_code)
+    );
 
     always_comb begin
         if (if_state_reg.INVALID) begin
             if_state = 3'b100;
         end
-        else if (busy_1 | busy_2) begin
+        else if (front_busy) begin
             if_state = 3'b010;
         end
         else begin
@@ -247,10 +274,12 @@ module rip_core
             if_pc    <= 32'h0;
         end
         else begin
-            if ((!pc_state.READY & !if_state.STALL) | ex_flush_by_jmp) begin
+            // a fetch in flight survives a redirect from DE, which then fetches the target
+            if ((!pc_state.READY & !if_state.STALL) |
+                (ex_flush_by_jmp & !(de_redirect & !if_state.INVALID))) begin
                 if_state_reg <= 3'b100;
             end
-            else if (ex_stall_by_load) begin
+            else if (ex_stall_by_hazard) begin
                 if_state_reg <= 3'b010;
             end
             else begin
@@ -259,20 +288,32 @@ module rip_core
 
             if (if_state.READY) begin
                 if_pc <= pc_with_pred;
-                if_pred_index <= pc_pred_index;
-                if_pred_weight <= pc_pred_weight;
-                if_pred <= pc_pred;
-                if_pred_taken <= pc_pred_taken;
-                `ifdef VERILATOR
-                    if_global_histroy <= pc_global_histroy;
-                `endif
             end
-            else if (!de_state.STALL) begin
+            else if (!if_state.STALL & !de_state.STALL) begin
                 if_pc <= 32'h0;
             end
         end
     end
 
+    // the predictor looks up the fetched pc and answers PRED_LATENCY cycles later
+    always_ff @(posedge clk) begin
+        if (!rst_n) begin
+            if_ready_buf <= '0;
+        end
+        else begin
+            if_ready_buf <= PRED_LATENCY'({if_ready_buf, if_state.READY});
+        end
+
+        if (if_ready_buf[PRED_LATENCY-1]) begin
+            if_pred_index <= pred_index;
+            if_pred_weight <= pred_weight;
+            if_pred <= pred;
+            `ifdef VERILATOR
+                if_global_histroy <= global_histroy;
+            `endif
+        end
+    end
+
     /* -------------------------------- *
      * Stage 2: DE (decode)             *
      * -------------------------------- */
@@ -283,13 +324,16 @@ module rip_core
 
     logic [REG_ADDR_WIDTH-1:0] de_rs1_num;
     logic [REG_ADDR_WIDTH-1:0] de_rs2_num;
+    logic [REG_ADDR_WIDTH-1:0] de_rs3_num;
     logic [REG_ADDR_WIDTH-1:0] de_rd_num;
     logic [CSR_ADDR_WIDTH-1:0] de_csr_num;
 
     wire [DATA_WIDTH-1:0] de_rs1_reg;
     wire [DATA_WIDTH-1:0] de_rs2_reg;
+    wire [DATA_WIDTH-1:0] de_rs3_reg;
     logic [DATA_WIDTH-1:0] de_rs1;
     logic [DATA_WIDTH-1:0] de_rs2;
+    logic [DATA_WIDTH-1:0] de_rs3;
     wire [DATA_WIDTH-1:0] de_imm;
     wire [REG_ADDR_WIDTH-1:0] de_csr_zimm;
     logic [DATA_WIDTH-1:0] de_csr_reg;
@@ -300,7 +344,6 @@ module rip_core
     bp_weight_t de_pred_weight;
     logic de_pred;
     logic branch_result;
-    logic de_pred_taken;
 
     `ifdef VERILATOR
         logic [HISTORY_LEN-1:0] de_global_histroy;
@@ -313,17 +356,24 @@ module rip_core
         .ex_stall(de_state.STALL),
 
         .inst_code(if_inst_code),
+        .compressed(if_compressed),
 
         .if_b_type(if_b_type),
         .if_imm(if_imm),
 
         .if_rs1_num(if_rs1_num),
         .if_rs2_num(if_rs2_num),
+        .if_rs3_num(if_rs3_num),
         .if_rd_num (if_rd_num),
+        .if_rs1_used(if_rs1_used),
+        .if_rs2_used(if_rs2_used),
+        .if_rs3_used(if_rs3_used),
+        .if_rs2_store(if_rs2_store),
         .if_csr_num(if_csr_num),
 
         .de_rs1_num(de_rs1_num),
         .de_rs2_num(de_rs2_num),
+        .de_rs3_num(de_rs3_num),
         .de_rd_num (de_rd_num),
         .de_csr_num(de_csr_num),
 
@@ -334,44 +384,52 @@ module rip_core
         .inst(de_inst)
     );
 
-    // forwarding register
-    always_comb begin
-        if (ma_state.READY && !ex_inst.ACCESS_MEM && !ex_inst.UPDATE_CSR && ex_rd_num != 5'h0 &&
-            de_rs1_num == ex_rd_num) begin
-            de_rs1 = ex_alu_rslt;
-        end
-        else if (wb_state.READY && !ma_inst.UPDATE_CSR && ma_rd_num != 5'h0 &&
-                 de_rs1_num == ma_rd_num) begin
-            de_rs1 = ma_wdata;
-        end
-        else if (after_wb_state.READY && !wb_inst.UPDATE_CSR && wb_rd_num != 5'h0 &&
-                 de_rs1_num == wb_rd_num) begin
-            de_rs1 = wb_wdata;
-        end
-        else begin
-            de_rs1 = de_rs1_reg;
-        end
+    // forwarding register: the select is registered in the cycle before
+    rip_forwarding_unit #(
+        .REG_ADDR_WIDTH(REG_ADDR_WIDTH),
+        .DATA_WIDTH(DATA_WIDTH)
+    ) forwarding_unit (
+        .rst_n(rst_n),
+        .clk(clk),
 
-        if (ma_state.READY && !ex_inst.ACCESS_MEM && !ex_inst.UPDATE_CSR && ex_rd_num != 5'h0 &&
-            de_rs2_num == ex_rd_num) begin
-            de_rs2 = ex_alu_rslt;
-        end
-        else if (wb_state.READY && !ma_inst.UPDATE_CSR && ma_rd_num != 5'h0 &&
-                 de_rs2_num == ma_rd_num) begin
-            de_rs2 = ma_wdata;
-        end
-        else if (after_wb_state.READY && !wb_inst.UPDATE_CSR && wb_rd_num != 5'h0 &&
-                 de_rs2_num == wb_rd_num) begin
-            de_rs2 = wb_wdata;
-        end
-        else begin
-            de_rs2 = de_rs2_reg;
-        end
-    end
+        .de_load(de_state.READY),
+        .de_hold(de_state.STALL),
+        .ex_load(ex_state.READY & !irq_take),
+        .ex_hold(ma_state.STALL),
+        .ma_load(ma_state.READY),
+        .ma_hold(wb_state.STALL),
+        .wb_load(wb_state.READY),
+        .wb_hold(after_wb_state.STALL),
+
+        .if_rs_num({if_rs3_num, if_rs2_num, if_rs1_num}),
+        .de_rs_num({de_rs3_num, de_rs2_num, de_rs1_num}),
+        .de_inst(de_inst),
+        .de_rd_num(de_rd_num),
+        .ex_inst(ex_inst),
+        .ex_rd_num(ex_rd_num),
+        .ma_rd_num(ma_rd_num),
+        .wb_rd_num(wb_rd_num),
 
-    // assign de_csr_reg = read_csr(csr, if_csr_num);
-    always_ff @(posedge clk) begin
-        de_csr_reg <= rip_csr::read_csr(csr, if_csr_num);
+        .ex_rslt(ex_alu_rslt),
+        .ma_rslt(ma_wdata),
+        .wb_rslt(wb_wdata),
+        .rf_rs({de_rs3_reg, de_rs2_reg, de_rs1_reg}),
+
+        .rs({de_rs3, de_rs2, de_rs1})
+    );
+
+    // the CSR of the instruction in DE next cycle, including this cycle's write;
+    // older writes still in EX or MA are forwarded below
+    logic [CSR_ADDR_WIDTH-1:0] de_csr_sel;
+    assign de_csr_sel = de_state.READY ? if_csr_num : de_csr_num;
+
+    always_ff @(posedge clk) begin : de_csr_read
+        csr_t csr_written;
+        csr_written = csr;
+        if (ma_csr_wen) begin
+            rip_csr::write_csr(csr_written, ma_csr_num, ma_alu_rslt);
+        end
+        de_csr_reg <= rip_csr::read_csr(csr_written, de_csr_sel);
     end
 
     // forwarding csr register
@@ -379,17 +437,17 @@ module rip_core
         if (de_state_reg.INVALID) begin
             de_state = 3'b100;
         end
-        else if (busy_1 | busy_2) begin
+        else if (front_busy) begin
             de_state = 3'b010;
         end
         else begin
             de_state = de_state_reg;
         end
 
-        if (ma_state.READY && ex_inst.UPDATE_CSR && if_csr_num == ex_csr_num) begin
+        if (ma_state.READY && ex_inst.UPDATE_CSR && de_csr_num == ex_csr_num) begin
             de_csr = ex_alu_rslt;
         end
-        else if (wb_state.READY && ma_inst.UPDATE_CSR && if_csr_num == ma_csr_num) begin
+        else if (wb_state.READY && ma_inst.UPDATE_CSR && de_csr_num == ma_csr_num) begin
             de_csr = ma_alu_rslt;
         end
         else begin
@@ -403,10 +461,12 @@ module rip_core
             de_pc      <= 32'h0;
         end
         else begin
-            if ((!if_state.READY & !de_state.STALL) | ex_flush_by_jmp) begin
+            // with a redirect from DE, a target fetched in the same cycle comes next
+            if ((!if_state.READY & !de_state.STALL) |
+                (ex_flush_by_jmp & !(de_redirect & if_state.READY))) begin
                 de_state_reg <= 3'b100;
             end
-            else if (ex_stall_by_load) begin
+            else if (ex_stall_by_hazard) begin
                 de_state_reg <= 3'b010;
             end
             else begin
@@ -419,7 +479,6 @@ module rip_core
                 de_pred_index <= if_pred_index;
                 de_pred_weight <= if_pred_weight;
                 de_pred <= if_pred;
-                de_pred_taken <= if_pred_taken;
 
                 `ifdef VERILATOR
                     de_global_histroy <= if_global_histroy;
@@ -441,29 +500,66 @@ module rip_core
 
     logic branch_correct;
 
+    logic [DATA_WIDTH-1:0] bp_access_rdata;
+    logic bp_access_valid;
+    logic [DATA_WIDTH-1:0] bp_history;
+
     logic [HISTORY_LEN-1:0] global_histroy;
 
-    assign update = ex_state.READY & de_b_type & !de_pred_taken;
+    assign update = ex_state.READY & de_b_type & !irq_take;
     assign update_index = de_pred_index;
     assign update_weight = de_pred_weight;
     assign actual = branch_result;
     assign branch_correct = de_b_type & (actual == de_pred);
+    // the predictor keeps what it learned across runs
     rip_branch_predictor branch_predictor (
         .clk(clk),
-        .rstn(rst_n),
-        .pc(pc_next_for_pred),
+        .rstn(sys_rst_n),
+        .core_rstn(rst_n),
+        .pc(pc_with_pred),
+        .fetch(if_state.READY),
         .pred_index(pred_index),
         .pred_weight(pred_weight),
         .pred(pred),
+        .spec_push(de_state.READY & if_b_type),
+        .spec_taken(if_pred),
+        .repair(ex_flush_by_jmp),
         .update(update),
         .update_index(update_index),
         .update_weight(update_weight),
-        .actual(actual)
+        .actual(actual),
+        .freeze(csr.bpidx[BPIDX_FREEZE]),
+        .access_index(bp_index_t'(csr.bpidx[15:0])),
+        .access_word(csr.bpidx[23:16]),
+        .access_load(ma_csr_wen & ma_csr_num == BPIDX),
+        .access_we(ma_csr_wen & ma_csr_num == BPDAT),
+        .access_wdata(ma_alu_rslt),
+        .access_rdata(bp_access_rdata),
+        .access_valid(bp_access_valid),
+        .history_we(ma_csr_wen & ma_csr_num == BPHIST),
+        .history_wdata(ma_alu_rslt),
+        .history_rdata(bp_history)
         `ifdef VERILATOR
         , .global_histroy_dbg(global_histroy)
+        , .clear(dbg_bp_clear)
         `endif
     );
 
+    // a mispredicted branch's target has not reached DE yet (counted in bpmc)
+    logic bp_penalty;
+
+    always_ff @(posedge clk) begin
+        if (!rst_n) begin
+            bp_penalty <= 1'b0;
+        end
+        else if (update & !branch_correct) begin
+            bp_penalty <= 1'b1;
+        end
+        else if (de_state.READY) begin
+            bp_penalty <= 1'b0;
+        end
+    end
+
     `ifdef VERILATOR
         logic using_same_pc;
         `ifdef PERCEPTRON
@@ -494,10 +590,16 @@ module rip_core
     state_t ex_state, ex_state_reg;
     logic [DATA_WIDTH-1:0] ex_pc;
     inst_t ex_inst;
-    wire ex_stall_by_load;
+    wire ex_stall_by_hazard;
+    wire hazard_avoided;  // a stall the plain register-number compare would have taken
     wire ex_flush_by_jmp;
+    logic ex_irq;  // the instruction was replaced by a taken interrupt
+    logic ex_jmp;  // the instruction flushed IF and DE, so MA redirects the pc
+    wire de_redirect;  // the instruction entering EX redirects the fetch itself
+    wire [DATA_WIDTH-1:0] de_target;
 
     logic [REG_ADDR_WIDTH-1:0] ex_rd_num;
+    logic [REG_ADDR_WIDTH-1:0] ex_rs2_num;
     logic [CSR_ADDR_WIDTH-1:0] ex_csr_num;
 
     logic [DATA_WIDTH-1:0] ex_rs1;
@@ -518,19 +620,55 @@ module rip_core
 
         .rs1 (de_rs1),
         .rs2 (de_rs2),
+        .rs3 (de_rs3),
         .pc  (de_pc),
         .csr (de_csr),
         .imm (de_imm),
         .zimm(de_csr_zimm),
 
-        .branch_result(branch_result),
+        .branch_result(),
         .rslt(ex_alu_rslt)
     );
 
-    assign ex_stall_by_load = ex_state.READY &
-        (de_inst.LB | de_inst.LH | de_inst.LW | de_inst.LBU | de_inst.LHU) & de_state.READY &
-        (de_rd_num == if_rs1_num | de_rd_num == if_rs2_num);
-    assign ex_flush_by_jmp = ex_state.READY & (de_inst.UPDATE_PC & !branch_correct);
+    rip_branch_unit #(
+        .DATA_WIDTH(DATA_WIDTH)
+    ) branch_unit (
+        .inst(de_inst),
+
+        .rs1(de_rs1),
+        .rs2(de_rs2),
+        .pc (de_pc),
+        .imm(de_imm),
+
+        .taken (branch_result),
+        .target(de_target)
+    );
+    // jumps needing EX results (JALR, ECALL, MRET) and interrupts still redirect from MA
+    assign de_redirect = BP_RESOLVE_IN_DE & ex_flush_by_jmp & !irq_take &
+                         (de_b_type | de_inst.JAL);
+
+    rip_hazard_unit #(
+        .REG_ADDR_WIDTH(REG_ADDR_WIDTH)
+    ) hazard_unit (
+        .ex_ready(ex_state.READY),
+        .de_ready(de_state.READY),
+
+        .de_inst(de_inst),
+        .de_rd_num(de_rd_num),
+
+        .if_rs1_num(if_rs1_num),
+        .if_rs2_num(if_rs2_num),
+        .if_rs3_num(if_rs3_num),
+        .if_rs1_used(if_rs1_used),
+        .if_rs2_used(if_rs2_used),
+        .if_rs3_used(if_rs3_used),
+        .if_rs2_store(if_rs2_store),
+
+        .stall(ex_stall_by_hazard),
+        .avoided(hazard_avoided)
+    );
+    // a taken interrupt redirects from MA like a jump
+    assign ex_flush_by_jmp = ex_state.READY & ((de_inst.UPDATE_PC & !branch_correct) | irq_take);
 
     always_comb begin
         if (ex_state_reg.INVALID) begin
@@ -557,21 +695,44 @@ module rip_core
             ex_csr      <= 32'h0;
 
             ex_rd_num   <= 5'h0;
+            ex_rs2_num  <= 5'h0;
             ex_csr_num  <= 12'h0;
+            ex_irq      <= 1'b0;
+            ex_jmp      <= 1'b0;
         end
         else begin
             if ((!de_state.READY && !ex_state.STALL) | ex_flush_by_jmp) begin
                 ex_state_reg <= 3'b100;
             end
-            else if (ex_stall_by_load) begin
+            else if (ex_stall_by_hazard) begin
                 ex_state_reg <= 3'b010;
             end
             else begin
                 ex_state_reg <= 3'b001;
             end
 
-            if (ex_state.READY) begin
+            if (ex_state.READY & irq_take) begin
+                // the instruction is dropped and runs again after MRET
+                ex_inst     <= 0;
+                ex_pc       <= de_pc;
+                ex_irq      <= 1'b1;
+                ex_jmp      <= 1'b0;
+
+                ex_rs1      <= 32'h0;
+                ex_rs2      <= 32'h0;
+                ex_imm      <= 32'h0;
+
+                ex_csr_zimm <= 5'h0;
+                ex_csr      <= 32'h0;
+
+                ex_rd_num   <= 5'h0;
+                ex_rs2_num  <= 5'h0;
+                ex_csr_num  <= 12'h0;
+            end
+            else if (ex_state.READY) begin
                 ex_inst     <= de_inst;
+                ex_irq      <= 1'b0;
+                ex_jmp      <= ex_flush_by_jmp & !de_redirect;
                 ex_pc       <= de_pc;
 
                 ex_rs1      <= de_rs1;
@@ -582,11 +743,14 @@ module rip_core
                 ex_csr      <= de_csr;
 
                 ex_rd_num   <= de_rd_num;
+                ex_rs2_num  <= de_rs2_num;
                 ex_csr_num  <= de_csr_num;
             end
             else if (!ma_state.STALL) begin
                 ex_inst     <= 0;
                 ex_pc       <= 32'h0;
+                ex_irq      <= 1'b0;
+                ex_jmp      <= 1'b0;
 
                 ex_rs1      <= 32'h0;
                 ex_rs2      <= 32'h0;
@@ -596,27 +760,99 @@ module rip_core
                 ex_csr      <= 32'h0;
 
                 ex_rd_num   <= 5'h0;
+                ex_rs2_num  <= 5'h0;
                 ex_csr_num  <= 12'h0;
             end
         end
     end
 
+    /*
+     * Interrupts
+     * A pending interrupt is taken on the instruction entering EX: it is dropped,
+     * mepc gets its pc, the younger stages are flushed and MA redirects to the
+     * trap vector. Waiting for EX to be ready bounds the latency by the longest
+     * memory or coprocessor stall. It also waits while a CSR write is in MA or WB,
+     * as that write may disable interrupts, and during a hazard stall.
+     */
+    logic irq_pending;
+    logic [4:0] irq_code;
+    logic irq_take;
+    logic [DATA_WIDTH-1:0] mtvec_fwd;
+    logic [DATA_WIDTH-1:0] trap_base;
+    logic [DATA_WIDTH-1:0] irq_vector;
+    logic [DATA_WIDTH-1:0] mepc_fwd;
+
+    always_comb begin
+        irq_pending = mode == RUNNING && csr.mstatus[MSTATUS_MIE] && (csr.mie & csr.mip) != 32'h0;
+        // external, then mailbox, then timer
+        if (csr.mie[IRQ_M_EXT] & csr.mip[IRQ_M_EXT]) begin
+            irq_code = 5'(IRQ_M_EXT);
+        end
+        else if (csr.mie[IRQ_MBOX] & csr.mip[IRQ_MBOX]) begin
+            irq_code = 5'(IRQ_MBOX);
+        end
+        else begin
+            irq_code = 5'(IRQ_M_TIMER);
+        end
+        irq_take = ex_state.READY & irq_pending & !ex_stall_by_hazard &
+                   !ex_inst.UPDATE_CSR & !ma_inst.UPDATE_CSR;
+
+        // MA reads these while an older CSR write may be in WB
+        if (wb_state.READY && ma_inst.UPDATE_CSR && ma_csr_num == MTVEC) begin
+            mtvec_fwd = ma_alu_rslt;
+        end
+        else begin
+            mtvec_fwd = csr.mtvec;
+        end
+        trap_base = {mtvec_fwd[DATA_WIDTH-1:2], 2'b00};
+        if (wb_state.READY && ma_inst.UPDATE_CSR && ma_csr_num == MEPC) begin
+            mepc_fwd = ma_alu_rslt;
+        end
+        else begin
+            mepc_fwd = csr.mepc;
+        end
+
+        // mcause was written when the interrupt was taken in EX; the mode is
+        // that of the mtvec trap_base comes from
+        if (mtvec_fwd[0]) begin
+            irq_vector = trap_base + {csr.mcause[DATA_WIDTH-3:0], 2'b00};
+        end
+        else begin
+            irq_vector = trap_base;
+        end
+    end
+
     // csr
     always_ff @(posedge clk) begin
         if (!rst_n) begin
             csr.mstatus = 32'h0;
+            csr.mie     = 32'h0;
+            csr.mip     = 32'h0;
             csr.mtvec   = 32'h0;
             csr.mepc    = 32'h0;
             csr.mcause  = 32'h0;
             csr.cycle   = 32'h0;
+            csr.mtime   = 64'h0;
+            csr.mtimecmp = 64'hFFFFFFFFFFFFFFFF;
+            csr.mbox_cmd_head = 32'h0;
+            csr.mbox_res_tail = 32'h0;
+            csr.mbox_cmd_tail = 32'h0;
+            csr.mbox_res_head = 32'h0;
+            csr.bpidx   = 32'h0;
+            csr.bpdat   = 32'h0;
+            csr.bphist  = 32'h0;
             csr.bptp    = 32'h0;
             csr.bptn    = 32'h0;
             csr.bpfp    = 32'h0;
             csr.bpfn    = 32'h0;
+            csr.bpmc    = 32'h0;
+            csr.hzst    = 32'h0;
+            csr.hzav    = 32'h0;
         end
         else begin
             if (mode == RUNNING) begin
                 csr.cycle = csr.cycle + 32'h1;
+                csr.mtime = csr.mtime + 64'h1;
             end
 
             if (ex_state.READY && update) begin
@@ -633,25 +869,61 @@ module rip_core
                     csr.bpfn = csr.bpfn + 32'h1;
                 end
             end
+            if (bp_penalty) begin
+                csr.bpmc = csr.bpmc + 32'h1;
+            end
+
+            if (ex_stall_by_hazard) begin
+                csr.hzst = csr.hzst + 32'h1;
+            end
+            if (hazard_avoided) begin
+                csr.hzav = csr.hzav + 32'h1;
+            end
 
             if (ma_csr_wen) begin
                 rip_csr::write_csr(csr, ma_csr_num, ma_alu_rslt);
             end
+            if (irq_take) begin
+                csr.mcause = CAUSE_INTERRUPT | 32'(irq_code);
+                csr.mepc   = de_pc;
+                csr.mstatus[MSTATUS_MPIE] = csr.mstatus[MSTATUS_MIE];
+                csr.mstatus[MSTATUS_MIE]  = 1'b0;
+            end
             // ECALL execution
-            if (ex_state.READY && de_inst.ECALL) begin
+            else if (ex_state.READY && de_inst.ECALL) begin
                 csr.mcause = CAUSE_ECALL;
-                csr.mepc   = ex_pc;
+                csr.mepc   = de_pc;
+                csr.mstatus[MSTATUS_MPIE] = csr.mstatus[MSTATUS_MIE];
+                csr.mstatus[MSTATUS_MIE]  = 1'b0;
+            end
+            else if (ex_state.READY && de_inst.MRET) begin
+                csr.mstatus[MSTATUS_MIE]  = csr.mstatus[MSTATUS_MPIE];
+                csr.mstatus[MSTATUS_MPIE] = 1'b1;
             end
             // illegal instruction: update read-only CSR
             // except [csrr XX, YY] := [csrrs XX, zero, YY]
-            if (ex_state.READY && de_inst.UPDATE_CSR && de_csr_num[11:10] == 2'b11 &&
-                !(de_inst.CSRRS && de_rs1 == 32'h0)) begin
+            else if (ex_state.READY && de_inst.UPDATE_CSR && de_csr_num[11:10] == 2'b11 &&
+                     !(de_inst.CSRRS && de_rs1 == 32'h0)) begin
                 csr.mcause = CAUSE_ILLEGAL_INST;
-                csr.mepc   = ex_pc;
+                csr.mepc   = de_pc;
             end
+
+            csr.mip[IRQ_M_TIMER] = csr.mtime >= csr.mtimecmp;
+            csr.mip[IRQ_M_EXT]   = irq_external;
+
+            csr.mbox_cmd_tail = mbox_cmd_tail;
+            csr.mbox_res_head = mbox_res_head;
+            csr.mip[IRQ_MBOX] = csr.mbox_cmd_tail != csr.mbox_cmd_head;
+
+            csr.bpidx[BPIDX_VALID] = bp_access_valid;
+            csr.bpdat = bp_access_rdata;
+            csr.bphist = bp_history;
         end
     end
 
+    assign mbox_cmd_head = csr.mbox_cmd_head;
+    assign mbox_res_tail = csr.mbox_res_tail;
+
     // core mode
     always_ff @(posedge clk) begin
         if (!sys_rst_n) begin
@@ -661,10 +933,10 @@ module rip_core
             mode = RUNNING;
         end
         else begin
-            if (ex_state.READY && de_inst.EXTX) begin
+            if (ex_state.READY && de_inst.EXTX && !irq_take) begin
                 mode = EXITPROC;
             end
-            else if (ex_state.READY && de_inst.EXT) begin
+            else if (ex_state.READY && de_inst.EXT && !irq_take) begin
                 mode = FINISHED;
             end
         end
@@ -741,41 +1013,94 @@ module rip_core
     wire [DATA_WIDTH-1:0] din_1;
     wire [DATA_WIDTH-1:0] dout_1;
     wire [DATA_WIDTH-1:0] dout_2;
-    wire busy_1;
+    amo_op_t amo_1;
+    wire [NUM_COL-1:0] fetch_we_1;
+    wire busy_1;  // memory access or coprocessor command in MA
     wire busy_2;
+    wire fetch_busy;
+    wire mmu_busy_1;
+    wire rc_busy;
+
+    assign busy_1 = mmu_busy_1 | rc_busy;
+
+    /*
+     * While a plain load waits in MA, PC, IF and DE keep going as long as DE is
+     * empty and EX holds nothing that needs the memory port, a CSR or a redirect.
+     * The load's consumer is then already in DE when the data returns, and takes
+     * it from `ma_wdata` instead of being fetched and decoded after the load.
+     */
+    wire ma_load;
+    wire front_busy;  // busy for PC, IF and DE
+
+    assign ma_load = ma_inst.LB | ma_inst.LH | ma_inst.LW | ma_inst.LBU | ma_inst.LHU;
+    assign front_busy = fetch_busy |
+                        (busy_1 & !(ma_load & ex_state_reg.INVALID & !ex_irq &
+                                    !ex_inst.ACCESS_MEM & !ex_inst.RC & !ex_inst.UPDATE_CSR &
+                                    !ex_inst.UPDATE_PC));
+
+    // store data of a producer that was still in EX when the store read rs2
+    logic [DATA_WIDTH-1:0] ex_din;
+
+    always_comb begin
+        if (wb_state.READY && ma_rd_num != 5'h0 && ex_rs2_num == ma_rd_num) begin
+            ex_din = ma_wdata;
+        end
+        else begin
+            ex_din = ex_rs2;
+        end
+    end
 
     rip_memory_access memory_access (
         .clk(clk),
 
         .we_1(we_1),
         .re_1(re_1),
-        .re_2(re_2),
         .addr_1(addr_1),
-        .addr_2(addr_2),
         .din_1(din_1),
         .dout_1(dout_1),
-        .dout_2(dout_2),
-
-        .if_ready(if_state.READY),
-        .pc(pc_with_pred),
-        .if_dout(if_dout),
+        .amo_1(amo_1),
 
         .ma_ready(ma_state.READY),
         .ex_inst (ex_inst),
         .ma_inst (ma_inst),
         .ex_addr (ex_alu_rslt),
         .ma_addr (ma_alu_rslt),
-        .ex_din  (ex_rs2),
+        .ex_din  (ex_din),
         .ma_dout (ma_ram_dout)
     );
 
+    // AMOs write back the word they read
+    assign fetch_we_1 = we_1 | {NUM_COL{re_1 && amo_1 inside {AMO_SWAP, AMO_ADD, AMO_OR}}};
+
+    rip_fetch_buffer #(
+        .DATA_WIDTH(DATA_WIDTH)
+    ) fetch_buffer (
+        .clk(clk),
+        .rst_n(rst_n),
+
+        .if_ready(if_state.READY),
+        .pc(pc_with_pred),
+        .if_dout(if_dout),
+        .busy(fetch_busy),
+
+        .we_1(fetch_we_1),
+        .addr_1(addr_1),
+
+        .re_2(re_2),
+        .addr_2(addr_2),
+        .dout_2(dout_2),
+        .busy_2(busy_2)
+    );
+
     wire [DATA_WIDTH-1:0] mmu_addr_1;
     wire [DATA_WIDTH-1:0] mmu_addr_2;
 
     assign mmu_addr_1 = addr_1 | (mode == RUNNING ? mem_offset : ret_offset);
     assign mmu_addr_2 = addr_2 | mem_offset;
 
-`ifdef VERILATOR
+    // Verilator builds use the DPI memory stub unless RIP_AXI_MEMORY selects the
+    // AXI path, which a testbench then serves (see rip_cluster)
+`ifdef RIP_MMU_STUB
     rip_mmu_stub mmu_stub (
         .clk(clk),
         .rstn(rst_n),
@@ -788,7 +1113,8 @@ module rip_core
         .din_1(din_1),
         .dout_1(dout_1),
         .dout_2(dout_2),
-        .busy_1(busy_1),
+        .amo_1(amo_1),
+        .busy_1(mmu_busy_1),
         .busy_2(busy_2)
     );
 
@@ -811,11 +1137,18 @@ module rip_core
     rip_memory_management_unit #(
         .ADDR_WIDTH(AXI_ADDR_WIDTH),
         .DATA_WIDTH(DATA_WIDTH),
+        .LINE_SIZE(MMU_LINE_SIZE),
         .AXI_ID_WIDTH(AXI_ID_WIDTH),
-        .AXI_DATA_WIDTH(AXI_DATA_WIDTH)
+        .AXI_DATA_WIDTH(AXI_DATA_WIDTH),
+        .WRAP_BURST(MMU_WRAP_BURST),
+        .AXI_ASYNC(AXI_ASYNC)
     ) memory_management_unit (
         .clk(clk),
         .rstn(rst_n),
+        // the crossing outlives a run, so a line read in flight can drain
+        .cdc_rstn(sys_rst_n),
+        .axi_clk(axi_clk),
+        .axi_rstn(axi_rst_n),
 
         .we_1(we_1),
         .re_1(re_1),
@@ -825,11 +1158,31 @@ module rip_core
         .din_1(din_1),
         .dout_1(dout_1),
         .dout_2(dout_2),
-        .busy_1(busy_1),
+        .amo_1(amo_1),
+        .busy_1(mmu_busy_1),
         .busy_2(busy_2),
         .M_AXI(M_AXI)
     );
-`endif  // VERILATOR
+`endif  // RIP_MMU_STUB
+
+    // reservoir coprocessor: commands issue from MA like loads and stall the pipeline
+    // through busy_1 until the result is ready
+    wire [DATA_WIDTH-1:0] rc_dout;
+
+    rip_reservoir #(
+        .DATA_WIDTH(DATA_WIDTH)
+    ) reservoir (
+        .clk(clk),
+        .rst_n(rst_n),
+
+        .issue(ma_state.READY & ex_inst.RC),
+        .funct7(ex_imm[6:0]),
+        .rs1(ex_rs1),
+        .rs2(ex_rs2),
+
+        .busy(rc_busy),
+        .dout(rc_dout)
+    );
 
     /* -------------------------------- *
      * Stage 5: WB (write back)         *
@@ -858,9 +1211,13 @@ module rip_core
             wb_state = wb_state_reg;
         end
 
-        if (ma_inst.LB | ma_inst.LH | ma_inst.LW | ma_inst.LBU | ma_inst.LHU) begin
+        if (ma_inst.LB | ma_inst.LH | ma_inst.LW | ma_inst.LBU | ma_inst.LHU | ma_inst.LR_W |
+            ma_inst.SC_W | ma_inst.AMOSWAP_W | ma_inst.AMOADD_W | ma_inst.AMOOR_W) begin
             ma_wdata = ma_ram_dout;
         end
+        else if (ma_inst.RC) begin
+            ma_wdata = rc_dout;
+        end
         else if (ma_inst.UPDATE_CSR) begin
             ma_wdata = ma_csr;
         end
@@ -880,9 +1237,14 @@ module rip_core
 
         .if_rs1_num(if_rs1_num),
         .if_rs2_num(if_rs2_num),
+        .if_rs3_num(if_rs3_num),
+        .de_rs1_num(de_rs1_num),
+        .de_rs2_num(de_rs2_num),
+        .de_rs3_num(de_rs3_num),
 
         .rs1(de_rs1_reg),
-        .rs2(de_rs2_reg)
+        .rs2(de_rs2_reg),
+        .rs3(de_rs3_reg)
     );
 
     always_ff @(posedge clk) begin
@@ -949,9 +1311,12 @@ module rip_core
     logic finished;
 
     assign riscv_tests_passed = regfile.regfile[3];
+    // the CSRs clear on the edge after busy falls, so read them before the next tick
+    assign dbg_csr_rdata = rip_csr::read_csr(csr, dbg_csr_num);
 
     initial begin
-        file_handle = $fopen("dump.txt");
+        // +no_dump: skip the trace when many models share one working directory
+        file_handle = $test$plusargs("no_dump") ? 0 : $fopen("dump.txt");
         t           = 0;
     end
 
@@ -985,7 +1350,7 @@ module rip_core
             end
         end
 
-        if (after_wb_state.READY & !finished) begin
+        if (after_wb_state.READY & !finished & file_handle != 0) begin
             $fdisplay(file_handle, "Inst @ %X (%d ps)\n???  := %b(BIN) = %X (HEX LE)", wb_pc, t,
                       wb_inst_code, wb_inst_code);
             $fdisplay(file_handle, "Regs after:");
@@ -1014,8 +1379,8 @@ module rip_core
                 file_handle, "x28( t3 ):= %X, x29( t4 ):= %X, x30( t5 ):= %X, x31( t6 ):= %X, ",
                 regfile.regfile[28], regfile.regfile[29], regfile.regfile[30], regfile.regfile[31]);
             $fdisplay(
-                file_handle, "cycle: %0d, bptp: %0d, bptn: %0d, bpfp: %0d, bpfn: %0d \n",
-                csr.cycle, csr.bptp, csr.bptn, csr.bpfp, csr.bpfn);
+                file_handle, "cycle: %0d, bptp: %0d, bptn: %0d, bpfp: %0d, bpfn: %0d, bpmc: %0d \n",
+                csr.cycle, csr.bptp, csr.bptn, csr.bpfp, csr.bpfn, csr.bpmc);
 
             // $fdisplay(file_handle, "  satp  := %X,  mstatus:= %X,  medeleg:= %X,  mideleg:= %X, ",
             //           32'h0, csr.mstatus, 32'h0, 32'h0);
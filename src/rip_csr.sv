@@ -13,14 +13,31 @@ package rip_csr;
             import rip_type::*;
 
             case (csr_num)
+                MSTATUS: read_csr = csr.mstatus;
+                MIE: read_csr = csr.mie;
+                MIP: read_csr = csr.mip;
                 MTVEC: read_csr = csr.mtvec;
                 MEPC: read_csr = csr.mepc;
                 MCAUSE: read_csr = csr.mcause;
                 CYCLE: read_csr = csr.cycle;
+                TIME: read_csr = csr.mtime[31:0];
+                TIMEH: read_csr = csr.mtime[63:32];
+                MTIMECMP: read_csr = csr.mtimecmp[31:0];
+                MTIMECMPH: read_csr = csr.mtimecmp[63:32];
+                MBOX_CMD_HEAD: read_csr = csr.mbox_cmd_head;
+                MBOX_RES_TAIL: read_csr = csr.mbox_res_tail;
+                MBOX_CMD_TAIL: read_csr = csr.mbox_cmd_tail;
+                MBOX_RES_HEAD: read_csr = csr.mbox_res_head;
+                BPIDX: read_csr = csr.bpidx;
+                BPDAT: read_csr = csr.bpdat;
+                BPHIST: read_csr = csr.bphist;
                 BPTP: read_csr = csr.bptp;
                 BPTN: read_csr = csr.bptn;
                 BPFP: read_csr = csr.bpfp;
                 BPFN: read_csr = csr.bpfn;
+                BPMC: read_csr = csr.bpmc;
+                HZST: read_csr = csr.hzst;
+                HZAV: read_csr = csr.hzav;
                 default: read_csr = 32'b0;
             endcase
         end
@@ -36,9 +53,18 @@ package rip_csr;
             import rip_type::*;
 
             case (csr_num)
-                MTVEC: csr.mtvec = csr_value;
+                MSTATUS: csr.mstatus = csr_value & MSTATUS_MASK;
+                MIE: csr.mie = csr_value & MIE_MASK;
+                MTVEC: csr.mtvec = csr_value & MTVEC_MASK;
                 MEPC: csr.mepc = csr_value;
                 MCAUSE: csr.mcause = csr_value;
+                MTIMECMP: csr.mtimecmp[31:0] = csr_value;
+                MTIMECMPH: csr.mtimecmp[63:32] = csr_value;
+                MBOX_CMD_HEAD: csr.mbox_cmd_head = csr_value;
+                MBOX_RES_TAIL: csr.mbox_res_tail = csr_value;
+                BPIDX: csr.bpidx = csr_value & BPIDX_MASK;
+                BPDAT: csr.bpdat = csr_value;
+                BPHIST: csr.bphist = csr_value;
                 default: ;
             endcase
         end
@@ -13,8 +13,9 @@ module rip_decode
     input wire de_ready,
     input wire ex_stall,
 
-    // instruction code
+    // instruction code (expanded by rip_rvc_expander)
     input wire [31:0] inst_code,
+    input wire compressed,
 
     // for branch prediction
     output logic if_b_type,
@@ -23,9 +24,17 @@ module rip_decode
     // register number
     output wire  [REG_ADDR_WIDTH-1:0] if_rs1_num,
     output wire  [REG_ADDR_WIDTH-1:0] if_rs2_num,
+    output wire  [REG_ADDR_WIDTH-1:0] if_rs3_num,
     output wire  [REG_ADDR_WIDTH-1:0] if_rd_num,
+    // the instruction reads the operand (for hazard detection)
+    output wire                       if_rs1_used,
+    output wire                       if_rs2_used,
+    output wire                       if_rs3_used,
+    // rs2 is store data, needed only when the store reaches MA
+    output wire                       if_rs2_store,
     output logic [REG_ADDR_WIDTH-1:0] de_rs1_num,
     output logic [REG_ADDR_WIDTH-1:0] de_rs2_num,
+    output logic [REG_ADDR_WIDTH-1:0] de_rs3_num,
     output logic [REG_ADDR_WIDTH-1:0] de_rd_num,
 
     // csr number
@@ -45,6 +54,9 @@ module rip_decode
     // instruction type and immediate
     wire r_type, i_type, s_type, b_type, u_type, j_type;
     wire csr_type, csr_i_type;
+    wire rc_type;
+    wire p_type;
+    wire a_type;
 
     assign r_type = inst_code[6:5] == 2'b01 && inst_code[4:2] == 3'b100;
     assign i_type = (inst_code[6:5] == 2'b00 &&
@@ -58,6 +70,12 @@ module rip_decode
     // The following two types are classified as I-type but are treated as two different types for convenience.
     assign csr_type = inst_code[6:5] == 2'b11 && inst_code[4:2] == 3'b100 && !inst_code[14];
     assign csr_i_type = inst_code[6:5] == 2'b11 && inst_code[4:2] == 3'b100 && inst_code[14];
+    // R-type on custom-1; funct7 is passed on as the immediate to select the coprocessor command
+    assign rc_type = inst_code[6:5] == 2'b01 && inst_code[4:2] == 3'b010;
+    // R-type on OP-P; multiply-accumulate instructions read rd as a third source
+    assign p_type = inst_code[6:5] == 2'b11 && inst_code[4:2] == 3'b101;
+    // R-type on AMO; the address is rs1 without an offset
+    assign a_type = inst_code[6:5] == 2'b01 && inst_code[4:2] == 3'b011;
 
     always_ff @(posedge clk) begin
         if (!rst_n) begin
@@ -95,6 +113,9 @@ module rip_decode
         else if (u_type) begin
             if_imm = {inst_code[31:12], 12'b0};
         end
+        else if (rc_type) begin
+            if_imm = {25'b0, inst_code[31:25]};
+        end
         else if (j_type) begin
             if_imm = {
                 {11{inst_code[31]}},
@@ -111,26 +132,37 @@ module rip_decode
     end
 
     // register number
-    assign if_rd_num = (r_type | i_type | u_type | j_type | csr_type | csr_i_type) ?
-        inst_code[11:7] : 5'b0;
-    assign if_rs1_num = (r_type | i_type | s_type | b_type | csr_type) ? inst_code[19:15] : 5'b0;
-    assign if_rs2_num = (r_type | s_type | b_type) ? inst_code[24:20] : 5'b0;
+    assign if_rd_num = (r_type | i_type | u_type | j_type | csr_type | csr_i_type | rc_type |
+                        p_type | a_type) ? inst_code[11:7] : 5'b0;
+    assign if_rs1_used = r_type | i_type | s_type | b_type | csr_type | rc_type | p_type |
+                         a_type;
+    assign if_rs2_used = r_type | s_type | b_type | rc_type | p_type | a_type;
+    assign if_rs2_store = s_type;
+    assign if_rs3_used = p_type && ((funct3 == 3'b000 && (funct7 == 7'b1100100 ||
+                                                           funct7 == 7'b1100110)) ||
+                                    (funct3 == 3'b001 && funct7 == 7'b0100100));
+    assign if_rs1_num = if_rs1_used ? inst_code[19:15] : 5'b0;
+    assign if_rs2_num = if_rs2_used ? inst_code[24:20] : 5'b0;
+    assign if_rs3_num = if_rs3_used ? inst_code[11:7] : 5'b0;
 
     always_ff @(posedge clk) begin
         if (!rst_n) begin
             de_rd_num  <= 5'b0;
             de_rs1_num <= 5'b0;
             de_rs2_num <= 5'b0;
+            de_rs3_num <= 5'b0;
         end
         else if (de_ready) begin
             de_rd_num  <= if_rd_num;
             de_rs1_num <= if_rs1_num;
             de_rs2_num <= if_rs2_num;
+            de_rs3_num <= if_rs3_num;
         end
         else if (!ex_stall) begin
             de_rd_num  <= 5'b0;
             de_rs1_num <= 5'b0;
             de_rs2_num <= 5'b0;
+            de_rs3_num <= 5'b0;
         end
     end
 
@@ -154,9 +186,11 @@ module rip_decode
 
     // function code
     wire [6:0] funct7;
+    wire [4:0] funct5;
     wire [2:0] funct3;
     wire [11:0] funct12;
     assign funct7  = inst_code[31:25];
+    assign funct5  = inst_code[31:27];
     assign funct3  = inst_code[14:12];
     assign funct12 = inst_code[31:20];
 
@@ -226,18 +260,73 @@ module rip_decode
             inst.REM <= inst_code[6:0] == 7'b0110011 && funct3 == 3'b110 && funct7 == 7'b0000001;
             inst.REMU <= inst_code[6:0] == 7'b0110011 && funct3 == 3'b111 && funct7 == 7'b0000001;
 
+            // Zba instruction
+            inst.SH1ADD <= inst_code[6:0] == 7'b0110011 && funct3 == 3'b010 && funct7 == 7'b0010000;
+            inst.SH2ADD <= inst_code[6:0] == 7'b0110011 && funct3 == 3'b100 && funct7 == 7'b0010000;
+            inst.SH3ADD <= inst_code[6:0] == 7'b0110011 && funct3 == 3'b110 && funct7 == 7'b0010000;
+
+            // Zbb instruction
+            inst.ANDN <= inst_code[6:0] == 7'b0110011 && funct3 == 3'b111 && funct7 == 7'b0100000;
+            inst.ORN <= inst_code[6:0] == 7'b0110011 && funct3 == 3'b110 && funct7 == 7'b0100000;
+            inst.XNOR <= inst_code[6:0] == 7'b0110011 && funct3 == 3'b100 && funct7 == 7'b0100000;
+            inst.CLZ <= inst_code[6:0] == 7'b0010011 && funct3 == 3'b001 && funct12 == 12'h600;
+            inst.CTZ <= inst_code[6:0] == 7'b0010011 && funct3 == 3'b001 && funct12 == 12'h601;
+            inst.CPOP <= inst_code[6:0] == 7'b0010011 && funct3 == 3'b001 && funct12 == 12'h602;
+            inst.MAX <= inst_code[6:0] == 7'b0110011 && funct3 == 3'b110 && funct7 == 7'b0000101;
+            inst.MAXU <= inst_code[6:0] == 7'b0110011 && funct3 == 3'b111 && funct7 == 7'b0000101;
+            inst.MIN <= inst_code[6:0] == 7'b0110011 && funct3 == 3'b100 && funct7 == 7'b0000101;
+            inst.MINU <= inst_code[6:0] == 7'b0110011 && funct3 == 3'b101 && funct7 == 7'b0000101;
+            inst.SEXT_B <= inst_code[6:0] == 7'b0010011 && funct3 == 3'b001 && funct12 == 12'h604;
+            inst.SEXT_H <= inst_code[6:0] == 7'b0010011 && funct3 == 3'b001 && funct12 == 12'h605;
+            inst.ZEXT_H <= inst_code[6:0] == 7'b0110011 && funct3 == 3'b100 && funct12 == 12'h080;
+            inst.ROL <= inst_code[6:0] == 7'b0110011 && funct3 == 3'b001 && funct7 == 7'b0110000;
+            inst.ROR <= inst_code[6:0] == 7'b0110011 && funct3 == 3'b101 && funct7 == 7'b0110000;
+            inst.RORI <= inst_code[6:0] == 7'b0010011 && funct3 == 3'b101 && funct7 == 7'b0110000;
+            inst.ORC_B <= inst_code[6:0] == 7'b0010011 && funct3 == 3'b101 && funct12 == 12'h287;
+            inst.REV8 <= inst_code[6:0] == 7'b0010011 && funct3 == 3'b101 && funct12 == 12'h698;
+
+            // RV32A instruction
+            inst.LR_W <= inst_code[6:0] == 7'b0101111 && funct3 == 3'b010 && funct5 == 5'b00010;
+            inst.SC_W <= inst_code[6:0] == 7'b0101111 && funct3 == 3'b010 && funct5 == 5'b00011;
+            inst.AMOSWAP_W <= inst_code[6:0] == 7'b0101111 && funct3 == 3'b010 &&
+                funct5 == 5'b00001;
+            inst.AMOADD_W <= inst_code[6:0] == 7'b0101111 && funct3 == 3'b010 &&
+                funct5 == 5'b00000;
+            inst.AMOOR_W <= inst_code[6:0] == 7'b0101111 && funct3 == 3'b010 && funct5 == 5'b01000;
+
             // Custom instruction
             inst.EXTX <= inst_code[6:0] == 7'b0001011 && funct12 == 12'h0;
             inst.EXT <= inst_code[6:0] == 7'b0001011 && funct12 == 12'h1;
+            inst.RC <= inst_code[6:0] == 7'b0101011;
+
+            // P extension subset
+            inst.ADD8 <= inst_code[6:0] == 7'b1110111 && funct3 == 3'b000 && funct7 == 7'b0100100;
+            inst.SUB8 <= inst_code[6:0] == 7'b1110111 && funct3 == 3'b000 && funct7 == 7'b0100101;
+            inst.ADD16 <= inst_code[6:0] == 7'b1110111 && funct3 == 3'b000 && funct7 == 7'b0100000;
+            inst.SUB16 <= inst_code[6:0] == 7'b1110111 && funct3 == 3'b000 && funct7 == 7'b0100001;
+            inst.KADD8 <= inst_code[6:0] == 7'b1110111 && funct3 == 3'b000 && funct7 == 7'b0001100;
+            inst.KSUB8 <= inst_code[6:0] == 7'b1110111 && funct3 == 3'b000 && funct7 == 7'b0001101;
+            inst.KADD16 <= inst_code[6:0] == 7'b1110111 && funct3 == 3'b000 && funct7 == 7'b0001000;
+            inst.KSUB16 <= inst_code[6:0] == 7'b1110111 && funct3 == 3'b000 && funct7 == 7'b0001001;
+            inst.UKADD8 <= inst_code[6:0] == 7'b1110111 && funct3 == 3'b000 && funct7 == 7'b0011100;
+            inst.UKSUB8 <= inst_code[6:0] == 7'b1110111 && funct3 == 3'b000 && funct7 == 7'b0011101;
+            inst.UKADD16 <= inst_code[6:0] == 7'b1110111 && funct3 == 3'b000 && funct7 == 7'b0011000;
+            inst.UKSUB16 <= inst_code[6:0] == 7'b1110111 && funct3 == 3'b000 && funct7 == 7'b0011001;
+            inst.SMAQA <= inst_code[6:0] == 7'b1110111 && funct3 == 3'b000 && funct7 == 7'b1100100;
+            inst.UMAQA <= inst_code[6:0] == 7'b1110111 && funct3 == 3'b000 && funct7 == 7'b1100110;
+            inst.KMDA <= inst_code[6:0] == 7'b1110111 && funct3 == 3'b001 && funct7 == 7'b0011100;
+            inst.KMADA <= inst_code[6:0] == 7'b1110111 && funct3 == 3'b001 && funct7 == 7'b0100100;
 
             // pipeline control
             inst.ACCESS_MEM <= inst_code[6:0] == 7'b0000011  /* LOAD */ ||
-                inst_code[6:0] == 7'b0100011  /* STORE */;
+                inst_code[6:0] == 7'b0100011  /* STORE */ ||
+                inst_code[6:0] == 7'b0101111  /* AMO */;
             inst.UPDATE_REG <= if_rd_num != 5'h0;
             inst.UPDATE_CSR <= inst_code[6:0] == 7'b1110011 && funct3 != 3'b000;
             inst.UPDATE_PC <= inst_code[6:0] == 7'b1101111  /* JAL */ || inst_code[6:0] ==
                 7'b1100111  /* JALR */ || inst_code[6:0] == 7'b1100011  /* BRANCH */ ||
                 (inst_code[6:0] == 7'b1110011 && funct3 == 3'b000)  /* ECALL and EBREAK */;
+            inst.COMPRESSED <= compressed;
         end
         else if (!ex_stall) begin
             inst <= 0;
@@ -0,0 +1,191 @@
+/*
+ * Module `rip_fetch_buffer`
+ *
+ * Halfword-aligned instruction fetch in front of memory port 2.
+ * The last fetched word is kept as a one-word line, so the second compressed
+ * instruction of a word does not go to memory again. A 32-bit instruction at
+ * pc[1] = 1 spans two words; its low half comes from the first word and the
+ * buffer reads the following word before it answers.
+ *
+ * The core side keeps the handshake of the memory port: `busy` rises the cycle
+ * after `if_ready` and `if_dout` is valid once it falls. A line hit still answers
+ * after two busy cycles, as the pipeline's hazard handling assumes a fetch takes
+ * at least that long.
+ */
+
+`default_nettype none
+`timescale 1ns / 1ps
+
+module rip_fetch_buffer #(
+    parameter int DATA_WIDTH = 32,
+    parameter int NUM_COL = DATA_WIDTH / 8
+) (
+    input wire clk,
+    input wire rst_n,
+
+    // core side
+    input wire if_ready,
+    input wire [DATA_WIDTH-1:0] pc,
+    output logic [DATA_WIDTH-1:0] if_dout,
+    output logic busy,
+
+    // stores from memory port 1 invalidate the line
+    input wire [NUM_COL-1:0] we_1,
+    input wire [DATA_WIDTH-1:0] addr_1,
+
+    // memory port 2
+    output logic re_2,
+    output logic [DATA_WIDTH-1:0] addr_2,
+    input wire [DATA_WIDTH-1:0] dout_2,
+    input wire busy_2
+);
+    typedef enum logic [1:0] {
+        IDLE,
+        HIT,     // answering from the line
+        MISS,    // reading the word at pc
+        MISS_HI  // reading the word after pc for the high half of a 32-bit instruction
+    } state_t;
+
+    typedef logic [DATA_WIDTH-3:0] word_addr_t;
+
+    state_t state;
+    logic hit_last;  // second busy cycle of HIT
+
+    logic [DATA_WIDTH-1:0] line;
+    word_addr_t line_addr;
+    logic line_valid;
+
+    word_addr_t fill_addr;
+    logic fill_valid;  // no store has hit the word being read
+    logic req_half;    // pc[1] of the request
+    logic [15:0] lo_half;
+    logic [DATA_WIDTH-1:0] inst_reg;
+
+    // the line as it is this cycle, including a word that arrives now
+    logic fill_done;
+    logic [DATA_WIDTH-1:0] cur_line;
+    word_addr_t cur_line_addr;
+    logic cur_line_valid;
+
+    logic fill_straddle;
+    logic [DATA_WIDTH-1:0] fill_inst;
+
+    word_addr_t req_addr;
+    logic [15:0] req_parcel;
+    logic req_hit;
+    logic req_straddle;
+
+    function automatic logic store_to(input word_addr_t addr);
+        store_to = we_1 != '0 && addr_1[DATA_WIDTH-1:2] == addr;
+    endfunction
+
+    assign fill_done = (state == MISS || state == MISS_HI) && !busy_2;
+    assign cur_line = fill_done ? dout_2 : line;
+    assign cur_line_addr = fill_done ? fill_addr : line_addr;
+    assign cur_line_valid = fill_done ? fill_valid : line_valid;
+
+    assign fill_straddle = state == MISS && req_half && dout_2[17:16] == 2'b11;
+    assign fill_inst = state == MISS_HI ? {dout_2[15:0], lo_half} :
+                       req_half ? {16'h0, dout_2[31:16]} : dout_2;
+
+    assign req_addr = pc[DATA_WIDTH-1:2];
+    assign req_parcel = pc[1] ? cur_line[31:16] : cur_line[15:0];
+    assign req_hit = cur_line_valid && cur_line_addr == req_addr;
+    assign req_straddle = pc[1] && req_parcel[1:0] == 2'b11;
+
+    assign busy = state == HIT || (fill_done ? fill_straddle : state != IDLE);
+    assign if_dout = (state == MISS || state == MISS_HI) ? fill_inst : inst_reg;
+
+    always_comb begin
+        re_2 = 1'b0;
+        addr_2 = {pc[DATA_WIDTH-1:2], 2'b0};
+
+        if (fill_done && fill_straddle) begin
+            re_2 = 1'b1;
+            addr_2 = {fill_addr + 1'b1, 2'b0};
+        end
+        else if (if_ready) begin
+            if (!req_hit) begin
+                re_2 = 1'b1;
+            end
+            else if (req_straddle) begin
+                re_2 = 1'b1;
+                addr_2 = {req_addr + 1'b1, 2'b0};
+            end
+        end
+    end
+
+    always_ff @(posedge clk) begin
+        if (!rst_n) begin
+            state <= IDLE;
+            hit_last <= 1'b0;
+            line_valid <= 1'b0;
+            fill_valid <= 1'b0;
+            inst_reg <= '0;
+        end
+        else begin
+            if (fill_done) begin
+                line <= dout_2;
+                line_addr <= fill_addr;
+                line_valid <= fill_valid & !store_to(fill_addr);
+            end
+            else if (store_to(line_addr)) begin
+                line_valid <= 1'b0;
+            end
+
+            if (state == MISS || state == MISS_HI) begin
+                if (store_to(fill_addr)) begin
+                    fill_valid <= 1'b0;
+                end
+            end
+
+            case (state)
+                HIT: begin
+                    hit_last <= 1'b1;
+                    if (hit_last) begin
+                        state <= IDLE;
+                    end
+                end
+                MISS, MISS_HI: begin
+                    if (fill_done) begin
+                        if (fill_straddle) begin
+                            lo_half <= dout_2[31:16];
+                            fill_addr <= fill_addr + 1'b1;
+                            fill_valid <= !store_to(fill_addr + 1'b1);
+                            state <= MISS_HI;
+                        end
+                        else begin
+                            inst_reg <= fill_inst;
+                            state <= IDLE;
+                        end
+                    end
+                end
+                default: ;
+            endcase
+
+            // a request can come in the cycle a fill completes
+            if (if_ready) begin
+                req_half <= pc[1];
+                hit_last <= 1'b0;
+
+                if (!req_hit) begin
+                    fill_addr <= req_addr;
+                    fill_valid <= !store_to(req_addr);
+                    state <= MISS;
+                end
+                else if (req_straddle) begin
+                    lo_half <= req_parcel;
+                    fill_addr <= req_addr + 1'b1;
+                    fill_valid <= !store_to(req_addr + 1'b1);
+                    state <= MISS_HI;
+                end
+                else begin
+                    inst_reg <= pc[1] ? {16'h0, req_parcel} : cur_line;
+                    state <= HIT;
+                end
+            end
+        end
+    end
+endmodule : rip_fetch_buffer
+
+`default_nettype wire
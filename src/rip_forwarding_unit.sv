@@ -0,0 +1,133 @@
+/*
+ * Module `rip_forwarding_unit`
+ *
+ * Picks the value of each DE operand from the newest of
+ * - the result in EX (`ex_alu_rslt`), unless it is a load, a CSR instruction or
+ *   a coprocessor command, whose results are not ready there
+ * - the result in MA (`ma_wdata`), written to the register file this cycle
+ * - the result written in the cycle before (`wb_wdata`), which the register
+ *   file read missed
+ * - the register file
+ *
+ * The register-number compares are done a cycle early. From the signals that
+ * move the pipeline registers, the unit computes the register numbers the
+ * stages will hold in the next cycle. It compares them and registers the
+ * result as a one-hot `fwd_sel_t` per operand. In DE, each operand is then one
+ * AND-OR over the four sources, instead of three compares in front of a
+ * priority mux. Each stage moves its register number the same way as the core
+ * does:
+ * - `*_load`: it takes the number of the stage before
+ * - `*_hold`: it keeps its own
+ * - otherwise it becomes a bubble (x0)
+ *
+ * The stage states do not gate the select. DE operands are only used when EX
+ * is ready, and then nothing is stalled on memory. A stage whose transfer
+ * would not be ready then holds a bubble, so it has no register to match.
+ */
+
+`default_nettype none
+`timescale 1ns / 1ps
+
+module rip_forwarding_unit
+    import rip_type::*;
+#(
+    parameter int REG_ADDR_WIDTH = 5,
+    parameter int DATA_WIDTH = 32,
+    parameter int NUM_RS = 3
+) (
+    input wire rst_n,
+    input wire clk,
+
+    input wire de_load,
+    input wire de_hold,
+    input wire ex_load,
+    input wire ex_hold,
+    input wire ma_load,
+    input wire ma_hold,
+    input wire wb_load,
+    input wire wb_hold,
+
+    input wire [NUM_RS-1:0][REG_ADDR_WIDTH-1:0] if_rs_num,
+    input wire [NUM_RS-1:0][REG_ADDR_WIDTH-1:0] de_rs_num,
+    input inst_t de_inst,
+    input wire [REG_ADDR_WIDTH-1:0] de_rd_num,
+    input inst_t ex_inst,
+    input wire [REG_ADDR_WIDTH-1:0] ex_rd_num,
+    input wire [REG_ADDR_WIDTH-1:0] ma_rd_num,
+    input wire [REG_ADDR_WIDTH-1:0] wb_rd_num,
+
+    input wire [DATA_WIDTH-1:0] ex_rslt,
+    input wire [DATA_WIDTH-1:0] ma_rslt,
+    input wire [DATA_WIDTH-1:0] wb_rslt,
+    input wire [NUM_RS-1:0][DATA_WIDTH-1:0] rf_rs,
+
+    output logic [NUM_RS-1:0][DATA_WIDTH-1:0] rs
+);
+    function automatic logic [REG_ADDR_WIDTH-1:0] next_num(
+        input logic load,
+        input logic hold,
+        input logic [REG_ADDR_WIDTH-1:0] prev_num,
+        input logic [REG_ADDR_WIDTH-1:0] num
+    );
+        return load ? prev_num : hold ? num : '0;
+    endfunction
+
+    // rd of an instruction whose result EX forwards, otherwise x0
+    function automatic logic [REG_ADDR_WIDTH-1:0] ex_fwd_rd(
+        input inst_t inst,
+        input logic [REG_ADDR_WIDTH-1:0] rd_num
+    );
+        return inst.ACCESS_MEM || inst.UPDATE_CSR || inst.RC ? '0 : rd_num;
+    endfunction
+
+    logic [REG_ADDR_WIDTH-1:0] ex_rd_next;
+    logic [REG_ADDR_WIDTH-1:0] ma_rd_next;
+    logic [REG_ADDR_WIDTH-1:0] wb_rd_next;
+    logic [NUM_RS-1:0][REG_ADDR_WIDTH-1:0] rs_next;
+    logic [NUM_RS-1:0] ex_match;
+    logic [NUM_RS-1:0] ma_match;
+    logic [NUM_RS-1:0] wb_match;
+    fwd_sel_t [NUM_RS-1:0] sel_next;
+    fwd_sel_t [NUM_RS-1:0] sel;
+
+    assign ex_rd_next = next_num(ex_load, ex_hold, ex_fwd_rd(de_inst, de_rd_num),
+                                 ex_fwd_rd(ex_inst, ex_rd_num));
+    assign ma_rd_next = next_num(ma_load, ma_hold, ex_rd_num, ma_rd_num);
+    assign wb_rd_next = next_num(wb_load, wb_hold, ma_rd_num, wb_rd_num);
+
+    always_comb begin
+        for (int i = 0; i < NUM_RS; i++) begin
+            rs_next[i] = next_num(de_load, de_hold, if_rs_num[i], de_rs_num[i]);
+            ex_match[i] = ex_rd_next != '0 && rs_next[i] == ex_rd_next;
+            ma_match[i] = ma_rd_next != '0 && rs_next[i] == ma_rd_next;
+            wb_match[i] = wb_rd_next != '0 && rs_next[i] == wb_rd_next;
+
+            sel_next[i].EX = ex_match[i];
+            sel_next[i].MA = !ex_match[i] && ma_match[i];
+            sel_next[i].WB = !ex_match[i] && !ma_match[i] && wb_match[i];
+            sel_next[i].RF = !ex_match[i] && !ma_match[i] && !wb_match[i];
+        end
+    end
+
+    always_ff @(posedge clk) begin
+        if (!rst_n) begin
+            for (int i = 0; i < NUM_RS; i++) begin
+                sel[i] <= '{EX: 1'b0, MA: 1'b0, WB: 1'b0, RF: 1'b1};
+            end
+        end
+        else begin
+            sel <= sel_next;
+        end
+    end
+
+    always_comb begin
+        for (int i = 0; i < NUM_RS; i++) begin
+            rs[i] = ({DATA_WIDTH{sel[i].EX}} & ex_rslt) |
+                    ({DATA_WIDTH{sel[i].MA}} & ma_rslt) |
+                    ({DATA_WIDTH{sel[i].WB}} & wb_rslt) |
+                    ({DATA_WIDTH{sel[i].RF}} & rf_rs[i]);
+        end
+    end
+endmodule : rip_forwarding_unit
+
+`default_nettype wire
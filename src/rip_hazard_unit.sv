@@ -0,0 +1,70 @@
+/*
+ * Module `rip_hazard_unit`
+ *
+ * Decides whether the instruction in IF waits a cycle for the instruction in DE.
+ * Most results are forwarded from EX, but three kinds are not ready there:
+ * - loads, LR/SC and AMOs, whose rd is the memory data returned in MA
+ * - coprocessor commands, multi-cycle operations whose result also arrives in MA
+ * - CSR instructions, whose rd is the old CSR value rather than the ALU result
+ * A one-cycle stall lets such a producer reach MA, from where `ma_wdata`
+ * forwards it. Only the operands the consumer reads (`if_rs*_used` from
+ * `rip_decode`) count, and x0 never does. Nor does the data operand of a store
+ * (`if_rs2_store`): it is not needed until the store issues, when the producer
+ * has reached MA and `ma_wdata` is forwarded into the store data instead.
+ *
+ * `avoided` flags a cycle in which the plain register-number compare used
+ * before would have stalled on a load or coprocessor command, but this unit does
+ * not, including a load feeding a store's data.
+ */
+
+`default_nettype none
+`timescale 1ns / 1ps
+
+module rip_hazard_unit
+    import rip_type::*;
+#(
+    parameter int REG_ADDR_WIDTH = 5
+) (
+    input wire ex_ready,
+    input wire de_ready,
+
+    // producer: the instruction entering EX
+    input inst_t de_inst,
+    input wire [REG_ADDR_WIDTH-1:0] de_rd_num,
+
+    // consumer: the instruction being decoded
+    input wire [REG_ADDR_WIDTH-1:0] if_rs1_num,
+    input wire [REG_ADDR_WIDTH-1:0] if_rs2_num,
+    input wire [REG_ADDR_WIDTH-1:0] if_rs3_num,
+    input wire if_rs1_used,
+    input wire if_rs2_used,
+    input wire if_rs3_used,
+    input wire if_rs2_store,
+
+    output logic stall,
+    output logic avoided
+);
+    logic load;
+    logic multi_cycle;
+    logic csr;
+    logic reads_rd;
+
+    assign load = de_inst.LB | de_inst.LH | de_inst.LW | de_inst.LBU | de_inst.LHU |
+                  de_inst.LR_W | de_inst.SC_W | de_inst.AMOSWAP_W | de_inst.AMOADD_W |
+                  de_inst.AMOOR_W;
+    assign multi_cycle = de_inst.RC;
+    assign csr = de_inst.UPDATE_CSR;
+
+    assign reads_rd = de_rd_num != '0 &&
+                      ((if_rs1_used && if_rs1_num == de_rd_num) ||
+                       (if_rs2_used && !if_rs2_store && if_rs2_num == de_rd_num) ||
+                       (if_rs3_used && if_rs3_num == de_rd_num));
+
+    assign stall = ex_ready && de_ready && (load || multi_cycle || csr) && reads_rd;
+
+    assign avoided = ex_ready && de_ready && (load || multi_cycle) && !reads_rd &&
+                     (de_rd_num == if_rs1_num || de_rd_num == if_rs2_num ||
+                      de_rd_num == if_rs3_num);
+endmodule : rip_hazard_unit
+
+`default_nettype wire
@@ -2,6 +2,9 @@
  * Module `rip_memory_access`
  *
  * Byte addressing memory system top module.
+ * Instruction fetch goes through `rip_fetch_buffer`.
+ * RV32A requests are word accesses qualified by `amo_1`: LR and AMOs read,
+ * SC writes, and the memory system returns the rd value on dout_1.
  */
 
 `default_nettype none
@@ -18,16 +21,10 @@ module rip_memory_access
 
     output logic [3:0] we_1,
     output wire re_1,
-    output wire re_2,
     output wire [31:0] addr_1,
-    output wire [31:0] addr_2,
     output logic [31:0] din_1,
     input wire [31:0] dout_1,
-    input wire [31:0] dout_2,
-
-    input wire if_ready,
-    input wire [DATA_WIDTH-1:0] pc,
-    output logic [DATA_WIDTH-1:0] if_dout,
+    output amo_op_t amo_1,
 
     input wire ma_ready,
     input inst_t ex_inst,
@@ -40,21 +37,40 @@ module rip_memory_access
     logic [1:0] ex_mem_offset;
     logic [1:0] ma_mem_offset;
 
-    // instruction fetch
-    assign re_2 = if_ready;
-    assign addr_2 = {pc[31:2], 2'b0};
-    assign if_dout = dout_2;
-
     // memory access
-    assign re_1 = ma_ready & (ex_inst.LB | ex_inst.LH | ex_inst.LBU | ex_inst.LHU | ex_inst.LW);
+    assign re_1 = ma_ready & (ex_inst.LB | ex_inst.LH | ex_inst.LBU | ex_inst.LHU | ex_inst.LW |
+                              ex_inst.LR_W | ex_inst.AMOSWAP_W | ex_inst.AMOADD_W |
+                              ex_inst.AMOOR_W);
     assign addr_1 = {ex_addr[31:2], 2'b0};
+    always_comb begin
+        if (ex_inst.LR_W) begin
+            amo_1 = AMO_LR;
+        end
+        else if (ex_inst.SC_W) begin
+            amo_1 = AMO_SC;
+        end
+        else if (ex_inst.AMOSWAP_W) begin
+            amo_1 = AMO_SWAP;
+        end
+        else if (ex_inst.AMOADD_W) begin
+            amo_1 = AMO_ADD;
+        end
+        else if (ex_inst.AMOOR_W) begin
+            amo_1 = AMO_OR;
+        end
+        else begin
+            amo_1 = AMO_NONE;
+        end
+    end
+
     always_comb begin
         ex_mem_offset = ex_addr[1:0];
         ma_mem_offset = ma_addr[1:0];
 
         for (integer i = 0; i < NUM_COL; i = i + 1) begin
             we_1[i] = ma_ready & ((ex_inst.SB && ex_mem_offset == i[1:0]) |
-                                  (ex_inst.SH && ex_mem_offset[1] == i[1]) | ex_inst.SW);
+                                  (ex_inst.SH && ex_mem_offset[1] == i[1]) | ex_inst.SW |
+                                  ex_inst.SC_W);
         end
 
         if (ex_inst.SB) begin
@@ -101,7 +117,8 @@ module rip_memory_access
                 default: ma_dout = 32'hFFFFFFFF;
             endcase
         end
-        else if (ma_inst.LW) begin
+        else if (ma_inst.LW | ma_inst.LR_W | ma_inst.SC_W | ma_inst.AMOSWAP_W | ma_inst.AMOADD_W |
+                 ma_inst.AMOOR_W) begin
             ma_dout = dout_1;
         end
         else begin
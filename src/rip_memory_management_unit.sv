@@ -3,8 +3,28 @@
 
 // Module: rip_memory_management_unit
 // Description: byte addressing memory system top module.
+//              Instruction fetch (channel 2) reads whole lines of LINE_SIZE
+//              bytes into a one-line buffer and answers as soon as the
+//              requested word arrives, with a WRAP burst starting at that word
+//              if WRAP_BURST is set. The buffer serves later fetches in the
+//              line; stores to it invalidate it. Data accesses (channel 1) are
+//              single beats, so they always see other masters' writes.
+//              LR/SC and AMOs use AXI exclusive accesses. LR keeps a local
+//              reservation; SC fails without a bus access when it does not
+//              hold, and otherwise by the slave answering OKAY to the exclusive
+//              write. An AMO is an exclusive read and write, repeated until the
+//              write succeeds. A slave that answers OKAY to the exclusive read
+//              has no monitor: the write is then a plain one and only the
+//              local reservation guards SC.
+//              The AXI data bus may be wider than the data port: single beats
+//              carry the word on the byte lanes of its address.
+//              With AXI_ASYNC, the AXI master runs on axi_clk behind
+//              rip_axi_master_async; cdc_rstn resets the clk side of the
+//              crossing together with axi_rstn, and must not follow rstn
+//              between runs.
 module rip_memory_management_unit
     import rip_const::*;
+    import rip_type::*;
 #(
     parameter ADDR_WIDTH = 32,
     parameter DATA_WIDTH = 32, // data port width
@@ -16,16 +36,22 @@ module rip_memory_management_unit
     parameter WAY_NUM = 1,
     // AXI configuration
     parameter AXI_ID_WIDTH = 4,
-    parameter AXI_DATA_WIDTH = 32
+    parameter AXI_DATA_WIDTH = 32, // >= DATA_WIDTH; LINE_SIZE covers at least one beat
+    parameter WRAP_BURST = 1, // the slave accepts WRAP bursts
+    parameter AXI_ASYNC = 0 // M_AXI on axi_clk instead of clk
 ) (
     input wire clk,
     input wire rstn,
+    input wire cdc_rstn,
+    input wire axi_clk,
+    input wire axi_rstn,
     input wire [DATA_WIDTH/B_WIDTH-1:0] we_1,
     input wire re_1,
     input wire re_2,
     input wire [ADDR_WIDTH-1:0] addr_1,
     input wire [ADDR_WIDTH-1:0] addr_2,
     input wire [DATA_WIDTH-1:0] din_1,
+    input amo_op_t amo_1,
     output logic [DATA_WIDTH-1:0] dout_1,
     output logic [DATA_WIDTH-1:0] dout_2,
     output logic busy_1,
@@ -34,41 +60,125 @@ module rip_memory_management_unit
 );
     import rip_axi_interface_const::*;
 
+    localparam LINE_WIDTH = LINE_SIZE * B_WIDTH;
+    localparam OFFSET_WIDTH = $clog2(LINE_SIZE);
+    localparam WORD_OFFSET_WIDTH = $clog2(DATA_WIDTH / B_WIDTH);
+    localparam BEAT_OFFSET_WIDTH = $clog2(AXI_DATA_WIDTH / B_WIDTH);
+    typedef logic [ADDR_WIDTH-OFFSET_WIDTH-1:0] line_addr_t;
+
+    function automatic line_addr_t line_of(input logic [ADDR_WIDTH-1:0] addr);
+        return addr[ADDR_WIDTH-1:OFFSET_WIDTH];
+    endfunction
+
+    // the word at addr in a line
+    function automatic logic [DATA_WIDTH-1:0] word_of(input logic [LINE_WIDTH-1:0] line,
+                                                      input logic [ADDR_WIDTH-1:0] addr);
+        return line[DATA_WIDTH*(addr[OFFSET_WIDTH-1:0] >> WORD_OFFSET_WIDTH) +: DATA_WIDTH];
+    endfunction
+
+    // the word at addr in a single beat
+    function automatic logic [DATA_WIDTH-1:0] beat_word_of(input logic [AXI_DATA_WIDTH-1:0] beat,
+                                                           input logic [ADDR_WIDTH-1:0] addr);
+        return beat[DATA_WIDTH*(addr[BEAT_OFFSET_WIDTH-1:0] >> WORD_OFFSET_WIDTH) +: DATA_WIDTH];
+    endfunction
+
+    // a word and its byte enables on the byte lanes of addr in a single beat
+    function automatic logic [LINE_WIDTH-1:0] beat_data(input logic [DATA_WIDTH-1:0] data,
+                                                        input logic [ADDR_WIDTH-1:0] addr);
+        return LINE_WIDTH'(data) << (B_WIDTH * addr[BEAT_OFFSET_WIDTH-1:0]);
+    endfunction
+
+    function automatic logic [LINE_SIZE-1:0] beat_strb(input logic [DATA_WIDTH/B_WIDTH-1:0] strb,
+                                                       input logic [ADDR_WIDTH-1:0] addr);
+        return LINE_SIZE'(strb) << addr[BEAT_OFFSET_WIDTH-1:0];
+    endfunction
+
     // AXI master control signals
     logic wready;
     logic [ADDR_WIDTH-1:0] waddr;
-    logic [LINE_SIZE*B_WIDTH-1:0] wdata;
+    logic [LINE_WIDTH-1:0] wdata;
     logic [LINE_SIZE-1:0] wstrb;
     logic wvalid;
+    logic wlock;
     logic wdone;
+    logic [1:0] wresp;
     logic rready;
     logic [ADDR_WIDTH-1:0] raddr;
     logic rvalid;
-    logic [LINE_SIZE*B_WIDTH-1:0] rdata;
+    logic rlock;
+    logic rline;
+    logic [LINE_WIDTH-1:0] rdata;
+    logic rcrit;
     logic rdone;
+    logic [1:0] rresp;
 
     localparam BURST_LEN = LINE_SIZE / (AXI_DATA_WIDTH / B_WIDTH);
-    rip_axi_master #(
-        .ID_WIDTH(AXI_ID_WIDTH),
-        .ADDR_WIDTH(ADDR_WIDTH),
-        .DATA_WIDTH(AXI_DATA_WIDTH),
-        .BURST_LEN(BURST_LEN)
-    ) AXIM (
-        .clk(clk),
-        .rstn(rstn),
-        .wready(wready),
-        .waddr(waddr),
-        .wdata(wdata),
-        .wstrb(wstrb),
-        .wvalid(wvalid),
-        .wdone(wdone),
-        .rready(rready),
-        .raddr(raddr),
-        .rvalid(rvalid),
-        .rdata(rdata),
-        .rdone(rdone),
-        .M_AXI(M_AXI)
-    );
+    generate
+        if (AXI_ASYNC) begin : GEN_AXI_ASYNC
+            rip_axi_master_async #(
+                .ID_WIDTH(AXI_ID_WIDTH),
+                .ADDR_WIDTH(ADDR_WIDTH),
+                .DATA_WIDTH(AXI_DATA_WIDTH),
+                .BURST_LEN(BURST_LEN),
+                .WRAP_BURST(WRAP_BURST)
+            ) AXIM (
+                .clk(clk),
+                .rstn(rstn),
+                .cdc_rstn(cdc_rstn),
+                .axi_clk(axi_clk),
+                .axi_rstn(axi_rstn),
+                .wready(wready),
+                .waddr(waddr),
+                .wdata(wdata),
+                .wstrb(wstrb),
+                .wvalid(wvalid),
+                .wlock(wlock),
+                .wline(1'b0),
+                .wdone(wdone),
+                .wresp(wresp),
+                .rready(rready),
+                .raddr(raddr),
+                .rvalid(rvalid),
+                .rlock(rlock),
+                .rline(rline),
+                .rdata(rdata),
+                .rcrit(rcrit),
+                .rdone(rdone),
+                .rresp(rresp),
+                .M_AXI(M_AXI)
+            );
+        end else begin : GEN_AXI
+            rip_axi_master #(
+                .ID_WIDTH(AXI_ID_WIDTH),
+                .ADDR_WIDTH(ADDR_WIDTH),
+                .DATA_WIDTH(AXI_DATA_WIDTH),
+                .BURST_LEN(BURST_LEN),
+                .WRAP_BURST(WRAP_BURST)
+            ) AXIM (
+                .clk(clk),
+                .rstn(rstn),
+                .wready(wready),
+                .waddr(waddr),
+                .wdata(wdata),
+                .wstrb(wstrb),
+                .wvalid(wvalid),
+                .wlock(wlock),
+                .wline(1'b0),
+                .wdone(wdone),
+                .wresp(wresp),
+                .rready(rready),
+                .raddr(raddr),
+                .rvalid(rvalid),
+                .rlock(rlock),
+                .rline(rline),
+                .rdata(rdata),
+                .rcrit(rcrit),
+                .rdone(rdone),
+                .rresp(rresp),
+                .M_AXI(M_AXI)
+            );
+        end
+    endgenerate
 
     // TO BE IMPLEMENTED
 
@@ -83,9 +193,39 @@ module rip_memory_management_unit
     logic wait_1_r;
     logic wait_1_r_2; // wait channel 2 read completion
     logic [ADDR_WIDTH-1:0] raddr_1;
+    logic [DATA_WIDTH-1:0] rdata_1; // the word at raddr_1 of a single-beat read
     logic wait_2;
     logic wait_2_1; // wait channel 1 read completion
     logic [ADDR_WIDTH-1:0] raddr_2;
+    logic hit_2;
+    logic wait_2_fill; // wait the line fill in progress
+    // channel 2 line buffer
+    logic [LINE_WIDTH-1:0] line_2;
+    line_addr_t line_2_addr;
+    logic line_2_valid;
+    logic fill_2; // a line read is in progress; it may outlast busy_2
+    line_addr_t fill_2_addr;
+    logic fill_2_valid; // no store has hit the line being read
+    // channel 1 write starting this cycle
+    logic store_1;
+    logic [ADDR_WIDTH-1:0] store_1_addr;
+    // atomic access on channel 1
+    amo_op_t amo_op;
+    logic [ADDR_WIDTH-1:0] amo_addr;
+    logic [DATA_WIDTH-1:0] amo_src;
+    logic amo_rmw;
+    // LR reservation; exclusive if the slave monitors it too
+    logic resv_valid;
+    logic resv_exclusive;
+    logic [ADDR_WIDTH-1:0] resv_addr;
+
+    assign amo_rmw = amo_op == AMO_SWAP || amo_op == AMO_ADD || amo_op == AMO_OR;
+    assign rdata_1 = beat_word_of(rdata[AXI_DATA_WIDTH-1:0], raddr_1);
+
+    // conservative: a failing SC also counts
+    assign store_1 = busy_1 ? busy_1_r && !wait_1_r_2 && !wait_1_r && rdone && amo_rmw
+                            : we_1 != '0;
+    assign store_1_addr = busy_1 ? amo_addr : addr_1;
 
     always_ff @(posedge clk) begin
         if (~rstn) begin
@@ -94,8 +234,11 @@ module rip_memory_management_unit
             wdata <= '0;
             wstrb <= '0;
             wvalid <= '0;
+            wlock <= '0;
             raddr <= '0;
             rvalid <= '0;
+            rlock <= '0;
+            rline <= '0;
             // internal states and buffers
             busy_1_w <= '0;
             busy_1_r <= '0;
@@ -106,6 +249,20 @@ module rip_memory_management_unit
             wait_2 <= '0;
             wait_2_1 <= '0;
             raddr_2 <= '0;
+            hit_2 <= '0;
+            wait_2_fill <= '0;
+            line_2 <= '0;
+            line_2_addr <= '0;
+            line_2_valid <= '0;
+            fill_2 <= '0;
+            fill_2_addr <= '0;
+            fill_2_valid <= '0;
+            amo_op <= AMO_NONE;
+            amo_addr <= '0;
+            amo_src <= '0;
+            resv_valid <= '0;
+            resv_exclusive <= '0;
+            resv_addr <= '0;
             // module outputs
             dout_1 <= '0;
             dout_2 <= '0;
@@ -123,6 +280,14 @@ module rip_memory_management_unit
                         wvalid <= '0;
                         if (wdone) begin
                             busy_1_w <= '0;
+                            if (amo_op == AMO_SC) begin
+                                dout_1 <= DATA_WIDTH'(wlock && wresp != EXOKAY);
+                            end else if (amo_rmw && wlock && wresp != EXOKAY) begin
+                                // the exclusive write failed: read again
+                                raddr_1 <= amo_addr;
+                                busy_1_r <= '1;
+                                wait_1_r_2 <= '1;
+                            end
                         end
                     end
                 end else if (busy_1_r) begin
@@ -132,6 +297,8 @@ module rip_memory_management_unit
                         end else begin
                             raddr <= raddr_1;
                             rvalid <= '1;
+                            rlock <= amo_op != AMO_NONE;
+                            rline <= '0;
                             wait_1_r_2 <= '0;
                             if (~rready) begin
                                 wait_1_r <= '1;
@@ -145,29 +312,60 @@ module rip_memory_management_unit
                     end else begin
                         rvalid <= '0;
                         if (rdone) begin
-                            dout_1 <= rdata;
+                            dout_1 <= rdata_1;
                             busy_1_r <= '0;
+                            if (amo_op == AMO_LR) begin
+                                resv_valid <= '1;
+                                resv_exclusive <= rresp == EXOKAY;
+                                resv_addr <= amo_addr;
+                            end else if (amo_rmw) begin
+                                // write back; busy_1 stays high
+                                waddr <= amo_addr;
+                                wdata <= beat_data(amo_result(amo_op, rdata_1, amo_src),
+                                                   amo_addr);
+                                wstrb <= beat_strb('1, amo_addr);
+                                wvalid <= '1;
+                                wlock <= rresp == EXOKAY;
+                                busy_1_w <= '1;
+                                if (~wready) begin
+                                    wait_1_w <= '1;
+                                end
+                            end
                         end
                     end
                 end
             end else if (we_1) begin
-                waddr <= addr_1;
-                wdata <= din_1;
-                wstrb <= we_1;
-                wvalid <= '1;
-                busy_1_w <= '1;
-                if (~wready) begin
-                    wait_1_w <= '1;
+                amo_op <= amo_1;
+                if (amo_1 == AMO_SC) begin
+                    resv_valid <= '0;
+                end
+                if (amo_1 == AMO_SC && !(resv_valid && resv_addr == addr_1)) begin
+                    dout_1 <= DATA_WIDTH'(1); // fails without a bus access
+                end else begin
+                    waddr <= addr_1;
+                    wdata <= beat_data(din_1, addr_1);
+                    wstrb <= beat_strb(we_1, addr_1);
+                    wvalid <= '1;
+                    wlock <= amo_1 == AMO_SC && resv_exclusive;
+                    busy_1_w <= '1;
+                    if (~wready) begin
+                        wait_1_w <= '1;
+                    end
                 end
             end else if (re_1) begin
+                amo_op <= amo_1;
+                amo_addr <= addr_1;
+                amo_src <= din_1;
+                raddr_1 <= addr_1;
                 if (busy_2 && ~wait_2_1) begin
                     // only when re_2 is not waiting re_1 (to avoid deadlock)
-                    raddr_1 <= addr_1;
                     busy_1_r <= '1;
                     wait_1_r_2 <= '1;
                 end else begin
                     raddr <= addr_1;
                     rvalid <= '1;
+                    rlock <= amo_1 != AMO_NONE;
+                    rline <= '0;
                     busy_1_r <= '1;
                     if (~rready) begin
                         wait_1_r <= '1;
@@ -175,13 +373,55 @@ module rip_memory_management_unit
                 end
             end
             // channel 2
+            if (fill_2 && rdone) begin
+                fill_2 <= '0;
+                line_2 <= rdata;
+                line_2_addr <= fill_2_addr;
+                line_2_valid <= fill_2_valid && !(store_1 && line_of(store_1_addr) == fill_2_addr);
+            end else if (store_1 && line_of(store_1_addr) == line_2_addr) begin
+                line_2_valid <= '0;
+            end
+            if (store_1 && line_of(store_1_addr) == fill_2_addr) begin
+                fill_2_valid <= '0;
+            end
             if (busy_2) begin
-                if (wait_2_1) begin
+                if (hit_2) begin
+                    hit_2 <= '0;
+                    busy_2 <= '0;
+                end else if (wait_2_fill) begin
+                    if (~fill_2) begin
+                        // line_2 holds the line that was being read
+                        wait_2_fill <= '0;
+                        if (line_2_valid && line_of(raddr_2) == line_2_addr) begin
+                            dout_2 <= word_of(line_2, raddr_2);
+                            busy_2 <= '0;
+                        end else if (busy_1_r && ~wait_1_r_2) begin
+                            wait_2_1 <= '1;
+                        end else begin
+                            raddr <= raddr_2;
+                            rvalid <= '1;
+                            rlock <= '0;
+                            rline <= '1;
+                            fill_2 <= '1;
+                            fill_2_addr <= line_of(raddr_2);
+                            fill_2_valid <= ~(store_1 &&
+                                              line_of(store_1_addr) == line_of(raddr_2));
+                            if (~rready) begin
+                                wait_2 <= '1;
+                            end
+                        end
+                    end
+                end else if (wait_2_1) begin
                     if (re_1 || busy_1_r) begin
                         wait_2_1 <= '1; // keep waiting
                     end else begin
                         raddr <= raddr_2;
                         rvalid <= '1;
+                        rlock <= '0;
+                        rline <= '1;
+                        fill_2 <= '1;
+                        fill_2_addr <= line_of(raddr_2);
+                        fill_2_valid <= ~(store_1 && line_of(store_1_addr) == line_of(raddr_2));
                         wait_2_1 <= '0;
                         if (~rready) begin
                             wait_2 <= '1;
@@ -194,20 +434,30 @@ module rip_memory_management_unit
                     end
                 end else begin
                     rvalid <= '0;
-                    if (rdone) begin
-                        dout_2 <= rdata;
+                    if (rcrit) begin
+                        // the rest of the line keeps arriving in fill_2
+                        dout_2 <= word_of(rdata, raddr_2);
                         busy_2 <= '0;
                     end
                 end
             end else if (re_2) begin
-                if (re_1 || busy_1_r) begin
-                    raddr_2 <= addr_2;
-                    busy_2 <= '1;
+                raddr_2 <= addr_2;
+                busy_2 <= '1;
+                if (line_2_valid && line_of(addr_2) == line_2_addr) begin
+                    dout_2 <= word_of(line_2, addr_2);
+                    hit_2 <= '1;
+                end else if (fill_2) begin
+                    wait_2_fill <= '1;
+                end else if (re_1 || busy_1_r) begin
                     wait_2_1 <= '1;
                 end else begin
                     raddr <= addr_2;
                     rvalid <= '1;
-                    busy_2 <= '1;
+                    rlock <= '0;
+                    rline <= '1;
+                    fill_2 <= '1;
+                    fill_2_addr <= line_of(addr_2);
+                    fill_2_valid <= ~(store_1 && line_of(store_1_addr) == line_of(addr_2));
                     if (~rready) begin
                         wait_2 <= '1;
                     end
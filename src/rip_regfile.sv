@@ -1,6 +1,15 @@
 `default_nettype none
 `timescale 1ns / 1ps
 
+// Module: rip_regfile
+// Description: 32 x 32-bit registers with one write port and no reset, so they
+//              map to LUTRAM (or BRAM) with a registered read per source.
+//              `written` marks the registers written since reset; the others
+//              read as their reset value (sp = SP_ADDR for riscv-tests, else 0,
+//              and x0 is never written).
+//              The sources of the instruction in DE next cycle are read every
+//              cycle. A read misses the write in the same cycle, which
+//              `rip_forwarding_unit` forwards from WB instead.
 module rip_regfile
     import rip_config::*;
 (
@@ -14,42 +23,67 @@ module rip_regfile
 
     input wire [4:0] if_rs1_num,
     input wire [4:0] if_rs2_num,
-    output reg [31:0] rs1,
-    output reg [31:0] rs2
+    input wire [4:0] if_rs3_num,
+    input wire [4:0] de_rs1_num,
+    input wire [4:0] de_rs2_num,
+    input wire [4:0] de_rs3_num,
+    output logic [31:0] rs1,
+    output logic [31:0] rs2,
+    output logic [31:0] rs3
 );
-    reg [31:0] regfile[32];
+    (* ram_style = "distributed" *)
+    logic [31:0] ram[32];
+    logic [31:0] written;
+
+    function automatic logic [31:0] reset_value(input logic [4:0] num);
+        return num == 5'd2 ? SP_ADDR : 32'h0;
+    endfunction
+
+    // write
+    always_ff @(posedge clk) begin
+        if (wen && ma_rd_num != 5'h0) begin
+            ram[ma_rd_num] <= wdata;
+        end
+    end
 
-    // initialize and write
     always_ff @(posedge clk) begin
         if (!rst_n) begin
-            for (int i = 0; i < 32; i = i + 1) begin
-                // sp; for riscv-tests
-                if (i == 2) begin
-                    regfile[i] <= SP_ADDR;
-                end
-                else begin
-                    regfile[i] <= 0;
-                end
-            end
+            written <= 32'h0;
         end
-        else begin
-            for (int i = 1; i < 32; i = i + 1) begin
-                if (wen && ma_rd_num == i[4:0]) begin
-                    regfile[i] <= wdata;
-                end
-            end
+        else if (wen && ma_rd_num != 5'h0) begin
+            written[ma_rd_num] <= 1'b1;
         end
     end
 
     // read
+    logic [2:0][4:0] rs_sel;
+    logic [2:0][4:0] rs_num;
+    logic [2:0][31:0] rs_ram;
+    logic [2:0] rs_written;
+
+    assign rs_sel[0] = de_ready ? if_rs1_num : de_rs1_num;
+    assign rs_sel[1] = de_ready ? if_rs2_num : de_rs2_num;
+    assign rs_sel[2] = de_ready ? if_rs3_num : de_rs3_num;
+
     always_ff @(posedge clk) begin
-        if (!rst_n) begin
-            rs1 <= 0;
-            rs2 <= 0;
+        for (int i = 0; i < 3; i++) begin
+            rs_ram[i] <= ram[rs_sel[i]];
+            rs_num[i] <= rs_sel[i];
+            rs_written[i] <= written[rs_sel[i]];
         end
-        else if (de_ready) begin
-            rs1 <= wen && (ma_rd_num == if_rs1_num) ? wdata : regfile[if_rs1_num];
-            rs2 <= wen && (ma_rd_num == if_rs2_num) ? wdata : regfile[if_rs2_num];
+    end
+
+    assign rs1 = rs_written[0] ? rs_ram[0] : reset_value(rs_num[0]);
+    assign rs2 = rs_written[1] ? rs_ram[1] : reset_value(rs_num[1]);
+    assign rs3 = rs_written[2] ? rs_ram[2] : reset_value(rs_num[2]);
+
+`ifdef VERILATOR
+    // architectural values for the testbench and the dump
+    logic [31:0] regfile[32];
+    always_comb begin
+        for (int i = 0; i < 32; i++) begin
+            regfile[i] = written[i] ? ram[i] : reset_value(5'(i));
         end
     end
+`endif  // VERILATOR
 endmodule: rip_regfile
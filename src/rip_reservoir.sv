@@ -0,0 +1,377 @@
+`default_nettype none
+`timescale 1ns / 1ps
+
+// Module: rip_reservoir
+// Description: reservoir computing coprocessor behind custom-1 (see rip_reservoir_const).
+//              RC_OP_STEP streams one nonzero weight per cycle through
+//              fetch -> gather -> multiply -> accumulate -> tanh and leaky integration,
+//              reading the current state bank and writing the other one.
+//              Commands are issued from the MA stage like memory accesses; `busy` stalls
+//              the pipeline until `dout` is valid.
+module rip_reservoir
+    import rip_config::*;
+    import rip_reservoir_const::*;
+#(
+    parameter int DATA_WIDTH = 32
+) (
+    input wire clk,
+    input wire rst_n,
+
+    input wire issue,
+    input wire [6:0] funct7,
+    input wire [DATA_WIDTH-1:0] rs1,
+    input wire [DATA_WIDTH-1:0] rs2,
+
+    output wire busy,
+    output logic [DATA_WIDTH-1:0] dout
+);
+    localparam int SAW = RC_STATE_ADDR_WIDTH;
+    localparam int WAW = RC_WEIGHT_ADDR_WIDTH;
+    localparam int VW = RC_VALUE_WIDTH;
+    localparam int LUT_DEPTH = 2 ** RC_LUT_ADDR_WIDTH;
+
+    typedef enum logic [1:0] {
+        IDLE,
+        READ_STATE,
+        STEP,
+        READOUT
+    } rc_state_t;
+
+    rc_state_t state;
+    assign busy = state != IDLE;
+
+    wire op_cfg;
+    wire op_ww;
+    wire op_ws;
+    wire op_rs;
+    wire op_step;
+    wire op_read;
+    assign op_cfg = issue && funct7 == RC_OP_CFG;
+    assign op_ww = issue && funct7 == RC_OP_WW;
+    assign op_ws = issue && funct7 == RC_OP_WS;
+    assign op_rs = issue && funct7 == RC_OP_RS;
+    assign op_step = issue && funct7 == RC_OP_STEP;
+    assign op_read = issue && funct7 == RC_OP_READ;
+
+    /* configuration */
+    logic [SAW:0] cfg_size;
+    logic [VW-1:0] cfg_leak;
+    logic [WAW-1:0] cfg_base;
+    logic [DATA_WIDTH-1:0] cfg_cycles;
+    logic [DATA_WIDTH-1:0] cfg_rdata;
+
+    always_comb begin
+        case (rs2[1:0])
+            RC_CFG_SIZE: cfg_rdata = DATA_WIDTH'(cfg_size);
+            RC_CFG_LEAK: cfg_rdata = DATA_WIDTH'(cfg_leak);
+            RC_CFG_BASE: cfg_rdata = DATA_WIDTH'(cfg_base);
+            default: cfg_rdata = cfg_cycles;
+        endcase
+    end
+
+    /* weight scratchpad */
+    rc_weight_t w_dout;
+    logic [DATA_WIDTH-1:0] w_dout_1_dummy;
+    logic fetch;
+    logic [WAW-1:0] w_addr;
+
+    rip_2r1w_bram #(
+        .DATA_WIDTH(DATA_WIDTH),
+        .ADDR_WIDTH(WAW)
+    ) weight_mem (
+        .clk(clk),
+        .enable_1(op_ww),
+        .enable_2(fetch),
+        .addr_1(rs1[WAW-1:0]),
+        .addr_2(w_addr),
+        .we_1(op_ww),
+        .din_1(rs2),
+        .dout_1(w_dout_1_dummy), // ignored
+        .dout_2(w_dout)
+    );
+
+    /* state scratchpads (double buffered) */
+    logic cur;  // bank holding the current state
+    logic [1:0] bank_en_1;
+    logic [1:0] bank_we_1;
+    logic [SAW-1:0] bank_addr_1[2];
+    logic [VW-1:0] bank_din_1[2];
+    logic [VW-1:0] bank_dout_1[2];
+    logic [VW-1:0] bank_dout_2[2];
+    logic [SAW-1:0] gather_addr;
+
+    generate
+        for (genvar i = 0; i < 2; i++) begin : g_bank
+            rip_2r1w_bram #(
+                .DATA_WIDTH(VW),
+                .ADDR_WIDTH(SAW)
+            ) state_mem (
+                .clk(clk),
+                .enable_1(bank_en_1[i]),
+                .enable_2(1'b1),
+                .addr_1(bank_addr_1[i]),
+                .addr_2(gather_addr),
+                .we_1(bank_we_1[i]),
+                .din_1(bank_din_1[i]),
+                .dout_1(bank_dout_1[i]),
+                .dout_2(bank_dout_2[i])
+            );
+        end
+    endgenerate
+
+    /* tanh LUT */
+    function automatic logic [VW-1:0] tanh_entry(input int index);
+        real x;
+        real e;
+        real term;
+        begin
+            // exp(2x) by its Taylor series: constant-foldable without math library calls
+            x = 2.0 * real'(index) / real'(2 ** (RC_LUT_ADDR_WIDTH - 3));
+            if (x < 0.0) begin
+                x = -x;
+            end
+            e = 1.0;
+            term = 1.0;
+            for (int k = 1; k < 64; k++) begin
+                term = term * x / real'(k);
+                e = e + term;
+            end
+            x = (e - 1.0) / (e + 1.0) * real'(2 ** RC_FRAC_WIDTH);
+            // real to integer conversion rounds half away from zero (lround)
+            tanh_entry = index < 0 ? VW'(-longint'(x)) : VW'(longint'(x));
+        end
+    endfunction
+
+    (* rom_style = "block" *)
+    logic [VW-1:0] tanh_lut[LUT_DEPTH];
+    logic [RC_LUT_ADDR_WIDTH-1:0] lut_addr;
+    logic [VW-1:0] lut_dout;
+
+    initial begin
+        for (int i = 0; i < LUT_DEPTH; i++) begin
+            tanh_lut[i] = tanh_entry(i - LUT_DEPTH / 2);
+        end
+    end
+
+    always_ff @(posedge clk) begin
+        lut_dout <= tanh_lut[lut_addr];
+    end
+
+    /* pipeline */
+    logic [SAW:0] rows;          // rows of the running command
+    logic [SAW:0] rows_fetched;  // rows whose last entry has been gathered
+    logic [SAW:0] rows_summed;   // rows whose sum is complete
+    logic [SAW:0] rows_written;  // rows written back to the next state bank
+    logic [DATA_WIDTH-1:0] cycles;
+
+    // stage 1: weight entry -> gather state[col]
+    logic s1_valid;
+    wire s1_take;
+    assign s1_take = s1_valid && rows_fetched != rows;
+    assign gather_addr = w_dout.col[SAW-1:0];
+
+    // stage 2: multiply
+    logic s2_valid;
+    logic s2_last;
+    logic signed [VW-1:0] s2_weight;
+    wire signed [VW-1:0] s2_state;
+    assign s2_state = bank_dout_2[cur];
+
+    // stage 3: accumulate
+    logic s3_valid;
+    logic s3_last;
+    logic signed [2*VW-1:0] s3_prod;
+    logic signed [RC_ACC_WIDTH-1:0] acc;
+    logic acc_first;
+    logic signed [RC_ACC_WIDTH-1:0] acc_sum;
+    logic signed [RC_ACC_WIDTH-RC_LUT_SHIFT-1:0] acc_index;
+    logic signed [RC_ACC_WIDTH-RC_FRAC_WIDTH-1:0] acc_value;
+    wire s3_row_done;
+    assign s3_row_done = s3_valid && s3_last;
+
+    always_comb begin
+        acc_sum = (acc_first ? RC_ACC_WIDTH'(0) : acc) + RC_ACC_WIDTH'(s3_prod);
+        acc_index = acc_sum >>> RC_LUT_SHIFT;
+        acc_value = acc_sum >>> RC_FRAC_WIDTH;
+
+        // clamp to [-4, 4) and offset to the LUT address
+        if (acc_index >= (LUT_DEPTH / 2)) begin
+            lut_addr = '1;
+        end
+        else if (acc_index < -(LUT_DEPTH / 2)) begin
+            lut_addr = '0;
+        end
+        else begin
+            lut_addr = {~acc_index[RC_LUT_ADDR_WIDTH-1], acc_index[RC_LUT_ADDR_WIDTH-2:0]};
+        end
+    end
+
+    // stage 4: leaky integration x + leak * (tanh(sum) - x)
+    logic s4_valid;
+    logic [SAW-1:0] s4_row;
+    logic signed [VW:0] s4_diff;
+    logic signed [2*VW+1:0] s4_scaled;
+    logic signed [2*VW+1:0] s4_sum;
+    logic [VW-1:0] s4_state;
+
+    always_comb begin
+        s4_diff = $signed(lut_dout) - $signed(bank_dout_1[cur]);
+        s4_scaled = ($signed({1'b0, cfg_leak}) * s4_diff) >>> RC_FRAC_WIDTH;
+        s4_sum = $signed(bank_dout_1[cur]) + s4_scaled;
+        if (s4_sum > $signed({1'b0, {(VW - 1) {1'b1}}})) begin
+            s4_state = {1'b0, {(VW - 1) {1'b1}}};
+        end
+        else if (s4_sum < -$signed({1'b0, 1'b1, {(VW - 1) {1'b0}}})) begin
+            s4_state = {1'b1, {(VW - 1) {1'b0}}};
+        end
+        else begin
+            s4_state = s4_sum[VW-1:0];
+        end
+    end
+
+    // state bank port 1: RC_OP_WS writes both banks, RC_OP_RS and stage 3 read the
+    // current bank, stage 4 writes the other one
+    always_comb begin
+        for (int i = 0; i < 2; i++) begin
+            bank_en_1[i] = 1'b0;
+            bank_we_1[i] = 1'b0;
+            bank_addr_1[i] = '0;
+            bank_din_1[i] = '0;
+
+            if (op_ws) begin
+                bank_en_1[i] = 1'b1;
+                bank_we_1[i] = 1'b1;
+                bank_addr_1[i] = rs1[SAW-1:0];
+                bank_din_1[i] = rs2[VW-1:0];
+            end
+            else if (cur == 1'(i)) begin
+                bank_en_1[i] = op_rs | (state == STEP && s3_row_done);
+                bank_addr_1[i] = op_rs ? rs1[SAW-1:0] : rows_summed[SAW-1:0];
+            end
+            else begin
+                bank_en_1[i] = state == STEP && s4_valid;
+                bank_we_1[i] = state == STEP && s4_valid;
+                bank_addr_1[i] = s4_row;
+                bank_din_1[i] = s4_state;
+            end
+        end
+    end
+
+    always_ff @(posedge clk) begin
+        if (!rst_n) begin
+            state <= IDLE;
+            dout <= '0;
+            cur <= 1'b0;
+            cfg_size <= '0;
+            cfg_leak <= VW'(1 << RC_FRAC_WIDTH);
+            cfg_base <= '0;
+            cfg_cycles <= '0;
+            fetch <= 1'b0;
+            w_addr <= '0;
+            s1_valid <= 1'b0;
+            s2_valid <= 1'b0;
+            s3_valid <= 1'b0;
+            s4_valid <= 1'b0;
+        end
+        else begin
+            // stage 0: weight fetch
+            s1_valid <= fetch;
+            if (fetch) begin
+                w_addr <= w_addr + 1'b1;
+            end
+
+            // stage 1
+            s2_valid <= s1_take;
+            s2_last <= w_dout.last;
+            s2_weight <= w_dout.weight;
+            if (s1_take && w_dout.last) begin
+                rows_fetched <= rows_fetched + 1'b1;
+                if (rows_fetched + 1'b1 == rows) begin
+                    fetch <= 1'b0;
+                end
+            end
+
+            // stage 2
+            s3_valid <= s2_valid;
+            s3_last <= s2_last;
+            s3_prod <= s2_weight * s2_state;
+
+            // stage 3
+            if (s3_valid) begin
+                acc <= acc_sum;
+                acc_first <= s3_last;
+            end
+            s4_valid <= state == STEP && s3_row_done;
+            s4_row <= rows_summed[SAW-1:0];
+            if (s3_row_done) begin
+                rows_summed <= rows_summed + 1'b1;
+            end
+
+            // stage 4
+            if (s4_valid) begin
+                rows_written <= rows_written + 1'b1;
+            end
+
+            cycles <= cycles + 1'b1;
+
+            case (state)
+                IDLE: begin
+                    cycles <= 1;
+                    rows_fetched <= '0;
+                    rows_summed <= '0;
+                    rows_written <= '0;
+                    acc_first <= 1'b1;
+
+                    if (op_cfg) begin
+                        dout <= cfg_rdata;
+                        case (rs2[1:0])
+                            RC_CFG_SIZE: cfg_size <= rs1[SAW:0];
+                            RC_CFG_LEAK: cfg_leak <= rs1[VW-1:0];
+                            RC_CFG_BASE: cfg_base <= rs1[WAW-1:0];
+                            default: ;
+                        endcase
+                    end
+                    else if (op_rs) begin
+                        state <= READ_STATE;
+                    end
+                    else if (op_step && cfg_size != 0) begin
+                        state <= STEP;
+                        dout <= '0;
+                        rows <= cfg_size;
+                        fetch <= 1'b1;
+                        w_addr <= cfg_base;
+                    end
+                    else if (op_read) begin
+                        state <= READOUT;
+                        rows <= 1;
+                        fetch <= 1'b1;
+                        w_addr <= rs1[WAW-1:0];
+                    end
+                    else if (issue) begin
+                        dout <= '0;
+                    end
+                end
+                READ_STATE: begin
+                    state <= IDLE;
+                    dout <= DATA_WIDTH'($signed(bank_dout_1[cur]));
+                end
+                STEP: begin
+                    if (s4_valid && rows_written + 1'b1 == rows) begin
+                        state <= IDLE;
+                        cur <= ~cur;
+                        cfg_cycles <= cycles;
+                    end
+                end
+                READOUT: begin
+                    if (s3_row_done) begin
+                        state <= IDLE;
+                        dout <= DATA_WIDTH'(acc_value);
+                    end
+                end
+                default: state <= IDLE;
+            endcase
+        end
+    end
+endmodule : rip_reservoir
+
+`default_nettype wire
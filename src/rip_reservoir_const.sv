@@ -0,0 +1,61 @@
+`ifndef RIP_RESERVOIR_CONST
+`define RIP_RESERVOIR_CONST
+
+package rip_reservoir_const;
+
+    import rip_config::*;
+
+    /*
+    * custom-1 (7'b0101011) R-type instructions; funct7 selects the operation
+    *   RC_OP_CFG  : rd = cfg[rs2], cfg[rs2] = rs1
+    *   RC_OP_WW   : weight[rs1] = rs2
+    *   RC_OP_WS   : state[rs1] = rs2[15:0]
+    *   RC_OP_RS   : rd = state[rs1] (sign extended)
+    *   RC_OP_STEP : state[i] += leak * (tanh(sum_j W[i][j] * state[j]) - state[i]), i < size
+    *   RC_OP_READ : rd = sum_j w[j] * state[j] over the weight row starting at rs1
+    */
+    localparam bit [6:0] RC_OP_CFG = 7'h00;
+    localparam bit [6:0] RC_OP_WW = 7'h01;
+    localparam bit [6:0] RC_OP_WS = 7'h02;
+    localparam bit [6:0] RC_OP_RS = 7'h03;
+    localparam bit [6:0] RC_OP_STEP = 7'h04;
+    localparam bit [6:0] RC_OP_READ = 7'h05;
+
+    /*
+    * configuration registers (RC_OP_CFG rs2)
+    *   RC_CFG_SIZE   : number of reservoir units; state[size..] hold the inputs
+    *   RC_CFG_LEAK   : leak rate (Q4.12, 1.0 = 32'h1000)
+    *   RC_CFG_BASE   : weight address of the first reservoir row
+    *   RC_CFG_CYCLES : cycles taken by the last RC_OP_STEP (read only)
+    */
+    localparam bit [1:0] RC_CFG_SIZE = 2'd0;
+    localparam bit [1:0] RC_CFG_LEAK = 2'd1;
+    localparam bit [1:0] RC_CFG_BASE = 2'd2;
+    localparam bit [1:0] RC_CFG_CYCLES = 2'd3;
+
+    /*
+    * fixed point format
+    * VALUE_WIDTH: width of states and weights (Q4.12)
+    * FRAC_WIDTH: fractional bits
+    * ACC_WIDTH: width of the row accumulator (Q16.24)
+    * LUT_ADDR_WIDTH: tanh LUT covers [-4, 4) in steps of 1/128
+    */
+    localparam int RC_VALUE_WIDTH = 16;
+    localparam int RC_FRAC_WIDTH = 12;
+    localparam int RC_ACC_WIDTH = 40;
+    localparam int RC_LUT_ADDR_WIDTH = 10;
+    localparam int RC_LUT_SHIFT = 2 * RC_FRAC_WIDTH - (RC_LUT_ADDR_WIDTH - 3);
+
+    /*
+    * weight scratchpad entry; rows are stored back to back and every row
+    * ends with an entry whose `last` is set (use a zero weight for an empty row)
+    */
+    typedef struct packed {
+        logic last;
+        logic [14:0] col;
+        logic [RC_VALUE_WIDTH-1:0] weight;
+    } rc_weight_t;
+
+endpackage
+
+`endif  // RIP_RESERVOIR_CONST
@@ -0,0 +1,38 @@
+`default_nettype none
+`timescale 1ns / 1ps
+
+// Module: rip_ring_oscillator_bank
+// Description: BP_RO_NUM ring oscillator monitors with the sizes and sample
+//              periods of rip_config; monitor i drives
+//              feature[i*RO_FEATURE_BITS +: RO_FEATURE_BITS]
+module rip_ring_oscillator_bank
+    import rip_config::*;
+    import rip_branch_predictor_const::*;
+(
+    input wire clk,
+    input wire rstn,
+    output logic [RO_FEATURE_NUM-1:0] feature
+);
+
+    generate
+        for (genvar i = 0; i < BP_RO_NUM; i++) begin : g_ro
+            rip_ring_oscillator_monitor #(
+                .INVERTER_DELAY(1),
+                .RO_SIZE(BP_RO_SIZE[i]),
+                .RO_DATAWIDTH(32),
+                .RO_SAMPLE_CYCLE(BP_RO_SAMPLE_CYCLE[i]),
+                .FEATURE(BP_RO_FEATURE),
+                .QUANT_BITS(BP_RO_QUANT_BITS),
+                .QUANT_STEP(BP_RO_QUANT_STEP),
+                .STREAM(i)
+            ) monitor (
+                .clk(clk),
+                .rstn(rstn),
+                .feature(feature[i*RO_FEATURE_BITS +: RO_FEATURE_BITS])
+            );
+        end
+    endgenerate
+
+endmodule
+
+`default_nettype wire
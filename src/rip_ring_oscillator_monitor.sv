@@ -2,27 +2,58 @@
 `timescale 1ns / 1ps
 
 // Module: rip_ring_oscillator_monitor
-// Description: returns if RO count delta2qaz3wesx increased from the previous sample cycle
-module rip_ring_oscillator_monitor #(
+// Description: counts RO edges over RO_SAMPLE_CYCLE cycles and encodes the count
+//              as FEATURE (see rip_config): whether it grew since the previous
+//              sample, whether it is above its running mean, or a thermometer
+//              code of it around the mean.
+//              Verilator builds count the edges of rip_ring_oscillator_stub.
+module rip_ring_oscillator_monitor
+    import rip_config::*;
+#(
     parameter INVERTER_DELAY = 1,
     parameter RO_SIZE = 3, // # of NOT gates (odd, >=3)
     parameter RO_DATAWIDTH = 32,
-    parameter RO_SAMPLE_CYCLE = 100
+    parameter RO_SAMPLE_CYCLE = 100,
+    parameter ro_feature_t FEATURE = RO_SDELTA,
+    parameter QUANT_BITS = 3, // RO_QUANT: # of thresholds
+    parameter QUANT_STEP = 4, // RO_QUANT: edges between thresholds
+    parameter STREAM = 0, // Verilator model: jitter stream of this RO
+    localparam FEATURE_BITS = FEATURE == RO_QUANT ? QUANT_BITS : 1
 ) (
     input wire clk,
     input wire rstn,
-    output logic sdelta // second delta (delta of delta)
+    output logic [FEATURE_BITS-1:0] feature
 );
 
+    // running mean of the count with MEAN_FRAC fraction bits, weight 1/2^MEAN_SHIFT
+    localparam MEAN_FRAC = 4;
+    localparam MEAN_SHIFT = 3;
+
     logic [$clog2(RO_SAMPLE_CYCLE):0] sample_cycle_cnt;
+    logic sampled; // cnt_prev and mean hold a sample
 
     logic [RO_DATAWIDTH-1:0] cnt;
     logic [RO_DATAWIDTH-1:0] cnt_prev;
     logic signed [RO_DATAWIDTH:0] cnt_delta;
     logic signed [RO_DATAWIDTH:0] cnt_delta_prev;
+    logic signed [RO_DATAWIDTH+MEAN_FRAC+1:0] mean;
+    logic signed [RO_DATAWIDTH+MEAN_FRAC+1:0] deviation;
 
     assign cnt_delta = cnt - cnt_prev;
+    assign deviation = (cnt_delta <<< MEAN_FRAC) - mean;
 
+`ifdef VERILATOR
+    rip_ring_oscillator_stub #(
+        .INVERTER_DELAY(INVERTER_DELAY),
+        .RO_SIZE(RO_SIZE),
+        .RO_DATAWIDTH(RO_DATAWIDTH),
+        .STREAM(STREAM)
+    ) ro_inst (
+        .clk(clk),
+        .rstn(rstn),
+        .cnt(cnt)
+    );
+`else
     logic ro;
 
     (* DONT_TOUCH = "yes" *)
@@ -41,19 +72,37 @@ module rip_ring_oscillator_monitor #(
             cnt <= cnt + 1'b1;
         end
     end
+`endif
+
+    // threshold k of RO_QUANT, symmetric around the mean
+    function automatic logic signed [RO_DATAWIDTH+MEAN_FRAC+1:0] threshold(input int k);
+        return ((2 * k + 1 - QUANT_BITS) * QUANT_STEP) <<< (MEAN_FRAC - 1);
+    endfunction
 
     always_ff @(posedge clk) begin
         if (~rstn) begin
             sample_cycle_cnt <= '0;
+            sampled <= 1'b0;
             cnt_prev <= '0;
             cnt_delta_prev <= '0;
-            sdelta <= '0;
+            mean <= '0;
+            feature <= '0;
         end else begin
             if (sample_cycle_cnt == RO_SAMPLE_CYCLE) begin
                 sample_cycle_cnt <= '0;
+                sampled <= 1'b1;
                 cnt_prev <= cnt;
                 cnt_delta_prev <= cnt_delta;
-                sdelta <= (cnt_delta_prev <= cnt_delta);
+                mean <= sampled ? mean + (deviation >>> MEAN_SHIFT) : cnt_delta <<< MEAN_FRAC;
+                case (FEATURE)
+                    RO_DELTA_SIGN: feature <= FEATURE_BITS'(deviation >= 0);
+                    RO_QUANT: begin
+                        for (int k = 0; k < FEATURE_BITS; k++) begin
+                            feature[k] <= deviation >= threshold(k);
+                        end
+                    end
+                    default: feature <= FEATURE_BITS'(cnt_delta_prev <= cnt_delta);
+                endcase
             end else begin
                 sample_cycle_cnt <= sample_cycle_cnt + 1'b1;
             end
@@ -0,0 +1,203 @@
+/*
+ * Module `rip_rvc_expander`
+ *
+ * Expands RV32C instructions into their 32-bit equivalents in front of `rip_decode`.
+ * Reserved encodings and the floating-point loads and stores expand to 32'h0,
+ * which decodes as no instruction.
+ */
+
+`default_nettype none
+`timescale 1ns / 1ps
+
+module rip_rvc_expander (
+    // fetched instruction; a compressed one is in [15:0]
+    input wire [31:0] fetch_code,
+
+    output logic compressed,
+    output logic [31:0] inst_code
+);
+    localparam bit [6:0] OPCODE_LOAD = 7'b0000011;
+    localparam bit [6:0] OPCODE_STORE = 7'b0100011;
+    localparam bit [6:0] OPCODE_OP_IMM = 7'b0010011;
+    localparam bit [6:0] OPCODE_OP = 7'b0110011;
+    localparam bit [6:0] OPCODE_LUI = 7'b0110111;
+    localparam bit [6:0] OPCODE_BRANCH = 7'b1100011;
+    localparam bit [6:0] OPCODE_JALR = 7'b1100111;
+    localparam bit [6:0] OPCODE_JAL = 7'b1101111;
+    localparam bit [31:0] EBREAK = 32'h00100073;
+
+    localparam bit [4:0] ZERO = 5'd0;
+    localparam bit [4:0] RA = 5'd1;
+    localparam bit [4:0] SP = 5'd2;
+
+    function automatic logic [31:0] r_type(input logic [6:0] funct7, input logic [4:0] rs2,
+                                           input logic [4:0] rs1, input logic [2:0] funct3,
+                                           input logic [4:0] rd);
+        r_type = {funct7, rs2, rs1, funct3, rd, OPCODE_OP};
+    endfunction
+
+    function automatic logic [31:0] i_type(input logic [11:0] imm, input logic [4:0] rs1,
+                                           input logic [2:0] funct3, input logic [4:0] rd,
+                                           input logic [6:0] opcode);
+        i_type = {imm, rs1, funct3, rd, opcode};
+    endfunction
+
+    function automatic logic [31:0] s_type(input logic [11:0] imm, input logic [4:0] rs2,
+                                           input logic [4:0] rs1);
+        s_type = {imm[11:5], rs2, rs1, 3'b010, imm[4:0], OPCODE_STORE};
+    endfunction
+
+    function automatic logic [31:0] b_type(input logic [12:0] imm, input logic [4:0] rs1,
+                                           input logic [2:0] funct3);
+        b_type = {imm[12], imm[10:5], ZERO, rs1, funct3, imm[4:1], imm[11], OPCODE_BRANCH};
+    endfunction
+
+    function automatic logic [31:0] j_type(input logic [20:0] imm, input logic [4:0] rd);
+        j_type = {imm[20], imm[10:1], imm[11], imm[19:12], rd, OPCODE_JAL};
+    endfunction
+
+    logic [15:0] c;
+    logic [2:0] funct3;
+    logic [4:0] rd;  // also rs1
+    logic [4:0] rs2;
+    logic [4:0] rd_p;  // rd', also rs2'
+    logic [4:0] rs1_p;  // rs1', also rd'
+
+    logic [2:0] funct3_ca;  // c.sub, c.xor, c.or, c.and
+
+    logic [11:0] imm_ci;  // c.addi, c.li, c.andi
+    logic [11:0] imm_addi4spn;
+    logic [11:0] imm_addi16sp;
+    logic [19:0] imm_lui;
+    logic [11:0] imm_lw;  // c.lw, c.sw
+    logic [11:0] imm_lwsp;
+    logic [11:0] imm_swsp;
+    logic [20:0] imm_j;
+    logic [12:0] imm_b;
+
+    assign c = fetch_code[15:0];
+    assign funct3 = c[15:13];
+    assign rd = c[11:7];
+    assign rs2 = c[6:2];
+    assign rd_p = {2'b01, c[4:2]};
+    assign rs1_p = {2'b01, c[9:7]};
+    assign funct3_ca = c[6:5] == 2'b00 ? 3'b000 : {1'b1, c[6], c[6] & c[5]};
+
+    assign imm_ci = {{7{c[12]}}, c[6:2]};
+    assign imm_addi4spn = {2'b0, c[10:7], c[12:11], c[5], c[6], 2'b0};
+    assign imm_addi16sp = {{3{c[12]}}, c[4:3], c[5], c[2], c[6], 4'b0};
+    assign imm_lui = {{15{c[12]}}, c[6:2]};
+    assign imm_lw = {5'b0, c[5], c[12:10], c[6], 2'b0};
+    assign imm_lwsp = {4'b0, c[3:2], c[12], c[6:4], 2'b0};
+    assign imm_swsp = {4'b0, c[8:7], c[12:9], 2'b0};
+    assign imm_j = {{10{c[12]}}, c[8], c[10:9], c[6], c[7], c[2], c[11], c[5:3], 1'b0};
+    assign imm_b = {{5{c[12]}}, c[6:5], c[2], c[11:10], c[4:3], 1'b0};
+
+    assign compressed = fetch_code[1:0] != 2'b11;
+
+    always_comb begin
+        inst_code = 32'h0;
+
+        if (!compressed) begin
+            inst_code = fetch_code;
+        end
+        else begin
+            case ({c[1:0], funct3})
+                // quadrant 0
+                5'b00_000: begin  // c.addi4spn
+                    if (c[12:5] != 8'h0) begin
+                        inst_code = i_type(imm_addi4spn, SP, 3'b000, rd_p, OPCODE_OP_IMM);
+                    end
+                end
+                5'b00_010: inst_code = i_type(imm_lw, rs1_p, 3'b010, rd_p, OPCODE_LOAD);  // c.lw
+                5'b00_110: inst_code = s_type(imm_lw, rd_p, rs1_p);  // c.sw
+
+                // quadrant 1
+                5'b01_000: inst_code = i_type(imm_ci, rd, 3'b000, rd, OPCODE_OP_IMM);  // c.addi
+                5'b01_001: inst_code = j_type(imm_j, RA);  // c.jal
+                5'b01_010: inst_code = i_type(imm_ci, ZERO, 3'b000, rd, OPCODE_OP_IMM);  // c.li
+                5'b01_011: begin
+                    if (rd == SP) begin  // c.addi16sp
+                        if (imm_addi16sp != 12'h0) begin
+                            inst_code = i_type(imm_addi16sp, SP, 3'b000, SP, OPCODE_OP_IMM);
+                        end
+                    end
+                    else if (imm_lui != 20'h0) begin  // c.lui
+                        inst_code = {imm_lui, rd, OPCODE_LUI};
+                    end
+                end
+                5'b01_100: begin
+                    case (c[11:10])
+                        2'b00: begin  // c.srli
+                            if (!c[12]) begin
+                                inst_code = i_type({7'b0000000, rs2}, rs1_p, 3'b101, rs1_p,
+                                                   OPCODE_OP_IMM);
+                            end
+                        end
+                        2'b01: begin  // c.srai
+                            if (!c[12]) begin
+                                inst_code = i_type({7'b0100000, rs2}, rs1_p, 3'b101, rs1_p,
+                                                   OPCODE_OP_IMM);
+                            end
+                        end
+                        2'b10: begin  // c.andi
+                            inst_code = i_type(imm_ci, rs1_p, 3'b111, rs1_p, OPCODE_OP_IMM);
+                        end
+                        default: begin  // c.sub, c.xor, c.or, c.and
+                            if (!c[12]) begin
+                                inst_code = r_type(c[6:5] == 2'b00 ? 7'b0100000 : 7'b0000000,
+                                                   rd_p, rs1_p, funct3_ca, rs1_p);
+                            end
+                        end
+                    endcase
+                end
+                5'b01_101: inst_code = j_type(imm_j, ZERO);  // c.j
+                5'b01_110: inst_code = b_type(imm_b, rs1_p, 3'b000);  // c.beqz
+                5'b01_111: inst_code = b_type(imm_b, rs1_p, 3'b001);  // c.bnez
+
+                // quadrant 2
+                5'b10_000: begin  // c.slli
+                    if (!c[12]) begin
+                        inst_code = i_type({7'b0000000, rs2}, rd, 3'b001, rd, OPCODE_OP_IMM);
+                    end
+                end
+                5'b10_010: begin  // c.lwsp
+                    if (rd != ZERO) begin
+                        inst_code = i_type(imm_lwsp, SP, 3'b010, rd, OPCODE_LOAD);
+                    end
+                end
+                5'b10_100: begin
+                    if (!c[12]) begin
+                        if (rs2 == ZERO) begin  // c.jr
+                            if (rd != ZERO) begin
+                                inst_code = i_type(12'h0, rd, 3'b000, ZERO, OPCODE_JALR);
+                            end
+                        end
+                        else begin  // c.mv
+                            inst_code = r_type(7'b0000000, rs2, ZERO, 3'b000, rd);
+                        end
+                    end
+                    else begin
+                        if (rs2 == ZERO) begin
+                            if (rd == ZERO) begin  // c.ebreak
+                                inst_code = EBREAK;
+                            end
+                            else begin  // c.jalr
+                                inst_code = i_type(12'h0, rd, 3'b000, RA, OPCODE_JALR);
+                            end
+                        end
+                        else begin  // c.add
+                            inst_code = r_type(7'b0000000, rs2, rd, 3'b000, rd);
+                        end
+                    end
+                end
+                5'b10_110: inst_code = s_type(imm_swsp, rs2, SP);  // c.swsp
+
+                // c.fld, c.flw, c.fsd, c.fsw and their stack-pointer forms
+                default: inst_code = 32'h0;
+            endcase
+        end
+    end
+endmodule : rip_rvc_expander
+
+`default_nettype wire
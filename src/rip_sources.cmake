@@ -0,0 +1,60 @@
+# SystemVerilog sources of the core, shared by the Verilator builds in test/
+# and the synthesis flow in synth/. Packages come first in every build:
+#
+#   ${RIP_PACKAGE_SOURCES} [${RIP_AXI_SOURCES}] ${RIP_CORE_SOURCES}
+#
+# plus ${RIP_VERILATOR_STUB_SOURCES} or ${RIP_SYNTH_SOURCES}, and
+# ${RIP_MMU_STUB_SOURCES} for Verilator cores without RIP_AXI_MEMORY.
+
+set(RIP_SRC_DIR ${CMAKE_CURRENT_LIST_DIR})
+
+set(RIP_PACKAGE_SOURCES
+  ${RIP_SRC_DIR}/rip_const.sv
+  ${RIP_SRC_DIR}/rip_config.sv
+  ${RIP_SRC_DIR}/rip_type.sv
+  ${RIP_SRC_DIR}/rip_branch_predictor_const.sv
+  ${RIP_SRC_DIR}/rip_reservoir_const.sv
+)
+
+# the AXI memory path
+set(RIP_AXI_SOURCES
+  ${RIP_SRC_DIR}/rip_axi_interface_const.sv
+  ${RIP_SRC_DIR}/rip_axi_interface.sv
+  ${RIP_SRC_DIR}/rip_axi_master.sv
+  ${RIP_SRC_DIR}/rip_fifo_async.sv
+  ${RIP_SRC_DIR}/rip_axi_master_async.sv
+  ${RIP_SRC_DIR}/rip_memory_management_unit.sv
+)
+
+set(RIP_CORE_SOURCES
+  ${RIP_SRC_DIR}/rip_2r1w_bram.sv
+  ${RIP_SRC_DIR}/rip_adder_tree.sv
+  ${RIP_SRC_DIR}/rip_ring_oscillator_monitor.sv
+  ${RIP_SRC_DIR}/rip_ring_oscillator_bank.sv
+  ${RIP_SRC_DIR}/rip_branch_predictor.sv
+  ${RIP_SRC_DIR}/rip_reservoir.sv
+  ${RIP_SRC_DIR}/rip_alu.sv
+  ${RIP_SRC_DIR}/rip_regfile.sv
+  ${RIP_SRC_DIR}/rip_csr.sv
+  ${RIP_SRC_DIR}/rip_memory_access.sv
+  ${RIP_SRC_DIR}/rip_fetch_buffer.sv
+  ${RIP_SRC_DIR}/rip_rvc_expander.sv
+  ${RIP_SRC_DIR}/rip_decode.sv
+  ${RIP_SRC_DIR}/rip_hazard_unit.sv
+  ${RIP_SRC_DIR}/rip_forwarding_unit.sv
+  ${RIP_SRC_DIR}/rip_branch_unit.sv
+  ${RIP_SRC_DIR}/rip_core.sv
+)
+
+# behavioral models for what Verilator cannot run
+set(RIP_VERILATOR_STUB_SOURCES
+  ${RIP_SRC_DIR}/stub/rip_ring_oscillator_stub.sv
+)
+set(RIP_MMU_STUB_SOURCES
+  ${RIP_SRC_DIR}/stub/rip_mmu_stub.sv
+)
+
+# what synthesis uses instead of the stubs
+set(RIP_SYNTH_SOURCES
+  ${RIP_SRC_DIR}/rip_ring_oscillator.sv
+)
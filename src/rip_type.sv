@@ -68,17 +68,75 @@ package rip_type;
         logic REM;
         logic REMU;
 
+        // Zba
+        logic SH1ADD;
+        logic SH2ADD;
+        logic SH3ADD;
+
+        // Zbb
+        logic ANDN;
+        logic ORN;
+        logic XNOR;
+        logic CLZ;
+        logic CTZ;
+        logic CPOP;
+        logic MAX;
+        logic MAXU;
+        logic MIN;
+        logic MINU;
+        logic SEXT_B;
+        logic SEXT_H;
+        logic ZEXT_H;
+        logic ROL;
+        logic ROR;
+        logic RORI;
+        logic ORC_B;
+        logic REV8;
+
+        // RV32A subset
+        // opcode ... 7'b0101111, funct3 ... 3'b010
+        // aq/rl are ignored; the core has one memory access in flight at a time
+        logic LR_W;
+        logic SC_W;
+        logic AMOSWAP_W;
+        logic AMOADD_W;
+        logic AMOOR_W;
+
         // Custom
         // opcode  ... 7'b0001011
         // funct12 ... EXTX: 12'b0, EXT: 12'b1
         logic EXTX;
         logic EXT;
+        // opcode  ... 7'b0101011 (custom-1, R-type)
+        // funct7  ... reservoir coprocessor command (see rip_reservoir_const)
+        logic RC;
+
+        // P extension subset (packed SIMD)
+        // opcode ... 7'b1110111
+        logic ADD8;
+        logic SUB8;
+        logic ADD16;
+        logic SUB16;
+        logic KADD8;
+        logic KSUB8;
+        logic KADD16;
+        logic KSUB16;
+        logic UKADD8;
+        logic UKSUB8;
+        logic UKADD16;
+        logic UKSUB16;
+        logic SMAQA;
+        logic UMAQA;
+        logic KMDA;
+        logic KMADA;
 
         // pipeline control signals
         logic ACCESS_MEM;
         logic UPDATE_REG;
         logic UPDATE_CSR;
         logic UPDATE_PC;
+        // expanded from a 16-bit RV32C instruction (links and falls through to pc + 2)
+        logic COMPRESSED;
     } inst_t;
 
     typedef struct packed {
@@ -87,12 +145,35 @@ package rip_type;
         logic READY;
     } state_t;
 
+    // source of an operand in DE, one-hot (rip_forwarding_unit)
+    typedef struct packed {
+        logic EX;
+        logic MA;
+        logic WB;
+        logic RF;
+    } fwd_sel_t;
+
     typedef struct packed {
         logic [31:0] mstatus;
+        logic [31:0] mie;
+        logic [31:0] mip;
         logic [31:0] mtvec;
         logic [31:0] mepc;
         logic [31:0] mcause;
         logic [31:0] cycle;
+        logic [63:0] mtime;
+        logic [63:0] mtimecmp;
+
+        // mailbox ring indices, see sw/rip_mailbox.h
+        logic [31:0] mbox_cmd_head;
+        logic [31:0] mbox_res_tail;
+        logic [31:0] mbox_cmd_tail;  // read only
+        logic [31:0] mbox_res_head;  // read only
+
+        // branch predictor table and history access
+        logic [31:0] bpidx;
+        logic [31:0] bpdat;
+        logic [31:0] bphist;
 
         // custom read only registers
         // Branch Prediction -- [True, False] [Positive, Negative]
@@ -100,8 +181,33 @@ package rip_type;
         logic [31:0] bptn;
         logic [31:0] bpfp;
         logic [31:0] bpfn;
+        // cycles lost to branch mispredictions
+        logic [31:0] bpmc;
+        // Hazard unit -- stalls taken, stalls avoided by operand-use decoding
+        logic [31:0] hzst;
+        logic [31:0] hzav;
     } csr_t;
     
+    // atomic memory operation that qualifies re_1 (LR and AMOs) or we_1 (SC)
+    // on the data port of the memory system
+    typedef enum logic [2:0] {
+        AMO_NONE = 3'b000,
+        AMO_LR   = 3'b001,
+        AMO_SC   = 3'b010,
+        AMO_SWAP = 3'b011,
+        AMO_ADD  = 3'b100,
+        AMO_OR   = 3'b101
+    } amo_op_t;
+
+    // the word an AMO writes back, from the old memory word and rs2
+    function automatic logic [31:0] amo_result(amo_op_t op, logic [31:0] mem, logic [31:0] src);
+        case (op)
+            AMO_ADD: return mem + src;
+            AMO_OR:  return mem | src;
+            default: return src;
+        endcase
+    endfunction
+
     typedef enum logic [1:0] {
         FINISHED = 2'b00,
         RUNNING  = 2'b01,
@@ -3,6 +3,9 @@
 
 // Module: rip_mmu_stub
 // Description: byte addressing memory system stub.
+//              Verilator builds back the memory with a sparse C++ model through DPI.
+//              There is a single core, so LR/SC only needs the local reservation
+//              and an AMO is a read and a write in the same cycle.
 module rip_mmu_stub
     import rip_const::*;
     import rip_type::*;
@@ -19,21 +22,50 @@ module rip_mmu_stub
     input wire [DATA_WIDTH-1:0] addr_1,
     input wire [DATA_WIDTH-1:0] addr_2,
     input wire [DATA_WIDTH-1:0] din_1,
+    input amo_op_t amo_1,
     output logic [DATA_WIDTH-1:0] dout_1,
     output logic [DATA_WIDTH-1:0] dout_2,
     output wire busy_1,
     output wire busy_2
 );
+`ifdef VERILATOR
+    // sparse C++ memory (test/sparse_memory.cpp); only touched pages are allocated
+    import "DPI-C" function chandle rip_sparse_mem_open(input string default_hex);
+    import "DPI-C" function void rip_sparse_mem_close(input chandle mem);
+    import "DPI-C" function int unsigned rip_sparse_mem_read(
+        input chandle mem,
+        input int unsigned word_addr
+    );
+    import "DPI-C" function void rip_sparse_mem_write(
+        input chandle mem,
+        input int unsigned word_addr,
+        input int unsigned data,
+        input byte unsigned strb
+    );
+
+    chandle mem_handle;
+
+    // word address in the memory: the sparse memory has no size of its own,
+    // so it wraps at ADDR_WIDTH bits like mem_block
+    function automatic int unsigned mem_word(input logic [31:0] word_addr);
+        return 32'(word_addr[ADDR_WIDTH-1:0]);
+    endfunction
+
+    initial begin
+        mem_handle = rip_sparse_mem_open("../../hex/testcase.hex");
+    end
+
+    final begin
+        rip_sparse_mem_close(mem_handle);
+    end
+`else
     (* ram_style = "block" *)
     reg [DATA_WIDTH-1:0] mem_block[1<<ADDR_WIDTH];
 
     initial begin
-`ifdef VERILATOR
-        $readmemh("../../hex/testcase.hex", mem_block);
-`else
         $readmemh("../../hex/fib.hex", mem_block);
-`endif  // VERILATOR
     end
+`endif  // VERILATOR
 
     logic [31:0] addr_1_word;
     logic [31:0] addr_2_word;
@@ -43,6 +75,13 @@ module rip_mmu_stub
     logic [31:0] addr_1_buf_w;
     logic [31:0] addr_2_buf;
     logic [31:0] din_1_buf;
+    amo_op_t amo_1_buf_r;
+    amo_op_t amo_1_buf_w;
+    logic [31:0] amo_src_buf;
+
+    // LR reservation (word address)
+    logic resv_valid;
+    logic [31:0] resv_addr;
 
     logic [ 2:0] busy_1_cnt_r;
     logic [ 2:0] busy_1_cnt_w;
@@ -61,49 +100,92 @@ module rip_mmu_stub
             busy_1_cnt_w <= 0;
             busy_2_cnt <= 0;
             din_1_buf <= 0;
+            resv_valid <= 0;
         end
         else begin
             if (re_1 & !busy_1) begin
                 addr_1_buf_r <= addr_1_word;
+                amo_1_buf_r <= amo_1;
+                amo_src_buf <= din_1;
                 busy_1_cnt_r <= 3'd1;
             end
             else if (0 < busy_1_cnt_r & busy_1_cnt_r < BUSY_1_CNT_MAX) begin
                 busy_1_cnt_r <= busy_1_cnt_r + 1;
             end
             else if (busy_1_cnt_r == BUSY_1_CNT_MAX) begin
+`ifdef VERILATOR
+                dout_1 <= rip_sparse_mem_read(mem_handle, mem_word(addr_1_buf_r));
+`else
                 dout_1 <= mem_block[addr_1_buf_r];
+`endif  // VERILATOR
+                if (amo_1_buf_r == AMO_LR) begin
+                    resv_valid <= 1;
+                    resv_addr <= addr_1_buf_r;
+                end
                 busy_1_cnt_r <= 0;
             end
 
+            if (re_2 & !busy_2) begin
+                addr_2_buf <= addr_2_word;
+                busy_2_cnt <= 3'd1;
+            end
+            else if (busy_2 && busy_2_cnt < BUSY_2_CNT_MAX) begin
+                busy_2_cnt <= busy_2_cnt + 1;
+            end
+            else if (busy_2_cnt == BUSY_2_CNT_MAX) begin
+`ifdef VERILATOR
+                dout_2 <= rip_sparse_mem_read(mem_handle, mem_word(addr_2_buf));
+`else
+                dout_2 <= mem_block[addr_2_buf];
+`endif  // VERILATOR
+                busy_2_cnt <= 0;
+            end
+
+            // writes come last so that DPI reads in the same cycle see the old data,
+            // as nonblocking array updates do
+            if (busy_1_cnt_r == BUSY_1_CNT_MAX && amo_1_buf_r != AMO_NONE &&
+                amo_1_buf_r != AMO_LR) begin
+`ifdef VERILATOR
+                rip_sparse_mem_write(
+                    mem_handle, mem_word(addr_1_buf_r),
+                    amo_result(amo_1_buf_r, rip_sparse_mem_read(mem_handle, mem_word(addr_1_buf_r)),
+                               amo_src_buf), 8'hF);
+`else
+                mem_block[addr_1_buf_r] <= amo_result(amo_1_buf_r, mem_block[addr_1_buf_r],
+                                                      amo_src_buf);
+`endif  // VERILATOR
+            end
+
             if (we_1 != 0 & !busy_1) begin
                 we_1_buf <= we_1;
                 addr_1_buf_w <= addr_1_word;
                 din_1_buf <= din_1;
+                amo_1_buf_w <= amo_1;
                 busy_1_cnt_w <= 3'd1;
             end
             else if (0 < busy_1_cnt_w & busy_1_cnt_w < BUSY_1_CNT_MAX) begin
                 busy_1_cnt_w <= busy_1_cnt_w + 1;
             end
             else if (busy_1_cnt_w == BUSY_1_CNT_MAX) begin
-                for (integer i = 0; i < 4; i = i + 1) begin
-                    if (we_1_buf[i]) begin
-                        mem_block[addr_1_buf_w][i*8+:8] <= din_1_buf[i*8+:8];
+                // SC writes only while the reservation holds and answers 0 on success
+                if (amo_1_buf_w != AMO_SC || (resv_valid && resv_addr == addr_1_buf_w)) begin
+`ifdef VERILATOR
+                    rip_sparse_mem_write(mem_handle, mem_word(addr_1_buf_w), din_1_buf,
+                                         {4'b0, we_1_buf});
+`else
+                    for (integer i = 0; i < 4; i = i + 1) begin
+                        if (we_1_buf[i]) begin
+                            mem_block[addr_1_buf_w][i*8+:8] <= din_1_buf[i*8+:8];
+                        end
                     end
+`endif  // VERILATOR
+                end
+                if (amo_1_buf_w == AMO_SC) begin
+                    dout_1 <= {31'b0, !(resv_valid && resv_addr == addr_1_buf_w)};
+                    resv_valid <= 0;
                 end
                 busy_1_cnt_w <= 0;
             end
-
-            if (re_2 & !busy_2) begin
-                addr_2_buf <= addr_2_word;
-                busy_2_cnt <= 3'd1;
-            end
-            else if (busy_2 && busy_2_cnt < BUSY_2_CNT_MAX) begin
-                busy_2_cnt <= busy_2_cnt + 1;
-            end
-            else if (busy_2_cnt == BUSY_2_CNT_MAX) begin
-                dout_2 <= mem_block[addr_2_buf];
-                busy_2_cnt <= 0;
-            end
         end
     end
 endmodule
@@ -0,0 +1,82 @@
+`default_nettype none
+`timescale 1ns / 1ps
+
+// Module: rip_ring_oscillator_stub
+// Description: behavioral ring oscillator and edge counter for Verilator, which
+//              cannot run the combinational loop of rip_ring_oscillator.
+//              Each clock cycle adds the edges of one CLK_PERIOD to a phase
+//              with PHASE_FRAC fraction bits: the nominal RO_SIZE-inverter rate,
+//              plus a slow random walk of up to DRIFT and white jitter of up to
+//              JITTER (both in 1/2^PHASE_FRAC edges per cycle). The randomness is
+//              a xorshift32 stream seeded by BP_RO_SEED, or +bp_ro_seed=<n>, and
+//              STREAM, so the same seed gives the same counts in every run.
+module rip_ring_oscillator_stub
+    import rip_config::*;
+#(
+    parameter INVERTER_DELAY = 1,
+    parameter RO_SIZE = 3, // # of NOT gates (odd, >=3)
+    parameter RO_DATAWIDTH = 32,
+    parameter CLK_PERIOD = 10, // in INVERTER_DELAY units
+    parameter JITTER = 32,
+    parameter DRIFT = 16,
+    parameter STREAM = 0
+) (
+    input wire clk,
+    input wire rstn,
+    output logic [RO_DATAWIDTH-1:0] cnt
+);
+
+    localparam PHASE_FRAC = 8;
+    localparam int RATE = (CLK_PERIOD << PHASE_FRAC) / (2 * RO_SIZE * INVERTER_DELAY);
+    localparam DRIFT_INTERVAL = 256; // cycles per random walk step
+
+    logic [RO_DATAWIDTH+PHASE_FRAC-1:0] phase;
+    logic [31:0] rand_state;
+    logic [31:0] rand_next;
+    logic signed [15:0] drift;
+    logic signed [15:0] jitter;
+    logic [$clog2(DRIFT_INTERVAL)-1:0] drift_cycle_cnt;
+
+    int unsigned seed;
+    initial begin
+        seed = BP_RO_SEED;
+        void'($value$plusargs("bp_ro_seed=%d", seed));
+    end
+
+    function automatic logic [31:0] xorshift32(input logic [31:0] x);
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        return x;
+    endfunction
+
+    assign rand_next = xorshift32(rand_state);
+    // signed byte of the stream scaled to +-JITTER
+    assign jitter = 16'((32'(signed'(rand_state[15:8])) * JITTER) >>> 7);
+
+    assign cnt = phase[RO_DATAWIDTH+PHASE_FRAC-1:PHASE_FRAC];
+
+    always_ff @(posedge clk) begin
+        if (~rstn) begin
+            phase <= '0;
+            // xorshift32 sticks at zero
+            rand_state <= (seed ^ (32'(STREAM) * 32'h9E3779B9)) | 32'h1;
+            drift <= '0;
+            drift_cycle_cnt <= '0;
+        end else begin
+            phase <= phase + (RO_DATAWIDTH+PHASE_FRAC)'(signed'(RATE + drift + jitter));
+            rand_state <= rand_next;
+            drift_cycle_cnt <= drift_cycle_cnt + 1'b1;
+            if (drift_cycle_cnt == '1) begin
+                if (rand_state[0] && drift < DRIFT) begin
+                    drift <= drift + 1'b1;
+                end else if (!rand_state[0] && drift > -DRIFT) begin
+                    drift <= drift - 1'b1;
+                end
+            end
+        end
+    end
+
+endmodule
+
+`default_nettype wire
@@ -0,0 +1,99 @@
+/*
+ * Host <-> core mailbox: a command ring and a result ring in shared memory.
+ *
+ * Both rings live in the program's region (addresses are offsets from
+ * mem_head, like every data access of the core). Each side owns one index of
+ * each ring and only reads the other:
+ *
+ *   ring     producer  consumer  core CSR (producer / consumer)
+ *   command  host      core      MBOX_CMD_TAIL (ro) / MBOX_CMD_HEAD
+ *   result   core      host      MBOX_RES_TAIL      / MBOX_RES_HEAD (ro)
+ *
+ * Indices count entries and wrap at 2^32; entry i is at slot i % ENTRIES.
+ * The host indices are doorbells on rip_core (mbox_cmd_tail, mbox_res_head)
+ * and the core indices are outputs (mbox_cmd_head, mbox_res_tail), so neither
+ * side polls memory. A producer writes the entry before it bumps its index.
+ * mip bit 16 is pending while the command ring is not empty, and the board
+ * wrapper's mbox_irq is high while the result ring is not empty.
+ *
+ * This file is shared by programs running on the core and by the host side
+ * (test/mailbox_host.cpp); the CSR helpers are only built for RISC-V.
+ */
+#ifndef RIP_MAILBOX_H
+#define RIP_MAILBOX_H
+
+#include <stdint.h>
+
+#define RIP_MBOX_BASE 0x01000000u
+#define RIP_MBOX_ENTRIES 64u /* power of two */
+#define RIP_MBOX_ENTRY_SIZE 16u
+#define RIP_MBOX_CMD_RING RIP_MBOX_BASE
+#define RIP_MBOX_RES_RING (RIP_MBOX_BASE + RIP_MBOX_ENTRIES * RIP_MBOX_ENTRY_SIZE)
+
+#define RIP_MBOX_CSR_CMD_HEAD 0x7C2
+#define RIP_MBOX_CSR_RES_TAIL 0x7C3
+#define RIP_MBOX_CSR_CMD_TAIL 0xFC4
+#define RIP_MBOX_CSR_RES_HEAD 0xFC5
+#define RIP_MBOX_IRQ 16
+
+/* larger payloads are passed by offset in arg0/arg1 */
+typedef struct {
+    uint32_t tag;
+    uint32_t op;
+    uint32_t arg0;
+    uint32_t arg1;
+} rip_mbox_cmd_t;
+
+typedef struct {
+    uint32_t tag;
+    uint32_t status;
+    uint32_t val0;
+    uint32_t val1;
+} rip_mbox_res_t;
+
+#define RIP_MBOX_CMD_ADDR(index) \
+    (RIP_MBOX_CMD_RING + ((index) & (RIP_MBOX_ENTRIES - 1)) * RIP_MBOX_ENTRY_SIZE)
+#define RIP_MBOX_RES_ADDR(index) \
+    (RIP_MBOX_RES_RING + ((index) & (RIP_MBOX_ENTRIES - 1)) * RIP_MBOX_ENTRY_SIZE)
+
+#ifdef __riscv
+
+#define RIP_MBOX_CSRR(csr)                                      \
+    ({                                                          \
+        uint32_t _v;                                            \
+        __asm__ volatile("csrr %0, %1" : "=r"(_v) : "i"(csr)); \
+        _v;                                                     \
+    })
+#define RIP_MBOX_CSRW(csr, value) \
+    __asm__ volatile("csrw %0, %1" : : "i"(csr), "r"((uint32_t)(value)) : "memory")
+
+/* the next command, or NULL if the ring is empty */
+static inline volatile rip_mbox_cmd_t* rip_mbox_peek_cmd(void) {
+    uint32_t head = RIP_MBOX_CSRR(RIP_MBOX_CSR_CMD_HEAD);
+    if (head == RIP_MBOX_CSRR(RIP_MBOX_CSR_CMD_TAIL)) {
+        return 0;
+    }
+    return (volatile rip_mbox_cmd_t*)RIP_MBOX_CMD_ADDR(head);
+}
+
+/* releases the command returned by rip_mbox_peek_cmd() */
+static inline void rip_mbox_pop_cmd(void) {
+    RIP_MBOX_CSRW(RIP_MBOX_CSR_CMD_HEAD, RIP_MBOX_CSRR(RIP_MBOX_CSR_CMD_HEAD) + 1);
+}
+
+/* waits for a free result slot */
+static inline volatile rip_mbox_res_t* rip_mbox_res_slot(void) {
+    uint32_t tail = RIP_MBOX_CSRR(RIP_MBOX_CSR_RES_TAIL);
+    while (tail - RIP_MBOX_CSRR(RIP_MBOX_CSR_RES_HEAD) >= RIP_MBOX_ENTRIES) {
+    }
+    return (volatile rip_mbox_res_t*)RIP_MBOX_RES_ADDR(tail);
+}
+
+/* publishes the slot returned by rip_mbox_res_slot() */
+static inline void rip_mbox_push_res(void) {
+    RIP_MBOX_CSRW(RIP_MBOX_CSR_RES_TAIL, RIP_MBOX_CSRR(RIP_MBOX_CSR_RES_TAIL) + 1);
+}
+
+#endif /* __riscv */
+
+#endif /* RIP_MAILBOX_H */
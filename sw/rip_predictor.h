@@ -0,0 +1,85 @@
+/*
+ * Dump and load of the branch predictor state (src/rip_branch_predictor.sv).
+ *
+ * The table and the global history survive the reset that every `run` pulse
+ * applies to the core, so a kernel that runs many times keeps what the
+ * predictor learned. To carry it further (across a power cycle, or to ship a
+ * trained table with a kernel), a program dumps it into memory, where the host
+ * reads it like any other result, and loads it back at the start of a run.
+ *
+ *   CSR     address  bits
+ *   bpidx   0x7C4    [15:0] entry, [23:16] word of the entry,
+ *                    [30] freeze: branches neither train nor shift the history,
+ *                    [31] bpdat holds the word (read only)
+ *   bpdat   0x7C5    the selected word; a write stores the entry back
+ *   bphist  0x7C6    the newest 32 outcomes of the global history
+ *
+ * Every write to bpidx reads the entry again, so wait for bit 31 before reading
+ * or writing bpdat. An image is the history followed by RIP_BP_WORDS words for
+ * each of RIP_BP_ENTRIES entries; both follow rip_config.sv (BIMODAL and GSHARE
+ * entries are one word, perceptron entries WEIGHT_NUM * WEIGHT_WIDTH bits).
+ */
+#ifndef RIP_PREDICTOR_H
+#define RIP_PREDICTOR_H
+
+#include <stdint.h>
+
+#define RIP_BP_CSR_IDX 0x7C4
+#define RIP_BP_CSR_DAT 0x7C5
+#define RIP_BP_CSR_HIST 0x7C6
+
+#define RIP_BP_IDX_FREEZE (1u << 30)
+#define RIP_BP_IDX_VALID (1u << 31)
+#define RIP_BP_IDX(entry, word) (((uint32_t)(word) & 0xFFu) << 16 | ((uint32_t)(entry) & 0xFFFFu))
+
+#ifndef RIP_BP_ENTRIES
+#define RIP_BP_ENTRIES 1024u /* 2 ** (BP_PC_MSB - BP_PC_LSB + 1) */
+#endif
+#ifndef RIP_BP_WORDS
+#define RIP_BP_WORDS 1u
+#endif
+#define RIP_BP_IMAGE_WORDS (1u + RIP_BP_ENTRIES * RIP_BP_WORDS)
+
+#ifdef __riscv
+
+#define RIP_BP_CSRR(csr)                                        \
+    ({                                                          \
+        uint32_t _v;                                            \
+        __asm__ volatile("csrr %0, %1" : "=r"(_v) : "i"(csr)); \
+        _v;                                                     \
+    })
+#define RIP_BP_CSRW(csr, value) \
+    __asm__ volatile("csrw %0, %1" : : "i"(csr), "r"((uint32_t)(value)) : "memory")
+
+/* selects a word of an entry with training frozen and waits until bpdat holds it */
+static inline void rip_bp_select(uint32_t entry, uint32_t word) {
+    RIP_BP_CSRW(RIP_BP_CSR_IDX, RIP_BP_IDX_FREEZE | RIP_BP_IDX(entry, word));
+    while (!(RIP_BP_CSRR(RIP_BP_CSR_IDX) & RIP_BP_IDX_VALID)) {
+    }
+}
+
+static inline void rip_bp_dump(uint32_t* image) {
+    image[0] = RIP_BP_CSRR(RIP_BP_CSR_HIST);
+    for (uint32_t i = 0; i < RIP_BP_ENTRIES; i++) {
+        for (uint32_t w = 0; w < RIP_BP_WORDS; w++) {
+            rip_bp_select(i, w);
+            image[1 + i * RIP_BP_WORDS + w] = RIP_BP_CSRR(RIP_BP_CSR_DAT);
+        }
+    }
+    RIP_BP_CSRW(RIP_BP_CSR_IDX, 0);
+}
+
+static inline void rip_bp_load(const uint32_t* image) {
+    for (uint32_t i = 0; i < RIP_BP_ENTRIES; i++) {
+        for (uint32_t w = 0; w < RIP_BP_WORDS; w++) {
+            rip_bp_select(i, w);
+            RIP_BP_CSRW(RIP_BP_CSR_DAT, image[1 + i * RIP_BP_WORDS + w]);
+        }
+    }
+    RIP_BP_CSRW(RIP_BP_CSR_HIST, image[0]);
+    RIP_BP_CSRW(RIP_BP_CSR_IDX, 0);
+}
+
+#endif /* __riscv */
+
+#endif /* RIP_PREDICTOR_H */
@@ -0,0 +1,71 @@
+/*
+ * C intrinsics for the packed-SIMD subset of the P extension in rip_alu.
+ *
+ * The instructions use the OP-P opcode (0x77) with the draft P extension
+ * encodings, so they assemble without P support in the toolchain.
+ *   add8/sub8/add16/sub16       : lane-wise add/sub, wrapping
+ *   kadd8/ksub8/kadd16/ksub16   : signed saturating
+ *   ukadd8/uksub8/ukadd16/uksub16 : unsigned saturating
+ *   smaqa/umaqa                 : acc + sum of four 8-bit products
+ *   kmda                        : sum of two 16-bit products, saturating
+ *   kmada                       : acc + sum of two 16-bit products, saturating
+ */
+#ifndef RIP_PSIMD_H
+#define RIP_PSIMD_H
+
+#include <stdint.h>
+
+#define RIP_PSIMD_RR(name, funct3, funct7)                                             \
+    static inline uint32_t rip_##name(uint32_t a, uint32_t b) {                         \
+        uint32_t rd;                                                                    \
+        __asm__(".insn r 0x77, " #funct3 ", " #funct7 ", %0, %1, %2"                    \
+                : "=r"(rd)                                                              \
+                : "r"(a), "r"(b));                                                      \
+        return rd;                                                                      \
+    }
+
+#define RIP_PSIMD_ACC(name, funct3, funct7)                                            \
+    static inline uint32_t rip_##name(uint32_t acc, uint32_t a, uint32_t b) {           \
+        __asm__(".insn r 0x77, " #funct3 ", " #funct7 ", %0, %1, %2"                    \
+                : "+r"(acc)                                                             \
+                : "r"(a), "r"(b));                                                      \
+        return acc;                                                                     \
+    }
+
+RIP_PSIMD_RR(add8, 0, 0x24)
+RIP_PSIMD_RR(sub8, 0, 0x25)
+RIP_PSIMD_RR(add16, 0, 0x20)
+RIP_PSIMD_RR(sub16, 0, 0x21)
+RIP_PSIMD_RR(kadd8, 0, 0x0C)
+RIP_PSIMD_RR(ksub8, 0, 0x0D)
+RIP_PSIMD_RR(kadd16, 0, 0x08)
+RIP_PSIMD_RR(ksub16, 0, 0x09)
+RIP_PSIMD_RR(ukadd8, 0, 0x1C)
+RIP_PSIMD_RR(uksub8, 0, 0x1D)
+RIP_PSIMD_RR(ukadd16, 0, 0x18)
+RIP_PSIMD_RR(uksub16, 0, 0x19)
+RIP_PSIMD_ACC(smaqa, 0, 0x64)
+RIP_PSIMD_ACC(umaqa, 0, 0x66)
+RIP_PSIMD_RR(kmda, 1, 0x1C)
+RIP_PSIMD_ACC(kmada, 1, 0x24)
+
+#undef RIP_PSIMD_RR
+#undef RIP_PSIMD_ACC
+
+/* int8 dot product, four elements per instruction */
+static inline int32_t rip_dot_i8(const int8_t* a, const int8_t* b, uint32_t n) {
+    uint32_t acc = 0;
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        uint32_t x, y;
+        __builtin_memcpy(&x, a + i, 4);
+        __builtin_memcpy(&y, b + i, 4);
+        acc = rip_smaqa(acc, x, y);
+    }
+    for (; i < n; i++) {
+        acc += (uint32_t)(a[i] * b[i]);
+    }
+    return (int32_t)acc;
+}
+
+#endif /* RIP_PSIMD_H */
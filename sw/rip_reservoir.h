@@ -0,0 +1,69 @@
+/*
+ * C intrinsics for the reservoir coprocessor (src/rip_reservoir.sv).
+ *
+ * Every command is a custom-1 R-type instruction with funct7 selecting the
+ * operation; see src/rip_reservoir_const.sv for the semantics.
+ * States and weights are Q4.12 fixed point (1.0 == 0x1000).
+ */
+#ifndef RIP_RESERVOIR_H
+#define RIP_RESERVOIR_H
+
+#include <stdint.h>
+
+#define RIP_RC_OP_CFG 0
+#define RIP_RC_OP_WW 1
+#define RIP_RC_OP_WS 2
+#define RIP_RC_OP_RS 3
+#define RIP_RC_OP_STEP 4
+#define RIP_RC_OP_READ 5
+
+#define RIP_RC_CFG_SIZE 0
+#define RIP_RC_CFG_LEAK 1
+#define RIP_RC_CFG_BASE 2
+#define RIP_RC_CFG_CYCLES 3
+
+#define RIP_RC_ONE 0x1000
+
+/* weight scratchpad entry; set `last` on the final nonzero of each row */
+#define RIP_RC_WEIGHT(last, col, weight)                                   \
+    ((((uint32_t)(last) & 1u) << 31) | (((uint32_t)(col) & 0x7FFFu) << 16) | \
+     ((uint32_t)(weight) & 0xFFFFu))
+
+#define RIP_RC_INSN(funct7, rs1, rs2)                                                  \
+    ({                                                                                  \
+        uint32_t _rd;                                                                   \
+        __asm__ volatile(".insn r 0x2B, 0, %3, %0, %1, %2"                              \
+                         : "=r"(_rd)                                                    \
+                         : "r"((uint32_t)(rs1)), "r"((uint32_t)(rs2)), "i"(funct7)); \
+        _rd;                                                                            \
+    })
+
+/* writes a configuration register and returns its previous value */
+static inline uint32_t rip_rc_config(uint32_t reg, uint32_t value) {
+    return RIP_RC_INSN(RIP_RC_OP_CFG, value, reg);
+}
+
+static inline void rip_rc_write_weight(uint32_t addr, uint32_t entry) {
+    (void)RIP_RC_INSN(RIP_RC_OP_WW, addr, entry);
+}
+
+/* state[size..] hold the inputs of the next step */
+static inline void rip_rc_write_state(uint32_t index, int16_t value) {
+    (void)RIP_RC_INSN(RIP_RC_OP_WS, index, (uint16_t)value);
+}
+
+static inline int16_t rip_rc_read_state(uint32_t index) {
+    return (int16_t)RIP_RC_INSN(RIP_RC_OP_RS, index, 0);
+}
+
+/* state[i] += leak * (tanh(sum_j W[i][j] * state[j]) - state[i]) for i < size */
+static inline void rip_rc_step(void) {
+    (void)RIP_RC_INSN(RIP_RC_OP_STEP, 0, 0);
+}
+
+/* dot product of the weight row at `addr` with the state, Q.12 */
+static inline int32_t rip_rc_readout(uint32_t addr) {
+    return (int32_t)RIP_RC_INSN(RIP_RC_OP_READ, addr, 0);
+}
+
+#endif /* RIP_RESERVOIR_H */
@@ -0,0 +1,11 @@
+# Joins the per-configuration reports into one JSON Lines file.
+#
+#   cmake -DINPUTS=a.jsonl,b.jsonl -DOUTPUT=synth_report.jsonl -P concat_reports.cmake
+
+string(REPLACE "," ";" inputs "${INPUTS}")
+set(text "")
+foreach(input ${inputs})
+  file(READ ${input} content)
+  string(APPEND text "${content}")
+endforeach()
+file(WRITE ${OUTPUT} "${text}")
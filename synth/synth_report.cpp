@@ -0,0 +1,182 @@
+//
+// Synthesis report
+// - reads the `stat` and `ltp` output of synth/rip_synth.ys.in and, optionally,
+//   the rip_sim_server result of a benchmark on the same configuration
+// - writes one JSON line: resource counts, the longest path in logic levels
+//   with an estimate in ns and MHz, and the benchmark's performance per MHz
+//   and per LUT and its branch prediction accuracy
+//
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+
+namespace {
+
+void usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s --name NAME --define DEFINE --stat STAT --ltp LTP [--bench BENCH] "
+                 "[--level-delay-ps PS] -o OUTPUT\n",
+                 argv0);
+}
+
+bool read_file(const std::string& path, std::string& content) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::fprintf(stderr, "cannot open %s\n", path.c_str());
+        return false;
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    content = ss.str();
+    return true;
+}
+
+bool is_number(const std::string& s) {
+    return !s.empty() && s.find_first_not_of("0123456789") == std::string::npos;
+}
+
+// cell type -> count; Yosys has printed both "<type> <count>" and "<count> <type>"
+std::map<std::string, uint64_t> parse_cells(const std::string& stat) {
+    std::map<std::string, uint64_t> cells;
+    std::istringstream in(stat);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream tokens(line);
+        std::string a, b, rest;
+        if (!(tokens >> a >> b) || (tokens >> rest)) {
+            continue;
+        }
+        if (is_number(b) && !is_number(a)) {
+            cells[a] = std::stoull(b);
+        } else if (is_number(a) && !is_number(b)) {
+            cells[b] = std::stoull(a);
+        }
+    }
+    return cells;
+}
+
+bool starts_with(const std::string& s, const char* prefix) { return s.rfind(prefix, 0) == 0; }
+
+// a counter of the rip_sim_server result, 0 if it has none
+uint64_t counter(const std::string& bench, const char* name) {
+    std::smatch m;
+    if (!std::regex_search(bench, m, std::regex(std::string("\"") + name + "\":([0-9]+)"))) {
+        return 0;
+    }
+    return std::stoull(m[1]);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string name, define, stat_path, ltp_path, bench_path, output;
+    double level_delay_ps = 600.0;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--name" && i + 1 < argc) {
+            name = argv[++i];
+        } else if (arg == "--define" && i + 1 < argc) {
+            define = argv[++i];
+        } else if (arg == "--stat" && i + 1 < argc) {
+            stat_path = argv[++i];
+        } else if (arg == "--ltp" && i + 1 < argc) {
+            ltp_path = argv[++i];
+        } else if (arg == "--bench" && i + 1 < argc) {
+            bench_path = argv[++i];
+        } else if (arg == "--level-delay-ps" && i + 1 < argc) {
+            level_delay_ps = std::stod(argv[++i]);
+        } else if (arg == "-o" && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (name.empty() || stat_path.empty() || ltp_path.empty() || output.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::string stat, ltp;
+    if (!read_file(stat_path, stat) || !read_file(ltp_path, ltp)) {
+        return 1;
+    }
+
+    uint64_t luts = 0, ffs = 0, lutram = 0, bram18 = 0, dsp = 0;
+    for (const auto& [type, count] : parse_cells(stat)) {
+        if (starts_with(type, "LUT")) {
+            luts += count;
+        } else if (starts_with(type, "FD")) {
+            ffs += count;
+        } else if (starts_with(type, "RAMB18")) {
+            bram18 += count;
+        } else if (starts_with(type, "RAMB36")) {
+            bram18 += 2 * count;
+        } else if (starts_with(type, "RAM") || starts_with(type, "SRL")) {
+            lutram += count;
+        } else if (starts_with(type, "DSP")) {
+            dsp += count;
+        }
+    }
+
+    std::smatch m;
+    if (!std::regex_search(ltp, m, std::regex("length=([0-9]+)"))) {
+        std::fprintf(stderr, "%s: no longest path found\n", ltp_path.c_str());
+        return 1;
+    }
+    const uint64_t levels = std::stoull(m[1]);
+    const double path_ns = levels * level_delay_ps / 1000.0;
+    const double fmax_mhz = path_ns > 0 ? 1000.0 / path_ns : 0.0;
+
+    char buf[512];
+    std::snprintf(buf, sizeof(buf),
+                  "{\"config\":\"%s\",\"define\":\"%s\",\"luts\":%llu,\"ffs\":%llu,"
+                  "\"lutram\":%llu,\"bram18\":%llu,\"dsp\":%llu,\"logic_levels\":%llu,"
+                  "\"critical_path_ns\":%.3f,\"est_fmax_mhz\":%.1f",
+                  name.c_str(), define.c_str(), static_cast<unsigned long long>(luts),
+                  static_cast<unsigned long long>(ffs), static_cast<unsigned long long>(lutram),
+                  static_cast<unsigned long long>(bram18), static_cast<unsigned long long>(dsp),
+                  static_cast<unsigned long long>(levels), path_ns, fmax_mhz);
+    std::string json = buf;
+
+    // runs of the benchmark per second at 1 MHz, and at the estimated Fmax per LUT
+    if (!bench_path.empty()) {
+        std::string bench;
+        if (!read_file(bench_path, bench)) {
+            return 1;
+        }
+        if (!std::regex_search(bench, m, std::regex("\"status\":\"finished\",\"cycles\":([0-9]+)")) ||
+            std::stoull(m[1]) == 0) {
+            std::fprintf(stderr, "%s: the benchmark did not finish\n", bench_path.c_str());
+            return 1;
+        }
+        const uint64_t cycles = std::stoull(m[1]);
+        const double perf_per_mhz = 1e6 / cycles;
+        const double perf_per_lut = luts > 0 ? perf_per_mhz * fmax_mhz / luts : 0.0;
+        // branches predicted correctly, in percent, next to est_fmax_mhz
+        const uint64_t correct = counter(bench, "bptp") + counter(bench, "bptn");
+        const uint64_t branches = correct + counter(bench, "bpfp") + counter(bench, "bpfn");
+        const double bp_accuracy = branches > 0 ? 100.0 * correct / branches : 0.0;
+        std::snprintf(buf, sizeof(buf),
+                      ",\"cycles\":%llu,\"perf_per_mhz\":%.6g,\"perf_per_lut\":%.6g,"
+                      "\"bp_accuracy\":%.3f,\"bpmc\":%llu",
+                      static_cast<unsigned long long>(cycles), perf_per_mhz, perf_per_lut,
+                      bp_accuracy, static_cast<unsigned long long>(counter(bench, "bpmc")));
+        json += buf;
+    }
+    json += "}";
+
+    std::ofstream out(output);
+    if (!out.is_open()) {
+        std::fprintf(stderr, "cannot open output: %s\n", output.c_str());
+        return 1;
+    }
+    out << json << std::endl;
+    return 0;
+}
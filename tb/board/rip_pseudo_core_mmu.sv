@@ -24,11 +24,14 @@ module rip_pseudo_core_mmu #(
     logic [ADDR_WIDTH-1:0] addr_1;
     logic [ADDR_WIDTH-1:0] addr_2;
     logic [DATA_WIDTH-1:0] din_1;
+    rip_type::amo_op_t amo_1;
     logic [DATA_WIDTH-1:0] dout_1;
     logic [DATA_WIDTH-1:0] dout_2;
     logic busy_1;
     logic busy_2;
 
+    assign amo_1 = rip_type::AMO_NONE;
+
     rip_memory_management_unit #(
         .ADDR_WIDTH(ADDR_WIDTH),
         .DATA_WIDTH(DATA_WIDTH),
@@ -59,12 +59,19 @@ module rip_axi_master_tb #(
         .wdata(wdata),
         .wstrb(wstrb),
         .wvalid(wvalid),
+        .wlock(1'b0),
+        .wline(1'b1),
         .wdone(wdone),
+        .wresp(),
         .rready(rready),
         .raddr(raddr),
         .rvalid(rvalid),
+        .rlock(1'b0),
+        .rline(1'b1),
         .rdata(rdata),
+        .rcrit(),
         .rdone(rdone),
+        .rresp(),
         .M_AXI(axi_if.master)
     );
 
@@ -68,6 +68,7 @@ module rip_memory_management_unit_tb #(
         .addr_1(addr_1),
         .addr_2(addr_2),
         .din_1(din_1),
+        .amo_1(rip_type::AMO_NONE),
         .dout_1(dout_1),
         .dout_2(dout_2),
         .busy_1(busy_1),
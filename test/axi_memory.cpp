@@ -0,0 +1,127 @@
+#include "axi_memory.hpp"
+
+#include <iterator>
+#include <sstream>
+
+#include "rv32_gen.hpp"
+#include "rv32_iss.hpp"
+
+AxiMemory::AxiMemory(SparseMemory& mem, uint32_t latency) : _mem(mem), _latency(latency) {
+    reset();
+}
+
+void AxiMemory::reset() {
+    _cycle = 0;
+    _reads.clear();
+    _read_beat = 0;
+    _writes.clear();
+    _wdata.clear();
+    _write_beat = 0;
+    _responses.clear();
+    _write_skipped = false;
+    _monitors.clear();
+    _read_bursts = 0;
+    _read_beats = 0;
+    _write_beats = 0;
+}
+
+std::vector<uint32_t> AxiMemory::r_data(uint32_t words) const {
+    uint32_t base = (beat_addr(_reads.front(), _read_beat) >> 2) & ~(words - 1);
+    std::vector<uint32_t> data(words);
+    for (uint32_t i = 0; i < words; i++) {
+        data[i] = _mem.read(base + i);
+    }
+    return data;
+}
+
+void AxiMemory::monitor_write(uint32_t addr) {
+    for (auto it = _monitors.begin(); it != _monitors.end();) {
+        it = it->second == addr ? _monitors.erase(it) : std::next(it);
+    }
+}
+
+void AxiMemory::advance(bool r_fire, bool b_fire) {
+    if (r_fire) {
+        _read_beats++;
+        const burst_t& burst = _reads.front();
+        if (burst.lock) {
+            _monitors[burst.id] = beat_addr(burst, _read_beat) >> 2;
+        }
+        if (r_last()) {
+            _reads.pop_front();
+            _read_beat = 0;
+        } else {
+            _read_beat++;
+        }
+    }
+    if (b_fire) {
+        _responses.pop_front();
+    }
+
+    // W may arrive before its AW; beats are applied once both are here
+    while (!_writes.empty() && !_wdata.empty()) {
+        burst_t& burst = _writes.front();
+        const wbeat_t& beat = _wdata.front();
+        uint32_t addr = beat_addr(burst, _write_beat) >> 2;
+        if (burst.lock && _write_beat == 0) {
+            auto it = _monitors.find(burst.id);
+            _write_skipped = it == _monitors.end() || it->second != addr;
+            burst.resp = _write_skipped ? OKAY : EXOKAY;
+        }
+        if (!_write_skipped) {
+            monitor_write(addr);
+            uint32_t base = addr & ~static_cast<uint32_t>(beat.data.size() - 1);
+            for (uint32_t i = 0; i < beat.data.size(); i++) {
+                uint8_t strb = (beat.strb >> (4 * i)) & 0xF;
+                if (strb != 0) {
+                    _mem.write(base + i, beat.data[i], strb);
+                }
+            }
+        }
+        _write_beats++;
+        if (beat.last) {
+            _write_skipped = false;
+            burst.ready_at = _cycle + _latency;
+            _responses.push_back(burst);
+            _writes.pop_front();
+            _write_beat = 0;
+        } else {
+            _write_beat++;
+        }
+        _wdata.pop_front();
+    }
+    _cycle++;
+}
+
+std::string fuzz_against_iss(SparseMemory& mem, int num_programs, size_t num_items,
+                             uint64_t max_cycles, const std::function<bool()>& run) {
+    std::ostringstream oss;
+    for (int seed = 1; seed <= num_programs; seed++) {
+        FuzzProgram program = RandomProgramGenerator(seed).generate(num_items);
+        SparseMemory iss_mem;
+        program.load(iss_mem);
+        Rv32Iss iss(iss_mem);
+        iss.set_exclusive_monitor(true);
+        iss.run(max_cycles);
+        if (!iss.finished()) {
+            oss << "seed " << seed << ": iss did not finish\n";
+            continue;
+        }
+
+        mem.clear();
+        program.load(mem);
+        if (!run()) {
+            oss << "seed " << seed << ": timeout\n";
+            continue;
+        }
+        for (uint32_t addr = FuzzProgram::DATA_BASE;
+             addr < FuzzProgram::SIG_BASE + FuzzProgram::SIG_SIZE; addr += 4) {
+            if (mem.read(addr >> 2) != iss_mem.read(addr >> 2)) {
+                oss << "seed " << seed << ": address " << std::hex << addr << " is "
+                    << mem.read(addr >> 2) << ", expected " << iss_mem.read(addr >> 2) << std::dec
+                    << "\n";
+            }
+        }
+    }
+    return oss.str();
+}
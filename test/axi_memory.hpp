@@ -0,0 +1,179 @@
+#ifndef _AXI_MEMORY_HPP_
+#define _AXI_MEMORY_HPP_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "sparse_memory.hpp"
+
+// Cycle-level AXI4 slave over a SparseMemory, for models with the flattened
+// AXI ports of rip_core_wrapper / rip_cluster, on a data bus of 32 bits or
+// wider. A beat moves the bus-aligned bytes around its address; WSTRB selects
+// the byte lanes written.
+// Every channel is always ready and any number of transactions may be
+// outstanding; bursts are INCR or WRAP. Read data starts `latency` cycles after the address and
+// streams one beat per cycle in request order; a write is answered `latency`
+// cycles after its last beat.
+// Exclusive accesses (AxLOCK) are supported with one monitor per ID: an
+// exclusive read answers EXOKAY and arms the monitor of its ID, any write to
+// the address disarms every monitor on it, and an exclusive write is only
+// performed (EXOKAY) while the monitor of its ID still covers the address.
+//
+// Per cycle: drive(), eval() with clk low, clock(), then the rising edge.
+class AxiMemory {
+   public:
+    explicit AxiMemory(SparseMemory& mem, uint32_t latency = 8);
+
+    void reset();
+
+    // slave outputs for the coming clock edge
+    template <class Dut>
+    void drive(Dut& dut) const {
+        dut.AWREADY = 1;
+        dut.WREADY = 1;
+        dut.ARREADY = 1;
+        dut.BVALID = b_valid();
+        dut.BID = b_valid() ? _responses.front().id : 0;
+        dut.BRESP = b_valid() ? _responses.front().resp : 0;
+        dut.RVALID = r_valid();
+        dut.RID = r_valid() ? _reads.front().id : 0;
+        uint32_t words = bus_words(dut);
+        set_bus(dut.RDATA, r_valid() ? r_data(words) : std::vector<uint32_t>(words));
+        dut.RRESP = r_valid() && _reads.front().lock ? EXOKAY : OKAY;
+        dut.RLAST = r_valid() && r_last();
+    }
+
+    // records the handshakes of the clock edge; the master outputs must have
+    // settled on the inputs from drive()
+    template <class Dut>
+    void clock(const Dut& dut) {
+        bool r_fire = r_valid() && dut.RREADY;
+        bool b_fire = b_valid() && dut.BREADY;
+        if (dut.ARVALID) {
+            _reads.push_back({dut.ARID, dut.ARADDR, dut.ARLEN, dut.ARSIZE, dut.ARBURST,
+                              static_cast<bool>(dut.ARLOCK), OKAY, _cycle + _latency});
+            _read_bursts++;
+        }
+        if (dut.AWVALID) {
+            _writes.push_back({dut.AWID, dut.AWADDR, dut.AWLEN, dut.AWSIZE, dut.AWBURST,
+                               static_cast<bool>(dut.AWLOCK), OKAY, 0});
+        }
+        if (dut.WVALID) {
+            _wdata.push_back({get_bus(dut.WDATA), dut.WSTRB, static_cast<bool>(dut.WLAST)});
+        }
+        advance(r_fire, b_fire);
+    }
+
+    uint64_t cycles() const { return _cycle; }
+    uint64_t read_bursts() const { return _read_bursts; }
+    uint64_t read_beats() const { return _read_beats; }
+    uint64_t write_beats() const { return _write_beats; }
+
+    static constexpr uint32_t OKAY = 0b00;
+    static constexpr uint32_t EXOKAY = 0b01;
+    static constexpr uint32_t INCR = 0b01;
+    static constexpr uint32_t WRAP = 0b10;
+
+   private:
+    struct burst_t {
+        uint32_t id;
+        uint32_t addr;
+        uint32_t len;    // AxLEN, beats - 1
+        uint32_t size;   // AxSIZE
+        uint32_t burst;  // AxBURST
+        bool lock;       // AxLOCK
+        uint32_t resp;   // BRESP of a write
+        uint64_t ready_at;
+    };
+    struct wbeat_t {
+        std::vector<uint32_t> data;  // one word per 4 byte lanes
+        uint64_t strb;
+        bool last;
+    };
+
+    SparseMemory& _mem;
+    uint32_t _latency;
+    uint64_t _cycle;
+
+    std::deque<burst_t> _reads;
+    uint32_t _read_beat;  // of _reads.front()
+    std::deque<burst_t> _writes;  // addresses waiting for their data
+    std::deque<wbeat_t> _wdata;
+    uint32_t _write_beat;  // of _writes.front()
+    std::deque<burst_t> _responses;  // B, ready_at is the response time
+    bool _write_skipped;  // _writes.front() is a failed exclusive write
+    std::map<uint32_t, uint32_t> _monitors;  // ID -> armed word address
+
+    uint64_t _read_bursts;
+    uint64_t _read_beats;
+    uint64_t _write_beats;
+
+    static uint32_t beat_addr(const burst_t& burst, uint32_t beat) {
+        uint32_t addr = burst.addr + (beat << burst.size);
+        if (burst.burst == WRAP) {
+            // wraps at the burst's total size, which WRAP bursts are aligned to
+            uint32_t bytes = (burst.len + 1) << burst.size;
+            addr = (burst.addr & ~(bytes - 1)) | (addr & (bytes - 1));
+        }
+        return addr;
+    }
+
+    // Verilator models a bus of up to 64 bits as an integer and a wider one as
+    // a VlWide array of 32-bit words
+    template <class Dut>
+    static uint32_t bus_words(const Dut& dut) {
+        static_assert(sizeof(dut.RDATA) % 4 == 0, "the data bus must be 32 bits or wider");
+        return sizeof(dut.RDATA) / 4;
+    }
+
+    template <class T>
+    static void set_bus(T& signal, const std::vector<uint32_t>& words) {
+        if constexpr (std::is_integral_v<T>) {
+            uint64_t value = 0;
+            for (size_t i = 0; i < words.size(); i++) {
+                value |= static_cast<uint64_t>(words[i]) << (32 * i);
+            }
+            signal = static_cast<T>(value);
+        } else {
+            for (size_t i = 0; i < words.size(); i++) {
+                signal[i] = words[i];
+            }
+        }
+    }
+
+    template <class T>
+    static std::vector<uint32_t> get_bus(const T& signal) {
+        std::vector<uint32_t> words(sizeof(T) / 4);
+        for (size_t i = 0; i < words.size(); i++) {
+            if constexpr (std::is_integral_v<T>) {
+                words[i] = static_cast<uint32_t>(static_cast<uint64_t>(signal) >> (32 * i));
+            } else {
+                words[i] = signal[i];
+            }
+        }
+        return words;
+    }
+
+    bool r_valid() const { return !_reads.empty() && _reads.front().ready_at <= _cycle; }
+    bool r_last() const { return _read_beat == _reads.front().len; }
+    std::vector<uint32_t> r_data(uint32_t words) const;
+    bool b_valid() const { return !_responses.empty() && _responses.front().ready_at <= _cycle; }
+
+    void monitor_write(uint32_t addr);
+    void advance(bool r_fire, bool b_fire);
+};
+
+// Differential fuzzing of a model served by AxiMemory: runs the programs of
+// RandomProgramGenerator seeds 1..num_programs on Rv32Iss, with the exclusive
+// monitor modelled, and through `run`, which runs the program it finds in
+// `mem` from address 0 and returns false on timeout.
+// Returns one line per mismatch in the data region or the register signature.
+std::string fuzz_against_iss(SparseMemory& mem, int num_programs, size_t num_items,
+                             uint64_t max_cycles, const std::function<bool()>& run);
+
+#endif
@@ -0,0 +1,167 @@
+//
+// Branch predictor report
+// - reads the rip_sim_server results of the same benchmarks on several
+//   predictor configurations, one file per configuration
+// - prints the prediction accuracy, the mispredictions, the cycles lost per
+//   misprediction (bpmc) and the cycles of each, and the difference to a
+//   baseline configuration
+// - runs labelled <name>#<seed> (PERCEPTRON_RO with +bp_ro_seed=<seed>) are
+//   also summarized per name: mean, min and max accuracy over the seeds
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace {
+
+void usage(const char* argv0) {
+    std::fprintf(stderr, "usage: %s [--baseline LABEL] LABEL=RESULTS.jsonl...\n", argv0);
+}
+
+typedef struct {
+    std::string label;
+    uint64_t jobs;
+    uint64_t cycles;
+    uint64_t bptp;
+    uint64_t bptn;
+    uint64_t bpfp;
+    uint64_t bpfn;
+    uint64_t bpmc;
+} bp_run_t;
+
+uint64_t field(const std::string& line, const char* name) {
+    std::smatch m;
+    if (!std::regex_search(line, m, std::regex(std::string("\"") + name + "\":([0-9]+)"))) {
+        return 0;
+    }
+    return std::stoull(m[1]);
+}
+
+// sums the counters over the finished jobs of one result file
+bool read_run(const std::string& label, const std::string& path, bp_run_t& run) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::fprintf(stderr, "cannot open %s\n", path.c_str());
+        return false;
+    }
+    run = {label, 0, 0, 0, 0, 0, 0, 0};
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.find("\"status\":\"finished\"") == std::string::npos) {
+            std::fprintf(stderr, "%s: a job did not finish: %s\n", path.c_str(), line.c_str());
+            return false;
+        }
+        run.jobs++;
+        run.cycles += field(line, "cycles");
+        run.bptp += field(line, "bptp");
+        run.bptn += field(line, "bptn");
+        run.bpfp += field(line, "bpfp");
+        run.bpfn += field(line, "bpfn");
+        run.bpmc += field(line, "bpmc");
+    }
+    if (run.jobs == 0) {
+        std::fprintf(stderr, "%s: no results\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+uint64_t branches(const bp_run_t& run) { return run.bptp + run.bptn + run.bpfp + run.bpfn; }
+uint64_t mispredicts(const bp_run_t& run) { return run.bpfp + run.bpfn; }
+
+double accuracy(const bp_run_t& run) {
+    return branches(run) > 0 ? 100.0 * (run.bptp + run.bptn) / branches(run) : 0.0;
+}
+
+void print_run(const bp_run_t& run, const bp_run_t* baseline) {
+    const double penalty = mispredicts(run) > 0 ? static_cast<double>(run.bpmc) / mispredicts(run) : 0.0;
+    std::printf("%-24s %12llu %9.3f %12llu %9.2f %14llu", run.label.c_str(),
+                static_cast<unsigned long long>(branches(run)), accuracy(run),
+                static_cast<unsigned long long>(mispredicts(run)), penalty,
+                static_cast<unsigned long long>(run.cycles));
+    if (baseline != nullptr) {
+        std::printf(" %+9.3f %+9.3f%%", accuracy(run) - accuracy(*baseline),
+                    100.0 * (static_cast<double>(run.cycles) - baseline->cycles) / baseline->cycles);
+    }
+    std::printf("\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string baseline_label;
+    std::vector<bp_run_t> runs;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        if (arg == "--baseline" && i + 1 < argc) {
+            baseline_label = argv[++i];
+        } else if (eq != std::string::npos && eq > 0) {
+            bp_run_t run;
+            if (!read_run(arg.substr(0, eq), arg.substr(eq + 1), run)) {
+                return 1;
+            }
+            runs.push_back(run);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (runs.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const bp_run_t* baseline = nullptr;
+    for (const bp_run_t& run : runs) {
+        if (run.label == baseline_label) {
+            baseline = &run;
+        }
+    }
+    if (!baseline_label.empty() && baseline == nullptr) {
+        std::fprintf(stderr, "no results labelled %s\n", baseline_label.c_str());
+        return 1;
+    }
+
+    std::printf("%-24s %12s %9s %12s %9s %14s", "config", "branches", "acc%", "mispredicts",
+                "bpmc/mp", "cycles");
+    if (baseline != nullptr) {
+        std::printf(" %9s %10s", "d_acc", "d_cycles");
+    }
+    std::printf("\n");
+    for (const bp_run_t& run : runs) {
+        print_run(run, baseline);
+    }
+
+    // the spread over the seeds of each seeded configuration
+    std::map<std::string, std::vector<const bp_run_t*>> seeded;
+    for (const bp_run_t& run : runs) {
+        size_t hash = run.label.find('#');
+        if (hash != std::string::npos) {
+            seeded[run.label.substr(0, hash)].push_back(&run);
+        }
+    }
+    for (const auto& [name, seeds] : seeded) {
+        double sum = 0.0, lo = 100.0, hi = 0.0;
+        for (const bp_run_t* run : seeds) {
+            sum += accuracy(*run);
+            lo = std::min(lo, accuracy(*run));
+            hi = std::max(hi, accuracy(*run));
+        }
+        const double mean = sum / seeds.size();
+        std::printf("%s over %zu seeds: acc%% mean %.3f min %.3f max %.3f", name.c_str(), seeds.size(),
+                    mean, lo, hi);
+        if (baseline != nullptr) {
+            std::printf(", mean %+.3f vs %s", mean - accuracy(*baseline), baseline->label.c_str());
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
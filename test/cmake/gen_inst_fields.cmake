@@ -0,0 +1,32 @@
+# Generates an X-macro list of the rip_type::inst_t fields.
+#
+#   cmake -DINPUT=rip_type.sv -DOUTPUT=inst_fields.inc -P gen_inst_fields.cmake
+#
+# The first field of a SystemVerilog packed struct is its MSB, so the list
+# is emitted LSB first to match the declaration order of C bit-fields.
+
+file(READ ${INPUT} content)
+string(REGEX REPLACE "//[^\n]*" "" content "${content}")
+string(REGEX MATCH "typedef struct packed {([^}]*)} inst_t;" matched "${content}")
+if (NOT matched)
+  message(FATAL_ERROR "inst_t was not found in ${INPUT}")
+endif()
+
+string(REGEX MATCHALL "logic[ \t\n]+[A-Za-z_][A-Za-z_0-9]*" decls "${CMAKE_MATCH_1}")
+set(fields "")
+foreach(decl ${decls})
+  string(REGEX REPLACE "^logic[ \t\n]+" "" name "${decl}")
+  list(PREPEND fields ${name})
+endforeach()
+
+list(LENGTH fields num_fields)
+set(text "// generated from ${INPUT}; do not edit\n")
+foreach(name ${fields})
+  string(APPEND text "RIP_INST_FIELD(${name})\n")
+endforeach()
+
+# keep the timestamp when nothing changed to avoid needless rebuilds
+file(WRITE ${OUTPUT}.tmp "${text}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different ${OUTPUT}.tmp ${OUTPUT})
+file(REMOVE ${OUTPUT}.tmp)
+message(STATUS "Generated ${OUTPUT} (${num_fields} fields)")
@@ -0,0 +1,49 @@
+#include "mailbox_host.hpp"
+
+#include <verilated.h>
+
+#include "Vcore.h"
+#include "sim_runner.hpp"
+
+MailboxHost::MailboxHost(SimRunner& runner, uint32_t mem_head)
+    : _runner(runner), _mem_head(mem_head), _cmd_tail(0), _res_head(0) {}
+
+void MailboxHost::reset() {
+    _cmd_tail = 0;
+    _res_head = 0;
+    _runner.dut().mbox_cmd_tail = _cmd_tail;
+    _runner.dut().mbox_res_head = _res_head;
+}
+
+bool MailboxHost::post(const rip_mbox_cmd_t& cmd) {
+    if (_cmd_tail - _runner.dut().mbox_cmd_head >= RIP_MBOX_ENTRIES) {
+        return false;
+    }
+    SparseMemory& mem = _runner.memory();
+    uint32_t addr = word_addr(RIP_MBOX_CMD_ADDR(_cmd_tail));
+    mem.write(addr, cmd.tag);
+    mem.write(addr + 1, cmd.op);
+    mem.write(addr + 2, cmd.arg0);
+    mem.write(addr + 3, cmd.arg1);
+    // the doorbell goes last
+    _runner.dut().mbox_cmd_tail = ++_cmd_tail;
+    return true;
+}
+
+bool MailboxHost::poll(rip_mbox_res_t& res) {
+    if (_runner.dut().mbox_res_tail == _res_head) {
+        return false;
+    }
+    const SparseMemory& mem = _runner.memory();
+    uint32_t addr = word_addr(RIP_MBOX_RES_ADDR(_res_head));
+    res.tag = mem.read(addr);
+    res.status = mem.read(addr + 1);
+    res.val0 = mem.read(addr + 2);
+    res.val1 = mem.read(addr + 3);
+    _runner.dut().mbox_res_head = ++_res_head;
+    return true;
+}
+
+uint32_t MailboxHost::cmd_in_flight() const { return _cmd_tail - _runner.dut().mbox_cmd_head; }
+
+uint32_t MailboxHost::res_pending() const { return _runner.dut().mbox_res_tail - _res_head; }
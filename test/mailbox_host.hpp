@@ -0,0 +1,35 @@
+#ifndef _MAILBOX_HOST_HPP_
+#define _MAILBOX_HOST_HPP_
+
+#include <cstdint>
+
+#include "../sw/rip_mailbox.h"
+#include "sim_runner.hpp"
+
+// C++ stand-in for the PS side of the mailbox (sw/rip_mailbox.h).
+// Writes commands into the runner's memory and drives the doorbell ports of
+// its Vcore between ticks, as the PS would through CMA and AXI GPIO.
+class MailboxHost {
+   public:
+    explicit MailboxHost(SimRunner& runner, uint32_t mem_head = 0);
+
+    // clears both rings; call before the core is started
+    void reset();
+    // false if the command ring is full
+    bool post(const rip_mbox_cmd_t& cmd);
+    // false if no result is waiting
+    bool poll(rip_mbox_res_t& res);
+
+    uint32_t cmd_in_flight() const;  // posted, not yet taken by the core
+    uint32_t res_pending() const;    // produced by the core, not yet polled
+
+   private:
+    SimRunner& _runner;
+    uint32_t _mem_head;
+    uint32_t _cmd_tail;
+    uint32_t _res_head;
+
+    uint32_t word_addr(uint32_t addr) const { return (addr | _mem_head) >> 2; }
+};
+
+#endif
@@ -0,0 +1,716 @@
+#include "ref_model.hpp"
+
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+const char* const ALU_OP_NAMES[] = {
+    "LUI",   "AUIPC",  "JAL",    "JALR",   "BEQ",   "BNE",  "BLT",   "BGE",  "BLTU",
+    "BGEU",  "LB",     "LH",     "LW",     "LBU",   "LHU",  "SB",    "SH",   "SW",
+    "ADDI",  "SLTI",   "SLTIU",  "XORI",   "ORI",   "ANDI", "SLLI",  "SRLI", "SRAI",
+    "ADD",   "SUB",    "SLL",    "SLT",    "SLTU",  "XOR",  "SRL",   "SRA",  "OR",
+    "AND",   "CSRRW",  "CSRRS",  "CSRRC",  "CSRRWI", "CSRRSI", "CSRRCI", "MUL", "MULH",
+    "MULHSU", "MULHU", "DIV",    "DIVU",   "REM",   "REMU", "SH1ADD", "SH2ADD", "SH3ADD",
+    "ANDN",  "ORN",    "XNOR",   "CLZ",    "CTZ",   "CPOP", "MAX",   "MAXU", "MIN",
+    "MINU",  "SEXT_B", "SEXT_H", "ZEXT_H", "ROL",   "ROR",  "RORI",  "ORC_B", "REV8",
+    "LR_W",  "SC_W",   "AMOSWAP_W", "AMOADD_W", "AMOOR_W",
+    "ADD8",  "SUB8",   "ADD16",  "SUB16",  "KADD8", "KSUB8", "KADD16", "KSUB16", "UKADD8",
+    "UKSUB8", "UKADD16", "UKSUB16", "SMAQA", "UMAQA", "KMDA", "KMADA",
+};
+static_assert(sizeof(ALU_OP_NAMES) / sizeof(ALU_OP_NAMES[0]) ==
+                  static_cast<size_t>(AluOp::NUM_OPS),
+              "ALU_OP_NAMES must match AluOp");
+
+inline int32_t sext(uint32_t value, int bits) {
+    return static_cast<int32_t>(value << (32 - bits)) >> (32 - bits);
+}
+
+// the operation is fixed for a whole batch, so the loop body has no
+// data-dependent branches
+template <typename F>
+void alu_map(const alu_batch_t& in, size_t n, uint32_t* rslt, F f) {
+    for (size_t i = 0; i < n; i++) {
+        rslt[i] = f(in.rs1[i], in.rs2[i], in.rs3[i], in.pc[i], in.csr[i], in.imm[i], in.zimm[i]);
+    }
+}
+
+#define ALU_LAMBDA(expr)                                                                   \
+    [](uint32_t rs1, uint32_t rs2, uint32_t rs3, uint32_t pc, uint32_t csr, uint32_t imm, \
+       uint32_t zimm) -> uint32_t {                                                        \
+        (void)rs1, (void)rs2, (void)rs3, (void)pc, (void)csr, (void)imm, (void)zimm;       \
+        return (expr);                                                                     \
+    }
+
+inline uint32_t div_s(uint32_t a, uint32_t b) {
+    uint32_t zero = b == 0;
+    uint32_t overflow = (a == 0x80000000) & (b == 0xFFFFFFFF);
+    int32_t divisor = (zero | overflow) ? 1 : static_cast<int32_t>(b);
+    uint32_t q = static_cast<uint32_t>(static_cast<int32_t>(a) / divisor);
+    q = overflow ? 0x80000000 : q;
+    return zero ? 0xFFFFFFFF : q;
+}
+
+inline uint32_t rem_s(uint32_t a, uint32_t b) {
+    uint32_t zero = b == 0;
+    uint32_t overflow = (a == 0x80000000) & (b == 0xFFFFFFFF);
+    int32_t divisor = (zero | overflow) ? 1 : static_cast<int32_t>(b);
+    uint32_t r = static_cast<uint32_t>(static_cast<int32_t>(a) % divisor);
+    r = overflow ? 0 : r;
+    return zero ? a : r;
+}
+
+inline uint32_t div_u(uint32_t a, uint32_t b) {
+    uint32_t q = a / (b | (b == 0));
+    return b == 0 ? 0xFFFFFFFF : q;
+}
+
+inline uint32_t rem_u(uint32_t a, uint32_t b) {
+    uint32_t r = a % (b | (b == 0));
+    return b == 0 ? a : r;
+}
+
+inline uint32_t mulh_ss(uint32_t a, uint32_t b) {
+    int64_t p = static_cast<int64_t>(static_cast<int32_t>(a)) * static_cast<int32_t>(b);
+    return static_cast<uint32_t>(static_cast<uint64_t>(p) >> 32);
+}
+
+inline uint32_t mulh_su(uint32_t a, uint32_t b) {
+    int64_t p = static_cast<int64_t>(static_cast<int32_t>(a)) * static_cast<int64_t>(b);
+    return static_cast<uint32_t>(static_cast<uint64_t>(p) >> 32);
+}
+
+inline uint32_t mulh_uu(uint32_t a, uint32_t b) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(a) * b) >> 32);
+}
+
+inline uint32_t lt(uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(a) < static_cast<int32_t>(b);
+}
+
+inline uint32_t rol(uint32_t a, uint32_t shamt) {
+    shamt &= 0x1F;
+    return (a << shamt) | (a >> ((32 - shamt) & 0x1F));
+}
+
+inline uint32_t ror(uint32_t a, uint32_t shamt) {
+    shamt &= 0x1F;
+    return (a >> shamt) | (a << ((32 - shamt) & 0x1F));
+}
+
+inline uint32_t orc_b(uint32_t a) {
+    uint32_t r = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        r |= ((a >> shift) & 0xFF ? 0xFFu : 0u) << shift;
+    }
+    return r;
+}
+
+enum class Sat { NONE, SIGNED, UNSIGNED };
+
+// packed SIMD add/sub over LANE-bit lanes
+template <int LANE, Sat SAT, bool SUB>
+inline uint32_t simd_add(uint32_t a, uint32_t b) {
+    const uint32_t mask = (1u << LANE) - 1;
+    uint32_t r = 0;
+    for (int shift = 0; shift < 32; shift += LANE) {
+        int32_t x = SAT == Sat::SIGNED ? sext((a >> shift) & mask, LANE) : (a >> shift) & mask;
+        int32_t y = SAT == Sat::SIGNED ? sext((b >> shift) & mask, LANE) : (b >> shift) & mask;
+        int32_t v = SUB ? x - y : x + y;
+        if (SAT == Sat::SIGNED) {
+            v = std::clamp(v, -(1 << (LANE - 1)), (1 << (LANE - 1)) - 1);
+        } else if (SAT == Sat::UNSIGNED) {
+            v = std::clamp(v, 0, static_cast<int32_t>(mask));
+        }
+        r |= (static_cast<uint32_t>(v) & mask) << shift;
+    }
+    return r;
+}
+
+template <bool SIGNED>
+inline uint32_t maqa(uint32_t a, uint32_t b, uint32_t acc) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        int32_t x = SIGNED ? sext((a >> shift) & 0xFF, 8) : (a >> shift) & 0xFF;
+        int32_t y = SIGNED ? sext((b >> shift) & 0xFF, 8) : (b >> shift) & 0xFF;
+        acc += static_cast<uint32_t>(x * y);
+    }
+    return acc;
+}
+
+inline uint32_t kmada(uint32_t a, uint32_t b, uint32_t acc) {
+    int64_t v = static_cast<int64_t>(static_cast<int32_t>(acc)) +
+                static_cast<int64_t>(sext(a >> 16, 16)) * sext(b >> 16, 16) +
+                static_cast<int64_t>(sext(a & 0xFFFF, 16)) * sext(b & 0xFFFF, 16);
+    return static_cast<uint32_t>(std::clamp<int64_t>(v, INT32_MIN, INT32_MAX));
+}
+
+}  // namespace
+
+const char* alu_op_name(AluOp op) { return ALU_OP_NAMES[static_cast<int>(op)]; }
+
+inst_bit_t alu_op_inst(AluOp op) {
+    inst_bit_t inst_bit = {0};
+    switch (op) {
+        // clang-format off
+        case AluOp::LUI:    inst_bit.LUI = 1;    break;
+        case AluOp::AUIPC:  inst_bit.AUIPC = 1;  break;
+        case AluOp::JAL:    inst_bit.JAL = 1;    inst_bit.UPDATE_PC = 1; break;
+        case AluOp::JALR:   inst_bit.JALR = 1;   inst_bit.UPDATE_PC = 1; break;
+        case AluOp::BEQ:    inst_bit.BEQ = 1;    inst_bit.UPDATE_PC = 1; break;
+        case AluOp::BNE:    inst_bit.BNE = 1;    inst_bit.UPDATE_PC = 1; break;
+        case AluOp::BLT:    inst_bit.BLT = 1;    inst_bit.UPDATE_PC = 1; break;
+        case AluOp::BGE:    inst_bit.BGE = 1;    inst_bit.UPDATE_PC = 1; break;
+        case AluOp::BLTU:   inst_bit.BLTU = 1;   inst_bit.UPDATE_PC = 1; break;
+        case AluOp::BGEU:   inst_bit.BGEU = 1;   inst_bit.UPDATE_PC = 1; break;
+        case AluOp::LB:     inst_bit.LB = 1;     inst_bit.ACCESS_MEM = 1; break;
+        case AluOp::LH:     inst_bit.LH = 1;     inst_bit.ACCESS_MEM = 1; break;
+        case AluOp::LW:     inst_bit.LW = 1;     inst_bit.ACCESS_MEM = 1; break;
+        case AluOp::LBU:    inst_bit.LBU = 1;    inst_bit.ACCESS_MEM = 1; break;
+        case AluOp::LHU:    inst_bit.LHU = 1;    inst_bit.ACCESS_MEM = 1; break;
+        case AluOp::SB:     inst_bit.SB = 1;     inst_bit.ACCESS_MEM = 1; break;
+        case AluOp::SH:     inst_bit.SH = 1;     inst_bit.ACCESS_MEM = 1; break;
+        case AluOp::SW:     inst_bit.SW = 1;     inst_bit.ACCESS_MEM = 1; break;
+        case AluOp::ADDI:   inst_bit.ADDI = 1;   break;
+        case AluOp::SLTI:   inst_bit.SLTI = 1;   break;
+        case AluOp::SLTIU:  inst_bit.SLTIU = 1;  break;
+        case AluOp::XORI:   inst_bit.XORI = 1;   break;
+        case AluOp::ORI:    inst_bit.ORI = 1;    break;
+        case AluOp::ANDI:   inst_bit.ANDI = 1;   break;
+        case AluOp::SLLI:   inst_bit.SLLI = 1;   break;
+        case AluOp::SRLI:   inst_bit.SRLI = 1;   break;
+        case AluOp::SRAI:   inst_bit.SRAI = 1;   break;
+        case AluOp::ADD:    inst_bit.ADD = 1;    break;
+        case AluOp::SUB:    inst_bit.SUB = 1;    break;
+        case AluOp::SLL:    inst_bit.SLL = 1;    break;
+        case AluOp::SLT:    inst_bit.SLT = 1;    break;
+        case AluOp::SLTU:   inst_bit.SLTU = 1;   break;
+        case AluOp::XOR:    inst_bit.XOR = 1;    break;
+        case AluOp::SRL:    inst_bit.SRL = 1;    break;
+        case AluOp::SRA:    inst_bit.SRA = 1;    break;
+        case AluOp::OR:     inst_bit.OR = 1;     break;
+        case AluOp::AND:    inst_bit.AND = 1;    break;
+        case AluOp::CSRRW:  inst_bit.CSRRW = 1;  inst_bit.UPDATE_CSR = 1; break;
+        case AluOp::CSRRS:  inst_bit.CSRRS = 1;  inst_bit.UPDATE_CSR = 1; break;
+        case AluOp::CSRRC:  inst_bit.CSRRC = 1;  inst_bit.UPDATE_CSR = 1; break;
+        case AluOp::CSRRWI: inst_bit.CSRRWI = 1; inst_bit.UPDATE_CSR = 1; break;
+        case AluOp::CSRRSI: inst_bit.CSRRSI = 1; inst_bit.UPDATE_CSR = 1; break;
+        case AluOp::CSRRCI: inst_bit.CSRRCI = 1; inst_bit.UPDATE_CSR = 1; break;
+        case AluOp::MUL:    inst_bit.MUL = 1;    break;
+        case AluOp::MULH:   inst_bit.MULH = 1;   break;
+        case AluOp::MULHSU: inst_bit.MULHSU = 1; break;
+        case AluOp::MULHU:  inst_bit.MULHU = 1;  break;
+        case AluOp::DIV:    inst_bit.DIV = 1;    break;
+        case AluOp::DIVU:   inst_bit.DIVU = 1;   break;
+        case AluOp::REM:    inst_bit.REM = 1;    break;
+        case AluOp::REMU:   inst_bit.REMU = 1;   break;
+        case AluOp::SH1ADD: inst_bit.SH1ADD = 1; break;
+        case AluOp::SH2ADD: inst_bit.SH2ADD = 1; break;
+        case AluOp::SH3ADD: inst_bit.SH3ADD = 1; break;
+        case AluOp::ANDN:   inst_bit.ANDN = 1;   break;
+        case AluOp::ORN:    inst_bit.ORN = 1;    break;
+        case AluOp::XNOR:   inst_bit.XNOR = 1;   break;
+        case AluOp::CLZ:    inst_bit.CLZ = 1;    break;
+        case AluOp::CTZ:    inst_bit.CTZ = 1;    break;
+        case AluOp::CPOP:   inst_bit.CPOP = 1;   break;
+        case AluOp::MAX:    inst_bit.MAX = 1;    break;
+        case AluOp::MAXU:   inst_bit.MAXU = 1;   break;
+        case AluOp::MIN:    inst_bit.MIN = 1;    break;
+        case AluOp::MINU:   inst_bit.MINU = 1;   break;
+        case AluOp::SEXT_B: inst_bit.SEXT_B = 1; break;
+        case AluOp::SEXT_H: inst_bit.SEXT_H = 1; break;
+        case AluOp::ZEXT_H: inst_bit.ZEXT_H = 1; break;
+        case AluOp::ROL:    inst_bit.ROL = 1;    break;
+        case AluOp::ROR:    inst_bit.ROR = 1;    break;
+        case AluOp::RORI:   inst_bit.RORI = 1;   break;
+        case AluOp::ORC_B:  inst_bit.ORC_B = 1;  break;
+        case AluOp::REV8:   inst_bit.REV8 = 1;   break;
+        case AluOp::LR_W:      inst_bit.LR_W = 1;      inst_bit.ACCESS_MEM = 1; break;
+        case AluOp::SC_W:      inst_bit.SC_W = 1;      inst_bit.ACCESS_MEM = 1; break;
+        case AluOp::AMOSWAP_W: inst_bit.AMOSWAP_W = 1; inst_bit.ACCESS_MEM = 1; break;
+        case AluOp::AMOADD_W:  inst_bit.AMOADD_W = 1;  inst_bit.ACCESS_MEM = 1; break;
+        case AluOp::AMOOR_W:   inst_bit.AMOOR_W = 1;   inst_bit.ACCESS_MEM = 1; break;
+        case AluOp::ADD8:    inst_bit.ADD8 = 1;    break;
+        case AluOp::SUB8:    inst_bit.SUB8 = 1;    break;
+        case AluOp::ADD16:   inst_bit.ADD16 = 1;   break;
+        case AluOp::SUB16:   inst_bit.SUB16 = 1;   break;
+        case AluOp::KADD8:   inst_bit.KADD8 = 1;   break;
+        case AluOp::KSUB8:   inst_bit.KSUB8 = 1;   break;
+        case AluOp::KADD16:  inst_bit.KADD16 = 1;  break;
+        case AluOp::KSUB16:  inst_bit.KSUB16 = 1;  break;
+        case AluOp::UKADD8:  inst_bit.UKADD8 = 1;  break;
+        case AluOp::UKSUB8:  inst_bit.UKSUB8 = 1;  break;
+        case AluOp::UKADD16: inst_bit.UKADD16 = 1; break;
+        case AluOp::UKSUB16: inst_bit.UKSUB16 = 1; break;
+        case AluOp::SMAQA:   inst_bit.SMAQA = 1;   break;
+        case AluOp::UMAQA:   inst_bit.UMAQA = 1;   break;
+        case AluOp::KMDA:    inst_bit.KMDA = 1;    break;
+        case AluOp::KMADA:   inst_bit.KMADA = 1;   break;
+        case AluOp::NUM_OPS: break;
+        // clang-format on
+    }
+    return inst_bit;
+}
+
+void alu_ref(AluOp op, const alu_batch_t& in, size_t n, uint32_t* rslt, uint8_t* branch_result) {
+    // operand selection follows rip_alu: a = pc for AUIPC/JAL/JALR,
+    // zimm for CSR*I; b = 4 for JAL/JALR, csr for CSR*; shifts use b[4:0]
+    switch (op) {
+        case AluOp::LUI:
+            alu_map(in, n, rslt, ALU_LAMBDA(imm));
+            break;
+        case AluOp::AUIPC:
+            alu_map(in, n, rslt, ALU_LAMBDA(pc + imm));
+            break;
+        case AluOp::JAL:
+        case AluOp::JALR:
+            alu_map(in, n, rslt, ALU_LAMBDA(pc + 4));
+            break;
+        case AluOp::BEQ:
+            alu_map(in, n, rslt, ALU_LAMBDA(static_cast<uint32_t>(rs1 == rs2)));
+            break;
+        case AluOp::BNE:
+            alu_map(in, n, rslt, ALU_LAMBDA(static_cast<uint32_t>(rs1 != rs2)));
+            break;
+        case AluOp::BLT:
+        case AluOp::SLT:
+            alu_map(in, n, rslt, ALU_LAMBDA(lt(rs1, rs2)));
+            break;
+        case AluOp::BGE:
+            alu_map(in, n, rslt, ALU_LAMBDA(lt(rs1, rs2) ^ 1));
+            break;
+        case AluOp::BLTU:
+        case AluOp::SLTU:
+            alu_map(in, n, rslt, ALU_LAMBDA(static_cast<uint32_t>(rs1 < rs2)));
+            break;
+        case AluOp::BGEU:
+            alu_map(in, n, rslt, ALU_LAMBDA(static_cast<uint32_t>(rs1 >= rs2)));
+            break;
+        case AluOp::LB:
+        case AluOp::LH:
+        case AluOp::LW:
+        case AluOp::LBU:
+        case AluOp::LHU:
+        case AluOp::SB:
+        case AluOp::SH:
+        case AluOp::SW:
+        case AluOp::ADDI:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1 + imm));
+            break;
+        case AluOp::SLTI:
+            alu_map(in, n, rslt, ALU_LAMBDA(lt(rs1, imm)));
+            break;
+        case AluOp::SLTIU:
+            alu_map(in, n, rslt, ALU_LAMBDA(static_cast<uint32_t>(rs1 < imm)));
+            break;
+        case AluOp::XORI:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1 ^ imm));
+            break;
+        case AluOp::ORI:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1 | imm));
+            break;
+        case AluOp::ANDI:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1 & imm));
+            break;
+        case AluOp::SLLI:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1 << (imm & 0x1F)));
+            break;
+        case AluOp::SRLI:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1 >> (imm & 0x1F)));
+            break;
+        case AluOp::SRAI:
+            alu_map(in, n, rslt,
+                    ALU_LAMBDA(static_cast<uint32_t>(static_cast<int32_t>(rs1) >> (imm & 0x1F))));
+            break;
+        case AluOp::ADD:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1 + rs2));
+            break;
+        case AluOp::SUB:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1 - rs2));
+            break;
+        case AluOp::SLL:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1 << (rs2 & 0x1F)));
+            break;
+        case AluOp::XOR:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1 ^ rs2));
+            break;
+        case AluOp::SRL:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1 >> (rs2 & 0x1F)));
+            break;
+        case AluOp::SRA:
+            alu_map(in, n, rslt,
+                    ALU_LAMBDA(static_cast<uint32_t>(static_cast<int32_t>(rs1) >> (rs2 & 0x1F))));
+            break;
+        case AluOp::OR:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1 | rs2));
+            break;
+        case AluOp::AND:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1 & rs2));
+            break;
+        case AluOp::CSRRW:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1));
+            break;
+        case AluOp::CSRRS:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1 | csr));
+            break;
+        case AluOp::CSRRC:
+            alu_map(in, n, rslt, ALU_LAMBDA(~rs1 & csr));
+            break;
+        case AluOp::CSRRWI:
+            alu_map(in, n, rslt, ALU_LAMBDA(zimm));
+            break;
+        case AluOp::CSRRSI:
+            alu_map(in, n, rslt, ALU_LAMBDA(zimm | csr));
+            break;
+        case AluOp::CSRRCI:
+            alu_map(in, n, rslt, ALU_LAMBDA(~zimm & csr));
+            break;
+        case AluOp::MUL:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1 * rs2));
+            break;
+        case AluOp::MULH:
+            alu_map(in, n, rslt, ALU_LAMBDA(mulh_ss(rs1, rs2)));
+            break;
+        case AluOp::MULHSU:
+            alu_map(in, n, rslt, ALU_LAMBDA(mulh_su(rs1, rs2)));
+            break;
+        case AluOp::MULHU:
+            alu_map(in, n, rslt, ALU_LAMBDA(mulh_uu(rs1, rs2)));
+            break;
+        case AluOp::DIV:
+            alu_map(in, n, rslt, ALU_LAMBDA(div_s(rs1, rs2)));
+            break;
+        case AluOp::DIVU:
+            alu_map(in, n, rslt, ALU_LAMBDA(div_u(rs1, rs2)));
+            break;
+        case AluOp::REM:
+            alu_map(in, n, rslt, ALU_LAMBDA(rem_s(rs1, rs2)));
+            break;
+        case AluOp::REMU:
+            alu_map(in, n, rslt, ALU_LAMBDA(rem_u(rs1, rs2)));
+            break;
+        case AluOp::SH1ADD:
+            alu_map(in, n, rslt, ALU_LAMBDA((rs1 << 1) + rs2));
+            break;
+        case AluOp::SH2ADD:
+            alu_map(in, n, rslt, ALU_LAMBDA((rs1 << 2) + rs2));
+            break;
+        case AluOp::SH3ADD:
+            alu_map(in, n, rslt, ALU_LAMBDA((rs1 << 3) + rs2));
+            break;
+        case AluOp::ANDN:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1 & ~rs2));
+            break;
+        case AluOp::ORN:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1 | ~rs2));
+            break;
+        case AluOp::XNOR:
+            alu_map(in, n, rslt, ALU_LAMBDA(~(rs1 ^ rs2)));
+            break;
+        case AluOp::CLZ:
+            alu_map(in, n, rslt,
+                    ALU_LAMBDA(rs1 ? static_cast<uint32_t>(__builtin_clz(rs1)) : 32u));
+            break;
+        case AluOp::CTZ:
+            alu_map(in, n, rslt,
+                    ALU_LAMBDA(rs1 ? static_cast<uint32_t>(__builtin_ctz(rs1)) : 32u));
+            break;
+        case AluOp::CPOP:
+            alu_map(in, n, rslt, ALU_LAMBDA(static_cast<uint32_t>(__builtin_popcount(rs1))));
+            break;
+        case AluOp::MAX:
+            alu_map(in, n, rslt, ALU_LAMBDA(lt(rs1, rs2) ? rs2 : rs1));
+            break;
+        case AluOp::MAXU:
+            alu_map(in, n, rslt, ALU_LAMBDA(std::max(rs1, rs2)));
+            break;
+        case AluOp::MIN:
+            alu_map(in, n, rslt, ALU_LAMBDA(lt(rs1, rs2) ? rs1 : rs2));
+            break;
+        case AluOp::MINU:
+            alu_map(in, n, rslt, ALU_LAMBDA(std::min(rs1, rs2)));
+            break;
+        case AluOp::SEXT_B:
+            alu_map(in, n, rslt, ALU_LAMBDA(static_cast<uint32_t>(sext(rs1, 8))));
+            break;
+        case AluOp::SEXT_H:
+            alu_map(in, n, rslt, ALU_LAMBDA(static_cast<uint32_t>(sext(rs1, 16))));
+            break;
+        case AluOp::ZEXT_H:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1 & 0xFFFF));
+            break;
+        case AluOp::ROL:
+            alu_map(in, n, rslt, ALU_LAMBDA(rol(rs1, rs2)));
+            break;
+        case AluOp::ROR:
+            alu_map(in, n, rslt, ALU_LAMBDA(ror(rs1, rs2)));
+            break;
+        case AluOp::RORI:
+            alu_map(in, n, rslt, ALU_LAMBDA(ror(rs1, imm)));
+            break;
+        case AluOp::ORC_B:
+            alu_map(in, n, rslt, ALU_LAMBDA(orc_b(rs1)));
+            break;
+        case AluOp::REV8:
+            alu_map(in, n, rslt, ALU_LAMBDA(__builtin_bswap32(rs1)));
+            break;
+        case AluOp::LR_W:
+        case AluOp::SC_W:
+        case AluOp::AMOSWAP_W:
+        case AluOp::AMOADD_W:
+        case AluOp::AMOOR_W:
+            alu_map(in, n, rslt, ALU_LAMBDA(rs1));  // the address, without an offset
+            break;
+        case AluOp::ADD8:
+            alu_map(in, n, rslt, ALU_LAMBDA((simd_add<8, Sat::NONE, false>(rs1, rs2))));
+            break;
+        case AluOp::SUB8:
+            alu_map(in, n, rslt, ALU_LAMBDA((simd_add<8, Sat::NONE, true>(rs1, rs2))));
+            break;
+        case AluOp::ADD16:
+            alu_map(in, n, rslt, ALU_LAMBDA((simd_add<16, Sat::NONE, false>(rs1, rs2))));
+            break;
+        case AluOp::SUB16:
+            alu_map(in, n, rslt, ALU_LAMBDA((simd_add<16, Sat::NONE, true>(rs1, rs2))));
+            break;
+        case AluOp::KADD8:
+            alu_map(in, n, rslt, ALU_LAMBDA((simd_add<8, Sat::SIGNED, false>(rs1, rs2))));
+            break;
+        case AluOp::KSUB8:
+            alu_map(in, n, rslt, ALU_LAMBDA((simd_add<8, Sat::SIGNED, true>(rs1, rs2))));
+            break;
+        case AluOp::KADD16:
+            alu_map(in, n, rslt, ALU_LAMBDA((simd_add<16, Sat::SIGNED, false>(rs1, rs2))));
+            break;
+        case AluOp::KSUB16:
+            alu_map(in, n, rslt, ALU_LAMBDA((simd_add<16, Sat::SIGNED, true>(rs1, rs2))));
+            break;
+        case AluOp::UKADD8:
+            alu_map(in, n, rslt, ALU_LAMBDA((simd_add<8, Sat::UNSIGNED, false>(rs1, rs2))));
+            break;
+        case AluOp::UKSUB8:
+            alu_map(in, n, rslt, ALU_LAMBDA((simd_add<8, Sat::UNSIGNED, true>(rs1, rs2))));
+            break;
+        case AluOp::UKADD16:
+            alu_map(in, n, rslt, ALU_LAMBDA((simd_add<16, Sat::UNSIGNED, false>(rs1, rs2))));
+            break;
+        case AluOp::UKSUB16:
+            alu_map(in, n, rslt, ALU_LAMBDA((simd_add<16, Sat::UNSIGNED, true>(rs1, rs2))));
+            break;
+        case AluOp::SMAQA:
+            alu_map(in, n, rslt, ALU_LAMBDA(maqa<true>(rs1, rs2, rs3)));
+            break;
+        case AluOp::UMAQA:
+            alu_map(in, n, rslt, ALU_LAMBDA(maqa<false>(rs1, rs2, rs3)));
+            break;
+        case AluOp::KMDA:
+            alu_map(in, n, rslt, ALU_LAMBDA(kmada(rs1, rs2, 0)));
+            break;
+        case AluOp::KMADA:
+            alu_map(in, n, rslt, ALU_LAMBDA(kmada(rs1, rs2, rs3)));
+            break;
+        case AluOp::NUM_OPS:
+            break;
+    }
+
+    // branch_result mirrors rslt for conditional branches and is 0 otherwise
+    bool is_branch = op >= AluOp::BEQ && op <= AluOp::BGEU;
+    for (size_t i = 0; i < n; i++) {
+        branch_result[i] = is_branch ? static_cast<uint8_t>(rslt[i]) : 0;
+    }
+}
+
+#undef ALU_LAMBDA
+
+// mirrors rip_decode with de_ready = 1, including the cases where the
+// type decode only looks at inst_code[6:2]
+void decode_ref(const uint32_t* inst_code, size_t n, decode_result_t* out) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t code = inst_code[i];
+        uint32_t opcode = code & 0x7F;
+        uint32_t op_hi = (code >> 5) & 0x3;
+        uint32_t op_mid = (code >> 2) & 0x7;
+        uint32_t funct3 = (code >> 12) & 0x7;
+        uint32_t funct7 = code >> 25;
+        uint32_t funct12 = code >> 20;
+
+        bool r_type = op_hi == 0b01 && op_mid == 0b100;
+        bool i_type = (op_hi == 0b00 && (op_mid == 0b000 || op_mid == 0b100)) ||
+                      (op_hi == 0b11 && op_mid == 0b001);
+        bool s_type = op_hi == 0b01 && op_mid == 0b000;
+        bool b_type = op_hi == 0b11 && op_mid == 0b000;
+        bool u_type = (op_hi == 0b00 || op_hi == 0b01) && op_mid == 0b101;
+        bool j_type = op_hi == 0b11 && op_mid == 0b011;
+        bool csr_type = op_hi == 0b11 && op_mid == 0b100 && !(funct3 & 0x4);
+        bool csr_i_type = op_hi == 0b11 && op_mid == 0b100 && (funct3 & 0x4);
+        bool rc_type = op_hi == 0b01 && op_mid == 0b010;
+        bool p_type = op_hi == 0b11 && op_mid == 0b101;
+        bool a_type = op_hi == 0b01 && op_mid == 0b011;
+
+        uint32_t imm_i = sext(funct12, 12);
+        uint32_t shamt = (code >> 20) & 0x1F;
+        uint32_t imm_s = sext((funct7 << 5) | ((code >> 7) & 0x1F), 12);
+        uint32_t imm_b = sext(((code >> 31) << 12) | (((code >> 7) & 0x1) << 11) |
+                                  (((code >> 25) & 0x3F) << 5) | (((code >> 8) & 0xF) << 1),
+                              13);
+        uint32_t imm_u = code & 0xFFFFF000;
+        uint32_t imm_j = sext(((code >> 31) << 20) | (((code >> 12) & 0xFF) << 12) |
+                                  (((code >> 20) & 0x1) << 11) | (((code >> 21) & 0x3FF) << 1),
+                              21);
+        imm_i = (funct3 == 0b101 && op_mid == 0b100) ? shamt : imm_i;
+
+        uint32_t imm = (i_type ? imm_i : 0) | (s_type ? imm_s : 0) | (b_type ? imm_b : 0) |
+                       (u_type ? imm_u : 0) | (j_type ? imm_j : 0) | (rc_type ? funct7 : 0);
+
+        uint32_t rd_num = (r_type | i_type | u_type | j_type | csr_type | csr_i_type | rc_type |
+                           p_type | a_type)
+                              ? (code >> 7) & 0x1F
+                              : 0;
+        uint32_t rs1_num = (r_type | i_type | s_type | b_type | csr_type | rc_type | p_type |
+                            a_type)
+                               ? (code >> 15) & 0x1F
+                               : 0;
+        uint32_t rs2_num =
+            (r_type | s_type | b_type | rc_type | p_type | a_type) ? (code >> 20) & 0x1F : 0;
+        // multiply-accumulate reads rd as a third source
+        bool p_acc = p_type && ((funct3 == 0b000 && (funct7 == 0b1100100 || funct7 == 0b1100110)) ||
+                                (funct3 == 0b001 && funct7 == 0b0100100));
+        uint32_t rs3_num = p_acc ? (code >> 7) & 0x1F : 0;
+
+        bool op = opcode == 0b0110011;
+        bool op_imm = opcode == 0b0010011;
+        bool load = opcode == 0b0000011;
+        bool store = opcode == 0b0100011;
+        bool branch = opcode == 0b1100011;
+        bool system = opcode == 0b1110011;
+        bool misc_mem = opcode == 0b0001111;
+        bool custom_0 = opcode == 0b0001011;
+        bool custom_1 = opcode == 0b0101011;
+        bool amo = opcode == 0b0101111;
+        bool amo_w = amo && funct3 == 0b010;
+        uint32_t funct5 = code >> 27;
+        bool op_p = opcode == 0b1110111;
+        bool op_p0 = op_p && funct3 == 0b000;
+        bool f7_0 = funct7 == 0b0000000;
+        bool f7_1 = funct7 == 0b0000001;
+        bool f7_32 = funct7 == 0b0100000;
+        bool f7_zba = funct7 == 0b0010000;
+        bool f7_minmax = funct7 == 0b0000101;
+        bool f7_rot = funct7 == 0b0110000;
+
+        inst_bit_t b = {0};
+        b.LUI = opcode == 0b0110111;
+        b.AUIPC = opcode == 0b0010111;
+        b.JAL = opcode == 0b1101111;
+        b.JALR = opcode == 0b1100111;
+        b.BEQ = branch && funct3 == 0b000;
+        b.BNE = branch && funct3 == 0b001;
+        b.BLT = branch && funct3 == 0b100;
+        b.BGE = branch && funct3 == 0b101;
+        b.BLTU = branch && funct3 == 0b110;
+        b.BGEU = branch && funct3 == 0b111;
+        b.LB = load && funct3 == 0b000;
+        b.LH = load && funct3 == 0b001;
+        b.LW = load && funct3 == 0b010;
+        b.LBU = load && funct3 == 0b100;
+        b.LHU = load && funct3 == 0b101;
+        b.SB = store && funct3 == 0b000;
+        b.SH = store && funct3 == 0b001;
+        b.SW = store && funct3 == 0b010;
+        b.ADDI = op_imm && funct3 == 0b000;
+        b.SLTI = op_imm && funct3 == 0b010;
+        b.SLTIU = op_imm && funct3 == 0b011;
+        b.XORI = op_imm && funct3 == 0b100;
+        b.ORI = op_imm && funct3 == 0b110;
+        b.ANDI = op_imm && funct3 == 0b111;
+        b.SLLI = op_imm && funct3 == 0b001 && f7_0;
+        b.SRLI = op_imm && funct3 == 0b101 && f7_0;
+        b.SRAI = op_imm && funct3 == 0b101 && f7_32;
+        b.ADD = op && funct3 == 0b000 && f7_0;
+        b.SUB = op && funct3 == 0b000 && f7_32;
+        b.SLL = op && funct3 == 0b001 && f7_0;
+        b.SLT = op && funct3 == 0b010 && f7_0;
+        b.SLTU = op && funct3 == 0b011 && f7_0;
+        b.XOR = op && funct3 == 0b100 && f7_0;
+        b.SRL = op && funct3 == 0b101 && f7_0;
+        b.SRA = op && funct3 == 0b101 && f7_32;
+        b.OR = op && funct3 == 0b110 && f7_0;
+        b.AND = op && funct3 == 0b111 && f7_0;
+        b.FENCE = misc_mem && funct3 == 0b000;
+        b.FENCE_I = misc_mem && funct3 == 0b001;
+        b.ECALL = system && funct3 == 0b000 && funct12 == 0x000;
+        b.EBREAK = system && funct3 == 0b000 && funct12 == 0x001;
+        b.MRET = system && funct3 == 0b000 && funct12 == 0x302;
+        b.CSRRW = system && funct3 == 0b001;
+        b.CSRRS = system && funct3 == 0b010;
+        b.CSRRC = system && funct3 == 0b011;
+        b.CSRRWI = system && funct3 == 0b101;
+        b.CSRRSI = system && funct3 == 0b110;
+        b.CSRRCI = system && funct3 == 0b111;
+        b.MUL = op && funct3 == 0b000 && f7_1;
+        b.MULH = op && funct3 == 0b001 && f7_1;
+        b.MULHSU = op && funct3 == 0b010 && f7_1;
+        b.MULHU = op && funct3 == 0b011 && f7_1;
+        b.DIV = op && funct3 == 0b100 && f7_1;
+        b.DIVU = op && funct3 == 0b101 && f7_1;
+        b.REM = op && funct3 == 0b110 && f7_1;
+        b.REMU = op && funct3 == 0b111 && f7_1;
+        b.SH1ADD = op && funct3 == 0b010 && f7_zba;
+        b.SH2ADD = op && funct3 == 0b100 && f7_zba;
+        b.SH3ADD = op && funct3 == 0b110 && f7_zba;
+        b.ANDN = op && funct3 == 0b111 && f7_32;
+        b.ORN = op && funct3 == 0b110 && f7_32;
+        b.XNOR = op && funct3 == 0b100 && f7_32;
+        b.CLZ = op_imm && funct3 == 0b001 && funct12 == 0x600;
+        b.CTZ = op_imm && funct3 == 0b001 && funct12 == 0x601;
+        b.CPOP = op_imm && funct3 == 0b001 && funct12 == 0x602;
+        b.MAX = op && funct3 == 0b110 && f7_minmax;
+        b.MAXU = op && funct3 == 0b111 && f7_minmax;
+        b.MIN = op && funct3 == 0b100 && f7_minmax;
+        b.MINU = op && funct3 == 0b101 && f7_minmax;
+        b.SEXT_B = op_imm && funct3 == 0b001 && funct12 == 0x604;
+        b.SEXT_H = op_imm && funct3 == 0b001 && funct12 == 0x605;
+        b.ZEXT_H = op && funct3 == 0b100 && funct12 == 0x080;
+        b.ROL = op && funct3 == 0b001 && f7_rot;
+        b.ROR = op && funct3 == 0b101 && f7_rot;
+        b.RORI = op_imm && funct3 == 0b101 && f7_rot;
+        b.ORC_B = op_imm && funct3 == 0b101 && funct12 == 0x287;
+        b.REV8 = op_imm && funct3 == 0b101 && funct12 == 0x698;
+        b.LR_W = amo_w && funct5 == 0b00010;
+        b.SC_W = amo_w && funct5 == 0b00011;
+        b.AMOSWAP_W = amo_w && funct5 == 0b00001;
+        b.AMOADD_W = amo_w && funct5 == 0b00000;
+        b.AMOOR_W = amo_w && funct5 == 0b01000;
+        b.EXTX = custom_0 && funct12 == 0x000;
+        b.EXT = custom_0 && funct12 == 0x001;
+        b.RC = custom_1;
+        b.ADD8 = op_p0 && funct7 == 0b0100100;
+        b.SUB8 = op_p0 && funct7 == 0b0100101;
+        b.ADD16 = op_p0 && funct7 == 0b0100000;
+        b.SUB16 = op_p0 && funct7 == 0b0100001;
+        b.KADD8 = op_p0 && funct7 == 0b0001100;
+        b.KSUB8 = op_p0 && funct7 == 0b0001101;
+        b.KADD16 = op_p0 && funct7 == 0b0001000;
+        b.KSUB16 = op_p0 && funct7 == 0b0001001;
+        b.UKADD8 = op_p0 && funct7 == 0b0011100;
+        b.UKSUB8 = op_p0 && funct7 == 0b0011101;
+        b.UKADD16 = op_p0 && funct7 == 0b0011000;
+        b.UKSUB16 = op_p0 && funct7 == 0b0011001;
+        b.SMAQA = op_p0 && funct7 == 0b1100100;
+        b.UMAQA = op_p0 && funct7 == 0b1100110;
+        b.KMDA = op_p && funct3 == 0b001 && funct7 == 0b0011100;
+        b.KMADA = op_p && funct3 == 0b001 && funct7 == 0b0100100;
+        b.ACCESS_MEM = load || store || amo;
+        b.UPDATE_REG = rd_num != 0;
+        b.UPDATE_CSR = system && funct3 != 0b000;
+        b.UPDATE_PC = b.JAL || b.JALR || branch || (system && funct3 == 0b000);
+
+        out[i].inst = pack_inst_bit(b);
+        out[i].imm = imm;
+        out[i].csr_num = (csr_type | csr_i_type) ? funct12 : 0;
+        out[i].rd_num = rd_num;
+        out[i].rs1_num = rs1_num;
+        out[i].rs2_num = rs2_num;
+        out[i].rs3_num = rs3_num;
+        out[i].csr_zimm = csr_i_type ? (code >> 15) & 0x1F : 0;
+    }
+}
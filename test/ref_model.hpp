@@ -0,0 +1,146 @@
+#ifndef _REF_MODEL_HPP_
+#define _REF_MODEL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "test_inst.hpp"
+
+// Branch-free reference models of rip_alu and rip_decode for the
+// high-volume unit tests. Each model works on a whole batch at once so
+// that the compiler can vectorize the inner loops.
+
+/*
+ * rip_alu
+ */
+enum class AluOp {
+    LUI,
+    AUIPC,
+    JAL,
+    JALR,
+    BEQ,
+    BNE,
+    BLT,
+    BGE,
+    BLTU,
+    BGEU,
+    LB,
+    LH,
+    LW,
+    LBU,
+    LHU,
+    SB,
+    SH,
+    SW,
+    ADDI,
+    SLTI,
+    SLTIU,
+    XORI,
+    ORI,
+    ANDI,
+    SLLI,
+    SRLI,
+    SRAI,
+    ADD,
+    SUB,
+    SLL,
+    SLT,
+    SLTU,
+    XOR,
+    SRL,
+    SRA,
+    OR,
+    AND,
+    CSRRW,
+    CSRRS,
+    CSRRC,
+    CSRRWI,
+    CSRRSI,
+    CSRRCI,
+    MUL,
+    MULH,
+    MULHSU,
+    MULHU,
+    DIV,
+    DIVU,
+    REM,
+    REMU,
+    SH1ADD,
+    SH2ADD,
+    SH3ADD,
+    ANDN,
+    ORN,
+    XNOR,
+    CLZ,
+    CTZ,
+    CPOP,
+    MAX,
+    MAXU,
+    MIN,
+    MINU,
+    SEXT_B,
+    SEXT_H,
+    ZEXT_H,
+    ROL,
+    ROR,
+    RORI,
+    ORC_B,
+    REV8,
+    LR_W,
+    SC_W,
+    AMOSWAP_W,
+    AMOADD_W,
+    AMOOR_W,
+    ADD8,
+    SUB8,
+    ADD16,
+    SUB16,
+    KADD8,
+    KSUB8,
+    KADD16,
+    KSUB16,
+    UKADD8,
+    UKSUB8,
+    UKADD16,
+    UKSUB16,
+    SMAQA,
+    UMAQA,
+    KMDA,
+    KMADA,
+    NUM_OPS
+};
+
+const char* alu_op_name(AluOp op);
+// instruction bits as rip_decode would drive them
+inst_bit_t alu_op_inst(AluOp op);
+
+// structure of arrays, one element per vector
+typedef struct {
+    uint32_t* rs1;
+    uint32_t* rs2;
+    uint32_t* rs3;
+    uint32_t* pc;
+    uint32_t* csr;
+    uint32_t* imm;
+    uint8_t* zimm;
+} alu_batch_t;
+
+void alu_ref(AluOp op, const alu_batch_t& in, size_t n, uint32_t* rslt, uint8_t* branch_result);
+
+/*
+ * rip_decode
+ */
+typedef struct {
+    inst_packed_t inst;
+    uint32_t imm;
+    uint16_t csr_num;
+    uint8_t rd_num;
+    uint8_t rs1_num;
+    uint8_t rs2_num;
+    uint8_t rs3_num;
+    uint8_t csr_zimm;
+} decode_result_t;
+
+void decode_ref(const uint32_t* inst_code, size_t n, decode_result_t* out);
+
+#endif
@@ -0,0 +1,125 @@
+#include "reservoir_model.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr uint32_t STATE_MASK = (1u << ReservoirModel::STATE_ADDR_WIDTH) - 1;
+constexpr uint32_t WEIGHT_MASK = (1u << ReservoirModel::WEIGHT_ADDR_WIDTH) - 1;
+constexpr int LUT_HALF = 1 << (ReservoirModel::LUT_ADDR_WIDTH - 1);
+
+inline int64_t wrap_acc(int64_t value) {
+    return static_cast<int64_t>(static_cast<uint64_t>(value) << (64 - ReservoirModel::ACC_WIDTH)) >>
+           (64 - ReservoirModel::ACC_WIDTH);
+}
+
+// one weight entry per cycle plus the fetch/gather/multiply/accumulate/update stages
+constexpr uint32_t STEP_LATENCY = 4;
+
+}  // namespace
+
+ReservoirModel::ReservoirModel()
+    : _weight(1u << WEIGHT_ADDR_WIDTH, 0),
+      _cur(0),
+      _size(0),
+      _leak(1u << FRAC_WIDTH),
+      _base(0),
+      _cycles(0) {
+    _state[0].assign(1u << STATE_ADDR_WIDTH, 0);
+    _state[1].assign(1u << STATE_ADDR_WIDTH, 0);
+}
+
+int16_t ReservoirModel::tanh_entry(int index) {
+    // same series and evaluation order as tanh_entry() in rip_reservoir.sv
+    double x = 2.0 * index / (1 << (LUT_ADDR_WIDTH - 3));
+    if (x < 0.0) {
+        x = -x;
+    }
+    double e = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 64; k++) {
+        term = term * x / k;
+        e = e + term;
+    }
+    x = (e - 1.0) / (e + 1.0) * (1 << FRAC_WIDTH);
+    return static_cast<int16_t>(index < 0 ? -std::lround(x) : std::lround(x));
+}
+
+int64_t ReservoirModel::row_sum(uint32_t& addr) const {
+    const std::vector<int16_t>& x = _state[_cur];
+    int64_t acc = 0;
+    for (;;) {
+        uint32_t entry = _weight[addr];
+        addr = (addr + 1) & WEIGHT_MASK;
+        int32_t prod = static_cast<int16_t>(entry & 0xFFFF) * x[(entry >> 16) & STATE_MASK];
+        acc = wrap_acc(acc + prod);
+        if (entry >> 31) {
+            return acc;
+        }
+    }
+}
+
+uint32_t ReservoirModel::command(uint32_t funct7, uint32_t rs1, uint32_t rs2) {
+    switch (funct7) {
+        case OP_CFG: {
+            uint32_t old;
+            switch (rs2 & 0x3) {
+                case CFG_SIZE:
+                    old = _size;
+                    _size = rs1 & ((2u << STATE_ADDR_WIDTH) - 1);
+                    break;
+                case CFG_LEAK:
+                    old = _leak;
+                    _leak = rs1 & 0xFFFF;
+                    break;
+                case CFG_BASE:
+                    old = _base;
+                    _base = rs1 & WEIGHT_MASK;
+                    break;
+                default:
+                    old = _cycles;
+                    break;
+            }
+            return old;
+        }
+        case OP_WW:
+            _weight[rs1 & WEIGHT_MASK] = rs2;
+            return 0;
+        case OP_WS:
+            _state[0][rs1 & STATE_MASK] = static_cast<int16_t>(rs2);
+            _state[1][rs1 & STATE_MASK] = static_cast<int16_t>(rs2);
+            return 0;
+        case OP_RS:
+            return static_cast<uint32_t>(static_cast<int32_t>(_state[_cur][rs1 & STATE_MASK]));
+        case OP_STEP: {
+            if (_size == 0) {
+                return 0;
+            }
+            const std::vector<int16_t>& x = _state[_cur];
+            std::vector<int16_t>& next = _state[_cur ^ 1];
+            uint32_t addr = _base;
+            uint32_t nnz = 0;
+            for (uint32_t row = 0; row < _size; row++) {
+                uint32_t begin = addr;
+                int64_t sum = row_sum(addr);
+                nnz += (addr - begin) & WEIGHT_MASK;
+
+                int64_t index = std::clamp<int64_t>(sum >> LUT_SHIFT, -LUT_HALF, LUT_HALF - 1);
+                int32_t diff = tanh_entry(static_cast<int>(index)) - x[row & STATE_MASK];
+                int64_t scaled = (static_cast<int64_t>(_leak) * diff) >> FRAC_WIDTH;
+                next[row & STATE_MASK] =
+                    static_cast<int16_t>(std::clamp<int64_t>(x[row & STATE_MASK] + scaled, -32768, 32767));
+            }
+            _cur ^= 1;
+            _cycles = nnz + STEP_LATENCY;
+            return 0;
+        }
+        case OP_READ: {
+            uint32_t addr = rs1 & WEIGHT_MASK;
+            return static_cast<uint32_t>(row_sum(addr) >> FRAC_WIDTH);
+        }
+        default:
+            return 0;
+    }
+}
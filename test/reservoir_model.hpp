@@ -0,0 +1,50 @@
+#ifndef _RESERVOIR_MODEL_HPP_
+#define _RESERVOIR_MODEL_HPP_
+
+#include <cstdint>
+#include <vector>
+
+// Bit-exact model of `rip_reservoir`.
+// Commands take the same funct7/rs1/rs2 as the custom-1 instructions and
+// return what the coprocessor writes back to rd (see rip_reservoir_const.sv).
+class ReservoirModel {
+   public:
+    // rip_config
+    static constexpr int STATE_ADDR_WIDTH = 10;
+    static constexpr int WEIGHT_ADDR_WIDTH = 12;
+    // rip_reservoir_const
+    static constexpr int FRAC_WIDTH = 12;
+    static constexpr int ACC_WIDTH = 40;
+    static constexpr int LUT_ADDR_WIDTH = 10;
+    static constexpr int LUT_SHIFT = 2 * FRAC_WIDTH - (LUT_ADDR_WIDTH - 3);
+
+    enum Op : uint32_t { OP_CFG = 0, OP_WW = 1, OP_WS = 2, OP_RS = 3, OP_STEP = 4, OP_READ = 5 };
+    enum Cfg : uint32_t { CFG_SIZE = 0, CFG_LEAK = 1, CFG_BASE = 2, CFG_CYCLES = 3 };
+
+    ReservoirModel();
+
+    uint32_t command(uint32_t funct7, uint32_t rs1, uint32_t rs2);
+
+    // rc_weight_t
+    static uint32_t weight_entry(bool last, uint32_t col, int16_t weight) {
+        return (static_cast<uint32_t>(last) << 31) | ((col & 0x7FFF) << 16) |
+               static_cast<uint16_t>(weight);
+    }
+    // tanh(index / 128) in Q4.12, generated exactly like the LUT in rip_reservoir
+    static int16_t tanh_entry(int index);
+
+   private:
+    std::vector<uint32_t> _weight;
+    std::vector<int16_t> _state[2];
+    int _cur;
+
+    uint32_t _size;
+    uint32_t _leak;
+    uint32_t _base;
+    uint32_t _cycles;
+
+    // row sum in ACC_WIDTH bit arithmetic; `addr` is advanced past the row
+    int64_t row_sum(uint32_t& addr) const;
+};
+
+#endif
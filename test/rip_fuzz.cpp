@@ -0,0 +1,194 @@
+//
+// Differential fuzzing harness
+// - generates constrained-random RV32IMC (+ Zba/Zbb/RV32A subset) programs (rv32_gen)
+// - runs each program on Vcore and on the reference ISS (rv32_iss)
+// - compares the data region and the register signature
+// - minimizes failing programs by dropping instruction groups
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rv32_gen.hpp"
+#include "rv32_iss.hpp"
+#include "sim_runner.hpp"
+#include "work_stealing_pool.hpp"
+
+namespace {
+
+typedef struct {
+    bool failed;
+    std::string report;
+    uint64_t instret;
+    uint64_t cycles;
+} fuzz_result_t;
+
+fuzz_result_t check(SimRunner& runner, const FuzzProgram& program, uint64_t max_cycles) {
+    fuzz_result_t result = {false, "", 0, 0};
+
+    SparseMemory iss_mem;
+    program.load(iss_mem);
+    Rv32Iss iss(iss_mem);
+    result.instret = iss.run(max_cycles);
+
+    program.load(runner.memory());
+    sim_job_t job = {0, "", max_cycles, 0, 0};
+    sim_result_t sim = runner.run_loaded(job);
+    result.cycles = sim.cycles;
+
+    std::ostringstream oss;
+    if (!iss.finished()) {
+        // generated programs always terminate; this is a generator bug
+        oss << "iss: did not finish\n";
+    }
+    if (sim.status != "finished") {
+        oss << "dut: " << sim.status << " after " << sim.cycles << " cycles\n";
+    }
+    char buf[96];
+    for (uint32_t addr = FuzzProgram::DATA_BASE;
+         addr < FuzzProgram::SIG_BASE + FuzzProgram::SIG_SIZE; addr += 4) {
+        uint32_t expected = iss_mem.read(addr >> 2);
+        uint32_t actual = runner.memory().read(addr >> 2);
+        if (expected != actual) {
+            if (addr >= FuzzProgram::SIG_BASE) {
+                std::snprintf(buf, sizeof(buf), "x%-2u: expected %08X, actual %08X\n",
+                              1 + (addr - FuzzProgram::SIG_BASE) / 4, expected, actual);
+            } else {
+                std::snprintf(buf, sizeof(buf), "[%08X]: expected %08X, actual %08X\n", addr,
+                              expected, actual);
+            }
+            oss << buf;
+        }
+    }
+    result.report = oss.str();
+    result.failed = !result.report.empty();
+    return result;
+}
+
+// delta debugging over instruction groups
+FuzzProgram minimize(SimRunner& runner, FuzzProgram program, uint64_t max_cycles) {
+    size_t chunk = program.body.size() / 2;
+    while (chunk >= 1) {
+        bool removed = false;
+        for (size_t start = 0; start < program.body.size();) {
+            FuzzProgram candidate = program;
+            size_t end = std::min(start + chunk, candidate.body.size());
+            candidate.body.erase(candidate.body.begin() + start, candidate.body.begin() + end);
+            if (check(runner, candidate, max_cycles).failed) {
+                program = candidate;
+                removed = true;
+            } else {
+                start += chunk;
+            }
+        }
+        if (!removed) {
+            chunk /= 2;
+        }
+    }
+    return program;
+}
+
+void usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s [-j WORKERS] [--seed SEED] [--programs N] [--items N]\n"
+                 "          [--max-cycles N] [--out DIR] [--no-minimize]\n",
+                 argv0);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t num_workers = std::thread::hardware_concurrency();
+    uint64_t seed = std::chrono::steady_clock::now().time_since_epoch().count();
+    size_t num_programs = 1000;
+    size_t num_items = 300;
+    uint64_t max_cycles = 1000000;
+    std::string out_dir = "fuzz_failures";
+    bool do_minimize = true;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            num_workers = std::stoul(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::stoull(argv[++i], nullptr, 0);
+        } else if (arg == "--programs" && i + 1 < argc) {
+            num_programs = std::stoul(argv[++i]);
+        } else if (arg == "--items" && i + 1 < argc) {
+            num_items = std::stoul(argv[++i]);
+        } else if (arg == "--max-cycles" && i + 1 < argc) {
+            max_cycles = std::stoull(argv[++i]);
+        } else if (arg == "--out" && i + 1 < argc) {
+            out_dir = argv[++i];
+        } else if (arg == "--no-minimize") {
+            do_minimize = false;
+        } else {
+            usage(argv[0]);
+            return arg == "-h" || arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::printf("seed: %llu, programs: %zu, items: %zu\n",
+                static_cast<unsigned long long>(seed), num_programs, num_items);
+    std::fflush(stdout);
+
+    std::atomic<uint64_t> total_instret(0);
+    std::atomic<uint64_t> total_cycles(0);
+    std::atomic<size_t> num_failed(0);
+    std::mutex out_mutex;
+    auto begin = std::chrono::steady_clock::now();
+    {
+        WorkStealingPool pool(num_workers);
+        std::vector<std::unique_ptr<SimRunner>> runners(pool.size());
+
+        for (size_t i = 0; i < num_programs; i++) {
+            pool.submit([&, i](size_t worker) {
+                if (!runners[worker]) {
+                    runners[worker].reset(new SimRunner());
+                }
+                SimRunner& runner = *runners[worker];
+
+                FuzzProgram program = RandomProgramGenerator(seed + i).generate(num_items);
+                fuzz_result_t result = check(runner, program, max_cycles);
+                total_instret += result.instret;
+                total_cycles += result.cycles;
+                if (!result.failed) {
+                    return;
+                }
+
+                num_failed++;
+                if (do_minimize) {
+                    program = minimize(runner, program, max_cycles);
+                    result = check(runner, program, max_cycles);
+                }
+
+                std::lock_guard<std::mutex> lock(out_mutex);
+                std::filesystem::create_directories(out_dir);
+                std::string base = out_dir + "/fuzz_" + std::to_string(program.seed);
+                program.write_hex(base + ".hex");
+                std::ofstream(base + ".txt") << program.describe() << "\n" << result.report;
+                std::printf("FAILED seed %llu (%zu groups) -> %s.hex\n%s",
+                            static_cast<unsigned long long>(program.seed), program.body.size(),
+                            base.c_str(), result.report.c_str());
+                std::fflush(stdout);
+            });
+        }
+        pool.wait();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+    std::printf("instructions: %llu, cycles: %llu, failed: %zu/%zu, %.2f s (%.2f MIPS)\n",
+                static_cast<unsigned long long>(total_instret.load()),
+                static_cast<unsigned long long>(total_cycles.load()), num_failed.load(),
+                num_programs, elapsed.count(), total_instret / elapsed.count() / 1e6);
+    return num_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+//
+// Batch simulation server
+// - reads jobs from a manifest (or stdin) and runs them on a pool of
+//   reusable Vcore instances
+// - writes one JSON line per finished job
+// - with --instret, also reports the dynamic instruction count from the
+//   reference ISS (e.g. to compare builds with and without Zba/Zbb)
+// - --plusarg passes a plusarg to every model, e.g. +bp_ro_seed=<n>
+// - every job starts with an empty branch predictor table, so its result does
+//   not depend on which jobs its worker ran before; --keep-predictor keeps
+//   what those jobs trained
+//
+// manifest format (one job per line, `#` starts a comment):
+//   <program.hex|program.elf> [max_cycles=N] [mem_head=ADDR] [ret_head=ADDR]
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sim_runner.hpp"
+#include "work_stealing_pool.hpp"
+
+namespace {
+
+constexpr uint64_t DEFAULT_MAX_CYCLES = 10000000;
+
+void usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s [-j WORKERS] [-o OUTPUT] [--max-cycles N] [--instret] "
+                 "[--plusarg +ARG]... [--keep-predictor] [MANIFEST|-]\n",
+                 argv0);
+}
+
+bool parse_job(const std::string& line, size_t id, uint64_t max_cycles, sim_job_t& job) {
+    std::istringstream iss(line.substr(0, line.find('#')));
+    if (!(iss >> job.program)) {
+        return false;
+    }
+    job.id = id;
+    job.max_cycles = max_cycles;
+    job.mem_head = 0;
+    job.ret_head = 0;
+
+    std::string option;
+    while (iss >> option) {
+        size_t eq = option.find('=');
+        if (eq == std::string::npos) {
+            throw std::invalid_argument("invalid option: " + option);
+        }
+        std::string key = option.substr(0, eq);
+        unsigned long long value = std::stoull(option.substr(eq + 1), nullptr, 0);
+        if (key == "max_cycles") {
+            job.max_cycles = value;
+        } else if (key == "mem_head") {
+            job.mem_head = static_cast<uint32_t>(value);
+        } else if (key == "ret_head") {
+            job.ret_head = static_cast<uint32_t>(value);
+        } else {
+            throw std::invalid_argument("unknown option: " + key);
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t num_workers = std::thread::hardware_concurrency();
+    uint64_t max_cycles = DEFAULT_MAX_CYCLES;
+    bool count_instret = false;
+    bool keep_predictor = false;
+    std::vector<std::string> plusargs;
+    std::string manifest = "-";
+    std::string output = "-";
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            num_workers = std::stoul(argv[++i]);
+        } else if (arg == "-o" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (arg == "--max-cycles" && i + 1 < argc) {
+            max_cycles = std::stoull(argv[++i]);
+        } else if (arg == "--instret") {
+            count_instret = true;
+        } else if (arg == "--plusarg" && i + 1 < argc) {
+            plusargs.push_back(argv[++i]);
+        } else if (arg == "--keep-predictor") {
+            keep_predictor = true;
+        } else if (arg == "-h" || arg == "--help") {
+            usage(argv[0]);
+            return 0;
+        } else if (arg[0] != '-' || arg == "-") {
+            manifest = arg;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::ifstream manifest_file;
+    if (manifest != "-") {
+        manifest_file.open(manifest);
+        if (!manifest_file.is_open()) {
+            std::fprintf(stderr, "cannot open manifest: %s\n", manifest.c_str());
+            return 1;
+        }
+    }
+    std::istream& in = manifest == "-" ? std::cin : manifest_file;
+
+    // the core prints to stdout (store to 0x10000000), so results default to
+    // stdout only when no other file is given
+    std::ofstream output_file;
+    if (output != "-") {
+        output_file.open(output);
+        if (!output_file.is_open()) {
+            std::fprintf(stderr, "cannot open output: %s\n", output.c_str());
+            return 1;
+        }
+    }
+    std::ostream& out = output == "-" ? std::cout : output_file;
+    std::mutex out_mutex;
+
+    WorkStealingPool pool(num_workers);
+    std::vector<std::unique_ptr<SimRunner>> runners(pool.size());
+
+    std::string line;
+    size_t id = 0;
+    size_t line_num = 0;
+    while (std::getline(in, line)) {
+        line_num++;
+        sim_job_t job;
+        try {
+            if (!parse_job(line, id, max_cycles, job)) {
+                continue;
+            }
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "%s:%zu: %s\n", manifest.c_str(), line_num, e.what());
+            continue;
+        }
+        id++;
+
+        pool.submit([job, count_instret, keep_predictor, &plusargs, &runners, &out,
+                     &out_mutex](size_t worker) {
+            // each worker builds its model once and reuses it for every job
+            if (!runners[worker]) {
+                runners[worker].reset(new SimRunner(plusargs));
+                runners[worker]->set_keep_predictor(keep_predictor);
+            }
+            sim_result_t result = runners[worker]->run(job);
+            result.worker = worker;
+            if (count_instret) {
+                result.instret = SimRunner::count_instret(job);
+            }
+
+            std::string json = to_json(result);
+            std::lock_guard<std::mutex> lock(out_mutex);
+            out << json << std::endl;
+        });
+    }
+
+    pool.wait();
+    return 0;
+}
@@ -0,0 +1,651 @@
+#include "rv32_gen.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace rv32 {
+
+uint32_t r_type(uint32_t funct7, uint32_t rs2, uint32_t rs1, uint32_t funct3, uint32_t rd,
+                uint32_t opcode) {
+    return (funct7 << 25) | (rs2 << 20) | (rs1 << 15) | (funct3 << 12) | (rd << 7) | opcode;
+}
+
+uint32_t i_type(int32_t imm, uint32_t rs1, uint32_t funct3, uint32_t rd, uint32_t opcode) {
+    return ((imm & 0xFFF) << 20) | (rs1 << 15) | (funct3 << 12) | (rd << 7) | opcode;
+}
+
+uint32_t s_type(int32_t imm, uint32_t rs2, uint32_t rs1, uint32_t funct3, uint32_t opcode) {
+    return (((imm >> 5) & 0x7F) << 25) | (rs2 << 20) | (rs1 << 15) | (funct3 << 12) |
+           ((imm & 0x1F) << 7) | opcode;
+}
+
+uint32_t b_type(int32_t imm, uint32_t rs2, uint32_t rs1, uint32_t funct3) {
+    return (((imm >> 12) & 0x1) << 31) | (((imm >> 5) & 0x3F) << 25) | (rs2 << 20) |
+           (rs1 << 15) | (funct3 << 12) | (((imm >> 1) & 0xF) << 8) | (((imm >> 11) & 0x1) << 7) |
+           0b1100011;
+}
+
+uint32_t u_type(uint32_t imm, uint32_t rd, uint32_t opcode) {
+    return (imm & 0xFFFFF000) | (rd << 7) | opcode;
+}
+
+uint32_t j_type(int32_t imm, uint32_t rd) {
+    return (((imm >> 20) & 0x1) << 31) | (((imm >> 1) & 0x3FF) << 21) |
+           (((imm >> 11) & 0x1) << 20) | (((imm >> 12) & 0xFF) << 12) | (rd << 7) | 0b1101111;
+}
+
+uint16_t cr_type(uint32_t funct4, uint32_t rd, uint32_t rs2) {
+    return (funct4 << 12) | (rd << 7) | (rs2 << 2) | 0b10;
+}
+
+uint16_t ci_type(uint32_t funct3, int32_t imm, uint32_t rd, uint32_t op) {
+    return (funct3 << 13) | (((imm >> 5) & 0x1) << 12) | (rd << 7) | ((imm & 0x1F) << 2) | op;
+}
+
+uint16_t cl_type(uint32_t funct3, uint32_t imm, uint32_t rs1, uint32_t rd) {
+    return (funct3 << 13) | (((imm >> 3) & 0x7) << 10) | ((rs1 - 8) << 7) |
+           (((imm >> 2) & 0x1) << 6) | (((imm >> 6) & 0x1) << 5) | ((rd - 8) << 2);
+}
+
+uint16_t ca_type(uint32_t funct2, uint32_t rs2, uint32_t rd) {
+    return (0b100011 << 10) | ((rd - 8) << 7) | (funct2 << 5) | ((rs2 - 8) << 2) | 0b01;
+}
+
+uint16_t cb_type(uint32_t funct3, int32_t imm, uint32_t rs1) {
+    return (funct3 << 13) | (((imm >> 8) & 0x1) << 12) | (((imm >> 3) & 0x3) << 10) |
+           ((rs1 - 8) << 7) | (((imm >> 6) & 0x3) << 5) | (((imm >> 1) & 0x3) << 3) |
+           (((imm >> 5) & 0x1) << 2) | 0b01;
+}
+
+uint16_t cb_alu(uint32_t funct2, int32_t imm, uint32_t rd) {
+    return (0b100 << 13) | (((imm >> 5) & 0x1) << 12) | (funct2 << 10) | ((rd - 8) << 7) |
+           ((imm & 0x1F) << 2) | 0b01;
+}
+
+uint16_t cj_type(uint32_t funct3, int32_t imm) {
+    return (funct3 << 13) | (((imm >> 11) & 0x1) << 12) | (((imm >> 4) & 0x1) << 11) |
+           (((imm >> 8) & 0x3) << 9) | (((imm >> 10) & 0x1) << 8) | (((imm >> 6) & 0x1) << 7) |
+           (((imm >> 7) & 0x1) << 6) | (((imm >> 1) & 0x7) << 3) | (((imm >> 5) & 0x1) << 2) |
+           0b01;
+}
+
+uint32_t addi(uint32_t rd, uint32_t rs1, int32_t imm) {
+    return i_type(imm, rs1, 0b000, rd, OP_IMM);
+}
+
+uint32_t add(uint32_t rd, uint32_t rs1, uint32_t rs2) {
+    return r_type(0, rs2, rs1, 0b000, rd, OP);
+}
+
+uint32_t lui(uint32_t rd, uint32_t imm) { return u_type(imm, rd, LUI); }
+
+uint32_t lw(uint32_t rd, uint32_t rs1, int32_t offset) {
+    return i_type(offset, rs1, 0b010, rd, LOAD);
+}
+
+uint32_t sw(uint32_t rs2, uint32_t rs1, int32_t offset) {
+    return s_type(offset, rs2, rs1, 0b010, STORE);
+}
+
+uint32_t csrr(uint32_t csr, uint32_t rd) { return i_type(csr, 0, 0b010, rd, SYSTEM); }
+
+uint32_t csrw(uint32_t csr, uint32_t rs1) { return i_type(csr, rs1, 0b001, 0, SYSTEM); }
+
+uint32_t csrwi(uint32_t csr, uint32_t zimm) { return i_type(csr, zimm, 0b101, 0, SYSTEM); }
+
+uint32_t csrrw(uint32_t csr, uint32_t rd, uint32_t rs1) {
+    return i_type(csr, rs1, 0b001, rd, SYSTEM);
+}
+
+uint32_t amo(uint32_t funct5, uint32_t rd, uint32_t rs1, uint32_t rs2) {
+    return r_type(funct5 << 2, rs2, rs1, 0b010, rd, AMO);
+}
+
+}  // namespace rv32
+
+namespace {
+
+using rv32::AMO;
+using rv32::LOAD;
+using rv32::OP;
+using rv32::OP_IMM;
+using rv32::STORE;
+using rv32::SYSTEM;
+
+using rv32::AMOADD;
+using rv32::AMOOR;
+using rv32::AMOSWAP;
+using rv32::LR;
+using rv32::SC;
+
+constexpr uint32_t NUM_HOT_REGS = 6;
+// keeps the code below DATA_BASE
+constexpr size_t MAX_CODE_WORDS = FuzzProgram::DATA_BASE / 4 - 64;
+
+}  // namespace
+
+/*
+ * FuzzProgram
+ */
+
+std::vector<uint32_t> FuzzProgram::epilogue() {
+    std::vector<uint32_t> code;
+    for (uint32_t r = 1; r <= 30; r++) {
+        code.push_back(rv32::s_type(DATA_SIZE + 4 * (r - 1), r, BASE_REG, 0b010, STORE));
+    }
+    // let the last stores drain before finishing
+    for (int i = 0; i < 4; i++) {
+        code.push_back(rv32::NOP);
+    }
+    code.push_back(rv32::EXT);
+    return code;
+}
+
+std::vector<uint32_t> FuzzProgram::code() const {
+    std::vector<uint32_t> words = prologue;
+    for (const auto& item : body) {
+        words.insert(words.end(), item.code.begin(), item.code.end());
+    }
+    std::vector<uint32_t> tail = epilogue();
+    words.insert(words.end(), tail.begin(), tail.end());
+    return words;
+}
+
+size_t FuzzProgram::size() const {
+    size_t num = prologue.size() + epilogue().size();
+    for (const auto& item : body) {
+        num += item.code.size();
+    }
+    return num;
+}
+
+void FuzzProgram::load(SparseMemory& mem) const {
+    mem.clear();
+    std::vector<uint32_t> words = code();
+    for (size_t i = 0; i < words.size(); i++) {
+        mem.write(i, words[i]);
+    }
+    for (size_t i = 0; i < data.size(); i++) {
+        mem.write(DATA_BASE / 4 + i, data[i]);
+    }
+}
+
+bool FuzzProgram::write_hex(const std::string& filename) const {
+    std::ofstream ofs(filename);
+    if (!ofs.is_open()) {
+        return false;
+    }
+    char buf[16];
+    for (uint32_t word : code()) {
+        std::snprintf(buf, sizeof(buf), "%08X\n", word);
+        ofs << buf;
+    }
+    std::snprintf(buf, sizeof(buf), "@%X\n", DATA_BASE / 4);
+    ofs << buf;
+    for (uint32_t word : data) {
+        std::snprintf(buf, sizeof(buf), "%08X\n", word);
+        ofs << buf;
+    }
+    return true;
+}
+
+std::string FuzzProgram::describe() const {
+    std::ostringstream oss;
+    char buf[16];
+    uint32_t addr = prologue.size() * 4;
+    oss << "seed: " << seed << "\n";
+    for (const auto& item : body) {
+        std::snprintf(buf, sizeof(buf), "%08X ", addr);
+        oss << buf << item.kind << ":";
+        for (uint32_t word : item.code) {
+            std::snprintf(buf, sizeof(buf), " %08X", word);
+            oss << buf;
+        }
+        oss << "\n";
+        addr += item.code.size() * 4;
+    }
+    return oss.str();
+}
+
+/*
+ * RandomProgramGenerator
+ */
+
+RandomProgramGenerator::RandomProgramGenerator(uint64_t seed) : _seed(seed), _engine(seed) {}
+
+uint32_t RandomProgramGenerator::rand(uint32_t n) {
+    return std::uniform_int_distribution<uint32_t>(0, n - 1)(_engine);
+}
+
+// a few registers are reused throughout a program to create dependencies
+uint32_t RandomProgramGenerator::hot_reg() { return _hot_regs[rand(_hot_regs.size())]; }
+
+uint32_t RandomProgramGenerator::dest_reg() {
+    uint32_t dice = rand(16);
+    if (dice == 0) {
+        return 0;  // x0 must never be forwarded
+    } else if (dice < 3) {
+        return 1 + rand(30);
+    }
+    return hot_reg();
+}
+
+uint32_t RandomProgramGenerator::special_value() {
+    static const uint32_t VALUES[] = {0x0, 0x1, 0xFFFFFFFF, 0x80000000, 0x7FFFFFFF};
+    if (rand(2)) {
+        return VALUES[rand(sizeof(VALUES) / sizeof(VALUES[0]))];
+    }
+    return static_cast<uint32_t>(_engine());
+}
+
+void RandomProgramGenerator::li(std::vector<uint32_t>& code, uint32_t rd, uint32_t value) {
+    code.push_back(rv32::u_type(value + 0x800, rd, 0b0110111));  // lui
+    code.push_back(rv32::i_type(value & 0xFFF, rd, 0b000, rd, OP_IMM));
+}
+
+uint32_t RandomProgramGenerator::alu_op(uint32_t rd, uint32_t rs1, uint32_t rs2) {
+    static const uint32_t R_OPS[][2] = {
+        {0b0000000, 0b000}, {0b0100000, 0b000}, {0b0000000, 0b001}, {0b0000000, 0b010},
+        {0b0000000, 0b011}, {0b0000000, 0b100}, {0b0000000, 0b101}, {0b0100000, 0b101},
+        {0b0000000, 0b110}, {0b0000000, 0b111},
+        // Zba, Zbb
+        {0b0010000, 0b010}, {0b0010000, 0b100}, {0b0010000, 0b110}, {0b0100000, 0b100},
+        {0b0100000, 0b110}, {0b0100000, 0b111}, {0b0000101, 0b100}, {0b0000101, 0b101},
+        {0b0000101, 0b110}, {0b0000101, 0b111}, {0b0110000, 0b001}, {0b0110000, 0b101},
+    };
+    static const uint32_t I_OPS[] = {0b000, 0b010, 0b011, 0b100, 0b110, 0b111};
+    // Zbb unary operations: {funct12, funct3}
+    static const uint32_t UNARY_OPS[][2] = {
+        {0x600, 0b001}, {0x601, 0b001}, {0x602, 0b001}, {0x604, 0b001},
+        {0x605, 0b001}, {0x287, 0b101}, {0x698, 0b101},
+    };
+
+    switch (rand(4)) {
+        case 0:
+        case 1: {
+            const uint32_t* op = R_OPS[rand(sizeof(R_OPS) / sizeof(R_OPS[0]))];
+            return rv32::r_type(op[0], rs2, rs1, op[1], rd, OP);
+        }
+        case 2: {
+            int32_t imm = static_cast<int32_t>(rand(4096)) - 2048;
+            return rv32::i_type(imm, rs1, I_OPS[rand(6)], rd, OP_IMM);
+        }
+        default:
+            switch (rand(8)) {
+                case 0:  // slli
+                    return rv32::i_type(rand(32), rs1, 0b001, rd, OP_IMM);
+                case 1:  // srli
+                    return rv32::i_type(rand(32), rs1, 0b101, rd, OP_IMM);
+                case 2:  // srai
+                    return rv32::i_type(0x400 | rand(32), rs1, 0b101, rd, OP_IMM);
+                case 3:  // rori
+                    return rv32::i_type(0x600 | rand(32), rs1, 0b101, rd, OP_IMM);
+                case 4: {  // clz, ctz, cpop, sext.b, sext.h, orc.b, rev8
+                    const uint32_t* op = UNARY_OPS[rand(sizeof(UNARY_OPS) / sizeof(UNARY_OPS[0]))];
+                    return rv32::i_type(op[0], rs1, op[1], rd, OP_IMM);
+                }
+                case 5:  // zext.h
+                    return rv32::r_type(0b0000100, 0, rs1, 0b100, rd, OP);
+                case 6:  // lui
+                    return rv32::u_type(_engine(), rd, 0b0110111);
+                default:  // auipc
+                    return rv32::u_type(_engine(), rd, 0b0010111);
+            }
+    }
+}
+
+// x8..x15, preferring the hot registers among them
+uint32_t RandomProgramGenerator::c_reg() {
+    uint32_t r = hot_reg();
+    return (8 <= r && r < 16) ? r : 8 + rand(8);
+}
+
+// one compressed ALU instruction, or a 32-bit one that may cross a word boundary
+void RandomProgramGenerator::c_alu_op(std::vector<uint16_t>& parcels) {
+    switch (rand(7)) {
+        case 0:  // c.addi
+            parcels.push_back(rv32::ci_type(0b000, rand(64), dest_reg(), 0b01));
+            break;
+        case 1:  // c.li
+            parcels.push_back(rv32::ci_type(0b010, rand(64), dest_reg(), 0b01));
+            break;
+        case 2: {  // c.lui; rd = 2 would be c.addi16sp
+            uint32_t rd;
+            do {
+                rd = dest_reg();
+            } while (rd == 0 || rd == 2);
+            parcels.push_back(rv32::ci_type(0b011, 1 + rand(63), rd, 0b01));
+            break;
+        }
+        case 3:  // c.mv, c.add
+            parcels.push_back(rv32::cr_type(0b1000 | rand(2), dest_reg(), hot_reg()));
+            break;
+        case 4:  // c.slli
+            parcels.push_back(rv32::ci_type(0b000, rand(32), dest_reg(), 0b10));
+            break;
+        case 5:  // c.srli, c.srai, c.andi or c.sub, c.xor, c.or, c.and
+            if (rand(2)) {
+                uint32_t funct2 = rand(3);
+                parcels.push_back(rv32::cb_alu(funct2, funct2 == 2 ? rand(64) : rand(32), c_reg()));
+            } else {
+                parcels.push_back(rv32::ca_type(rand(4), c_reg(), c_reg()));
+            }
+            break;
+        default: {
+            uint32_t inst = alu_op(dest_reg(), hot_reg(), hot_reg());
+            parcels.push_back(inst & 0xFFFF);
+            parcels.push_back(inst >> 16);
+            break;
+        }
+    }
+}
+
+uint32_t RandomProgramGenerator::muldiv_op(uint32_t rd, uint32_t rs1, uint32_t rs2) {
+    return rv32::r_type(0b0000001, rs2, rs1, rand(8), rd, OP);
+}
+
+uint32_t RandomProgramGenerator::load_op(uint32_t rd) {
+    static const uint32_t FUNCT3[] = {0b000, 0b001, 0b010, 0b100, 0b101};
+    static const uint32_t SIZE[] = {1, 2, 4, 1, 2};
+    uint32_t i = rand(5);
+    int32_t offset = rand(FuzzProgram::DATA_SIZE / SIZE[i]) * SIZE[i];
+    return rv32::i_type(offset, FuzzProgram::BASE_REG, FUNCT3[i], rd, LOAD);
+}
+
+uint32_t RandomProgramGenerator::store_op(uint32_t rs2, int32_t& offset, uint32_t& funct3) {
+    funct3 = rand(3);
+    uint32_t size = 1u << funct3;
+    offset = rand(FuzzProgram::DATA_SIZE / size) * size;
+    return rv32::s_type(offset, rs2, FuzzProgram::BASE_REG, funct3, STORE);
+}
+
+uint32_t RandomProgramGenerator::csr_num() {
+    // mstatus, mie, mtvec, mepc, mcause
+    // no interrupt can become pending as mtimecmp keeps its reset value
+    static const uint32_t CSRS[] = {0x300, 0x304, 0x305, 0x341, 0x342};
+    return CSRS[rand(5)];
+}
+
+gen_item_t RandomProgramGenerator::alu_chain() {
+    gen_item_t item = {"alu_chain", {}};
+    uint32_t prev = hot_reg();
+    for (uint32_t i = 0, n = 2 + rand(4); i < n; i++) {
+        uint32_t rd = dest_reg();
+        item.code.push_back(rand(2) ? alu_op(rd, prev, hot_reg()) : alu_op(rd, hot_reg(), prev));
+        prev = rd;
+    }
+    return item;
+}
+
+gen_item_t RandomProgramGenerator::load_use() {
+    gen_item_t item = {"load_use", {}};
+    uint32_t rd = dest_reg();
+    item.code.push_back(load_op(rd));
+    // distance 0..2 covers forwarding from MA, WB and after WB
+    for (uint32_t i = 0, n = rand(3); i < n; i++) {
+        item.code.push_back(alu_op(dest_reg(), hot_reg(), hot_reg()));
+    }
+    item.code.push_back(rand(2) ? alu_op(dest_reg(), rd, hot_reg())
+                                : rv32::r_type(0, rd, hot_reg(), 0b000, dest_reg(), OP));
+    return item;
+}
+
+gen_item_t RandomProgramGenerator::store_load() {
+    gen_item_t item = {"store_load", {}};
+    int32_t offset;
+    uint32_t funct3;
+    item.code.push_back(store_op(hot_reg(), offset, funct3));
+    uint32_t rd = dest_reg();
+    // reload the same bytes, sign- or zero-extended
+    uint32_t load_funct3 = funct3 == 0b010 ? 0b010 : (funct3 | (rand(2) << 2));
+    item.code.push_back(rv32::i_type(offset, FuzzProgram::BASE_REG, load_funct3, rd, LOAD));
+    item.code.push_back(alu_op(dest_reg(), rd, rd));
+    return item;
+}
+
+gen_item_t RandomProgramGenerator::csr_raw() {
+    gen_item_t item = {"csr_raw", {}};
+    uint32_t csr = csr_num();
+    uint32_t rd = dest_reg();
+    uint32_t funct3 = 1 + rand(3);
+    if (rand(2)) {
+        item.code.push_back(rv32::i_type(csr, hot_reg(), funct3, rd, SYSTEM));
+    } else {
+        item.code.push_back(rv32::i_type(csr, rand(32), funct3 | 0x4, rd, SYSTEM));  // zimm
+    }
+    for (uint32_t i = 0, n = rand(3); i < n; i++) {
+        item.code.push_back(alu_op(dest_reg(), hot_reg(), hot_reg()));
+    }
+    uint32_t rd2 = dest_reg();
+    item.code.push_back(rv32::i_type(csr, 0, 0b010, rd2, SYSTEM));  // csrr
+    item.code.push_back(rv32::r_type(0, rd2, rd, 0b100, dest_reg(), OP));
+    return item;
+}
+
+gen_item_t RandomProgramGenerator::branch_shadow() {
+    static const uint32_t FUNCT3[] = {0b000, 0b001, 0b100, 0b101, 0b110, 0b111};
+    gen_item_t item = {"branch_shadow", {}};
+    uint32_t rs1 = hot_reg();
+    if (rand(4)) {
+        rs1 = dest_reg();
+        item.code.push_back(load_op(rs1));
+    }
+    // forward only, so every program terminates
+    uint32_t skip = 1 + rand(3);
+    item.code.push_back(rv32::b_type(4 * (skip + 1), hot_reg(), rs1, FUNCT3[rand(6)]));
+    for (uint32_t i = 0; i < skip; i++) {
+        item.code.push_back(alu_op(dest_reg(), hot_reg(), hot_reg()));
+    }
+    return item;
+}
+
+gen_item_t RandomProgramGenerator::muldiv_chain() {
+    gen_item_t item = {"muldiv_chain", {}};
+    uint32_t prev = hot_reg();
+    if (rand(2)) {
+        li(item.code, prev, special_value());
+    }
+    for (uint32_t i = 0, n = 2 + rand(3); i < n; i++) {
+        uint32_t rd = dest_reg();
+        item.code.push_back(rand(2) ? muldiv_op(rd, prev, hot_reg())
+                                    : muldiv_op(rd, hot_reg(), prev));
+        prev = rd;
+    }
+    return item;
+}
+
+uint32_t RandomProgramGenerator::amo_op(uint32_t funct5, uint32_t rd, uint32_t rs2,
+                                        uint32_t addr) {
+    // aq/rl are random; the core ignores them
+    return rv32::r_type((funct5 << 2) | rand(4), rs2, addr, 0b010, rd, AMO);
+}
+
+gen_item_t RandomProgramGenerator::atomic() {
+    gen_item_t item = {"atomic", {}};
+    uint32_t addr = hot_reg();
+    item.code.push_back(rv32::i_type(rand(FuzzProgram::DATA_SIZE / 4) * 4, FuzzProgram::BASE_REG,
+                                     0b000, addr, OP_IMM));
+    uint32_t rd = dest_reg();
+    switch (rand(3)) {
+        case 0: {
+            static const uint32_t FUNCT5[] = {AMOSWAP, AMOADD, AMOOR};
+            item.code.push_back(amo_op(FUNCT5[rand(3)], rd, hot_reg(), addr));
+            break;
+        }
+        case 1:
+            // the ALU op may move addr, so SC may fail
+            item.code.push_back(amo_op(LR, dest_reg(), 0, addr));
+            for (uint32_t i = 0, n = rand(2); i < n; i++) {
+                item.code.push_back(alu_op(dest_reg(), hot_reg(), hot_reg()));
+            }
+            item.code.push_back(amo_op(SC, rd, hot_reg(), addr));
+            break;
+        default:
+            // succeeds only on a reservation left by an earlier item
+            item.code.push_back(amo_op(SC, rd, hot_reg(), addr));
+            break;
+    }
+    item.code.push_back(alu_op(dest_reg(), rd, hot_reg()));
+    return item;
+}
+
+gen_item_t RandomProgramGenerator::jump() {
+    gen_item_t item = {"jump", {}};
+    uint32_t skip = 1 + rand(2);
+    if (rand(2)) {
+        item.code.push_back(rv32::j_type(4 * (skip + 1), dest_reg()));
+    } else {
+        uint32_t rt = hot_reg();
+        item.code.push_back(rv32::u_type(0, rt, 0b0010111));  // auipc rt, 0
+        item.code.push_back(rv32::i_type(4 * (skip + 2), rt, 0b000, dest_reg(), 0b1100111));
+    }
+    for (uint32_t i = 0; i < skip; i++) {
+        item.code.push_back(alu_op(dest_reg(), hot_reg(), hot_reg()));
+    }
+    return item;
+}
+
+gen_item_t RandomProgramGenerator::compressed() {
+    gen_item_t item = {"compressed", {}};
+    std::vector<uint16_t> parcels;
+    auto push32 = [&parcels](uint32_t inst) {
+        parcels.push_back(inst & 0xFFFF);
+        parcels.push_back(inst >> 16);
+    };
+    // forward only; offsets count the parcels of the skipped instructions
+    auto skipped = [this]() {
+        std::vector<uint16_t> skip;
+        for (uint32_t i = 0, n = 1 + rand(3); i < n; i++) {
+            c_alu_op(skip);
+        }
+        return skip;
+    };
+
+    for (uint32_t i = 0, n = 2 + rand(5); i < n; i++) {
+        switch (rand(6)) {
+            case 0:
+            case 1:
+                c_alu_op(parcels);
+                break;
+            case 2: {  // c.lw, c.sw through a base register in x8..x15
+                uint32_t rb = 8 + rand(8);
+                uint32_t offset = 4 * rand(32);
+                push32(rv32::i_type(4 * rand(FuzzProgram::DATA_SIZE / 4 - 32),
+                                    FuzzProgram::BASE_REG, 0b000, rb, OP_IMM));
+                if (rand(2)) {
+                    uint32_t rd = c_reg();
+                    parcels.push_back(rv32::cl_type(0b010, offset, rb, rd));
+                    parcels.push_back(rv32::ca_type(rand(4), rd, c_reg()));
+                } else {
+                    parcels.push_back(rv32::cl_type(0b110, offset, rb, c_reg()));
+                }
+                break;
+            }
+            case 3: {  // c.beqz, c.bnez
+                std::vector<uint16_t> skip = skipped();
+                parcels.push_back(rv32::cb_type(0b110 | rand(2), 2 * (skip.size() + 1), c_reg()));
+                parcels.insert(parcels.end(), skip.begin(), skip.end());
+                break;
+            }
+            case 4: {  // c.j, c.jal
+                std::vector<uint16_t> skip = skipped();
+                parcels.push_back(rv32::cj_type(rand(2) ? 0b101 : 0b001, 2 * (skip.size() + 1)));
+                parcels.insert(parcels.end(), skip.begin(), skip.end());
+                break;
+            }
+            default: {  // c.jr, c.jalr
+                std::vector<uint16_t> skip = skipped();
+                uint32_t rt = hot_reg();
+                push32(rv32::u_type(0, rt, 0b0010111));  // auipc rt, 0
+                push32(rv32::i_type(2 * (skip.size() + 5), rt, 0b000, rt, OP_IMM));
+                parcels.push_back(rv32::cr_type(0b1000 | rand(2), rt, 0));
+                parcels.insert(parcels.end(), skip.begin(), skip.end());
+                break;
+            }
+        }
+    }
+
+    if (parcels.size() % 2) {
+        parcels.push_back(rv32::C_NOP);
+    }
+    for (size_t i = 0; i < parcels.size(); i += 2) {
+        item.code.push_back(parcels[i] | (parcels[i + 1] << 16));
+    }
+    return item;
+}
+
+FuzzProgram RandomProgramGenerator::generate(size_t num_items) {
+    FuzzProgram program;
+    program.seed = _seed;
+    _engine.seed(_seed);
+
+    _hot_regs.clear();
+    while (_hot_regs.size() < NUM_HOT_REGS) {
+        uint32_t r = 1 + rand(30);
+        bool used = false;
+        for (uint32_t hot : _hot_regs) {
+            used |= hot == r;
+        }
+        if (!used) {
+            _hot_regs.push_back(r);
+        }
+    }
+
+    for (uint32_t r = 1; r <= 30; r++) {
+        li(program.prologue, r, special_value());
+    }
+    program.prologue.push_back(rv32::u_type(FuzzProgram::DATA_BASE, FuzzProgram::BASE_REG,
+                                            0b0110111));
+
+    for (uint32_t i = 0; i < FuzzProgram::DATA_SIZE / 4; i++) {
+        program.data.push_back(static_cast<uint32_t>(_engine()));
+    }
+
+    size_t code_words = program.size();
+    for (size_t i = 0; i < num_items; i++) {
+        gen_item_t item;
+        switch (rand(17)) {
+            case 0:
+            case 1:
+            case 2:
+                item = alu_chain();
+                break;
+            case 3:
+            case 4:
+            case 5:
+                item = load_use();
+                break;
+            case 6:
+            case 7:
+                item = store_load();
+                break;
+            case 8:
+                item = csr_raw();
+                break;
+            case 9:
+            case 10:
+                item = branch_shadow();
+                break;
+            case 11:
+            case 12:
+                item = muldiv_chain();
+                break;
+            case 13:
+                item = jump();
+                break;
+            case 14:
+                item = atomic();
+                break;
+            default:
+                item = compressed();
+                break;
+        }
+        code_words += item.code.size();
+        if (code_words > MAX_CODE_WORDS) {
+            break;
+        }
+        program.body.push_back(item);
+    }
+    return program;
+}
@@ -0,0 +1,144 @@
+#ifndef _RV32_GEN_HPP_
+#define _RV32_GEN_HPP_
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sparse_memory.hpp"
+
+/*
+ * instruction encoders
+ */
+namespace rv32 {
+
+uint32_t r_type(uint32_t funct7, uint32_t rs2, uint32_t rs1, uint32_t funct3, uint32_t rd,
+                uint32_t opcode);
+uint32_t i_type(int32_t imm, uint32_t rs1, uint32_t funct3, uint32_t rd, uint32_t opcode);
+uint32_t s_type(int32_t imm, uint32_t rs2, uint32_t rs1, uint32_t funct3, uint32_t opcode);
+uint32_t b_type(int32_t imm, uint32_t rs2, uint32_t rs1, uint32_t funct3);
+uint32_t u_type(uint32_t imm, uint32_t rd, uint32_t opcode);
+uint32_t j_type(int32_t imm, uint32_t rd);
+
+// RV32C; registers in the CA, CB, CL and CS formats are x8..x15
+uint16_t cr_type(uint32_t funct4, uint32_t rd, uint32_t rs2);
+uint16_t ci_type(uint32_t funct3, int32_t imm, uint32_t rd, uint32_t op);
+uint16_t cl_type(uint32_t funct3, uint32_t imm, uint32_t rs1, uint32_t rd);  // also CS
+uint16_t ca_type(uint32_t funct2, uint32_t rs2, uint32_t rd);
+uint16_t cb_type(uint32_t funct3, int32_t imm, uint32_t rs1);
+uint16_t cb_alu(uint32_t funct2, int32_t imm, uint32_t rd);  // c.srli, c.srai, c.andi
+uint16_t cj_type(uint32_t funct3, int32_t imm);
+
+constexpr uint32_t NOP = 0x00000013;  // addi x0, x0, 0
+constexpr uint16_t C_NOP = 0x0001;    // c.addi x0, 0
+constexpr uint32_t EXT = 0x0010000B;  // finishes the core
+constexpr uint32_t ECALL = 0x00000073;
+constexpr uint32_t MRET = 0x30200073;
+
+// major opcodes
+constexpr uint32_t LOAD = 0b0000011;
+constexpr uint32_t OP_IMM = 0b0010011;
+constexpr uint32_t STORE = 0b0100011;
+constexpr uint32_t AMO = 0b0101111;
+constexpr uint32_t OP = 0b0110011;
+constexpr uint32_t LUI = 0b0110111;
+constexpr uint32_t SYSTEM = 0b1110011;
+
+// RV32A funct5
+constexpr uint32_t AMOADD = 0b00000;
+constexpr uint32_t AMOSWAP = 0b00001;
+constexpr uint32_t LR = 0b00010;
+constexpr uint32_t SC = 0b00011;
+constexpr uint32_t AMOOR = 0b01000;
+
+// instructions of hand-written test programs
+uint32_t addi(uint32_t rd, uint32_t rs1, int32_t imm);
+uint32_t add(uint32_t rd, uint32_t rs1, uint32_t rs2);
+uint32_t lui(uint32_t rd, uint32_t imm);  // imm is the value of rd, low 12 bits ignored
+uint32_t lw(uint32_t rd, uint32_t rs1, int32_t offset);
+uint32_t sw(uint32_t rs2, uint32_t rs1, int32_t offset);
+uint32_t csrr(uint32_t csr, uint32_t rd);
+uint32_t csrw(uint32_t csr, uint32_t rs1);
+uint32_t csrwi(uint32_t csr, uint32_t zimm);
+uint32_t csrrw(uint32_t csr, uint32_t rd, uint32_t rs1);
+uint32_t amo(uint32_t funct5, uint32_t rd, uint32_t rs1, uint32_t rs2);  // aq = rl = 0
+
+}  // namespace rv32
+
+// A group of instructions generated to exercise one hazard pattern.
+// Control flow never leaves its own item, so items can be dropped
+// independently while minimizing a failing program.
+typedef struct {
+    std::string kind;
+    std::vector<uint32_t> code;
+} gen_item_t;
+
+class FuzzProgram {
+   public:
+    // loads and stores only touch [DATA_BASE, DATA_BASE + DATA_SIZE)
+    static constexpr uint32_t DATA_BASE = 0x10000;
+    static constexpr uint32_t DATA_SIZE = 0x700;
+    // x1..x30 are stored here by the epilogue
+    static constexpr uint32_t SIG_BASE = DATA_BASE + DATA_SIZE;
+    static constexpr uint32_t SIG_SIZE = 30 * 4;
+    static constexpr uint32_t BASE_REG = 31;
+
+    uint64_t seed;
+    std::vector<uint32_t> prologue;
+    std::vector<gen_item_t> body;
+    std::vector<uint32_t> data;
+
+    std::vector<uint32_t> code() const;
+    size_t size() const;
+    void load(SparseMemory& mem) const;
+    bool write_hex(const std::string& filename) const;
+    std::string describe() const;
+
+    static std::vector<uint32_t> epilogue();
+};
+
+// Constrained-random RV32IMC (+ Zba, Zbb, the RV32A subset) program generator.
+// Targets pipeline hazards: load-use, back-to-back forwarding, CSR
+// read-after-write, branches in the shadow of loads, mul/div chains,
+// LR/SC pairs and AMOs, and compressed code with 32-bit instructions across
+// word boundaries.
+class RandomProgramGenerator {
+   public:
+    explicit RandomProgramGenerator(uint64_t seed);
+
+    // deterministic for a given (seed, num_items)
+    FuzzProgram generate(size_t num_items);
+
+   private:
+    uint64_t _seed;
+    std::mt19937_64 _engine;
+    std::vector<uint32_t> _hot_regs;
+
+    uint32_t rand(uint32_t n);
+    uint32_t hot_reg();
+    uint32_t dest_reg();
+    uint32_t special_value();
+    uint32_t c_reg();
+
+    uint32_t alu_op(uint32_t rd, uint32_t rs1, uint32_t rs2);
+    void c_alu_op(std::vector<uint16_t>& parcels);
+    uint32_t muldiv_op(uint32_t rd, uint32_t rs1, uint32_t rs2);
+    uint32_t load_op(uint32_t rd);
+    uint32_t store_op(uint32_t rs2, int32_t& offset, uint32_t& funct3);
+    uint32_t amo_op(uint32_t funct5, uint32_t rd, uint32_t rs2, uint32_t addr);
+    uint32_t csr_num();
+    void li(std::vector<uint32_t>& code, uint32_t rd, uint32_t value);
+
+    gen_item_t alu_chain();
+    gen_item_t load_use();
+    gen_item_t store_load();
+    gen_item_t csr_raw();
+    gen_item_t branch_shadow();
+    gen_item_t muldiv_chain();
+    gen_item_t atomic();
+    gen_item_t jump();
+    gen_item_t compressed();
+};
+
+#endif
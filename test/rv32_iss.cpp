@@ -0,0 +1,662 @@
+#include "rv32_iss.hpp"
+
+#include "rv32_gen.hpp"
+
+namespace {
+
+inline int32_t sext(uint32_t value, int bits) {
+    return static_cast<int32_t>(value << (32 - bits)) >> (32 - bits);
+}
+
+inline uint32_t imm_i(uint32_t inst) { return sext(inst >> 20, 12); }
+inline uint32_t imm_s(uint32_t inst) {
+    return sext(((inst >> 25) << 5) | ((inst >> 7) & 0x1F), 12);
+}
+inline uint32_t imm_b(uint32_t inst) {
+    return sext(((inst >> 31) << 12) | (((inst >> 7) & 0x1) << 11) |
+                    (((inst >> 25) & 0x3F) << 5) | (((inst >> 8) & 0xF) << 1),
+                13);
+}
+inline uint32_t imm_u(uint32_t inst) { return inst & 0xFFFFF000; }
+inline uint32_t imm_j(uint32_t inst) {
+    return sext(((inst >> 31) << 20) | (((inst >> 12) & 0xFF) << 12) |
+                    (((inst >> 20) & 0x1) << 11) | (((inst >> 21) & 0x3FF) << 1),
+                21);
+}
+
+inline uint32_t ror(uint32_t value, uint32_t shamt) {
+    return shamt ? (value >> shamt) | (value << (32 - shamt)) : value;
+}
+
+// Zbb unary operations on OP-IMM (funct3 = 001 or 101, selected by funct12)
+uint32_t zbb_unary(uint32_t funct12, uint32_t a) {
+    switch (funct12) {
+        case 0x600:  // CLZ
+            return a ? __builtin_clz(a) : 32;
+        case 0x601:  // CTZ
+            return a ? __builtin_ctz(a) : 32;
+        case 0x602:  // CPOP
+            return __builtin_popcount(a);
+        case 0x604:  // SEXT.B
+            return sext(a, 8);
+        case 0x605:  // SEXT.H
+            return sext(a, 16);
+        case 0x287: {  // ORC.B
+            uint32_t rslt = 0;
+            for (int shift = 0; shift < 32; shift += 8) {
+                if ((a >> shift) & 0xFF) {
+                    rslt |= 0xFFu << shift;
+                }
+            }
+            return rslt;
+        }
+        case 0x698:  // REV8
+            return __builtin_bswap32(a);
+        default:
+            return 0;
+    }
+}
+
+// opcodes of the RV32C expansion
+constexpr uint32_t OPCODE_LOAD = 0b0000011;
+constexpr uint32_t OPCODE_STORE = 0b0100011;
+constexpr uint32_t OPCODE_OP_IMM = 0b0010011;
+constexpr uint32_t OPCODE_OP = 0b0110011;
+constexpr uint32_t OPCODE_LUI = 0b0110111;
+constexpr uint32_t OPCODE_JALR = 0b1100111;
+constexpr uint32_t EBREAK = 0x00100073;
+
+inline uint32_t bits(uint32_t value, int hi, int lo) {
+    return (value >> lo) & ((1u << (hi - lo + 1)) - 1);
+}
+
+}  // namespace
+
+Rv32Iss::Rv32Iss(SparseMemory& mem, uint32_t mem_head, uint32_t ret_head)
+    : _mem(mem), _mem_head(mem_head), _ret_head(ret_head), _exclusive_monitor(false) {
+    reset();
+}
+
+void Rv32Iss::reset() {
+    for (auto& x : _x) {
+        x = 0;
+    }
+    _x[2] = SP_ADDR;  // sp; for riscv-tests
+    _pc = 0;
+    _mstatus = 0;
+    _mie = 0;
+    _mtimecmp = ~0ull;
+    _mtvec = 0;
+    _mepc = 0;
+    _mcause = 0;
+    _mode = RUNNING;
+    _instret = 0;
+    _reserved = false;
+    _reservation = 0;
+    _monitor_armed = false;
+    _monitor = 0;
+}
+
+uint32_t Rv32Iss::csr(uint32_t csr_num) const {
+    switch (csr_num) {
+        case MSTATUS:
+            return _mstatus;
+        case MIE:
+            return _mie;
+        case MTVEC:
+            return _mtvec;
+        case MEPC:
+            return _mepc;
+        case MCAUSE:
+            return _mcause;
+        case MTIMECMP:
+            return static_cast<uint32_t>(_mtimecmp);
+        case MTIMECMPH:
+            return static_cast<uint32_t>(_mtimecmp >> 32);
+        default:
+            // mip, cycle, time and branch prediction counters are microarchitectural
+            return 0;
+    }
+}
+
+void Rv32Iss::write_csr(uint32_t csr_num, uint32_t value) {
+    switch (csr_num) {
+        case MSTATUS:
+            _mstatus = value & (MSTATUS_MIE | MSTATUS_MPIE);
+            break;
+        case MIE:
+            _mie = value & ((1u << IRQ_M_TIMER) | (1u << IRQ_M_EXT) | (1u << IRQ_MBOX));
+            break;
+        case MTVEC:
+            _mtvec = value & ~0x2u;  // direct or vectored
+            break;
+        case MEPC:
+            _mepc = value;
+            break;
+        case MCAUSE:
+            _mcause = value;
+            break;
+        case MTIMECMP:
+            _mtimecmp = (_mtimecmp & ~0xFFFFFFFFull) | value;
+            break;
+        case MTIMECMPH:
+            _mtimecmp = (_mtimecmp & 0xFFFFFFFFull) | (static_cast<uint64_t>(value) << 32);
+            break;
+        default:
+            break;
+    }
+}
+
+void Rv32Iss::enter_trap(uint32_t cause) {
+    _mcause = cause;
+    _mepc = _pc;
+    _mstatus = (_mstatus & MSTATUS_MIE) ? MSTATUS_MPIE : 0;
+    _pc = _mtvec & ~0x3u;
+    if ((cause & CAUSE_INTERRUPT) && (_mtvec & 0x1)) {
+        _pc += (cause & ~CAUSE_INTERRUPT) << 2;
+    }
+}
+
+bool Rv32Iss::interrupt(uint32_t code) {
+    if (_mode != RUNNING || !(_mstatus & MSTATUS_MIE) || !((_mie >> code) & 1)) {
+        return false;
+    }
+    enter_trap(CAUSE_INTERRUPT | code);
+    return true;
+}
+
+void Rv32Iss::set_reg(uint32_t num, uint32_t value) {
+    if (num != 0) {
+        _x[num] = value;
+    }
+}
+
+uint32_t Rv32Iss::data_addr(uint32_t addr) const {
+    return (addr & ~0x3u) | (_mode == RUNNING ? _mem_head : _ret_head);
+}
+
+// lane selection mirrors rip_memory_access (no misaligned access support)
+uint32_t Rv32Iss::load(uint32_t funct3, uint32_t addr) const {
+    uint32_t word = _mem.read(data_addr(addr) >> 2);
+    uint32_t offset = addr & 0x3;
+    uint32_t half_shift = offset == 1 ? 8 : (offset & 0x2) ? 16 : 0;
+    switch (funct3) {
+        case 0b000:  // LB
+            return sext(word >> (8 * offset), 8);
+        case 0b001:  // LH
+            return sext(word >> half_shift, 16);
+        case 0b010:  // LW
+            return word;
+        case 0b100:  // LBU
+            return (word >> (8 * offset)) & 0xFF;
+        case 0b101:  // LHU
+            return (word >> half_shift) & 0xFFFF;
+        default:
+            return 0;
+    }
+}
+
+void Rv32Iss::store(uint32_t funct3, uint32_t addr, uint32_t data) {
+    uint32_t offset = addr & 0x3;
+    switch (funct3) {
+        case 0b000:  // SB
+            write_word(data_addr(addr) >> 2, (data & 0xFF) << (8 * offset), 1u << offset);
+            break;
+        case 0b001:  // SH
+            write_word(data_addr(addr) >> 2, (data & 0xFFFF) << (8 * offset),
+                       (offset & 0x2) ? 0xC : 0x3);
+            break;
+        case 0b010:  // SW
+            write_word(data_addr(addr) >> 2, data, 0xF);
+            break;
+        default:
+            break;
+    }
+}
+
+// a data write; clears the slave's monitor on the word
+void Rv32Iss::write_word(uint32_t word_addr, uint32_t data, uint32_t strb) {
+    if (_monitor_armed && _monitor == word_addr) {
+        _monitor_armed = false;
+    }
+    _mem.write(word_addr, data, strb);
+}
+
+// LR.W, SC.W, AMOSWAP.W, AMOADD.W and AMOOR.W; returns the rd value
+uint32_t Rv32Iss::atomic(uint32_t funct5, uint32_t addr, uint32_t src) {
+    uint32_t word_addr = data_addr(addr) >> 2;
+    uint32_t old_value = _mem.read(word_addr);
+    if (funct5 != 0b00010 && funct5 != 0b00011) {
+        // an AMO's exclusive read moves the monitor here, and its write clears it
+        _monitor_armed = false;
+    }
+    switch (funct5) {
+        case 0b00010:  // LR.W
+            _reserved = true;
+            _reservation = word_addr;
+            _monitor_armed = _exclusive_monitor;
+            _monitor = word_addr;
+            return old_value;
+        case 0b00011: {  // SC.W
+            // without the local reservation SC fails before reaching the slave
+            bool success = _reserved && _reservation == word_addr;
+            _reserved = false;
+            if (success && _exclusive_monitor) {
+                success = _monitor_armed && _monitor == word_addr;
+            }
+            if (success) {
+                write_word(word_addr, src, 0xF);
+            }
+            return success ? 0 : 1;
+        }
+        case 0b00001:  // AMOSWAP.W
+            write_word(word_addr, src, 0xF);
+            return old_value;
+        case 0b00000:  // AMOADD.W
+            write_word(word_addr, old_value + src, 0xF);
+            return old_value;
+        case 0b01000:  // AMOOR.W
+            write_word(word_addr, old_value | src, 0xF);
+            return old_value;
+        default:
+            return 0;
+    }
+}
+
+uint32_t Rv32Iss::expand(uint16_t inst) {
+    uint32_t c = inst;
+    uint32_t funct3 = bits(c, 15, 13);
+    uint32_t rd = bits(c, 11, 7);
+    uint32_t rs2 = bits(c, 6, 2);
+    uint32_t rd_p = 8 + bits(c, 4, 2);
+    uint32_t rs1_p = 8 + bits(c, 9, 7);
+
+    uint32_t imm_ci = sext((bits(c, 12, 12) << 5) | bits(c, 6, 2), 6);
+    uint32_t imm_lw = (bits(c, 5, 5) << 6) | (bits(c, 12, 10) << 3) | (bits(c, 6, 6) << 2);
+    uint32_t imm_j = sext((bits(c, 12, 12) << 11) | (bits(c, 8, 8) << 10) | (bits(c, 10, 9) << 8) |
+                              (bits(c, 6, 6) << 7) | (bits(c, 7, 7) << 6) | (bits(c, 2, 2) << 5) |
+                              (bits(c, 11, 11) << 4) | (bits(c, 5, 3) << 1),
+                          12);
+    uint32_t imm_b = sext((bits(c, 12, 12) << 8) | (bits(c, 6, 5) << 6) | (bits(c, 2, 2) << 5) |
+                              (bits(c, 11, 10) << 3) | (bits(c, 4, 3) << 1),
+                          9);
+
+    switch ((bits(c, 1, 0) << 3) | funct3) {
+        // quadrant 0
+        case 0b00000: {  // C.ADDI4SPN
+            uint32_t imm = (bits(c, 10, 7) << 6) | (bits(c, 12, 11) << 4) | (bits(c, 5, 5) << 3) |
+                           (bits(c, 6, 6) << 2);
+            return imm ? rv32::i_type(imm, 2, 0b000, rd_p, OPCODE_OP_IMM) : 0;
+        }
+        case 0b00010:  // C.LW
+            return rv32::i_type(imm_lw, rs1_p, 0b010, rd_p, OPCODE_LOAD);
+        case 0b00110:  // C.SW
+            return rv32::s_type(imm_lw, rd_p, rs1_p, 0b010, OPCODE_STORE);
+
+        // quadrant 1
+        case 0b01000:  // C.ADDI
+            return rv32::i_type(imm_ci, rd, 0b000, rd, OPCODE_OP_IMM);
+        case 0b01001:  // C.JAL
+            return rv32::j_type(imm_j, 1);
+        case 0b01010:  // C.LI
+            return rv32::i_type(imm_ci, 0, 0b000, rd, OPCODE_OP_IMM);
+        case 0b01011:
+            if (rd == 2) {  // C.ADDI16SP
+                uint32_t imm = sext((bits(c, 12, 12) << 9) | (bits(c, 4, 3) << 7) |
+                                        (bits(c, 5, 5) << 6) | (bits(c, 2, 2) << 5) |
+                                        (bits(c, 6, 6) << 4),
+                                    10);
+                return imm ? rv32::i_type(imm, 2, 0b000, 2, OPCODE_OP_IMM) : 0;
+            }
+            // C.LUI
+            return imm_ci ? ((imm_ci & 0xFFFFF) << 12) | (rd << 7) | OPCODE_LUI : 0;
+        case 0b01100:
+            switch (bits(c, 11, 10)) {
+                case 0b00:  // C.SRLI
+                    return bits(c, 12, 12)
+                               ? 0
+                               : rv32::i_type(rs2, rs1_p, 0b101, rs1_p, OPCODE_OP_IMM);
+                case 0b01:  // C.SRAI
+                    return bits(c, 12, 12)
+                               ? 0
+                               : rv32::i_type(0x400 | rs2, rs1_p, 0b101, rs1_p, OPCODE_OP_IMM);
+                case 0b10:  // C.ANDI
+                    return rv32::i_type(imm_ci, rs1_p, 0b111, rs1_p, OPCODE_OP_IMM);
+                default: {
+                    if (bits(c, 12, 12)) {
+                        return 0;
+                    }
+                    // C.SUB, C.XOR, C.OR, C.AND
+                    static constexpr uint32_t FUNCT3[4] = {0b000, 0b100, 0b110, 0b111};
+                    uint32_t op = bits(c, 6, 5);
+                    return rv32::r_type(op == 0 ? 0b0100000 : 0, rd_p, rs1_p, FUNCT3[op], rs1_p,
+                                        OPCODE_OP);
+                }
+            }
+        case 0b01101:  // C.J
+            return rv32::j_type(imm_j, 0);
+        case 0b01110:  // C.BEQZ
+            return rv32::b_type(imm_b, 0, rs1_p, 0b000);
+        case 0b01111:  // C.BNEZ
+            return rv32::b_type(imm_b, 0, rs1_p, 0b001);
+
+        // quadrant 2
+        case 0b10000:  // C.SLLI
+            return bits(c, 12, 12) ? 0 : rv32::i_type(rs2, rd, 0b001, rd, OPCODE_OP_IMM);
+        case 0b10010: {  // C.LWSP
+            uint32_t imm = (bits(c, 3, 2) << 6) | (bits(c, 12, 12) << 5) | (bits(c, 6, 4) << 2);
+            return rd ? rv32::i_type(imm, 2, 0b010, rd, OPCODE_LOAD) : 0;
+        }
+        case 0b10100:
+            if (!bits(c, 12, 12)) {
+                if (rs2 == 0) {  // C.JR
+                    return rd ? rv32::i_type(0, rd, 0b000, 0, OPCODE_JALR) : 0;
+                }
+                return rv32::r_type(0, rs2, 0, 0b000, rd, OPCODE_OP);  // C.MV
+            }
+            if (rs2 == 0) {
+                // C.EBREAK, C.JALR
+                return rd ? rv32::i_type(0, rd, 0b000, 1, OPCODE_JALR) : EBREAK;
+            }
+            return rv32::r_type(0, rs2, rd, 0b000, rd, OPCODE_OP);  // C.ADD
+        case 0b10110: {  // C.SWSP
+            uint32_t imm = (bits(c, 8, 7) << 6) | (bits(c, 12, 9) << 2);
+            return rv32::s_type(imm, rs2, 2, 0b010, OPCODE_STORE);
+        }
+
+        default:
+            // floating-point loads and stores
+            return 0;
+    }
+}
+
+bool Rv32Iss::step() {
+    if (_mode == FINISHED) {
+        return false;
+    }
+
+    // fetch parcels like rip_fetch_buffer: a 32-bit instruction at pc[1] = 1 spans two words
+    uint32_t word_addr = (_pc | _mem_head) >> 2;
+    uint32_t inst = _mem.read(word_addr);
+    if (_pc & 0x2) {
+        inst = (inst >> 16) | (_mem.read(word_addr + 1) << 16);
+    }
+    bool compressed = (inst & 0x3) != 0x3;
+    if (compressed) {
+        inst = expand(inst & 0xFFFF);
+    }
+    uint32_t inst_len = compressed ? 2 : 4;
+
+    uint32_t opcode = inst & 0x7F;
+    uint32_t rd = (inst >> 7) & 0x1F;
+    uint32_t funct3 = (inst >> 12) & 0x7;
+    uint32_t rs1 = (inst >> 15) & 0x1F;
+    uint32_t rs2 = (inst >> 20) & 0x1F;
+    uint32_t funct7 = inst >> 25;
+    uint32_t funct12 = inst >> 20;
+    uint32_t a = _x[rs1];
+    uint32_t b = _x[rs2];
+    uint32_t next_pc = _pc + inst_len;
+
+    switch (opcode) {
+        case 0b0110111:  // LUI
+            set_reg(rd, imm_u(inst));
+            break;
+        case 0b0010111:  // AUIPC
+            set_reg(rd, _pc + imm_u(inst));
+            break;
+        case 0b1101111:  // JAL
+            set_reg(rd, _pc + inst_len);
+            next_pc = _pc + imm_j(inst);
+            break;
+        case 0b1100111:  // JALR
+            next_pc = (a + imm_i(inst)) & ~0x1u;
+            set_reg(rd, _pc + inst_len);
+            break;
+        case 0b1100011: {  // BRANCH
+            bool taken;
+            switch (funct3) {
+                case 0b000:
+                    taken = a == b;
+                    break;
+                case 0b001:
+                    taken = a != b;
+                    break;
+                case 0b100:
+                    taken = static_cast<int32_t>(a) < static_cast<int32_t>(b);
+                    break;
+                case 0b101:
+                    taken = static_cast<int32_t>(a) >= static_cast<int32_t>(b);
+                    break;
+                case 0b110:
+                    taken = a < b;
+                    break;
+                case 0b111:
+                    taken = a >= b;
+                    break;
+                default:
+                    taken = false;
+                    break;
+            }
+            if (taken) {
+                next_pc = _pc + imm_b(inst);
+            }
+            break;
+        }
+        case 0b0000011:  // LOAD
+            set_reg(rd, load(funct3, a + imm_i(inst)));
+            break;
+        case 0b0100011:  // STORE
+            store(funct3, a + imm_s(inst), b);
+            break;
+        case 0b0101111:  // AMO; rip_core writes 0 to rd for the unsupported ones
+            set_reg(rd, funct3 == 0b010 ? atomic(funct7 >> 2, a, b) : 0);
+            break;
+        case 0b0010011: {  // OP-IMM
+            uint32_t imm = imm_i(inst);
+            uint32_t shamt = rs2;
+            uint32_t rslt = 0;
+            switch (funct3) {
+                case 0b000:
+                    rslt = a + imm;
+                    break;
+                case 0b010:
+                    rslt = static_cast<int32_t>(a) < static_cast<int32_t>(imm);
+                    break;
+                case 0b011:
+                    rslt = a < imm;
+                    break;
+                case 0b100:
+                    rslt = a ^ imm;
+                    break;
+                case 0b110:
+                    rslt = a | imm;
+                    break;
+                case 0b111:
+                    rslt = a & imm;
+                    break;
+                case 0b001:
+                    rslt = funct7 == 0 ? a << shamt : zbb_unary(funct12, a);
+                    break;
+                case 0b101:
+                    if (funct7 == 0) {
+                        rslt = a >> shamt;
+                    } else if (funct7 == 0b0100000) {
+                        rslt = static_cast<int32_t>(a) >> shamt;
+                    } else if (funct7 == 0b0110000) {  // RORI
+                        rslt = ror(a, shamt);
+                    } else {
+                        rslt = zbb_unary(funct12, a);
+                    }
+                    break;
+            }
+            set_reg(rd, rslt);
+            break;
+        }
+        case 0b0110011: {  // OP
+            uint32_t rslt = 0;
+            if (funct7 == 0b0000001) {
+                int64_t sa = static_cast<int32_t>(a);
+                int64_t sb = static_cast<int32_t>(b);
+                uint64_t ua = a;
+                uint64_t ub = b;
+                switch (funct3) {
+                    case 0b000:  // MUL
+                        rslt = a * b;
+                        break;
+                    case 0b001:  // MULH
+                        rslt = static_cast<uint64_t>(sa * sb) >> 32;
+                        break;
+                    case 0b010:  // MULHSU
+                        rslt = static_cast<uint64_t>(sa * static_cast<int64_t>(ub)) >> 32;
+                        break;
+                    case 0b011:  // MULHU
+                        rslt = (ua * ub) >> 32;
+                        break;
+                    case 0b100:  // DIV
+                        rslt = b == 0 ? 0xFFFFFFFF
+                               : (a == 0x80000000 && b == 0xFFFFFFFF)
+                                   ? 0x80000000
+                                   : static_cast<uint32_t>(sa / sb);
+                        break;
+                    case 0b101:  // DIVU
+                        rslt = b == 0 ? 0xFFFFFFFF : a / b;
+                        break;
+                    case 0b110:  // REM
+                        rslt = b == 0 ? a
+                               : (a == 0x80000000 && b == 0xFFFFFFFF)
+                                   ? 0
+                                   : static_cast<uint32_t>(sa % sb);
+                        break;
+                    case 0b111:  // REMU
+                        rslt = b == 0 ? a : a % b;
+                        break;
+                }
+            } else if (funct7 == 0b0000000) {
+                switch (funct3) {
+                    case 0b000:
+                        rslt = a + b;
+                        break;
+                    case 0b001:
+                        rslt = a << (b & 0x1F);
+                        break;
+                    case 0b010:
+                        rslt = static_cast<int32_t>(a) < static_cast<int32_t>(b);
+                        break;
+                    case 0b011:
+                        rslt = a < b;
+                        break;
+                    case 0b100:
+                        rslt = a ^ b;
+                        break;
+                    case 0b101:
+                        rslt = a >> (b & 0x1F);
+                        break;
+                    case 0b110:
+                        rslt = a | b;
+                        break;
+                    case 0b111:
+                        rslt = a & b;
+                        break;
+                }
+            } else if (funct7 == 0b0100000) {
+                switch (funct3) {
+                    case 0b000:
+                        rslt = a - b;
+                        break;
+                    case 0b101:
+                        rslt = static_cast<int32_t>(a) >> (b & 0x1F);
+                        break;
+                    case 0b100:  // XNOR
+                        rslt = ~(a ^ b);
+                        break;
+                    case 0b110:  // ORN
+                        rslt = a | ~b;
+                        break;
+                    case 0b111:  // ANDN
+                        rslt = a & ~b;
+                        break;
+                }
+            } else if (funct7 == 0b0010000) {  // SH1ADD, SH2ADD, SH3ADD
+                if (funct3 == 0b010 || funct3 == 0b100 || funct3 == 0b110) {
+                    rslt = (a << (funct3 >> 1)) + b;
+                }
+            } else if (funct7 == 0b0000101) {
+                bool lt = funct3 & 0x1 ? a < b
+                                       : static_cast<int32_t>(a) < static_cast<int32_t>(b);
+                if (funct3 == 0b100 || funct3 == 0b101) {  // MIN, MINU
+                    rslt = lt ? a : b;
+                } else if (funct3 == 0b110 || funct3 == 0b111) {  // MAX, MAXU
+                    rslt = lt ? b : a;
+                }
+            } else if (funct7 == 0b0110000) {
+                if (funct3 == 0b001) {  // ROL
+                    rslt = ror(a, (32 - (b & 0x1F)) & 0x1F);
+                } else if (funct3 == 0b101) {  // ROR
+                    rslt = ror(a, b & 0x1F);
+                }
+            } else if (funct7 == 0b0000100 && funct3 == 0b100 && rs2 == 0) {  // ZEXT.H
+                rslt = a & 0xFFFF;
+            }
+            set_reg(rd, rslt);
+            break;
+        }
+        case 0b1110011:  // SYSTEM
+            if (funct3 == 0b000) {
+                if (funct12 == 0x000) {  // ECALL
+                    enter_trap(CAUSE_ECALL);
+                    next_pc = _pc;
+                } else if (funct12 == 0x302) {  // MRET
+                    _mstatus = MSTATUS_MPIE | ((_mstatus & MSTATUS_MPIE) ? MSTATUS_MIE : 0);
+                    next_pc = _mepc;
+                }
+                // EBREAK falls through to the next instruction
+            } else {
+                uint32_t csr_num = funct12;
+                uint32_t old_value = csr(csr_num);
+                uint32_t src = (funct3 & 0x4) ? rs1 : a;  // zimm for CSRR*I
+                uint32_t new_value;
+                switch (funct3 & 0x3) {
+                    case 0b01:
+                        new_value = src;
+                        break;
+                    case 0b10:
+                        new_value = src | old_value;
+                        break;
+                    default:
+                        new_value = ~src & old_value;
+                        break;
+                }
+                write_csr(csr_num, new_value);
+                set_reg(rd, old_value);
+                // writing a read-only CSR is reported without trapping,
+                // except [csrr XX, YY] := [csrrs XX, zero, YY]
+                if ((csr_num >> 10) == 0b11 && !(funct3 == 0b010 && a == 0)) {
+                    _mcause = CAUSE_ILLEGAL_INST;
+                    _mepc = _pc;
+                }
+            }
+            break;
+        case 0b0001011:  // custom-0
+            if (funct12 == 0x0) {  // EXTX
+                _mode = EXITPROC;
+            } else if (funct12 == 0x1) {  // EXT
+                _mode = FINISHED;
+            }
+            break;
+        default:
+            // FENCE, FENCE.I and unknown opcodes do nothing
+            break;
+    }
+
+    _pc = next_pc;
+    _instret++;
+    return _mode != FINISHED;
+}
+
+uint64_t Rv32Iss::run(uint64_t max_steps) {
+    uint64_t start = _instret;
+    while (_instret - start < max_steps && step()) {
+    }
+    return _instret - start;
+}
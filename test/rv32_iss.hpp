@@ -0,0 +1,96 @@
+#ifndef _RV32_ISS_HPP_
+#define _RV32_ISS_HPP_
+
+#include <cstdint>
+
+#include "sparse_memory.hpp"
+
+// Reference instruction set simulator for differential testing.
+// Follows the architectural behavior of rip_core (RV32IMC, Zba, Zbb, the RV32A
+// subset, the CSRs in rip_config, EXT/EXTX and the reset state) rather than a
+// full privileged spec implementation.
+class Rv32Iss {
+   public:
+    static constexpr uint32_t SP_ADDR = 0x1u << 25;
+
+    static constexpr uint32_t MSTATUS = 0x300;
+    static constexpr uint32_t MIE = 0x304;
+    static constexpr uint32_t MTVEC = 0x305;
+    static constexpr uint32_t MEPC = 0x341;
+    static constexpr uint32_t MCAUSE = 0x342;
+    static constexpr uint32_t MTIMECMP = 0x7C0;
+    static constexpr uint32_t MTIMECMPH = 0x7C1;
+
+    static constexpr uint32_t CAUSE_ILLEGAL_INST = 2;
+    static constexpr uint32_t CAUSE_ECALL = 11;
+    static constexpr uint32_t CAUSE_INTERRUPT = 0x80000000;
+    static constexpr uint32_t IRQ_M_TIMER = 7;
+    static constexpr uint32_t IRQ_M_EXT = 11;
+    static constexpr uint32_t IRQ_MBOX = 16;  // platform interrupt, see sw/rip_mailbox.h
+
+    static constexpr uint32_t MSTATUS_MIE = 1u << 3;
+    static constexpr uint32_t MSTATUS_MPIE = 1u << 7;
+
+    // same encoding as rip_type::core_mode_t
+    enum Mode { FINISHED = 0, RUNNING = 1, EXITPROC = 2 };
+
+    explicit Rv32Iss(SparseMemory& mem, uint32_t mem_head = 0, uint32_t ret_head = 0);
+
+    void reset();
+    // executes one instruction; returns false once the core has finished
+    bool step();
+    // returns the number of executed instructions
+    uint64_t run(uint64_t max_steps);
+    // takes interrupt `code` before the next instruction if mstatus.MIE and its
+    // mie bit allow it; the timer is not modelled, so the caller decides when
+    bool interrupt(uint32_t code);
+    // models the exclusive monitor of an AXI slave (AxiMemory) behind the
+    // MMU: LR and AMOs arm it, a write to its word clears it, and SC also
+    // needs it to succeed
+    void set_exclusive_monitor(bool enable) { _exclusive_monitor = enable; }
+
+    // RV32C: the 32-bit equivalent of a 16-bit instruction as rip_rvc_expander
+    // produces it (0 for reserved encodings)
+    static uint32_t expand(uint16_t inst);
+
+    bool finished() const { return _mode == FINISHED; }
+    Mode mode() const { return _mode; }
+    uint32_t pc() const { return _pc; }
+    uint32_t reg(int num) const { return _x[num]; }
+    uint32_t csr(uint32_t csr_num) const;
+    uint64_t instret() const { return _instret; }
+
+   private:
+    SparseMemory& _mem;
+    uint32_t _mem_head;
+    uint32_t _ret_head;
+
+    uint32_t _x[32];
+    uint32_t _pc;
+    uint32_t _mstatus;
+    uint32_t _mie;
+    uint64_t _mtimecmp;
+    uint32_t _mtvec;
+    uint32_t _mepc;
+    uint32_t _mcause;
+    Mode _mode;
+    uint64_t _instret;
+    // LR reservation; only SC clears it, as in the memory system
+    bool _reserved;
+    uint32_t _reservation;
+    // the slave's monitor, if set_exclusive_monitor()
+    bool _exclusive_monitor;
+    bool _monitor_armed;
+    uint32_t _monitor;
+
+    uint32_t data_addr(uint32_t addr) const;
+    uint32_t load(uint32_t funct3, uint32_t addr) const;
+    void store(uint32_t funct3, uint32_t addr, uint32_t data);
+    void write_word(uint32_t word_addr, uint32_t data, uint32_t strb);
+    uint32_t atomic(uint32_t funct5, uint32_t addr, uint32_t src);
+    void write_csr(uint32_t csr_num, uint32_t value);
+    void enter_trap(uint32_t cause);
+    void set_reg(uint32_t num, uint32_t value);
+};
+
+#endif
@@ -0,0 +1,81 @@
+#include "sim_runner.hpp"
+
+#include <verilated.h>
+
+#include <cstdio>
+#include <fstream>
+
+#include "Vcore.h"
+#include "rv32_iss.hpp"
+
+namespace {
+
+std::string escape_json(const std::string& str) {
+    std::string escaped;
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            escaped += buf;
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+bool is_elf(const std::string& filename) {
+    std::ifstream ifs(filename, std::ios::binary);
+    char magic[4] = {0};
+    ifs.read(magic, sizeof(magic));
+    return ifs && magic[0] == 0x7f && magic[1] == 'E' && magic[2] == 'L' && magic[3] == 'F';
+}
+
+}  // namespace
+
+std::string to_json(const sim_result_t& result) {
+    char buf[512];
+    std::snprintf(buf, sizeof(buf),
+                  "\"status\":\"%s\",\"cycles\":%llu,\"instret\":%llu,\"gp\":%u,"
+                  "\"passed\":%s,\"pages\":%zu,\"worker\":%zu,\"wall_ms\":%.3f,"
+                  "\"bptp\":%u,\"bptn\":%u,\"bpfp\":%u,\"bpfn\":%u,\"bpmc\":%u,\"hzst\":%u}",
+                  result.status.c_str(), static_cast<unsigned long long>(result.cycles),
+                  static_cast<unsigned long long>(result.instret), result.gp, result.gp == 1 ? "true" : "false", result.pages, result.worker,
+                  result.wall_ms, result.bptp, result.bptn, result.bpfp, result.bpfn, result.bpmc,
+                  result.hzst);
+    return "{\"id\":" + std::to_string(result.id) + ",\"program\":\"" +
+           escape_json(result.program) + "\"," + buf;
+}
+
+std::unique_ptr<VerilatedContext> new_sim_context(const std::vector<std::string>& plusargs) {
+    std::unique_ptr<VerilatedContext> contextp(new VerilatedContext());
+    // every runner would otherwise truncate the same dump.txt
+    std::vector<const char*> argv = {"rip_sim_server", "+no_dump"};
+    for (const std::string& arg : plusargs) {
+        argv.push_back(arg.c_str());
+    }
+    contextp->commandArgs(static_cast<int>(argv.size()), argv.data());
+    return contextp;
+}
+
+bool load_program(SparseMemory& mem, const std::string& program, uint32_t mem_head) {
+    mem.clear();
+    if (is_elf(program)) {
+        return mem.load_elf(program, mem_head >> 2);
+    }
+    return mem.load_hex(program, mem_head >> 2);
+}
+
+uint64_t count_instret(const sim_job_t& job) {
+    SparseMemory mem;
+    if (!load_program(mem, job.program, job.mem_head)) {
+        return 0;
+    }
+    Rv32Iss iss(mem, job.mem_head, job.ret_head);
+    return iss.run(job.max_cycles);
+}
+
+template class BasicSimRunner<Vcore>;
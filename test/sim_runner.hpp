@@ -0,0 +1,250 @@
+#ifndef _SIM_RUNNER_HPP_
+#define _SIM_RUNNER_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../sw/rip_predictor.h"
+#include "sparse_memory.hpp"
+
+class Vcore;
+class VerilatedContext;
+
+typedef struct {
+    size_t id;
+    std::string program;  // .hex ($readmemh format) or ELF32
+    uint64_t max_cycles;
+    uint32_t mem_head;
+    uint32_t ret_head;
+} sim_job_t;
+
+typedef struct {
+    size_t id;
+    std::string program;
+    std::string status;  // "finished", "timeout" or "load_error"
+    uint64_t cycles;
+    uint64_t instret;  // instructions retired on the reference ISS (0 unless counted)
+    uint32_t gp;  // riscv-tests result register
+    size_t pages;
+    size_t worker;
+    double wall_ms;
+    // counters of the run (rip_config.sv): branch predictor outcomes, cycles
+    // lost to mispredictions and hazard stalls
+    uint32_t bptp;
+    uint32_t bptn;
+    uint32_t bpfp;
+    uint32_t bpfn;
+    uint32_t bpmc;
+    uint32_t hzst;
+} sim_result_t;
+
+std::string to_json(const sim_result_t& result);
+
+// loads a .hex or ELF32 program into `mem` (cleared first) at `mem_head`
+bool load_program(SparseMemory& mem, const std::string& program, uint32_t mem_head);
+// a VerilatedContext for a runner: no dump.txt, and `plusargs` for the model
+std::unique_ptr<VerilatedContext> new_sim_context(const std::vector<std::string>& plusargs);
+
+// Owns one rip_core model, its context and its backing memory.
+// The model is built once and reset between jobs, so a batch of small
+// programs does not pay for model construction each time. `Dut` is a
+// Verilated rip_core (SimRunner is the default build, Vcore); the tests
+// build others with different rip_config.sv defines.
+template <class Dut>
+class BasicSimRunner {
+   public:
+    static constexpr uint32_t BPTP = 0xFC0;
+    static constexpr uint32_t BPTN = 0xFC1;
+    static constexpr uint32_t BPFP = 0xFC2;
+    static constexpr uint32_t BPFN = 0xFC3;
+    static constexpr uint32_t HZST = 0xFC6;
+    static constexpr uint32_t BPMC = 0xFC8;
+
+    // `plusargs` go to the model, e.g. "+bp_ro_seed=2"
+    explicit BasicSimRunner(const std::vector<std::string>& plusargs = {});
+    ~BasicSimRunner();
+
+    BasicSimRunner(const BasicSimRunner&) = delete;
+    BasicSimRunner& operator=(const BasicSimRunner&) = delete;
+
+    sim_result_t run(const sim_job_t& job);
+    // runs whatever has been loaded into memory() (job.program is not read)
+    sim_result_t run_loaded(const sim_job_t& job);
+    // runs what is loaded with only the `run` pulse, as the host does between
+    // jobs: no sys_rst_n, so the predictor keeps its table and takes its
+    // history from the resolved one, whatever set_keep_predictor() says
+    sim_result_t rerun_loaded(const sim_job_t& job);
+    SparseMemory& memory() { return _mem; }
+    Dut& dut() { return *_dut; }
+    // a CSR of the core; the counters hold until the next tick after a run
+    uint32_t csr(uint32_t csr_num);
+
+    bool load(const std::string& program, uint32_t mem_head);
+    // clears the memory and writes `code` from address 0
+    void load_code(const std::vector<uint32_t>& code);
+    // writes `code` from `addr`, keeping the rest of the memory
+    void write_code(uint32_t addr, const std::vector<uint32_t>& code);
+    // dynamic instruction count of the job on Rv32Iss, bounded by job.max_cycles
+    static uint64_t count_instret(const sim_job_t& job);
+    // the branch predictor table outlives sys_rst_n; reset() clears it unless
+    // kept, so a job does not depend on the jobs this runner ran before it
+    void set_keep_predictor(bool keep) { _keep_predictor = keep; }
+    void reset();
+    void start(uint32_t mem_head, uint32_t ret_head);
+    void tick();
+
+   private:
+    static constexpr int RESET_CYCLES = 4;
+
+    // starts the job on a reset core and collects its result
+    sim_result_t run_started(const sim_job_t& job);
+
+    std::unique_ptr<VerilatedContext> _contextp;
+    SparseMemory _mem;
+    std::unique_ptr<Dut> _dut;
+    bool _keep_predictor = false;
+};
+
+typedef BasicSimRunner<Vcore> SimRunner;
+
+uint64_t count_instret(const sim_job_t& job);
+
+template <class Dut>
+BasicSimRunner<Dut>::BasicSimRunner(const std::vector<std::string>& plusargs)
+    : _contextp(new_sim_context(plusargs)) {
+    SparseMemory::bind(_contextp.get(), &_mem);
+    _dut.reset(new Dut(_contextp.get()));
+}
+
+template <class Dut>
+BasicSimRunner<Dut>::~BasicSimRunner() {
+    _dut->final();
+    _dut.reset();
+    SparseMemory::unbind(_contextp.get());
+}
+
+template <class Dut>
+bool BasicSimRunner<Dut>::load(const std::string& program, uint32_t mem_head) {
+    return load_program(_mem, program, mem_head);
+}
+
+template <class Dut>
+void BasicSimRunner<Dut>::load_code(const std::vector<uint32_t>& code) {
+    _mem.clear();
+    write_code(0, code);
+}
+
+template <class Dut>
+void BasicSimRunner<Dut>::write_code(uint32_t addr, const std::vector<uint32_t>& code) {
+    for (size_t i = 0; i < code.size(); i++) {
+        _mem.write((addr >> 2) + i, code[i]);
+    }
+}
+
+template <class Dut>
+uint64_t BasicSimRunner<Dut>::count_instret(const sim_job_t& job) {
+    return ::count_instret(job);
+}
+
+template <class Dut>
+uint32_t BasicSimRunner<Dut>::csr(uint32_t csr_num) {
+    _dut->dbg_csr_num = csr_num;
+    _dut->eval();
+    return _dut->dbg_csr_rdata;
+}
+
+template <class Dut>
+void BasicSimRunner<Dut>::tick() {
+    _dut->clk = 0;
+    _dut->eval();
+    _dut->clk = 1;
+    _dut->eval();
+}
+
+template <class Dut>
+void BasicSimRunner<Dut>::reset() {
+    _dut->sys_rst_n = 0;
+    _dut->run = 0;
+    for (int i = 0; i < RESET_CYCLES; i++) {
+        tick();
+    }
+    _dut->sys_rst_n = 1;
+    if (!_keep_predictor) {
+        // one entry per cycle
+        _dut->dbg_bp_clear = 1;
+        for (uint32_t i = 0; i < RIP_BP_ENTRIES; i++) {
+            tick();
+        }
+        _dut->dbg_bp_clear = 0;
+    }
+}
+
+template <class Dut>
+void BasicSimRunner<Dut>::start(uint32_t mem_head, uint32_t ret_head) {
+    _dut->mem_head = mem_head;
+    _dut->ret_head = ret_head;
+    _dut->run = 1;
+    tick();
+    _dut->run = 0;
+}
+
+template <class Dut>
+sim_result_t BasicSimRunner<Dut>::run(const sim_job_t& job) {
+    auto begin = std::chrono::steady_clock::now();
+    if (!load(job.program, job.mem_head)) {
+        sim_result_t result = {job.id, job.program, "load_error", 0, 0, 0, 0, 0, 0.0};
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - begin;
+        result.wall_ms = elapsed.count();
+        return result;
+    }
+    return run_loaded(job);
+}
+
+template <class Dut>
+sim_result_t BasicSimRunner<Dut>::run_loaded(const sim_job_t& job) {
+    reset();
+    return run_started(job);
+}
+
+template <class Dut>
+sim_result_t BasicSimRunner<Dut>::rerun_loaded(const sim_job_t& job) {
+    // busy is low, so the core is held in reset until the pulse
+    _dut->sys_rst_n = 1;
+    return run_started(job);
+}
+
+template <class Dut>
+sim_result_t BasicSimRunner<Dut>::run_started(const sim_job_t& job) {
+    auto begin = std::chrono::steady_clock::now();
+    sim_result_t result = {job.id, job.program, "finished", 0, 0, 0, 0, 0, 0.0};
+
+    start(job.mem_head, job.ret_head);
+    while (_dut->busy && result.cycles < job.max_cycles) {
+        tick();
+        result.cycles++;
+    }
+    if (_dut->busy) {
+        result.status = "timeout";
+    }
+    result.gp = _dut->riscv_tests_passed;
+    result.pages = _mem.page_count();
+    result.bptp = csr(BPTP);
+    result.bptn = csr(BPTN);
+    result.bpfp = csr(BPFP);
+    result.bpfn = csr(BPFN);
+    result.bpmc = csr(BPMC);
+    result.hzst = csr(HZST);
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+    result.wall_ms = elapsed.count();
+    return result;
+}
+
+// built once in sim_runner.cpp, so the users of SimRunner need not include Vcore.h
+extern template class BasicSimRunner<Vcore>;
+
+#endif
@@ -0,0 +1,180 @@
+#include "sparse_memory.hpp"
+
+#include <verilated.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <mutex>
+#include <unordered_set>
+
+namespace {
+
+std::mutex registry_mutex;
+std::unordered_map<const VerilatedContext*, SparseMemory*> bound_memories;
+std::unordered_set<SparseMemory*> owned_memories;
+
+}  // namespace
+
+SparseMemory::SparseMemory() : _last_page_num(0), _last_page(nullptr) {}
+
+SparseMemory::~SparseMemory() {}
+
+SparseMemory::Page* SparseMemory::find_page(uint32_t page_num) const {
+    if (_last_page != nullptr && _last_page_num == page_num) {
+        return _last_page;
+    }
+    auto it = _pages.find(page_num);
+    if (it == _pages.end()) {
+        return nullptr;
+    }
+    _last_page_num = page_num;
+    _last_page = it->second.get();
+    return _last_page;
+}
+
+uint32_t SparseMemory::read(uint32_t word_addr) const {
+    const Page* page = find_page(word_addr >> PAGE_WORDS_LOG2);
+    return page == nullptr ? 0 : (*page)[word_addr & (PAGE_WORDS - 1)];
+}
+
+void SparseMemory::write(uint32_t word_addr, uint32_t data, uint8_t strb) {
+    uint32_t page_num = word_addr >> PAGE_WORDS_LOG2;
+    Page* page = find_page(page_num);
+    if (page == nullptr) {
+        auto& slot = _pages[page_num];
+        slot.reset(new Page());  // value-initialized (zero)
+        page = slot.get();
+        _last_page_num = page_num;
+        _last_page = page;
+    }
+
+    uint32_t mask = 0;
+    for (int i = 0; i < 4; i++) {
+        if (strb & (1u << i)) {
+            mask |= 0xFFu << (8 * i);
+        }
+    }
+    uint32_t& word = (*page)[word_addr & (PAGE_WORDS - 1)];
+    word = (word & ~mask) | (data & mask);
+}
+
+bool SparseMemory::load_hex(const std::string& filename, uint32_t word_offset) {
+    std::ifstream ifs(filename);
+    if (!ifs.is_open()) {
+        return false;
+    }
+
+    uint32_t word_addr = word_offset;
+    std::string token;
+    while (ifs >> token) {
+        if (token.compare(0, 2, "//") == 0) {
+            std::getline(ifs, token);
+        } else if (token[0] == '@') {
+            word_addr = word_offset + std::stoul(token.substr(1), nullptr, 16);
+        } else {
+            write(word_addr++, std::stoul(token, nullptr, 16));
+        }
+    }
+    return true;
+}
+
+bool SparseMemory::load_elf(const std::string& filename, uint32_t word_offset) {
+    std::ifstream ifs(filename, std::ios::binary);
+    if (!ifs.is_open()) {
+        return false;
+    }
+    std::vector<uint8_t> elf((std::istreambuf_iterator<char>(ifs)),
+                             std::istreambuf_iterator<char>());
+
+    auto u16 = [&](size_t pos) -> uint32_t { return elf[pos] | (elf[pos + 1] << 8); };
+    auto u32 = [&](size_t pos) -> uint32_t { return u16(pos) | (u16(pos + 2) << 16); };
+
+    // ELFCLASS32, ELFDATA2LSB
+    if (elf.size() < 52 || std::memcmp(elf.data(), "\x7f" "ELF", 4) != 0 || elf[4] != 1 ||
+        elf[5] != 1) {
+        return false;
+    }
+
+    constexpr uint32_t PT_LOAD = 1;
+    uint32_t phoff = u32(28);
+    uint32_t phentsize = u16(42);
+    uint32_t phnum = u16(44);
+    for (uint32_t i = 0; i < phnum; i++) {
+        size_t ph = phoff + i * phentsize;
+        if (ph + 32 > elf.size()) {
+            return false;
+        }
+        if (u32(ph) != PT_LOAD) {
+            continue;
+        }
+        uint32_t offset = u32(ph + 4);
+        uint32_t paddr = u32(ph + 12);
+        uint32_t filesz = u32(ph + 16);
+        if (offset + filesz > elf.size()) {
+            return false;
+        }
+        for (uint32_t j = 0; j < filesz; j++) {
+            uint32_t addr = paddr + j;
+            write(word_offset + (addr >> 2), elf[offset + j] << (8 * (addr & 3)),
+                  1u << (addr & 3));
+        }
+    }
+    return true;
+}
+
+void SparseMemory::clear() {
+    _pages.clear();
+    _last_page = nullptr;
+}
+
+void SparseMemory::bind(const VerilatedContext* contextp, SparseMemory* mem) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    bound_memories[contextp] = mem;
+}
+
+void SparseMemory::unbind(const VerilatedContext* contextp) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    bound_memories.erase(contextp);
+}
+
+SparseMemory* SparseMemory::bound(const VerilatedContext* contextp) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    auto it = bound_memories.find(contextp);
+    return it == bound_memories.end() ? nullptr : it->second;
+}
+
+/*
+ * DPI-C functions imported by `rip_mmu_stub`
+ */
+
+extern "C" void* rip_sparse_mem_open(const char* default_hex) {
+    SparseMemory* mem = SparseMemory::bound(Verilated::threadContextp());
+    if (mem != nullptr) {
+        return mem;
+    }
+
+    mem = new SparseMemory();
+    mem->load_hex(default_hex);
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    owned_memories.insert(mem);
+    return mem;
+}
+
+extern "C" void rip_sparse_mem_close(void* mem) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    SparseMemory* sparse_mem = static_cast<SparseMemory*>(mem);
+    if (owned_memories.erase(sparse_mem)) {
+        delete sparse_mem;
+    }
+}
+
+extern "C" unsigned int rip_sparse_mem_read(void* mem, unsigned int word_addr) {
+    return static_cast<SparseMemory*>(mem)->read(word_addr);
+}
+
+extern "C" void rip_sparse_mem_write(void* mem, unsigned int word_addr,
+                                     unsigned int data, unsigned char strb) {
+    static_cast<SparseMemory*>(mem)->write(word_addr, data, strb);
+}
@@ -0,0 +1,61 @@
+#ifndef _SPARSE_MEMORY_HPP_
+#define _SPARSE_MEMORY_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+class VerilatedContext;
+
+// Word-addressed, page-granular sparse memory.
+// Backs `rip_mmu_stub` through DPI under Verilator so that each model only
+// allocates the pages a program actually touches.
+class SparseMemory {
+   public:
+    static constexpr uint32_t PAGE_WORDS_LOG2 = 10;  // 4 KiB pages
+    static constexpr uint32_t PAGE_WORDS = 1u << PAGE_WORDS_LOG2;
+
+    SparseMemory();
+    ~SparseMemory();
+
+    SparseMemory(const SparseMemory&) = delete;
+    SparseMemory& operator=(const SparseMemory&) = delete;
+
+    // untouched words read as zero without allocating a page
+    uint32_t read(uint32_t word_addr) const;
+    // byte-enabled write (strb[i] enables byte i)
+    void write(uint32_t word_addr, uint32_t data, uint8_t strb = 0xF);
+
+    // $readmemh compatible: one word per line, `@` sets the word address
+    bool load_hex(const std::string& filename, uint32_t word_offset = 0);
+    // loads PT_LOAD segments of a little-endian ELF32 file at their physical
+    // addresses
+    bool load_elf(const std::string& filename, uint32_t word_offset = 0);
+    void clear();
+
+    size_t page_count() const { return _pages.size(); }
+    size_t footprint_bytes() const { return _pages.size() * sizeof(Page); }
+
+    // Binds `mem` to every model evaluated under `contextp`.
+    // Unbound models fall back to a private memory loaded from the stub's
+    // default hex file.
+    static void bind(const VerilatedContext* contextp, SparseMemory* mem);
+    static void unbind(const VerilatedContext* contextp);
+    static SparseMemory* bound(const VerilatedContext* contextp);
+
+   private:
+    typedef std::array<uint32_t, PAGE_WORDS> Page;
+
+    std::unordered_map<uint32_t, std::unique_ptr<Page>> _pages;
+
+    // last accessed page; fetch and data streams are highly local
+    mutable uint32_t _last_page_num;
+    mutable Page* _last_page;
+
+    Page* find_page(uint32_t page_num) const;
+};
+
+#endif
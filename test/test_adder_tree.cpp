@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <verilated.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "Vadder_tree.h"
+#include "Vadder_tree_s2.h"
+#include "Vadder_tree_s8.h"
+
+namespace {
+
+// every model sums NUM rows of WIDTH bits (CMakeLists.txt), five carry-save
+// levels and the adder
+constexpr int WIDTH = 8;
+constexpr int NUM = 11;
+constexpr int SAMPLES = 1000;
+
+// rip_adder_tree with STAGES = 0, 2 (inside the tree) and 8 (three past it)
+template <class Dut>
+class TestAdderTree : public ::testing::Test {
+   protected:
+    std::unique_ptr<Dut> dut;
+
+    void SetUp() override {
+        dut.reset(new Dut());
+        dut->clk = 0;
+    }
+
+    void TearDown() override { dut->final(); }
+
+    void set_rows(const std::vector<uint32_t>& rows) {
+        for (int w = 0; w < (NUM * WIDTH + 31) / 32; w++) {
+            dut->rows[w] = 0;
+        }
+        for (int i = 0; i < NUM; i++) {
+            for (int b = 0; b < WIDTH; b++) {
+                const int bit = i * WIDTH + b;
+                dut->rows[bit / 32] |= ((rows[i] >> b) & 1u) << (bit % 32);
+            }
+        }
+    }
+
+    void tick() {
+        dut->clk = 1;
+        dut->eval();
+        dut->clk = 0;
+        dut->eval();
+    }
+};
+
+typedef ::testing::Types<Vadder_tree, Vadder_tree_s2, Vadder_tree_s8> Models;
+TYPED_TEST_SUITE(TestAdderTree, Models);
+
+// a new set of rows every cycle; each sum is the plain sum modulo 2^WIDTH,
+// `stages` cycles later
+TYPED_TEST(TestAdderTree, MatchesPlainSum) {
+    const int stages = std::is_same<TypeParam, Vadder_tree>::value      ? 0
+                       : std::is_same<TypeParam, Vadder_tree_s2>::value ? 2
+                                                                        : 8;
+    std::mt19937 rng(1);
+    std::vector<uint32_t> expected;
+    for (int t = 0; t < SAMPLES + stages; t++) {
+        std::vector<uint32_t> rows(NUM);
+        uint32_t sum = 0;
+        for (uint32_t& row : rows) {
+            // all ones now and then, so every carry ripples through
+            row = rng() % 8 == 0 ? (1u << WIDTH) - 1 : rng() & ((1u << WIDTH) - 1);
+            sum += row;
+        }
+        expected.push_back(sum & ((1u << WIDTH) - 1));
+        this->set_rows(rows);
+        this->dut->eval();
+        if (t >= stages) {
+            ASSERT_EQ(this->dut->sum, expected[t - stages]) << "rows of cycle " << t - stages;
+        }
+        this->tick();
+    }
+}
+
+}  // namespace
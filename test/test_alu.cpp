@@ -5,9 +5,11 @@
 #include <verilated.h>
 
 #include <climits>
+#include <cstdlib>
 #include <cstring>
 #include <random>
 #include <string>
+#include <vector>
 
 #include "test_inst.hpp"
 
@@ -33,6 +35,32 @@ void ValuForTest::exec(const inst_bit_t &_inst_bit, const int &_rs1,
   eval();
 }
 
+void ValuForTest::exec_batch(const inst_bit_t &_inst_bit,
+                             const alu_batch_t &_in, size_t _n,
+                             uint32_t *_rslt, uint8_t *_branch_result) {
+  rst_n = 1;
+  ex_ready = 1;
+  std::memcpy(&inst, &_inst_bit, sizeof(inst_bit_t));
+
+  for (size_t i = 0; i < _n; ++i) {
+    clk = 0;
+    rs1 = _in.rs1[i];
+    rs2 = _in.rs2[i];
+    rs3 = _in.rs3[i];
+    pc = _in.pc[i];
+    csr = _in.csr[i];
+    imm = _in.imm[i];
+    zimm = _in.zimm[i];
+    eval();
+
+    // positive edge
+    clk = 1;
+    eval();
+    _rslt[i] = rslt;
+    _branch_result[i] = branch_result;
+  }
+}
+
 class TestAlu : public ::testing::Test {
 protected:
   TestAlu()
@@ -134,6 +162,43 @@ TEST_F(TestAlu, Jalr) {
   }
 }
 
+// c.jal, c.jr and c.jalr link to the next halfword
+TEST_F(TestAlu, JalCompressed) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.JAL = 1;
+  inst_bit.UPDATE_PC = 1;
+  inst_bit.COMPRESSED = 1;
+  for (int i = 0; i < N; ++i) {
+    rs1 = dist_int(engine);
+    rs2 = dist_int(engine);
+    pc = dist_int(engine);
+    csr = dist_int(engine);
+    imm = dist_int(engine);
+    zimm = dist_5bit(engine);
+
+    dut->exec(inst_bit, rs1, rs2, pc, csr, imm, zimm);
+    EXPECT_EQ(dut->rslt, pc + 2);
+  }
+}
+
+TEST_F(TestAlu, JalrCompressed) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.JALR = 1;
+  inst_bit.UPDATE_PC = 1;
+  inst_bit.COMPRESSED = 1;
+  for (int i = 0; i < N; ++i) {
+    rs1 = dist_int(engine);
+    rs2 = dist_int(engine);
+    pc = dist_int(engine);
+    csr = dist_int(engine);
+    imm = dist_int(engine);
+    zimm = dist_5bit(engine);
+
+    dut->exec(inst_bit, rs1, rs2, pc, csr, imm, zimm);
+    EXPECT_EQ(dut->rslt, pc + 2);
+  }
+}
+
 TEST_F(TestAlu, Beq) {
   inst_bit_t inst_bit = {0};
   inst_bit.BEQ = 1;
@@ -791,7 +856,7 @@ TEST_F(TestAlu, Csrrw) {
     zimm = dist_5bit(engine);
 
     dut->exec(inst_bit, rs1, rs2, pc, csr, imm, zimm);
-    EXPECT_EQ(dut->rslt, rs1);
+    EXPECT_EQ(dut->rslt, static_cast<uint32_t>(rs1));
   }
 }
 
@@ -1067,7 +1132,7 @@ TEST_F(TestAlu, REMZERO) {
 
     dut->exec(inst_bit, rs1, 0, pc, csr, imm, zimm);
     // TODO: rounding test
-    EXPECT_EQ(dut->rslt, rs1);
+    EXPECT_EQ(dut->rslt, static_cast<uint32_t>(rs1));
   }
 }
 
@@ -1116,8 +1181,440 @@ TEST_F(TestAlu, REMUZERO) {
 
     dut->exec(inst_bit, rs1, 0, pc, csr, imm, zimm);
     // TODO: rounding test
-    EXPECT_EQ(dut->rslt, rs1);
+    EXPECT_EQ(dut->rslt, static_cast<uint32_t>(rs1));
+  }
+}
+
+// Packed SIMD (P extension subset), riscv-tests style vectors:
+// {rs1, rs2, rs3 (accumulator), expected}
+typedef struct {
+  uint32_t rs1;
+  uint32_t rs2;
+  uint32_t rs3;
+  uint32_t rslt;
+} simd_vector_t;
+
+void expect_simd(ValuForTest *dut, const inst_bit_t &inst_bit,
+                 const std::vector<simd_vector_t> &vectors) {
+  for (const simd_vector_t &v : vectors) {
+    dut->rs3 = v.rs3;
+    dut->exec(inst_bit, v.rs1, v.rs2, 0, 0, 0, 0);
+    EXPECT_EQ(dut->rslt, v.rslt)
+        << std::hex << "rs1=" << v.rs1 << " rs2=" << v.rs2 << " rs3=" << v.rs3;
+  }
+}
+
+TEST_F(TestAlu, ADD8) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.ADD8 = 1;
+  expect_simd(dut, inst_bit,
+              {{0x01020304, 0x10203040, 0, 0x11223344},
+               {0x7F80FF00, 0x01800101, 0, 0x80000001},
+               {0xFFFFFFFF, 0x01010101, 0, 0x00000000}});
+}
+
+TEST_F(TestAlu, SUB8) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.SUB8 = 1;
+  expect_simd(dut, inst_bit,
+              {{0x11223344, 0x01020304, 0, 0x10203040},
+               {0x00800000, 0x01017F01, 0, 0xFF7F81FF}});
+}
+
+TEST_F(TestAlu, ADD16) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.ADD16 = 1;
+  expect_simd(dut, inst_bit,
+              {{0x00010002, 0x00030004, 0, 0x00040006},
+               {0x7FFFFFFF, 0x00010001, 0, 0x80000000}});
+}
+
+TEST_F(TestAlu, SUB16) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.SUB16 = 1;
+  expect_simd(dut, inst_bit,
+              {{0x00040006, 0x00030004, 0, 0x00010002},
+               {0x80000000, 0x00010001, 0, 0x7FFFFFFF}});
+}
+
+TEST_F(TestAlu, KADD8) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.KADD8 = 1;
+  expect_simd(dut, inst_bit,
+              {{0x01020304, 0x10203040, 0, 0x11223344},
+               {0x7F80407F, 0x01FFC07F, 0, 0x7F80007F},
+               {0x80C0F000, 0x80C0F000, 0, 0x8080E000}});
+}
+
+TEST_F(TestAlu, KSUB8) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.KSUB8 = 1;
+  expect_simd(dut, inst_bit,
+              {{0x7F80007F, 0xFF01807F, 0, 0x7F807F00},
+               {0x10203040, 0x01020304, 0, 0x0F1E2D3C}});
+}
+
+TEST_F(TestAlu, KADD16) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.KADD16 = 1;
+  expect_simd(dut, inst_bit,
+              {{0x7FFF8000, 0x0001FFFF, 0, 0x7FFF8000},
+               {0x40001234, 0x40001111, 0, 0x7FFF2345}});
+}
+
+TEST_F(TestAlu, KSUB16) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.KSUB16 = 1;
+  expect_simd(dut, inst_bit,
+              {{0x80007FFF, 0x0001FFFF, 0, 0x80007FFF},
+               {0x00050005, 0x00030007, 0, 0x0002FFFE}});
+}
+
+TEST_F(TestAlu, UKADD8) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.UKADD8 = 1;
+  expect_simd(dut, inst_bit,
+              {{0xFF80017F, 0x01800101, 0, 0xFFFF0280},
+               {0x01020304, 0x10203040, 0, 0x11223344}});
+}
+
+TEST_F(TestAlu, UKSUB8) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.UKSUB8 = 1;
+  expect_simd(dut, inst_bit,
+              {{0x00800201, 0x01810102, 0, 0x00000100},
+               {0x11223344, 0x01020304, 0, 0x10203040}});
+}
+
+TEST_F(TestAlu, UKADD16) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.UKADD16 = 1;
+  expect_simd(dut, inst_bit,
+              {{0xFFFF8000, 0x00018000, 0, 0xFFFFFFFF},
+               {0x12340001, 0x11110002, 0, 0x23450003}});
+}
+
+TEST_F(TestAlu, UKSUB16) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.UKSUB16 = 1;
+  expect_simd(dut, inst_bit,
+              {{0x00018000, 0x00027FFF, 0, 0x00000001},
+               {0x23450003, 0x11110002, 0, 0x12340001}});
+}
+
+TEST_F(TestAlu, SMAQA) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.SMAQA = 1;
+  // 1*5 + 2*6 + 3*7 + 4*8 = 70
+  expect_simd(dut, inst_bit,
+              {{0x04030201, 0x08070605, 0, 70},
+               {0x04030201, 0x08070605, 100, 170},
+               // (-1)*1 + (-128)*(-128) + 127*(-128) + 0 = -1 + 16384 - 16256
+               {0x007F80FF, 0x00808001, 0xFFFFFFFF, 126},
+               {0x80808080, 0x80808080, 0x7FFFFFFF, 0x8000FFFF}});
+}
+
+TEST_F(TestAlu, UMAQA) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.UMAQA = 1;
+  expect_simd(dut, inst_bit,
+              {{0x04030201, 0x08070605, 0, 70},
+               {0xFFFFFFFF, 0xFFFFFFFF, 1, 4 * 65025 + 1},
+               {0x000000FF, 0x00000002, 0xFFFFFFFF, 509}});
+}
+
+TEST_F(TestAlu, KMDA) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.KMDA = 1;
+  // 3*5 + (-2)*7 = 1; rs3 is ignored
+  expect_simd(dut, inst_bit,
+              {{0x0003FFFE, 0x00050007, 0x12345678, 1},
+               {0x80008000, 0x80008000, 0, 0x7FFFFFFF},
+               {0x80007FFF, 0x7FFF7FFF, 0, 0xFFFF8001}});
+}
+
+TEST_F(TestAlu, KMADA) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.KMADA = 1;
+  expect_simd(dut, inst_bit,
+              {{0x0003FFFE, 0x00050007, 100, 101},
+               {0x7FFF7FFF, 0x7FFF7FFF, 0x7FFFFFFF, 0x7FFFFFFF},
+               {0x80007FFF, 0x7FFF8000, 0x80000000, 0x80000000}});
+}
+
+// Bit manipulation (Zba, Zbb), with the vectors of the SIMD tests
+TEST_F(TestAlu, SH1ADD) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.SH1ADD = 1;
+  expect_simd(dut, inst_bit,
+              {{5, 7, 0, 17}, {0x80000001, 1, 0, 3}});
+}
+
+TEST_F(TestAlu, SH2ADD) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.SH2ADD = 1;
+  expect_simd(dut, inst_bit,
+              {{5, 7, 0, 27}, {0x40000001, 0xFFFFFFFC, 0, 0}});
+}
+
+TEST_F(TestAlu, SH3ADD) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.SH3ADD = 1;
+  expect_simd(dut, inst_bit,
+              {{5, 7, 0, 47}, {0x20000000, 0, 0, 0}});
+}
+
+TEST_F(TestAlu, ANDN) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.ANDN = 1;
+  expect_simd(dut, inst_bit, {{0xFF00FF00, 0x0F0F0F0F, 0, 0xF000F000}});
+}
+
+TEST_F(TestAlu, ORN) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.ORN = 1;
+  expect_simd(dut, inst_bit, {{0xFF00FF00, 0x0F0F0F0F, 0, 0xFFF0FFF0}});
+}
+
+TEST_F(TestAlu, XNOR) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.XNOR = 1;
+  expect_simd(dut, inst_bit, {{0xFF00FF00, 0x0F0F0F0F, 0, 0x0FF00FF0}});
+}
+
+TEST_F(TestAlu, CLZ) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.CLZ = 1;
+  expect_simd(dut, inst_bit,
+              {{0x00000000, 0, 0, 32},
+               {0x00000001, 0, 0, 31},
+               {0x00010000, 0, 0, 15},
+               {0x80000000, 0, 0, 0}});
+}
+
+TEST_F(TestAlu, CTZ) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.CTZ = 1;
+  expect_simd(dut, inst_bit,
+              {{0x00000000, 0, 0, 32},
+               {0x00000001, 0, 0, 0},
+               {0x00010000, 0, 0, 16},
+               {0x80000000, 0, 0, 31}});
+}
+
+TEST_F(TestAlu, CPOP) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.CPOP = 1;
+  expect_simd(dut, inst_bit,
+              {{0x00000000, 0, 0, 0},
+               {0xFFFFFFFF, 0, 0, 32},
+               {0x55555555, 0, 0, 16},
+               {0x80000001, 0, 0, 2}});
+}
+
+TEST_F(TestAlu, MAX) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.MAX = 1;
+  expect_simd(dut, inst_bit,
+              {{0xFFFFFFFF, 1, 0, 1}, {0x80000000, 0x7FFFFFFF, 0, 0x7FFFFFFF}});
+}
+
+TEST_F(TestAlu, MAXU) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.MAXU = 1;
+  expect_simd(dut, inst_bit,
+              {{0xFFFFFFFF, 1, 0, 0xFFFFFFFF}, {0x80000000, 0x7FFFFFFF, 0, 0x80000000}});
+}
+
+TEST_F(TestAlu, MIN) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.MIN = 1;
+  expect_simd(dut, inst_bit,
+              {{0xFFFFFFFF, 1, 0, 0xFFFFFFFF}, {0x80000000, 0x7FFFFFFF, 0, 0x80000000}});
+}
+
+TEST_F(TestAlu, MINU) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.MINU = 1;
+  expect_simd(dut, inst_bit,
+              {{0xFFFFFFFF, 1, 0, 1}, {0x80000000, 0x7FFFFFFF, 0, 0x7FFFFFFF}});
+}
+
+TEST_F(TestAlu, SEXT_B) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.SEXT_B = 1;
+  expect_simd(dut, inst_bit,
+              {{0x12345680, 0, 0, 0xFFFFFF80}, {0x1234567F, 0, 0, 0x0000007F}});
+}
+
+TEST_F(TestAlu, SEXT_H) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.SEXT_H = 1;
+  expect_simd(dut, inst_bit,
+              {{0x12348000, 0, 0, 0xFFFF8000}, {0x12347FFF, 0, 0, 0x00007FFF}});
+}
+
+TEST_F(TestAlu, ZEXT_H) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.ZEXT_H = 1;
+  expect_simd(dut, inst_bit, {{0xFFFF8000, 0, 0, 0x00008000}});
+}
+
+TEST_F(TestAlu, ROL) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.ROL = 1;
+  expect_simd(dut, inst_bit,
+              {{0x80000001, 1, 0, 0x00000003},
+               {0x12345678, 4, 0, 0x23456781},
+               {0x12345678, 0, 0, 0x12345678},
+               {0x12345678, 36, 0, 0x23456781}});
+}
+
+TEST_F(TestAlu, ROR) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.ROR = 1;
+  expect_simd(dut, inst_bit,
+              {{0x80000001, 1, 0, 0xC0000000},
+               {0x12345678, 4, 0, 0x81234567},
+               {0x12345678, 0, 0, 0x12345678}});
+}
+
+TEST_F(TestAlu, RORI) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.RORI = 1;
+  for (int i = 0; i < N; ++i) {
+    rs2 = dist_int(engine);
+    dut->exec(inst_bit, 0x12345678, rs2, 0, 0, 8, 0);
+    EXPECT_EQ(dut->rslt, 0x78123456u);
+  }
+}
+
+TEST_F(TestAlu, ORC_B) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.ORC_B = 1;
+  expect_simd(dut, inst_bit,
+              {{0x00100001, 0, 0, 0x00FF00FF}, {0x00000000, 0, 0, 0x00000000}});
+}
+
+TEST_F(TestAlu, REV8) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.REV8 = 1;
+  expect_simd(dut, inst_bit, {{0x12345678, 0, 0, 0x78563412}});
+}
+
+// RV32A: the address is rs1 without an offset
+TEST_F(TestAlu, AMOADD_W) {
+  inst_bit_t inst_bit = {0};
+  inst_bit.AMOADD_W = 1;
+  inst_bit.ACCESS_MEM = 1;
+  for (int i = 0; i < N; ++i) {
+    rs1 = dist_int(engine);
+    rs2 = dist_int(engine);
+    dut->exec(inst_bit, rs1, rs2, 0, 0, 0, 0);
+    EXPECT_EQ(dut->rslt, static_cast<uint32_t>(rs1));
+  }
+}
+
+// High-volume mode: streams batches of operands through the ALU and
+// compares against the branch-free reference model in ref_model.cpp.
+// The number of vectors is taken from RIP_ALU_VECTORS (e.g. 100000000).
+class OperandStream {
+public:
+  explicit OperandStream(uint64_t seed) : _state(seed) {}
+
+  // uniform 32-bit values with 1/8 of them replaced by corner cases
+  void fill(uint32_t *dst, size_t n) {
+    static const uint32_t CORNERS[16] = {
+        0x00000000, 0x00000001, 0x00000002, 0x0000001F,
+        0x00000020, 0x0000007F, 0x00000080, 0x000007FF,
+        0x00000800, 0x7FFFFFFF, 0x80000000, 0x80000001,
+        0xFFFFF800, 0xFFFFFFFE, 0xFFFFFFFF, 0x55555555,
+    };
+    for (size_t i = 0; i < n; ++i) {
+      uint64_t r = next();
+      uint32_t value = static_cast<uint32_t>(r >> 32);
+      dst[i] = (r & 0x7) == 0 ? CORNERS[(r >> 3) & 0xF] : value;
+    }
+  }
+
+  void fill(uint8_t *dst, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = static_cast<uint8_t>(next() >> 59);
+    }
+  }
+
+private:
+  uint64_t _state;
+
+  // splitmix64
+  uint64_t next() {
+    uint64_t z = (_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+  }
+};
+
+uint64_t env_count(const char *name, uint64_t default_value) {
+  const char *value = std::getenv(name);
+  return value ? std::strtoull(value, nullptr, 0) : default_value;
+}
+
+TEST_F(TestAlu, Batch) {
+  const size_t BATCH = 4096;
+  const size_t NUM_OPS = static_cast<size_t>(AluOp::NUM_OPS);
+  const uint64_t vectors = env_count("RIP_ALU_VECTORS", 1 << 20);
+  const uint64_t per_op = (vectors + NUM_OPS - 1) / NUM_OPS;
+
+  std::vector<uint32_t> rs1_v(BATCH), rs2_v(BATCH), rs3_v(BATCH), pc_v(BATCH),
+      csr_v(BATCH), imm_v(BATCH);
+  std::vector<uint8_t> zimm_v(BATCH);
+  alu_batch_t in = {rs1_v.data(), rs2_v.data(), rs3_v.data(), pc_v.data(),
+                    csr_v.data(),  imm_v.data(), zimm_v.data()};
+  std::vector<uint32_t> expected(BATCH), actual(BATCH);
+  std::vector<uint8_t> expected_br(BATCH), actual_br(BATCH);
+
+  OperandStream stream(engine());
+  uint64_t mismatches = 0;
+  for (size_t op_index = 0; op_index < NUM_OPS; ++op_index) {
+    AluOp op = static_cast<AluOp>(op_index);
+    inst_bit_t op_inst = alu_op_inst(op);
+    for (uint64_t done = 0; done < per_op; done += BATCH) {
+      size_t n = std::min<uint64_t>(BATCH, per_op - done);
+      stream.fill(in.rs1, n);
+      stream.fill(in.rs2, n);
+      stream.fill(in.rs3, n);
+      stream.fill(in.pc, n);
+      stream.fill(in.csr, n);
+      stream.fill(in.imm, n);
+      stream.fill(in.zimm, n);
+
+      alu_ref(op, in, n, expected.data(), expected_br.data());
+      dut->exec_batch(op_inst, in, n, actual.data(), actual_br.data());
+
+      if (std::memcmp(expected.data(), actual.data(), n * sizeof(uint32_t)) == 0 &&
+          std::memcmp(expected_br.data(), actual_br.data(), n) == 0) {
+        continue;
+      }
+      for (size_t i = 0; i < n; ++i) {
+        if (expected[i] == actual[i] && expected_br[i] == actual_br[i]) {
+          continue;
+        }
+        // report only the first few so that a broken opcode stays readable
+        if (mismatches++ < 16) {
+          ADD_FAILURE() << std::hex << alu_op_name(op) << " rs1=" << in.rs1[i]
+                        << " rs2=" << in.rs2[i] << " rs3=" << in.rs3[i]
+                        << " pc=" << in.pc[i]
+                        << " csr=" << in.csr[i] << " imm=" << in.imm[i]
+                        << " zimm=" << +in.zimm[i] << ": rslt " << actual[i]
+                        << " (expected " << expected[i] << "), branch_result "
+                        << +actual_br[i] << " (expected " << +expected_br[i]
+                        << ")";
+        }
+      }
+    }
   }
+  EXPECT_EQ(mismatches, 0u);
 }
 
 } // namespace
@@ -2,6 +2,7 @@
 #include <string>
 
 #include "Valu.h"
+#include "ref_model.hpp"
 #include "test_inst.hpp"
 
 class ValuForTest : public Valu {
@@ -12,4 +13,7 @@ public:
   void exec(const inst_bit_t &_inst_bit, const int &_rs1, const int &_rs2,
             const int &_pc, const int &_csr, const int &_imm,
             const unsigned char &_zimm);
+  // one posedge per vector, results are collected instead of checked
+  void exec_batch(const inst_bit_t &_inst_bit, const alu_batch_t &_in,
+                  size_t _n, uint32_t *_rslt, uint8_t *_branch_result);
 };
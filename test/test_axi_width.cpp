@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <verilated.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "Vcore_wrapper128.h"
+#include "Vcore_wrapper64.h"
+#include "axi_memory.hpp"
+
+namespace {
+
+constexpr uint64_t MAX_CYCLES = 200000;
+
+// rip_core_wrapper on AXI data buses wider than the core's data port
+template <class Dut>
+class TestAxiWidth : public ::testing::Test {
+   protected:
+    std::unique_ptr<VerilatedContext> contextp;
+    std::unique_ptr<Dut> dut;
+    SparseMemory mem;
+    AxiMemory axi{mem};
+
+    void SetUp() override {
+        contextp.reset(new VerilatedContext());
+        const char* argv[] = {"test_axi_width", "+no_dump"};
+        contextp->commandArgs(2, argv);
+        dut.reset(new Dut(contextp.get()));
+    }
+
+    void TearDown() override { dut->final(); }
+
+    void tick() {
+        axi.drive(*dut);
+        dut->clk = 0;
+        dut->axi_clk = 0;
+        dut->eval();
+        axi.clock(*dut);
+        dut->clk = 1;
+        dut->axi_clk = 1;
+        dut->eval();
+    }
+
+    // runs the program in `mem` from address 0; returns false on timeout
+    bool run() {
+        dut->sys_rst_n = 0;
+        dut->axi_rst_n = 0;
+        dut->run = 0;
+        for (int i = 0; i < 4; i++) {
+            tick();
+        }
+        axi.reset();
+        dut->sys_rst_n = 1;
+        dut->axi_rst_n = 1;
+        dut->mem_head = 0;
+        dut->ret_head = 0;
+        dut->run = 1;
+        tick();
+        dut->run = 0;
+        for (uint64_t cycles = 1; dut->busy; cycles++) {
+            if (cycles >= MAX_CYCLES) {
+                return false;
+            }
+            tick();
+        }
+        return true;
+    }
+};
+
+typedef ::testing::Types<Vcore_wrapper64, Vcore_wrapper128> Models;
+TYPED_TEST_SUITE(TestAxiWidth, Models);
+
+// byte and halfword accesses land on every lane of the beat
+TYPED_TEST(TestAxiWidth, RiscvTests) {
+    for (const char* name : {"lb", "lbu", "lh", "lhu", "lw", "sb", "sh", "sw"}) {
+        std::string filename = std::string("../../hex/riscv-tests/rv32ui-p-") + name + ".hex";
+        this->mem.clear();
+        ASSERT_TRUE(this->mem.load_hex(filename)) << filename;
+        ASSERT_TRUE(this->run()) << name;
+        EXPECT_EQ(this->dut->riscv_tests_passed, 1u) << name;
+    }
+}
+
+// data memory and the register signature match the ISS, LR/SC included
+TYPED_TEST(TestAxiWidth, FuzzPrograms) {
+    EXPECT_EQ(fuzz_against_iss(this->mem, 20, 40, MAX_CYCLES, [this] { return this->run(); }), "");
+}
+
+}  // namespace
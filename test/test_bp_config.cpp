@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <verilated.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Vcore.h"
+#include "Vcore_gshare.h"
+#include "Vcore_gshare_resolved.h"
+#include "Vcore_resolve_ma.h"
+#include "rv32_gen.hpp"
+#include "sim_runner.hpp"
+
+namespace {
+
+using namespace rv32;
+
+constexpr uint64_t MAX_CYCLES = 200000;
+
+// `code` run from address 0 on a core built as `Dut`
+template <class Dut>
+sim_result_t run_on(const std::vector<uint32_t>& code) {
+    BasicSimRunner<Dut> runner;
+    runner.load_code(code);
+    return runner.run_loaded({0, "", MAX_CYCLES, 0, 0});
+}
+
+uint32_t mispredicts(const sim_result_t& result) { return result.bpfp + result.bpfn; }
+
+double penalty(const sim_result_t& result) {
+    return mispredicts(result) > 0 ? static_cast<double>(result.bpmc) / mispredicts(result) : 0.0;
+}
+
+// `iterations` of a random branch A followed by a branch B on the same
+// condition. The not-taken path of A puts one instruction between them, so B
+// is fetched after A left IF but before A resolves: only a speculative
+// history can tell B what A did.
+std::vector<uint32_t> correlated_branches(int32_t iterations) {
+    std::vector<uint32_t> code = {
+        lui(5, 0x12345000),
+        addi(5, 5, 0x678),  // xorshift32 state
+        addi(6, 0, iterations),
+    };
+    std::vector<uint32_t> loop = {
+        rv32::i_type(13, 5, 0b001, 7, OP_IMM),  // slli x7, x5, 13
+        rv32::r_type(0, 7, 5, 0b100, 5, OP),    // xor x5, x5, x7
+        rv32::i_type(17, 5, 0b101, 7, OP_IMM),  // srli x7, x5, 17
+        rv32::r_type(0, 7, 5, 0b100, 5, OP),
+        rv32::i_type(5, 5, 0b001, 7, OP_IMM),  // slli x7, x5, 5
+        rv32::r_type(0, 7, 5, 0b100, 5, OP),
+        rv32::i_type(1, 5, 0b111, 8, OP_IMM),  // andi x8, x5, 1
+        addi(6, 6, -1),
+        rv32::NOP,  // x8 reaches DE without a stall
+        rv32::b_type(8, 0, 8, 0b000),  // A: beq x8, x0
+        addi(9, 9, 1),
+        rv32::b_type(8, 0, 8, 0b000),  // B: beq x8, x0
+        addi(10, 10, 1),
+    };
+    loop.push_back(rv32::b_type(-4 * static_cast<int32_t>(loop.size()), 0, 6, 0b001));  // bne x6, x0
+    code.insert(code.end(), loop.begin(), loop.end());
+    code.insert(code.end(), 4, rv32::NOP);
+    code.push_back(rv32::EXT);
+    return code;
+}
+
+// B learns A's outcome from the speculative history, and not from the
+// resolved one
+TEST(TestBpConfig, SpeculativeHistory) {
+    const std::vector<uint32_t> code = correlated_branches(1000);
+    sim_result_t speculative = run_on<Vcore_gshare>(code);
+    sim_result_t resolved = run_on<Vcore_gshare_resolved>(code);
+    ASSERT_EQ(speculative.status, "finished");
+    ASSERT_EQ(resolved.status, "finished");
+    EXPECT_GE(resolved.bptp + resolved.bptn + resolved.bpfp + resolved.bpfn, 3000u);
+    EXPECT_LT(mispredicts(speculative), mispredicts(resolved));
+}
+
+// a misprediction redirected from DE costs fewer cycles in bpmc than one
+// redirected from MA, and the whole run is shorter
+TEST(TestBpConfig, ResolveInDe) {
+    const std::vector<uint32_t> code = correlated_branches(1000);
+    sim_result_t de = run_on<Vcore>(code);
+    sim_result_t ma = run_on<Vcore_resolve_ma>(code);
+    ASSERT_EQ(de.status, "finished");
+    ASSERT_EQ(ma.status, "finished");
+    ASSERT_GT(mispredicts(de), 0u);
+    ASSERT_GT(mispredicts(ma), 0u);
+    ::testing::Test::RecordProperty("penalty_de", std::to_string(penalty(de)));
+    ::testing::Test::RecordProperty("penalty_ma", std::to_string(penalty(ma)));
+    ::testing::Test::RecordProperty("cycles_de", std::to_string(de.cycles));
+    ::testing::Test::RecordProperty("cycles_ma", std::to_string(ma.cycles));
+    EXPECT_LT(penalty(de), penalty(ma));
+    EXPECT_LT(de.cycles, ma.cycles);
+}
+
+}  // namespace
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <verilated.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "Vcore_wrapper_async.h"
+#include "axi_memory.hpp"
+
+namespace {
+
+constexpr uint64_t MAX_CYCLES = 400000;
+
+// half periods of clk and axi_clk, and the time of the first axi_clk edge;
+// no ratio is an integer, so the edges drift against each other
+struct clocks_t {
+    uint64_t core_half;
+    uint64_t axi_half;
+    uint64_t axi_phase;
+};
+
+constexpr clocks_t CLOCKS[] = {
+    {5, 7, 2},   // AXI slower
+    {5, 3, 1},   // AXI faster
+    {13, 5, 4},  // AXI much faster
+    {4, 11, 0},  // AXI much slower, edges aligned at the start
+};
+
+std::string describe(const clocks_t& clocks) {
+    return "clk/axi_clk " + std::to_string(clocks.core_half) + "/" +
+           std::to_string(clocks.axi_half);
+}
+
+// rip_core_wrapper with AXI_ASYNC, AxiMemory on axi_clk
+class TestClockDomain : public ::testing::Test {
+   protected:
+    std::unique_ptr<VerilatedContext> contextp;
+    std::unique_ptr<Vcore_wrapper_async> dut;
+    SparseMemory mem;
+    AxiMemory axi{mem};
+    clocks_t clocks;
+    uint64_t now;
+    uint64_t core_next;
+    uint64_t axi_next;
+
+    void SetUp() override {
+        contextp.reset(new VerilatedContext());
+        const char* argv[] = {"test_clock_domain", "+no_dump"};
+        contextp->commandArgs(2, argv);
+        dut.reset(new Vcore_wrapper_async(contextp.get()));
+        set_clocks(CLOCKS[0]);
+    }
+
+    void TearDown() override { dut->final(); }
+
+    void set_clocks(const clocks_t& value) {
+        clocks = value;
+        now = 0;
+        core_next = clocks.core_half;
+        axi_next = clocks.axi_phase;
+    }
+
+    // advances to the next edge of either clock; returns whether clk rose
+    bool step() {
+        now = std::min(core_next, axi_next);
+        bool core_edge = core_next == now;
+        bool axi_edge = axi_next == now;
+        if (axi_edge && !dut->axi_clk) {
+            axi.drive(*dut);
+            dut->eval();
+            axi.clock(*dut);
+        }
+        if (core_edge) {
+            dut->clk = !dut->clk;
+            core_next += clocks.core_half;
+        }
+        if (axi_edge) {
+            dut->axi_clk = !dut->axi_clk;
+            axi_next += clocks.axi_half;
+        }
+        dut->eval();
+        return core_edge && dut->clk;
+    }
+
+    // runs the program in `mem` from address 0; with `reset`, both domains
+    // are reset first, otherwise the crossing keeps its state from the last
+    // run. Returns false on timeout
+    bool run(bool reset = true) {
+        dut->run = 0;
+        if (reset) {
+            dut->sys_rst_n = 0;
+            dut->axi_rst_n = 0;
+            // four cycles of the slower clock
+            for (uint64_t until = now + 8 * std::max(clocks.core_half, clocks.axi_half);
+                 now < until;) {
+                step();
+            }
+            axi.reset();
+            dut->sys_rst_n = 1;
+            dut->axi_rst_n = 1;
+        }
+        dut->mem_head = 0;
+        dut->ret_head = 0;
+        dut->run = 1;
+        while (!step()) {
+        }
+        dut->run = 0;
+        for (uint64_t cycles = 1; dut->busy;) {
+            if (cycles >= MAX_CYCLES) {
+                return false;
+            }
+            cycles += step();
+        }
+        return true;
+    }
+};
+
+TEST_F(TestClockDomain, RiscvTests) {
+    for (const clocks_t& c : CLOCKS) {
+        set_clocks(c);
+        for (const char* name : {"rv32ui-p-lb", "rv32ui-p-lw", "rv32ui-p-sb", "rv32ui-p-sh",
+                                 "rv32ui-p-sw", "rv32ui-p-jal", "rv32um-p-mul", "rv32um-p-div"}) {
+            std::string filename = std::string("../../hex/riscv-tests/") + name + ".hex";
+            mem.clear();
+            ASSERT_TRUE(mem.load_hex(filename)) << filename;
+            ASSERT_TRUE(run()) << name << ", " << describe(c);
+            EXPECT_EQ(dut->riscv_tests_passed, 1u) << name << ", " << describe(c);
+        }
+    }
+}
+
+// a run that starts right after the previous one ends, without a system
+// reset, finds the crossing idle or draining a line read
+TEST_F(TestClockDomain, ConsecutiveRuns) {
+    for (const clocks_t& c : CLOCKS) {
+        set_clocks(c);
+        mem.clear();
+        ASSERT_TRUE(mem.load_hex("../../hex/riscv-tests/rv32ui-p-sw.hex"));
+        ASSERT_TRUE(run()) << describe(c);
+        for (int i = 0; i < 3; i++) {
+            ASSERT_TRUE(run(false)) << "run " << i << ", " << describe(c);
+            EXPECT_EQ(dut->riscv_tests_passed, 1u) << "run " << i << ", " << describe(c);
+        }
+    }
+}
+
+// data memory and the register signature match the ISS, LR/SC included
+TEST_F(TestClockDomain, FuzzPrograms) {
+    for (const clocks_t& c : CLOCKS) {
+        set_clocks(c);
+        EXPECT_EQ(fuzz_against_iss(mem, 8, 40, MAX_CYCLES, [this] { return run(); }), "")
+            << describe(c);
+    }
+}
+
+}  // namespace
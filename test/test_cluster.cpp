@@ -0,0 +1,314 @@
+#include <gtest/gtest.h>
+#include <verilated.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Vcluster.h"
+#include "axi_memory.hpp"
+#include "reservoir_model.hpp"
+#include "rv32_gen.hpp"
+
+namespace {
+
+using namespace rv32;
+using Rc = ReservoirModel;
+
+constexpr int NUM_CORES = 4;  // -GNUM_CORES in CMakeLists.txt
+
+constexpr uint32_t BRANCH_BNE = 0b001;
+constexpr uint32_t CUSTOM_1 = 0b0101011;
+
+// job layout, relative to the core's mem_head
+constexpr uint32_t HEADER = 0x1000;   // weights, steps, readout row, units
+constexpr uint32_t WEIGHTS = HEADER + 16;
+constexpr uint32_t INPUTS = 0x4000;   // one Q4.12 input per step
+constexpr uint32_t OUTPUTS = 0x5000;  // one readout per step
+
+constexpr uint32_t UNITS = 16;
+constexpr uint32_t FAN_IN = 4;
+constexpr uint32_t STEPS = 16;
+constexpr uint32_t LEAK = 0x700;
+
+constexpr uint64_t MAX_CYCLES = 1000000;
+
+uint32_t rc(uint32_t op, uint32_t rd, uint32_t rs1, uint32_t rs2) {
+    return rv32::r_type(op, rs2, rs1, 0b000, rd, CUSTOM_1);
+}
+
+// Reservoir inference: loads the weights from memory into the scratchpad,
+// then feeds one input per step and stores the readout of every step.
+std::vector<uint32_t> inference_program() {
+    return {
+        lui(8, HEADER),
+        lw(9, 8, 0),    // weights
+        lw(10, 8, 4),   // steps
+        lw(11, 8, 8),   // readout row
+        lw(12, 8, 12),  // units
+        addi(13, 8, WEIGHTS - HEADER),
+        addi(14, 0, 0),
+        // weight loop
+        lw(15, 13, 0),
+        rc(Rc::OP_WW, 0, 14, 15),
+        addi(13, 13, 4),
+        addi(14, 14, 1),
+        rv32::b_type(-16, 9, 14, BRANCH_BNE),
+        rc(Rc::OP_CFG, 0, 12, 0),  // size
+        addi(16, 0, LEAK),
+        addi(17, 0, Rc::CFG_LEAK),
+        rc(Rc::OP_CFG, 0, 16, 17),
+        lui(18, INPUTS),
+        lui(19, OUTPUTS),
+        // step loop
+        lw(15, 18, 0),
+        rc(Rc::OP_WS, 0, 12, 15),  // the input follows the units
+        rc(Rc::OP_STEP, 0, 0, 0),
+        rc(Rc::OP_READ, 20, 11, 0),
+        sw(20, 19, 0),
+        addi(18, 18, 4),
+        addi(19, 19, 4),
+        addi(10, 10, -1),
+        rv32::b_type(-32, 0, 10, BRANCH_BNE),
+        rv32::EXT,
+    };
+}
+
+// Shared counters: `iterations` AMOADDs to one word and as many LR/SC
+// increments (retried until SC succeeds) of the next one.
+constexpr uint32_t COUNTERS = 0x2000;
+
+std::vector<uint32_t> counter_program(uint32_t iterations) {
+    return {
+        lui(8, COUNTERS),
+        addi(9, 0, iterations),
+        addi(10, 0, 1),
+        // loop
+        amo(AMOADD, 0, 8, 10),
+        addi(11, 8, 4),
+        amo(LR, 12, 11, 0),  // retry
+        addi(12, 12, 1),
+        amo(SC, 13, 11, 12),
+        rv32::b_type(-12, 0, 13, BRANCH_BNE),
+        addi(9, 9, -1),
+        rv32::b_type(-28, 0, 9, BRANCH_BNE),
+        rv32::EXT,
+    };
+}
+
+struct job_t {
+    std::vector<uint32_t> weights;
+    uint32_t readout;
+    std::vector<uint32_t> inputs;
+    std::vector<uint32_t> expected;
+};
+
+// random sparse reservoir with one input; expected readouts from the model
+job_t make_job(std::mt19937& engine) {
+    std::uniform_int_distribution<int> weight(-0x1800, 0x1800);
+    std::uniform_int_distribution<int> value(-0x1000, 0x1000);
+    std::uniform_int_distribution<uint32_t> col(0, UNITS);
+
+    job_t job;
+    for (uint32_t row = 0; row < UNITS; row++) {
+        for (uint32_t j = 0; j < FAN_IN; j++) {
+            job.weights.push_back(Rc::weight_entry(j == FAN_IN - 1, col(engine),
+                                                   static_cast<int16_t>(weight(engine))));
+        }
+    }
+    job.readout = job.weights.size();
+    for (uint32_t j = 0; j < UNITS; j++) {
+        job.weights.push_back(
+            Rc::weight_entry(j == UNITS - 1, j, static_cast<int16_t>(weight(engine))));
+    }
+
+    Rc model;
+    for (uint32_t i = 0; i < job.weights.size(); i++) {
+        model.command(Rc::OP_WW, i, job.weights[i]);
+    }
+    model.command(Rc::OP_CFG, UNITS, Rc::CFG_SIZE);
+    model.command(Rc::OP_CFG, LEAK, Rc::CFG_LEAK);
+    for (uint32_t step = 0; step < STEPS; step++) {
+        uint32_t input = static_cast<uint16_t>(value(engine));
+        job.inputs.push_back(input);
+        model.command(Rc::OP_WS, UNITS, input);
+        model.command(Rc::OP_STEP, 0, 0);
+        job.expected.push_back(model.command(Rc::OP_READ, job.readout, 0));
+    }
+    return job;
+}
+
+class TestCluster : public ::testing::Test {
+   protected:
+    std::unique_ptr<VerilatedContext> contextp;
+    std::unique_ptr<Vcluster> dut;
+    SparseMemory mem;
+    std::unique_ptr<AxiMemory> axi;
+    std::vector<job_t> jobs;
+
+    void SetUp() override {
+        contextp.reset(new VerilatedContext());
+        // the cores would otherwise share one dump.txt
+        const char* argv[] = {"test_cluster", "+no_dump"};
+        contextp->commandArgs(2, argv);
+        dut.reset(new Vcluster(contextp.get()));
+        axi.reset(new AxiMemory(mem));
+
+        std::mt19937 engine(1);
+        std::vector<uint32_t> program = inference_program();
+        for (int i = 0; i < NUM_CORES; i++) {
+            jobs.push_back(make_job(engine));
+            load(i, program, jobs[i]);
+        }
+    }
+
+    void TearDown() override { dut->final(); }
+
+    // disjoint partitions, ORed into every address like on the board
+    static uint32_t partition(int core) { return (core + 1) << 20; }
+
+    void load(int core, const std::vector<uint32_t>& program, const job_t& job) {
+        uint32_t base = partition(core) >> 2;
+        for (size_t i = 0; i < program.size(); i++) {
+            mem.write(base + i, program[i]);
+        }
+        const uint32_t header[] = {static_cast<uint32_t>(job.weights.size()), STEPS, job.readout,
+                                   UNITS};
+        for (uint32_t i = 0; i < 4; i++) {
+            mem.write(base + HEADER / 4 + i, header[i]);
+        }
+        for (size_t i = 0; i < job.weights.size(); i++) {
+            mem.write(base + WEIGHTS / 4 + i, job.weights[i]);
+        }
+        for (size_t i = 0; i < job.inputs.size(); i++) {
+            mem.write(base + INPUTS / 4 + i, job.inputs[i]);
+        }
+    }
+
+    void tick() {
+        axi->drive(*dut);
+        dut->clk = 0;
+        dut->eval();
+        axi->clock(*dut);
+        dut->clk = 1;
+        dut->eval();
+    }
+
+    void reset() {
+        dut->sys_rst_n = 0;
+        dut->run = 0;
+        for (int i = 0; i < 4; i++) {
+            tick();
+        }
+        axi->reset();
+        dut->sys_rst_n = 1;
+        for (int i = 0; i < NUM_CORES; i++) {
+            dut->mem_head[i] = partition(i);
+            dut->ret_head[i] = partition(i);
+            for (uint32_t step = 0; step < STEPS; step++) {
+                mem.write((partition(i) + OUTPUTS) / 4 + step, 0);
+            }
+        }
+    }
+
+    // starts the cores in `mask` together; returns the cycle each one finished
+    std::vector<uint64_t> run(uint32_t mask) {
+        std::vector<uint64_t> done(NUM_CORES, 0);
+        dut->run = mask;
+        tick();
+        dut->run = 0;
+        uint64_t cycles = 1;
+        while (dut->busy && cycles < MAX_CYCLES) {
+            tick();
+            cycles++;
+            for (int i = 0; i < NUM_CORES; i++) {
+                if ((mask >> i) & 1 && done[i] == 0 && !((dut->busy >> i) & 1)) {
+                    done[i] = cycles;
+                }
+            }
+        }
+        EXPECT_EQ(dut->busy, 0u);
+        return done;
+    }
+
+    void expect_outputs(int core) {
+        uint32_t base = (partition(core) + OUTPUTS) >> 2;
+        for (uint32_t step = 0; step < STEPS; step++) {
+            EXPECT_EQ(mem.read(base + step), jobs[core].expected[step])
+                << "core " << core << " step " << step;
+        }
+    }
+};
+
+TEST_F(TestCluster, IndependentJobs) {
+    reset();
+    run((1u << NUM_CORES) - 1);
+    for (int i = 0; i < NUM_CORES; i++) {
+        expect_outputs(i);
+    }
+}
+
+// the cores share the AXI port, but they wait on memory latency far more than on each other
+TEST_F(TestCluster, ThroughputScales) {
+    constexpr double MIN_EFFICIENCY = 0.85;
+
+    reset();
+    uint64_t alone = run(1)[0];
+    expect_outputs(0);
+
+    reset();
+    std::vector<uint64_t> done = run((1u << NUM_CORES) - 1);
+    uint64_t together = *std::max_element(done.begin(), done.end());
+    for (int i = 0; i < NUM_CORES; i++) {
+        expect_outputs(i);
+    }
+    double speedup = static_cast<double>(NUM_CORES * alone) / together;
+    RecordProperty("speedup", std::to_string(speedup));
+    EXPECT_GE(speedup, MIN_EFFICIENCY * NUM_CORES) << alone << " vs " << together << " cycles";
+}
+
+// instruction fetch reads whole lines and serves the rest of the line from its buffer
+TEST_F(TestCluster, LineFills) {
+    reset();
+    run(1);
+    expect_outputs(0);
+    EXPECT_GT(axi->read_beats(), axi->read_bursts());
+}
+
+// with every core contending each cycle, the highest QoS finishes first
+TEST_F(TestCluster, QosPriority) {
+    axi.reset(new AxiMemory(mem, 0));
+    reset();
+    dut->qos = 0xF << (4 * (NUM_CORES - 1));
+    std::vector<uint64_t> done = run((1u << NUM_CORES) - 1);
+    for (int i = 0; i < NUM_CORES - 1; i++) {
+        EXPECT_LE(done[NUM_CORES - 1], done[i]) << "core " << i;
+    }
+    for (int i = 0; i < NUM_CORES; i++) {
+        expect_outputs(i);
+    }
+}
+
+// every core updates the same two words; no increment may be lost
+TEST_F(TestCluster, SharedCounters) {
+    constexpr uint32_t ITERATIONS = 50;
+
+    std::vector<uint32_t> program = counter_program(ITERATIONS);
+    uint32_t base = partition(0) >> 2;
+    for (size_t i = 0; i < program.size(); i++) {
+        mem.write(base + i, program[i]);
+    }
+    reset();
+    mem.write(base + COUNTERS / 4, 0);
+    mem.write(base + COUNTERS / 4 + 1, 0);
+    for (int i = 0; i < NUM_CORES; i++) {
+        dut->mem_head[i] = partition(0);
+    }
+    run((1u << NUM_CORES) - 1);
+    EXPECT_EQ(mem.read(base + COUNTERS / 4), NUM_CORES * ITERATIONS);
+    EXPECT_EQ(mem.read(base + COUNTERS / 4 + 1), NUM_CORES * ITERATIONS);
+}
+
+}  // namespace
@@ -3,17 +3,21 @@
 #include <gtest/gtest.h>
 #include <verilated.h>
 
+#include <cstdlib>
 #include <cstring>
+#include <random>
 #include <string>
+#include <vector>
 
 #include "test_inst.hpp"
 
-void VdecodeForTest::set_inst_code(uint32_t inst_code_input) {
+void VdecodeForTest::set_inst_code(uint32_t inst_code_input, bool compressed_input) {
     rst_n = 1;
     clk = 0;
     de_ready = 1;
     ex_stall = 0;
     inst_code = inst_code_input;
+    compressed = compressed_input;
     eval();
 
     // positive edge
@@ -28,8 +32,33 @@ std::string VdecodeForTest::get_inst_name() {
     return _inst.get_inst_name();
 }
 
+void VdecodeForTest::decode_batch(const uint32_t* inst_codes, size_t n, decode_result_t* out) {
+    rst_n = 1;
+    de_ready = 1;
+    ex_stall = 0;
+    compressed = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        clk = 0;
+        inst_code = inst_codes[i];
+        eval();
+
+        // positive edge
+        clk = 1;
+        eval();
+        out[i].inst = pack_inst_bit(&inst);
+        out[i].imm = imm;
+        out[i].csr_num = de_csr_num;
+        out[i].rd_num = de_rd_num;
+        out[i].rs1_num = de_rs1_num;
+        out[i].rs2_num = de_rs2_num;
+        out[i].rs3_num = de_rs3_num;
+        out[i].csr_zimm = csr_zimm;
+    }
+}
+
 bool VdecodeForTest::get_ctrl_signal(std::string ctrl_signal_name) {
-    return _inst.ctrl_signal_map.at(ctrl_signal_name);
+    return _inst.get_ctrl_signal(ctrl_signal_name);
 }
 
 class TestDecode : public ::testing::Test {
@@ -89,6 +118,19 @@ TEST_F(TestDecode, Jal) {
     EXPECT_TRUE(dut->get_ctrl_signal("UPDATE_REG"));
     EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_CSR"));
     EXPECT_TRUE(dut->get_ctrl_signal("UPDATE_PC"));
+    EXPECT_FALSE(dut->get_ctrl_signal("COMPRESSED"));
+}
+
+TEST_F(TestDecode, JalCompressed) {
+    dut->set_inst_code(0x008000EF, true);  // c.jal 8 (0x2021) as rip_rvc_expander expands it
+
+    EXPECT_EQ(dut->de_rd_num, 1);
+    EXPECT_EQ(dut->imm, 8);
+
+    EXPECT_EQ(dut->get_inst_name(), "JAL");
+    EXPECT_TRUE(dut->get_ctrl_signal("UPDATE_REG"));
+    EXPECT_TRUE(dut->get_ctrl_signal("UPDATE_PC"));
+    EXPECT_TRUE(dut->get_ctrl_signal("COMPRESSED"));
 }
 
 TEST_F(TestDecode, Jalr) {
@@ -889,6 +931,141 @@ TEST_F(TestDecode, Remu) {
     EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_PC"));
 }
 
+TEST_F(TestDecode, Sh1add) {
+    dut->set_inst_code(0x203120B3);  // sh1add x1, x2, x3
+
+    EXPECT_EQ(dut->de_rs1_num, 2);
+    EXPECT_EQ(dut->de_rs2_num, 3);
+    EXPECT_EQ(dut->de_rd_num, 1);
+    EXPECT_EQ(dut->imm, 0);
+
+    EXPECT_EQ(dut->get_inst_name(), "SH1ADD");
+    EXPECT_FALSE(dut->get_ctrl_signal("ACCESS_MEM"));
+    EXPECT_TRUE(dut->get_ctrl_signal("UPDATE_REG"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_CSR"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_PC"));
+}
+
+TEST_F(TestDecode, Min) {
+    dut->set_inst_code(0x0AF746B3);  // min x13, x14, x15
+
+    EXPECT_EQ(dut->de_rs1_num, 14);
+    EXPECT_EQ(dut->de_rs2_num, 15);
+    EXPECT_EQ(dut->de_rd_num, 13);
+    EXPECT_EQ(dut->imm, 0);
+
+    EXPECT_EQ(dut->get_inst_name(), "MIN");
+    EXPECT_FALSE(dut->get_ctrl_signal("ACCESS_MEM"));
+    EXPECT_TRUE(dut->get_ctrl_signal("UPDATE_REG"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_CSR"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_PC"));
+}
+
+TEST_F(TestDecode, Clz) {
+    dut->set_inst_code(0x60031293);  // clz x5, x6
+
+    EXPECT_EQ(dut->de_rs1_num, 6);
+    EXPECT_EQ(dut->de_rs2_num, 0);
+    EXPECT_EQ(dut->de_rd_num, 5);
+    EXPECT_EQ(dut->imm, 0x600);
+
+    EXPECT_EQ(dut->get_inst_name(), "CLZ");
+    EXPECT_FALSE(dut->get_ctrl_signal("ACCESS_MEM"));
+    EXPECT_TRUE(dut->get_ctrl_signal("UPDATE_REG"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_CSR"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_PC"));
+}
+
+TEST_F(TestDecode, ZextH) {
+    dut->set_inst_code(0x080645B3);  // zext.h x11, x12
+
+    EXPECT_EQ(dut->de_rs1_num, 12);
+    EXPECT_EQ(dut->de_rs2_num, 0);
+    EXPECT_EQ(dut->de_rd_num, 11);
+    EXPECT_EQ(dut->imm, 0);
+
+    EXPECT_EQ(dut->get_inst_name(), "ZEXT_H");
+    EXPECT_FALSE(dut->get_ctrl_signal("ACCESS_MEM"));
+    EXPECT_TRUE(dut->get_ctrl_signal("UPDATE_REG"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_CSR"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_PC"));
+}
+
+TEST_F(TestDecode, Rori) {
+    dut->set_inst_code(0x60C45393);  // rori x7, x8, 12
+
+    EXPECT_EQ(dut->de_rs1_num, 8);
+    EXPECT_EQ(dut->de_rs2_num, 0);
+    EXPECT_EQ(dut->de_rd_num, 7);
+    EXPECT_EQ(dut->imm, 12);
+
+    EXPECT_EQ(dut->get_inst_name(), "RORI");
+    EXPECT_FALSE(dut->get_ctrl_signal("ACCESS_MEM"));
+    EXPECT_TRUE(dut->get_ctrl_signal("UPDATE_REG"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_CSR"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_PC"));
+}
+
+TEST_F(TestDecode, Rev8) {
+    dut->set_inst_code(0x69855493);  // rev8 x9, x10
+
+    EXPECT_EQ(dut->de_rs1_num, 10);
+    EXPECT_EQ(dut->de_rs2_num, 0);
+    EXPECT_EQ(dut->de_rd_num, 9);
+    EXPECT_EQ(dut->imm, 24);
+
+    EXPECT_EQ(dut->get_inst_name(), "REV8");
+    EXPECT_FALSE(dut->get_ctrl_signal("ACCESS_MEM"));
+    EXPECT_TRUE(dut->get_ctrl_signal("UPDATE_REG"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_CSR"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_PC"));
+}
+
+TEST_F(TestDecode, LrW) {
+    dut->set_inst_code(0x100522AF);  // lr.w x5, (x10)
+
+    EXPECT_EQ(dut->de_rs1_num, 10);
+    EXPECT_EQ(dut->de_rs2_num, 0);
+    EXPECT_EQ(dut->de_rd_num, 5);
+    EXPECT_EQ(dut->imm, 0);
+
+    EXPECT_EQ(dut->get_inst_name(), "LR_W");
+    EXPECT_TRUE(dut->get_ctrl_signal("ACCESS_MEM"));
+    EXPECT_TRUE(dut->get_ctrl_signal("UPDATE_REG"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_CSR"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_PC"));
+}
+
+TEST_F(TestDecode, ScW) {
+    dut->set_inst_code(0x1875232F);  // sc.w x6, x7, (x10)
+
+    EXPECT_EQ(dut->de_rs1_num, 10);
+    EXPECT_EQ(dut->de_rs2_num, 7);
+    EXPECT_EQ(dut->de_rd_num, 6);
+    EXPECT_EQ(dut->imm, 0);
+
+    EXPECT_EQ(dut->get_inst_name(), "SC_W");
+    EXPECT_TRUE(dut->get_ctrl_signal("ACCESS_MEM"));
+    EXPECT_TRUE(dut->get_ctrl_signal("UPDATE_REG"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_CSR"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_PC"));
+}
+
+TEST_F(TestDecode, AmoaddW) {
+    dut->set_inst_code(0x0695A42F);  // amoadd.w.aqrl x8, x9, (x11)
+
+    EXPECT_EQ(dut->de_rs1_num, 11);
+    EXPECT_EQ(dut->de_rs2_num, 9);
+    EXPECT_EQ(dut->de_rd_num, 8);
+    EXPECT_EQ(dut->imm, 0);
+
+    EXPECT_EQ(dut->get_inst_name(), "AMOADD_W");
+    EXPECT_TRUE(dut->get_ctrl_signal("ACCESS_MEM"));
+    EXPECT_TRUE(dut->get_ctrl_signal("UPDATE_REG"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_CSR"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_PC"));
+}
+
 TEST_F(TestDecode, Extx) {
     dut->set_inst_code(0x0000000B);  // extx
 
@@ -919,6 +1096,69 @@ TEST_F(TestDecode, Ext) {
     EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_PC"));   
 }
 
+TEST_F(TestDecode, Rc) {
+    dut->set_inst_code(0x0881852B);  // .insn r 0x2B, 0, 4, x10, x3, x8 (RC_OP_STEP)
+
+    EXPECT_EQ(dut->de_rs1_num, 3);
+    EXPECT_EQ(dut->de_rs2_num, 8);
+    EXPECT_EQ(dut->de_rd_num, 10);
+    EXPECT_EQ(dut->imm, 4);
+
+    EXPECT_EQ(dut->get_inst_name(), "RC");
+    EXPECT_FALSE(dut->get_ctrl_signal("ACCESS_MEM"));
+    EXPECT_TRUE(dut->get_ctrl_signal("UPDATE_REG"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_CSR"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_PC"));
+}
+
+TEST_F(TestDecode, Kadd8) {
+    dut->set_inst_code(0x183100F7);  // kadd8 x1, x2, x3
+
+    EXPECT_EQ(dut->de_rs1_num, 2);
+    EXPECT_EQ(dut->de_rs2_num, 3);
+    EXPECT_EQ(dut->de_rs3_num, 0);
+    EXPECT_EQ(dut->de_rd_num, 1);
+    EXPECT_EQ(dut->imm, 0);
+
+    EXPECT_EQ(dut->get_inst_name(), "KADD8");
+    EXPECT_FALSE(dut->get_ctrl_signal("ACCESS_MEM"));
+    EXPECT_TRUE(dut->get_ctrl_signal("UPDATE_REG"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_CSR"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_PC"));
+}
+
+TEST_F(TestDecode, Smaqa) {
+    dut->set_inst_code(0xC8628277);  // smaqa x4, x5, x6
+
+    EXPECT_EQ(dut->de_rs1_num, 5);
+    EXPECT_EQ(dut->de_rs2_num, 6);
+    EXPECT_EQ(dut->de_rs3_num, 4);
+    EXPECT_EQ(dut->de_rd_num, 4);
+    EXPECT_EQ(dut->imm, 0);
+
+    EXPECT_EQ(dut->get_inst_name(), "SMAQA");
+    EXPECT_FALSE(dut->get_ctrl_signal("ACCESS_MEM"));
+    EXPECT_TRUE(dut->get_ctrl_signal("UPDATE_REG"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_CSR"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_PC"));
+}
+
+TEST_F(TestDecode, Kmada) {
+    dut->set_inst_code(0x489413F7);  // kmada x7, x8, x9
+
+    EXPECT_EQ(dut->de_rs1_num, 8);
+    EXPECT_EQ(dut->de_rs2_num, 9);
+    EXPECT_EQ(dut->de_rs3_num, 7);
+    EXPECT_EQ(dut->de_rd_num, 7);
+    EXPECT_EQ(dut->imm, 0);
+
+    EXPECT_EQ(dut->get_inst_name(), "KMADA");
+    EXPECT_FALSE(dut->get_ctrl_signal("ACCESS_MEM"));
+    EXPECT_TRUE(dut->get_ctrl_signal("UPDATE_REG"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_CSR"));
+    EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_PC"));
+}
+
 TEST_F(TestDecode, AddiNoRegUpdate) {
     dut->set_inst_code(0x00000013);  // addi x0, x0, 0 (NOP)
 
@@ -984,4 +1224,61 @@ TEST_F(TestDecode, AddiSignalTiming) {
     EXPECT_FALSE(dut->get_ctrl_signal("UPDATE_PC"));
 }
 
+// High-volume mode: every combination of opcode, funct3 and funct7
+// (2^17 encoding classes) with RIP_DECODE_SAMPLES random fillings of the
+// register fields each. The first samples put fixed values in the rs2 field
+// so that ECALL, EBREAK, MRET, EXTX, EXT and the Zbb unary instructions
+// (CLZ, CTZ, CPOP, SEXT_B, SEXT_H, ZEXT_H, ORC_B, REV8) are always reached.
+TEST_F(TestDecode, Batch) {
+    const uint32_t NUM_CLASSES = 1 << 17;
+    const uint32_t FIXED_RS2[] = {0, 1, 2, 4, 5, 7, 24};
+    const uint32_t NUM_FIXED = sizeof(FIXED_RS2) / sizeof(FIXED_RS2[0]);
+    const char* env = std::getenv("RIP_DECODE_SAMPLES");
+    const uint32_t samples = env ? std::strtoul(env, nullptr, 0) : NUM_FIXED + 1;
+
+    std::mt19937 engine(std::random_device{}());
+    std::vector<uint32_t> codes(NUM_CLASSES);
+    std::vector<decode_result_t> expected(NUM_CLASSES);
+    std::vector<decode_result_t> actual(NUM_CLASSES);
+
+    uint64_t mismatches = 0;
+    for (uint32_t sample = 0; sample < samples; sample++) {
+        for (uint32_t c = 0; c < NUM_CLASSES; c++) {
+            uint32_t opcode = c & 0x7F;
+            uint32_t funct3 = (c >> 7) & 0x7;
+            uint32_t funct7 = c >> 10;
+            uint32_t r = engine();
+            uint32_t rs2 = sample < NUM_FIXED ? FIXED_RS2[sample] : (r >> 10) & 0x1F;
+            codes[c] = (funct7 << 25) | (rs2 << 20) | (((r >> 5) & 0x1F) << 15) |
+                       (funct3 << 12) | ((r & 0x1F) << 7) | opcode;
+        }
+
+        decode_ref(codes.data(), NUM_CLASSES, expected.data());
+        dut->decode_batch(codes.data(), NUM_CLASSES, actual.data());
+
+        for (uint32_t c = 0; c < NUM_CLASSES; c++) {
+            const decode_result_t& e = expected[c];
+            const decode_result_t& a = actual[c];
+            if (e.inst == a.inst && e.imm == a.imm && e.csr_num == a.csr_num &&
+                e.rd_num == a.rd_num && e.rs1_num == a.rs1_num && e.rs2_num == a.rs2_num &&
+                e.rs3_num == a.rs3_num && e.csr_zimm == a.csr_zimm) {
+                continue;
+            }
+            // report only the first few so that a broken opcode stays readable
+            if (mismatches++ < 16) {
+                ADD_FAILURE() << std::hex << "inst_code " << codes[c] << ": "
+                              << Inst(unpack_inst_bit(a.inst)).get_inst_name() << " (expected "
+                              << Inst(unpack_inst_bit(e.inst)).get_inst_name() << ")"
+                              << " inst " << a.inst.to_string() << "/" << e.inst.to_string()
+                              << " imm " << a.imm << "/" << e.imm << " csr " << a.csr_num << "/"
+                              << e.csr_num << " rd " << +a.rd_num << "/" << +e.rd_num << " rs1 "
+                              << +a.rs1_num << "/" << +e.rs1_num << " rs2 " << +a.rs2_num << "/"
+                              << +e.rs2_num << " rs3 " << +a.rs3_num << "/" << +e.rs3_num
+                              << " zimm " << +a.csr_zimm << "/" << +e.csr_zimm;
+            }
+        }
+    }
+    EXPECT_EQ(mismatches, 0u);
+}
+
 }  // namespace
@@ -1,6 +1,7 @@
 #include <map>
 #include <string>
 
+#include "ref_model.hpp"
 #include "test_inst.hpp"
 #include "Vdecode.h"
 
@@ -11,7 +12,9 @@ class VdecodeForTest : public Vdecode {
 
     Inst _inst;
     inst_bit_t _inst_bit;
-    void set_inst_code(uint32_t);
+    void set_inst_code(uint32_t, bool = false);
     std::string get_inst_name();
     bool get_ctrl_signal(std::string);
+    // one posedge per instruction code, results are collected instead of checked
+    void decode_batch(const uint32_t*, size_t, decode_result_t*);
 };
\ No newline at end of file
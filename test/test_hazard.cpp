@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+#include <verilated.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Vcore.h"
+#include "rv32_gen.hpp"
+#include "rv32_iss.hpp"
+#include "sim_runner.hpp"
+
+namespace {
+
+using namespace rv32;
+
+constexpr uint32_t BPFP = 0xFC2;
+constexpr uint32_t BPFN = 0xFC3;
+constexpr uint32_t HZST = 0xFC6;
+constexpr uint32_t HZAV = 0xFC7;
+constexpr uint32_t BPMC = 0xFC8;
+
+constexpr uint32_t RESULT = 0x1000;  // x12
+constexpr uint64_t MAX_CYCLES = 10000;
+
+class TestHazard : public ::testing::Test {
+   protected:
+    SimRunner runner;
+
+    void run(std::vector<uint32_t> code) {
+        code.insert(code.begin(), lui(12, RESULT));
+        // drain the last store before EXT stops the core
+        code.insert(code.end(), 4, addi(0, 0, 0));
+        code.push_back(rv32::EXT);
+        runner.load_code(code);
+        sim_result_t sim = runner.run_loaded({0, "", MAX_CYCLES, 0, 0});
+        ASSERT_EQ(sim.status, "finished");
+    }
+
+    uint32_t result(int index) { return runner.memory().read(RESULT / 4 + index); }
+};
+
+// a load to x0 has no consumer, even where an unused operand field reads as x0
+TEST_F(TestHazard, LoadToZeroDoesNotStall) {
+    constexpr int32_t ITERATIONS = 10;
+    run({
+        addi(9, 0, ITERATIONS),
+        // loop
+        lw(0, 12, 0x40),
+        addi(5, 5, 1),
+        addi(9, 9, -1),
+        rv32::b_type(-12, 0, 9, 0b001),  // bne x9, x0, loop
+        csrr(HZST, 6),
+        sw(5, 12, 0),
+        sw(6, 12, 4),
+    });
+    EXPECT_EQ(result(0), static_cast<uint32_t>(ITERATIONS));
+    EXPECT_EQ(result(1), 0u);
+}
+
+// a load's consumer gets the loaded value, and a CSR instruction's old value
+// reaches the next three instructions
+TEST_F(TestHazard, LoadUseAndCsrRaw) {
+    run({
+        addi(5, 0, 7),
+        sw(5, 12, 0x40),
+        lw(6, 12, 0x40),
+        addi(7, 6, 1),  // load-use
+        addi(1, 0, 0x100),
+        addi(2, 0, 0x200),
+        csrrw(Rv32Iss::MTVEC, 0, 1),
+        csrrw(Rv32Iss::MTVEC, 8, 2),  // x8 = 0x100
+        addi(10, 8, 1),               // CSR RAW
+        addi(15, 8, 2),
+        addi(16, 8, 3),
+        csrr(Rv32Iss::MTVEC, 11),
+        add(13, 11, 0),  // CSR RAW
+        sw(7, 12, 0),
+        sw(10, 12, 4),
+        sw(15, 12, 8),
+        sw(16, 12, 12),
+        sw(13, 12, 16),
+    });
+    EXPECT_EQ(result(0), 8u);
+    EXPECT_EQ(result(1), 0x101u);
+    EXPECT_EQ(result(2), 0x102u);
+    EXPECT_EQ(result(3), 0x103u);
+    EXPECT_EQ(result(4), 0x200u);
+}
+
+// a loaded word feeds the next store's data without a stall
+TEST_F(TestHazard, LoadFeedsStoreData) {
+    constexpr int32_t WORDS = 8;
+    constexpr int32_t SRC = 0x40;
+    run({
+        addi(9, 0, WORDS),
+        addi(10, 12, SRC),
+        // fill: src[i] = WORDS - i
+        sw(9, 10, 0),
+        addi(10, 10, 4),
+        addi(9, 9, -1),
+        rv32::b_type(-12, 0, 9, 0b001),  // bne x9, x0, fill
+        addi(9, 0, WORDS),
+        addi(10, 12, SRC),
+        addi(11, 12, 0),
+        // copy
+        lw(5, 10, 0),
+        sw(5, 11, 0),
+        addi(10, 10, 4),
+        addi(11, 11, 4),
+        addi(9, 9, -1),
+        rv32::b_type(-20, 0, 9, 0b001),  // bne x9, x0, copy
+        csrr(HZST, 6),
+        sw(6, 12, WORDS * 4),
+    });
+    for (int i = 0; i < WORDS; i++) {
+        EXPECT_EQ(result(i), static_cast<uint32_t>(WORDS - i)) << i;
+    }
+    EXPECT_EQ(result(WORDS), 0u);
+}
+
+// a word-by-word memcpy of 4 KiB, two words per iteration: the recorded cycles
+// and stalls are the numbers to compare across hazard unit changes
+TEST_F(TestHazard, MemcpyKernel) {
+    constexpr int32_t WORDS = 1024;
+    constexpr uint32_t SRC = 0x10000;
+    constexpr uint32_t DST = 0x20000;
+    for (int32_t i = 0; i < WORDS; i++) {
+        runner.memory().write(SRC / 4 + i, 0x5A000000u | i);
+    }
+    const std::vector<uint32_t> code = {
+        lui(10, SRC),
+        lui(11, DST),
+        addi(9, 0, WORDS / 2),
+        // copy
+        lw(5, 10, 0),
+        sw(5, 11, 0),  // store data from the load before it
+        lw(6, 10, 4),
+        sw(6, 11, 4),
+        addi(10, 10, 8),
+        addi(11, 11, 8),
+        addi(9, 9, -1),
+        rv32::b_type(-28, 0, 9, 0b001),  // bne x9, x0, copy
+        csrr(HZAV, 7),
+        lui(12, RESULT),
+        sw(7, 12, 0),
+        addi(0, 0, 0),
+        addi(0, 0, 0),
+        addi(0, 0, 0),
+        addi(0, 0, 0),
+        rv32::EXT,
+    };
+    runner.write_code(0, code);
+    sim_result_t sim = runner.run_loaded({0, "", 100000, 0, 0});
+    ASSERT_EQ(sim.status, "finished");
+    for (int32_t i = 0; i < WORDS; i++) {
+        ASSERT_EQ(runner.memory().read(DST / 4 + i), 0x5A000000u | i) << i;
+    }
+    RecordProperty("cycles", std::to_string(sim.cycles));
+    RecordProperty("hzst", std::to_string(sim.hzst));
+    RecordProperty("hzav", std::to_string(result(0)));
+}
+
+// Dhrystone runs to the end; its cycles and stalls are recorded
+TEST_F(TestHazard, Dhrystone) {
+    sim_result_t sim = runner.run({0, "../../hex/dhry.hex", 10000000, 0, 0});
+    ASSERT_EQ(sim.status, "finished");
+    RecordProperty("cycles", std::to_string(sim.cycles));
+    RecordProperty("hzst", std::to_string(sim.hzst));
+    RecordProperty("bpmc", std::to_string(sim.bpmc));
+}
+
+// branches and a JAL resolved in DE go the right way, and every misprediction
+// costs at least one cycle in bpmc
+TEST_F(TestHazard, MispredictCyclesAreCounted) {
+    constexpr int32_t ITERATIONS = 16;
+    run({
+        addi(9, 0, ITERATIONS),
+        addi(8, 0, 1),
+        // loop: swap x7 and x8, so x7 is 1, 0, 1, ...
+        add(11, 7, 0),
+        add(7, 8, 0),
+        add(8, 11, 0),
+        rv32::b_type(8, 0, 7, 0b000),  // beq x7, x0, skip
+        addi(5, 5, 1),
+        // skip
+        rv32::j_type(8, 0),  // jal x0, next
+        addi(6, 6, 1),
+        // next
+        addi(9, 9, -1),
+        rv32::b_type(-32, 0, 9, 0b001),  // bne x9, x0, loop
+        csrr(BPMC, 13),
+        csrr(BPFP, 14),
+        csrr(BPFN, 15),
+        sw(5, 12, 0),
+        sw(6, 12, 4),
+        sw(13, 12, 8),
+        sw(14, 12, 12),
+        sw(15, 12, 16),
+    });
+    EXPECT_EQ(result(0), static_cast<uint32_t>(ITERATIONS / 2));
+    EXPECT_EQ(result(1), 0u);
+    const uint32_t mispredicts = result(3) + result(4);
+    EXPECT_GT(mispredicts, 0u);
+    EXPECT_GE(result(2), mispredicts);
+}
+
+}  // namespace
@@ -2,99 +2,82 @@
 
 #include <gtest/gtest.h>
 
-#include <cstring>
+#include <cstdio>
+#include <stdexcept>
 
-Inst::Inst() {}
-Inst::Inst(const inst_bit_t& inst_bit) { init(inst_bit); }
-
-Inst::~Inst() {}
+std::string inst_packed_t::to_string() const {
+    std::string str;
+    char buf[17];
+    for (int i = NUM_INST_WORDS - 1; i >= 0; i--) {
+        std::snprintf(buf, sizeof(buf), str.empty() ? "%llx" : "%016llx",
+                      static_cast<unsigned long long>(word[i]));
+        str += buf;
+    }
+    return str;
+}
 
-void Inst::init(const inst_bit_t& inst_bit) {
-    std::memcpy(&_inst_bit, &inst_bit, sizeof(inst_bit_t));
-    ctrl_signal_map = {
-        // pipeline control signals
-        {"UPDATE_PC", (bool)_inst_bit.UPDATE_PC},
-        {"UPDATE_REG", (bool)_inst_bit.UPDATE_REG},
-        {"UPDATE_CSR", (bool)_inst_bit.UPDATE_CSR},
-        {"ACCESS_MEM", (bool)_inst_bit.ACCESS_MEM},
-    };
-    _inst_map = {
-        // RV32I
-        {"CSRRCI", (bool)_inst_bit.CSRRCI},
-        {"CSRRSI", (bool)_inst_bit.CSRRSI},
-        {"CSRRWI", (bool)_inst_bit.CSRRWI},
-        {"CSRRC", (bool)_inst_bit.CSRRC},
-        {"CSRRS", (bool)_inst_bit.CSRRS},
-        {"CSRRW", (bool)_inst_bit.CSRRW},
-        {"MRET", (bool)_inst_bit.MRET},
-        {"EBREAK", (bool)_inst_bit.EBREAK},
-        {"ECALL", (bool)_inst_bit.ECALL},
-        {"FENCE_I", (bool)_inst_bit.FENCE_I},
-        {"FENCE", (bool)_inst_bit.FENCE},
-        {"AND", (bool)_inst_bit.AND},
-        {"OR", (bool)_inst_bit.OR},
-        {"SRA", (bool)_inst_bit.SRA},
-        {"SRL", (bool)_inst_bit.SRL},
-        {"XOR", (bool)_inst_bit.XOR},
-        {"SLTU", (bool)_inst_bit.SLTU},
-        {"SLT", (bool)_inst_bit.SLT},
-        {"SLL", (bool)_inst_bit.SLL},
-        {"SUB", (bool)_inst_bit.SUB},
-        {"ADD", (bool)_inst_bit.ADD},
-        {"SRAI", (bool)_inst_bit.SRAI},
-        {"SRLI", (bool)_inst_bit.SRLI},
-        {"SLLI", (bool)_inst_bit.SLLI},
-        {"ANDI", (bool)_inst_bit.ANDI},
-        {"ORI", (bool)_inst_bit.ORI},
-        {"XORI", (bool)_inst_bit.XORI},
-        {"SLTIU", (bool)_inst_bit.SLTIU},
-        {"SLTI", (bool)_inst_bit.SLTI},
-        {"ADDI", (bool)_inst_bit.ADDI},
-        {"SW", (bool)_inst_bit.SW},
-        {"SH", (bool)_inst_bit.SH},
-        {"SB", (bool)_inst_bit.SB},
-        {"LHU", (bool)_inst_bit.LHU},
-        {"LBU", (bool)_inst_bit.LBU},
-        {"LW", (bool)_inst_bit.LW},
-        {"LH", (bool)_inst_bit.LH},
-        {"LB", (bool)_inst_bit.LB},
-        {"BGEU", (bool)_inst_bit.BGEU},
-        {"BLTU", (bool)_inst_bit.BLTU},
-        {"BGE", (bool)_inst_bit.BGE},
-        {"BLT", (bool)_inst_bit.BLT},
-        {"BNE", (bool)_inst_bit.BNE},
-        {"BEQ", (bool)_inst_bit.BEQ},
-        {"JALR", (bool)_inst_bit.JALR},
-        {"JAL", (bool)_inst_bit.JAL},
-        {"AUIPC", (bool)_inst_bit.AUIPC},
-        {"LUI", (bool)_inst_bit.LUI},
+std::string Inst::get_inst_name() const {
+    const char* name = inst_name(_packed);
+    if (name) {
+        return name;
+    }
 
-        // RV32M
-        {"MUL", (bool)_inst_bit.MUL},
-        {"MULH", (bool)_inst_bit.MULH},
-        {"MULHSU", (bool)_inst_bit.MULHSU},
-        {"MULHU", (bool)_inst_bit.MULHU},
-        {"DIV", (bool)_inst_bit.DIV},
-        {"DIVU", (bool)_inst_bit.DIVU},
-        {"REM", (bool)_inst_bit.REM},
-        {"REMU", (bool)_inst_bit.REMU},
+    std::string inst_names;
+    inst_packed_t inst = _packed & ~INST_CTRL_MASK;
+    for (int i = 0; i < NUM_INST_BITS; i++) {
+        if (inst.test(i)) {
+            if (!inst_names.empty()) {
+                inst_names += " ";
+            }
+            inst_names += INST_BIT_NAMES[i];
+        }
+    }
+    return inst_names;
+}
 
-        // Custom
-        {"EXTX", (bool)_inst_bit.EXTX},
-        {"EXT", (bool)_inst_bit.EXT},
-    };
+bool Inst::get_ctrl_signal(std::string_view ctrl_signal_name) const {
+    int index = inst_bit_index(ctrl_signal_name);
+    if (index < 0 || !INST_CTRL_MASK.test(index)) {
+        throw std::out_of_range("unknown control signal: " + std::string(ctrl_signal_name));
+    }
+    return _packed.test(index);
 }
 
-std::string Inst::get_inst_name() {
-    std::string inst_name = "NOP";
-    for (const auto& [op_name, is_active] : _inst_map) {
-        if (is_active) {
-            if (inst_name == "NOP") {
-                inst_name = op_name;
-            } else {
-                inst_name += " " + op_name;
-            }
-        }
+namespace {
+
+// every field of inst_bit_t must sit at the bit the table assigns to it
+TEST(InstTable, MirrorsPackedStruct) {
+#define RIP_INST_FIELD(name)                                                      \
+    {                                                                             \
+        inst_bit_t inst_bit = {0};                                                \
+        inst_bit.name = 1;                                                        \
+        EXPECT_TRUE(pack_inst_bit(inst_bit) == make_inst_mask({INST_BIT_##name})) \
+            << #name;                                                             \
     }
-    return inst_name;
+#include "inst_fields.inc"
+#undef RIP_INST_FIELD
+}
+
+TEST(InstTable, NameLookup) {
+    static_assert(inst_bit_index("LUI") == INST_BIT_LUI);
+    static_assert(inst_bit_index("NOT_AN_INST") == -1);
+    static_assert(inst_name(inst_packed_t{}) == std::string_view("NOP"));
+    static_assert(inst_name(make_inst_mask({INST_BIT_RC, INST_BIT_UPDATE_REG})) ==
+                  std::string_view("RC"));
+
+    inst_bit_t inst_bit = {0};
+    inst_bit.MULHSU = 1;
+    inst_bit.UPDATE_REG = 1;
+    Inst inst(inst_bit);
+    EXPECT_EQ(inst.get_inst_name(), "MULHSU");
+    EXPECT_TRUE(inst.get_ctrl_signal("UPDATE_REG"));
+    EXPECT_FALSE(inst.get_ctrl_signal("UPDATE_PC"));
+    EXPECT_THROW(inst.get_ctrl_signal("MULHSU"), std::out_of_range);
+
+    inst_bit.ADD = 1;
+    inst.init(inst_bit);
+    EXPECT_EQ(inst_name(inst.packed()), nullptr);
+    EXPECT_EQ(inst.get_inst_name(), "MULHSU ADD");
 }
+
+}  // namespace
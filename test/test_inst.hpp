@@ -1,94 +1,160 @@
 #ifndef _INSTRUCTIONS_HPP_
 #define _INSTRUCTIONS_HPP_
 
-#include <map>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
 #include <string>
+#include <string_view>
 
+// Mirror of rip_type::inst_t. inst_fields.inc is generated from
+// src/rip_type.sv at build time (cmake/gen_inst_fields.cmake) and lists
+// the fields LSB first, so the layout follows the SystemVerilog struct.
 typedef struct {
-    // pipeline control signals
-    bool UPDATE_PC : 1;
-    bool UPDATE_CSR : 1;
-    bool UPDATE_REG : 1;
-    bool ACCESS_MEM : 1;
-
-    // Custom
-    bool EXT : 1;
-    bool EXTX : 1;
-
-    // RV32M
-    bool REMU : 1;
-    bool REM : 1;
-    bool DIVU : 1;
-    bool DIV : 1;
-    bool MULHU : 1;
-    bool MULHSU : 1;
-    bool MULH : 1;
-    bool MUL : 1;
-
-    // RV32I
-    bool CSRRCI : 1;
-    bool CSRRSI : 1;
-    bool CSRRWI : 1;
-    bool CSRRC : 1;
-    bool CSRRS : 1;
-    bool CSRRW : 1;
-    bool MRET : 1;
-    bool EBREAK : 1;
-    bool ECALL : 1;
-    bool FENCE_I : 1;
-    bool FENCE : 1;
-    bool AND : 1;
-    bool OR : 1;
-    bool SRA : 1;
-    bool SRL : 1;
-    bool XOR : 1;
-    bool SLTU : 1;
-    bool SLT : 1;
-    bool SLL : 1;
-    bool SUB : 1;
-    bool ADD : 1;
-    bool SRAI : 1;
-    bool SRLI : 1;
-    bool SLLI : 1;
-    bool ANDI : 1;
-    bool ORI : 1;
-    bool XORI : 1;
-    bool SLTIU : 1;
-    bool SLTI : 1;
-    bool ADDI : 1;
-    bool SW : 1;
-    bool SH : 1;
-    bool SB : 1;
-    bool LHU : 1;
-    bool LBU : 1;
-    bool LW : 1;
-    bool LH : 1;
-    bool LB : 1;
-    bool BGEU : 1;
-    bool BLTU : 1;
-    bool BGE : 1;
-    bool BLT : 1;
-    bool BNE : 1;
-    bool BEQ : 1;
-    bool JALR : 1;
-    bool JAL : 1;
-    bool AUIPC : 1;
-    bool LUI : 1;
+#define RIP_INST_FIELD(name) bool name : 1;
+#include "inst_fields.inc"
+#undef RIP_INST_FIELD
 } __attribute__((packed)) inst_bit_t;
 
+// bit position of each field in the packed word
+enum inst_bit_index_t : int {
+#define RIP_INST_FIELD(name) INST_BIT_##name,
+#include "inst_fields.inc"
+#undef RIP_INST_FIELD
+    NUM_INST_BITS
+};
+
+constexpr const char* INST_BIT_NAMES[NUM_INST_BITS] = {
+#define RIP_INST_FIELD(name) #name,
+#include "inst_fields.inc"
+#undef RIP_INST_FIELD
+};
+
+static_assert(sizeof(inst_bit_t) == (NUM_INST_BITS + 7) / 8, "inst_bit_t must be packed");
+
+constexpr int NUM_INST_WORDS = (NUM_INST_BITS + 63) / 64;
+
+// inst_t as 64-bit words, LSB first (bit i is field INST_BIT_NAMES[i])
+struct inst_packed_t {
+    uint64_t word[NUM_INST_WORDS];
+
+    constexpr bool test(int index) const { return (word[index / 64] >> (index % 64)) & 1; }
+    constexpr void set(int index) { word[index / 64] |= 1ull << (index % 64); }
+    constexpr bool none() const {
+        for (int i = 0; i < NUM_INST_WORDS; i++) {
+            if (word[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    constexpr inst_packed_t operator&(const inst_packed_t& rhs) const {
+        inst_packed_t result = {};
+        for (int i = 0; i < NUM_INST_WORDS; i++) {
+            result.word[i] = word[i] & rhs.word[i];
+        }
+        return result;
+    }
+    constexpr inst_packed_t operator~() const {
+        inst_packed_t result = {};
+        for (int i = 0; i < NUM_INST_WORDS; i++) {
+            result.word[i] = ~word[i];
+        }
+        return result;
+    }
+    constexpr bool operator==(const inst_packed_t& rhs) const {
+        for (int i = 0; i < NUM_INST_WORDS; i++) {
+            if (word[i] != rhs.word[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    constexpr bool operator!=(const inst_packed_t& rhs) const { return !(*this == rhs); }
+    // hex, most significant word first
+    std::string to_string() const;
+};
+
+constexpr inst_packed_t make_inst_mask(std::initializer_list<int> indices) {
+    inst_packed_t mask = {};
+    for (int index : indices) {
+        mask.set(index);
+    }
+    return mask;
+}
+
+constexpr inst_packed_t INST_BIT_MASK = [] {
+    inst_packed_t mask = {};
+    for (int i = 0; i < NUM_INST_BITS; i++) {
+        mask.set(i);
+    }
+    return mask;
+}();
+
+// pipeline control signals
+constexpr inst_packed_t INST_CTRL_MASK =
+    make_inst_mask({INST_BIT_ACCESS_MEM, INST_BIT_UPDATE_REG, INST_BIT_UPDATE_CSR,
+                    INST_BIT_UPDATE_PC, INST_BIT_COMPRESSED});
+
+// also reads the Verilated `inst` port (QData or VlWide) through a pointer to it
+inline inst_packed_t pack_inst_bit(const void* inst_bit) {
+    inst_packed_t packed = {};
+    std::memcpy(packed.word, inst_bit, sizeof(inst_bit_t));
+    return packed & INST_BIT_MASK;
+}
+
+inline inst_packed_t pack_inst_bit(const inst_bit_t& inst_bit) {
+    return pack_inst_bit(static_cast<const void*>(&inst_bit));
+}
+
+inline inst_bit_t unpack_inst_bit(const inst_packed_t& packed) {
+    inst_bit_t inst_bit;
+    std::memcpy(&inst_bit, packed.word, sizeof(inst_bit_t));
+    return inst_bit;
+}
+
+// returns -1 for unknown names
+constexpr int inst_bit_index(std::string_view name) {
+    for (int i = 0; i < NUM_INST_BITS; i++) {
+        if (name == INST_BIT_NAMES[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// name of the instruction when at most one instruction bit is set
+// ("NOP" for none), nullptr otherwise
+constexpr const char* inst_name(const inst_packed_t& packed) {
+    inst_packed_t inst = packed & INST_BIT_MASK & ~INST_CTRL_MASK;
+    int index = -1;
+    for (int i = 0; i < NUM_INST_WORDS; i++) {
+        uint64_t word = inst.word[i];
+        if (word == 0) {
+            continue;
+        }
+        if (index >= 0 || (word & (word - 1))) {
+            return nullptr;
+        }
+        index = i * 64 + __builtin_ctzll(word);
+    }
+    return index < 0 ? "NOP" : INST_BIT_NAMES[index];
+}
+
 class Inst {
    private:
-    inst_bit_t _inst_bit;
-    std::map<std::string, bool> _inst_map;
+    inst_packed_t _packed;
 
    public:
-    Inst();
-    Inst(const inst_bit_t&);
-    ~Inst();
+    Inst() : _packed() {}
+    Inst(const inst_bit_t& inst_bit) { init(inst_bit); }
 
-    std::map<std::string, bool> ctrl_signal_map;
-    void init(const inst_bit_t&);
-    std::string get_inst_name();
+    void init(const inst_bit_t& inst_bit) { _packed = pack_inst_bit(inst_bit); }
+    const inst_packed_t& packed() const { return _packed; }
+    // space-separated in bit order if several instruction bits are set
+    std::string get_inst_name() const;
+    // throws std::out_of_range for an unknown signal name
+    bool get_ctrl_signal(std::string_view ctrl_signal_name) const;
 };
 
 #endif
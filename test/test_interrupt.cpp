@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <verilated.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "Vcore.h"
+#include "rv32_gen.hpp"
+#include "rv32_iss.hpp"
+#include "sim_runner.hpp"
+
+namespace {
+
+using namespace rv32;
+
+constexpr uint32_t MTIMECMP = 0x7C0;
+constexpr uint32_t MTIMECMPH = 0x7C1;
+
+constexpr uint32_t HANDLER = 0x100;
+constexpr uint32_t RESULT = 0x1000;  // x12
+constexpr uint64_t MAX_CYCLES = 10000;
+
+class TestInterrupt : public ::testing::Test {
+   protected:
+    SimRunner runner;
+    uint32_t loop_pc;
+
+    // Enables the interrupts in `mie` after `setup` and counts in x10 until the
+    // handler sets x11. Then x10, x13, x14 (mcause and mepc read by the handler)
+    // and mstatus are stored to RESULT.
+    void load(uint32_t mtvec, uint32_t mie, const std::vector<uint32_t>& setup,
+              uint32_t handler_pc, const std::vector<uint32_t>& handler) {
+        std::vector<uint32_t> code = {
+            lui(12, RESULT),
+            addi(1, 0, mtvec),
+            csrw(Rv32Iss::MTVEC, 1),
+            addi(2, 0, mie >> 1),
+            rv32::r_type(0, 2, 2, 0b000, 2, OP),  // add x2, x2, x2
+            csrw(Rv32Iss::MIE, 2),
+        };
+        code.insert(code.end(), setup.begin(), setup.end());
+        code.push_back(rv32::i_type(Rv32Iss::MSTATUS, 8, 0b110, 0, SYSTEM));  // csrsi mstatus, MIE
+        loop_pc = 4 * code.size();
+        std::vector<uint32_t> tail = {
+            addi(10, 10, 1),
+            rv32::b_type(-4, 0, 11, 0b000),  // beq x11, x0, loop
+            sw(10, 12, 0),
+            sw(13, 12, 4),
+            sw(14, 12, 8),
+            csrr(Rv32Iss::MSTATUS, 15),
+            sw(15, 12, 12),
+            rv32::EXT,
+        };
+        code.insert(code.end(), tail.begin(), tail.end());
+
+        runner.load_code(code);
+        runner.write_code(handler_pc, handler);
+    }
+
+    uint32_t result(int index) { return runner.memory().read(RESULT / 4 + index); }
+
+    void expect_results(uint32_t cause) {
+        EXPECT_GT(result(0), 0u);
+        EXPECT_EQ(result(1), Rv32Iss::CAUSE_INTERRUPT | cause);
+        // taken on the loop body; the interrupted instruction runs again after MRET
+        EXPECT_GE(result(2), loop_pc);
+        EXPECT_LE(result(2), loop_pc + 4);
+        EXPECT_EQ(result(3), Rv32Iss::MSTATUS_MIE | Rv32Iss::MSTATUS_MPIE);
+    }
+};
+
+TEST_F(TestInterrupt, Timer) {
+    load(HANDLER, 1u << Rv32Iss::IRQ_M_TIMER,
+         {
+             addi(3, 0, 200),
+             csrw(MTIMECMP, 3),
+             csrwi(MTIMECMPH, 0),
+         },
+         HANDLER,
+         {
+             csrr(Rv32Iss::MCAUSE, 13),
+             csrr(Rv32Iss::MEPC, 14),
+             csrwi(MTIMECMPH, 31),  // acknowledge by moving the compare value away
+             addi(11, 0, 1),
+             rv32::MRET,
+         });
+
+    sim_result_t sim = runner.run_loaded({0, "", MAX_CYCLES, 0, 0});
+    ASSERT_EQ(sim.status, "finished");
+    expect_results(Rv32Iss::IRQ_M_TIMER);
+}
+
+TEST_F(TestInterrupt, ExternalVectored) {
+    constexpr uint64_t RAISE_AT = 300;
+    constexpr uint64_t MAX_LATENCY = 48;  // until the handler's store reaches memory
+    load(HANDLER | 1, 1u << Rv32Iss::IRQ_M_EXT, {},
+         HANDLER + 4 * Rv32Iss::IRQ_M_EXT,
+         {
+             csrr(Rv32Iss::MCAUSE, 13),
+             csrr(Rv32Iss::MEPC, 14),
+             csrw(Rv32Iss::MIE, 0),  // the line stays high until the host sees the flag
+             addi(11, 0, 1),
+             sw(11, 12, 16),
+             rv32::MRET,
+         });
+
+    Vcore& dut = runner.dut();
+    dut.irq_external = 0;
+    runner.reset();
+    runner.start(0, 0);
+    uint64_t cycles = 0, raised = 0, latency = 0;
+    while (dut.busy && cycles < MAX_CYCLES) {
+        if (cycles == RAISE_AT) {
+            dut.irq_external = 1;
+            raised = cycles;
+        }
+        if (dut.irq_external && result(4) != 0) {
+            dut.irq_external = 0;
+            latency = cycles - raised;
+        }
+        runner.tick();
+        cycles++;
+    }
+    ASSERT_FALSE(dut.busy);
+    EXPECT_GT(latency, 0u);
+    EXPECT_LE(latency, MAX_LATENCY);
+    expect_results(Rv32Iss::IRQ_M_EXT);
+}
+
+// the mode of an mtvec written just before the interrupt is enabled selects
+// the vector, as its base does
+TEST_F(TestInterrupt, MtvecWrittenBeforeEnable) {
+    std::vector<uint32_t> code = {
+        lui(12, RESULT),
+        addi(1, 0, HANDLER),
+        csrw(Rv32Iss::MTVEC, 1),  // direct
+        addi(2, 0, (1u << Rv32Iss::IRQ_M_EXT) >> 1),
+        rv32::r_type(0, 2, 2, 0b000, 2, OP),  // add x2, x2, x2
+        csrw(Rv32Iss::MIE, 2),
+        addi(1, 0, HANDLER | 1),
+        csrw(Rv32Iss::MTVEC, 1),                              // vectored
+        rv32::i_type(Rv32Iss::MSTATUS, 8, 0b110, 0, SYSTEM),  // csrsi mstatus, MIE
+        addi(10, 10, 1),
+        rv32::b_type(-4, 0, 11, 0b000),  // beq x11, x0, loop
+        sw(11, 12, 0),
+        sw(13, 12, 4),
+        rv32::EXT,
+    };
+    // direct mode would land here
+    std::vector<uint32_t> direct = {
+        addi(11, 0, 2),
+        csrw(Rv32Iss::MIE, 0),
+        rv32::MRET,
+    };
+    std::vector<uint32_t> vectored = {
+        csrr(Rv32Iss::MCAUSE, 13),
+        addi(11, 0, 1),
+        csrw(Rv32Iss::MIE, 0),
+        rv32::MRET,
+    };
+    runner.load_code(code);
+    runner.write_code(HANDLER, direct);
+    runner.write_code(HANDLER + 4 * Rv32Iss::IRQ_M_EXT, vectored);
+
+    runner.dut().irq_external = 1;
+    sim_result_t sim = runner.run_loaded({0, "", MAX_CYCLES, 0, 0});
+    runner.dut().irq_external = 0;
+    ASSERT_EQ(sim.status, "finished");
+    EXPECT_EQ(result(0), 1u);
+    EXPECT_EQ(result(1), Rv32Iss::CAUSE_INTERRUPT | Rv32Iss::IRQ_M_EXT);
+}
+
+}  // namespace
@@ -0,0 +1,277 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "rv32_gen.hpp"
+#include "rv32_iss.hpp"
+
+namespace {
+
+TEST(TestIss, RiscvTests) {
+    constexpr uint64_t STEP_MAX = 100000;
+    int num_tests = 0;
+    for (const auto& entry : std::filesystem::directory_iterator("../../hex/riscv-tests")) {
+        if (entry.path().extension() != ".hex") {
+            continue;
+        }
+        SparseMemory mem;
+        ASSERT_TRUE(mem.load_hex(entry.path().string()));
+        Rv32Iss iss(mem);
+        iss.run(STEP_MAX);
+
+        EXPECT_TRUE(iss.finished()) << entry.path();
+        EXPECT_EQ(iss.reg(3), 1u) << entry.path();
+        num_tests++;
+    }
+    EXPECT_GT(num_tests, 0);
+}
+
+TEST(TestIss, Encoders) {
+    EXPECT_EQ(rv32::u_type(0x12345000, 1, 0b0110111), 0x123450B7u);  // lui x1, 0x12345
+    EXPECT_EQ(rv32::j_type(-132, 1), 0xF7DFF0EFu);                   // jal x1, -132
+    EXPECT_EQ(rv32::b_type(-16, 2, 1, 0b000), 0xFE2088E3u);          // beq x1, x2, -16
+    EXPECT_EQ(rv32::s_type(-4, 2, 1, 0b010, 0b0100011), 0xFE20AE23u);  // sw x2, -4(x1)
+    EXPECT_EQ(rv32::i_type(-1, 1, 0b000, 2, 0b0010011), 0xFFF08113u);  // addi x2, x1, -1
+    EXPECT_EQ(rv32::cl_type(0b010, 4, 11, 10), 0x41C8u);               // c.lw a0, 4(a1)
+    EXPECT_EQ(rv32::cj_type(0b101, -4), 0xBFF5u);                      // c.j -4
+    EXPECT_EQ(rv32::cb_type(0b111, -6, 9), 0xFCEDu);                   // c.bnez s1, -6
+    EXPECT_EQ(rv32::cb_alu(0b10, -5, 12), 0x9A6Du);                    // c.andi a2, -5
+    EXPECT_EQ(rv32::ca_type(0b00, 11, 10), 0x8D0Du);                   // c.sub a0, a1
+    EXPECT_EQ(rv32::cr_type(0b1001, 5, 6), 0x929Au);                   // c.add t0, t1
+}
+
+TEST(TestIss, BitManipulation) {
+    constexpr uint32_t OP = 0b0110011;
+    constexpr uint32_t OP_IMM = 0b0010011;
+    std::vector<uint32_t> code = {
+        rv32::u_type(0x12345000, 1, 0b0110111),            // lui x1, 0x12345
+        rv32::i_type(0x678, 1, 0b000, 1, OP_IMM),           // addi x1, x1, 0x678
+        rv32::i_type(-3, 0, 0b000, 2, OP_IMM),              // addi x2, x0, -3
+        rv32::r_type(0b0010000, 2, 1, 0b100, 3, OP),        // sh2add x3, x1, x2
+        rv32::r_type(0b0000101, 2, 1, 0b100, 4, OP),        // min x4, x1, x2
+        rv32::r_type(0b0000101, 2, 1, 0b111, 5, OP),        // maxu x5, x1, x2
+        rv32::r_type(0b0100000, 2, 1, 0b111, 6, OP),        // andn x6, x1, x2
+        rv32::r_type(0b0110000, 2, 1, 0b001, 7, OP),        // rol x7, x1, x2
+        rv32::i_type(0x608, 1, 0b101, 8, OP_IMM),           // rori x8, x1, 8
+        rv32::i_type(0x600, 1, 0b001, 9, OP_IMM),           // clz x9, x1
+        rv32::i_type(0x602, 2, 0b001, 10, OP_IMM),          // cpop x10, x2
+        rv32::i_type(0x604, 1, 0b001, 11, OP_IMM),          // sext.b x11, x1
+        rv32::r_type(0b0000100, 0, 2, 0b100, 12, OP),       // zext.h x12, x2
+        rv32::i_type(0x698, 1, 0b101, 13, OP_IMM),          // rev8 x13, x1
+        rv32::i_type(0x287, 1, 0b101, 14, OP_IMM),          // orc.b x14, x1
+        rv32::EXT,
+    };
+    SparseMemory mem;
+    for (size_t i = 0; i < code.size(); i++) {
+        mem.write(i, code[i]);
+    }
+    Rv32Iss iss(mem);
+    EXPECT_EQ(iss.run(100), code.size());
+    EXPECT_TRUE(iss.finished());
+
+    EXPECT_EQ(iss.reg(3), 0x48D159DDu);
+    EXPECT_EQ(iss.reg(4), 0xFFFFFFFDu);
+    EXPECT_EQ(iss.reg(5), 0xFFFFFFFDu);
+    EXPECT_EQ(iss.reg(6), 0x00000000u);
+    EXPECT_EQ(iss.reg(7), 0x02468ACFu);
+    EXPECT_EQ(iss.reg(8), 0x78123456u);
+    EXPECT_EQ(iss.reg(9), 3u);
+    EXPECT_EQ(iss.reg(10), 31u);
+    EXPECT_EQ(iss.reg(11), 0x00000078u);
+    EXPECT_EQ(iss.reg(12), 0x0000FFFDu);
+    EXPECT_EQ(iss.reg(13), 0x78563412u);
+    EXPECT_EQ(iss.reg(14), 0xFFFFFFFFu);
+}
+
+TEST(TestIss, Compressed) {
+    constexpr uint32_t OP = 0b0110011;
+    constexpr uint32_t OP_IMM = 0b0010011;
+    uint32_t add = rv32::r_type(0, 11, 10, 0b000, 12, OP);   // add a2, a0, a1
+    uint32_t addi = rv32::i_type(100, 12, 0b000, 13, OP_IMM);  // addi a3, a2, 100
+    std::vector<uint16_t> parcels = {
+        rv32::ci_type(0b010, 5, 10, 0b01),   // c.li a0, 5
+        rv32::ci_type(0b010, -3, 11, 0b01),  // c.li a1, -3
+        static_cast<uint16_t>(add),
+        static_cast<uint16_t>(add >> 16),
+        rv32::ci_type(0b000, 1, 12, 0b01),  // c.addi a2, 1
+        static_cast<uint16_t>(addi),        // crosses into the next word
+        static_cast<uint16_t>(addi >> 16),
+        rv32::cj_type(0b001, 4),            // c.jal 4
+        rv32::ci_type(0b010, 0, 10, 0b01),  // c.li a0, 0 (skipped)
+        rv32::cr_type(0b1000, 14, 1),       // c.mv a4, ra
+        static_cast<uint16_t>(rv32::EXT),
+        static_cast<uint16_t>(rv32::EXT >> 16),
+    };
+    SparseMemory mem;
+    for (size_t i = 0; i < parcels.size(); i += 2) {
+        mem.write(i / 2, parcels[i] | (parcels[i + 1] << 16));
+    }
+    Rv32Iss iss(mem);
+    EXPECT_EQ(iss.run(100), 8u);
+    EXPECT_TRUE(iss.finished());
+
+    EXPECT_EQ(iss.reg(10), 5u);
+    EXPECT_EQ(iss.reg(11), 0xFFFFFFFDu);
+    EXPECT_EQ(iss.reg(12), 3u);
+    EXPECT_EQ(iss.reg(13), 103u);
+    EXPECT_EQ(iss.reg(1), 16u);  // c.jal at 14 links to the next halfword
+    EXPECT_EQ(iss.reg(14), 16u);
+}
+
+TEST(TestIss, Atomics) {
+    constexpr uint32_t OP_IMM = 0b0010011;
+    constexpr uint32_t AMO = 0b0101111;
+    auto amo = [](uint32_t funct5, uint32_t rd, uint32_t rs1, uint32_t rs2) {
+        return rv32::r_type(funct5 << 2, rs2, rs1, 0b010, rd, AMO);
+    };
+    std::vector<uint32_t> code = {
+        rv32::i_type(0x100, 0, 0b000, 1, OP_IMM),  // addi x1, x0, 0x100
+        rv32::i_type(5, 0, 0b000, 2, OP_IMM),      // addi x2, x0, 5
+        amo(0b00000, 3, 1, 2),                     // amoadd.w x3, x2, (x1)
+        amo(0b01000, 4, 1, 2),                     // amoor.w x4, x2, (x1)
+        amo(0b00001, 5, 1, 0),                     // amoswap.w x5, x0, (x1)
+        amo(0b00011, 6, 1, 2),                     // sc.w x6, x2, (x1): no reservation
+        amo(0b00010, 7, 1, 0),                     // lr.w x7, (x1)
+        amo(0b00011, 8, 1, 2),                     // sc.w x8, x2, (x1)
+        amo(0b00011, 9, 1, 1),                     // sc.w x9, x1, (x1): already used
+        rv32::EXT,
+    };
+    SparseMemory mem;
+    for (size_t i = 0; i < code.size(); i++) {
+        mem.write(i, code[i]);
+    }
+    mem.write(0x100 / 4, 0x30);
+    Rv32Iss iss(mem);
+    iss.run(100);
+    EXPECT_TRUE(iss.finished());
+
+    EXPECT_EQ(iss.reg(3), 0x30u);
+    EXPECT_EQ(iss.reg(4), 0x35u);
+    EXPECT_EQ(iss.reg(5), 0x35u);
+    EXPECT_EQ(iss.reg(6), 1u);
+    EXPECT_EQ(iss.reg(7), 0u);
+    EXPECT_EQ(iss.reg(8), 0u);
+    EXPECT_EQ(iss.reg(9), 1u);
+    EXPECT_EQ(mem.read(0x100 / 4), 5u);
+}
+
+// with the AXI exclusive monitor, SC also fails after a write to its word or an AMO
+TEST(TestIss, ExclusiveMonitor) {
+    using namespace rv32;
+    std::vector<uint32_t> code = {
+        addi(1, 0, 0x100),
+        addi(2, 0, 5),
+        amo(LR, 3, 1, 0),
+        sw(2, 1, 0),
+        amo(SC, 4, 1, 2),  // the store cleared the monitor
+        amo(LR, 3, 1, 0),
+        addi(5, 1, 4),
+        amo(AMOADD, 0, 5, 2),
+        amo(SC, 6, 1, 2),  // the AMO moved the monitor
+        amo(LR, 3, 1, 0),
+        sw(2, 1, 4),
+        amo(SC, 7, 1, 2),  // a store to another word keeps it
+        EXT,
+    };
+    for (bool monitor : {false, true}) {
+        SparseMemory mem;
+        for (size_t i = 0; i < code.size(); i++) {
+            mem.write(i, code[i]);
+        }
+        Rv32Iss iss(mem);
+        iss.set_exclusive_monitor(monitor);
+        iss.run(100);
+        EXPECT_TRUE(iss.finished());
+
+        EXPECT_EQ(iss.reg(4), monitor ? 1u : 0u) << monitor;
+        EXPECT_EQ(iss.reg(6), monitor ? 1u : 0u) << monitor;
+        EXPECT_EQ(iss.reg(7), 0u) << monitor;
+    }
+}
+
+TEST(TestIss, Interrupts) {
+    constexpr uint32_t OP = 0b0110011;
+    constexpr uint32_t OP_IMM = 0b0010011;
+    constexpr uint32_t SYSTEM = 0b1110011;
+    std::vector<uint32_t> code = {
+        rv32::i_type(0x41, 0, 0b000, 1, OP_IMM),              // addi x1, x0, 0x41 (vectored)
+        rv32::i_type(Rv32Iss::MTVEC, 1, 0b001, 0, SYSTEM),    // csrw mtvec, x1
+        rv32::i_type(0x400, 0, 0b000, 2, OP_IMM),             // addi x2, x0, 0x400
+        rv32::r_type(0, 2, 2, 0b000, 2, OP),                  // add x2, x2, x2
+        rv32::i_type(Rv32Iss::MIE, 2, 0b001, 0, SYSTEM),      // csrw mie, x2 (MEIE)
+        rv32::i_type(Rv32Iss::MSTATUS, 8, 0b110, 0, SYSTEM),  // csrsi mstatus, MIE
+        rv32::i_type(1, 3, 0b000, 3, OP_IMM),                 // addi x3, x3, 1
+        rv32::ECALL,
+        rv32::EXT,
+    };
+    // ECALL handler at the base: return past the ECALL
+    std::vector<uint32_t> handler = {
+        rv32::i_type(Rv32Iss::MEPC, 0, 0b010, 4, SYSTEM),  // csrr x4, mepc
+        rv32::i_type(4, 4, 0b000, 4, OP_IMM),               // addi x4, x4, 4
+        rv32::i_type(Rv32Iss::MEPC, 4, 0b001, 0, SYSTEM),  // csrw mepc, x4
+        rv32::MRET,
+    };
+    SparseMemory mem;
+    for (size_t i = 0; i < code.size(); i++) {
+        mem.write(i, code[i]);
+    }
+    for (size_t i = 0; i < handler.size(); i++) {
+        mem.write(0x40 / 4 + i, handler[i]);
+    }
+    mem.write((0x40 + 4 * Rv32Iss::IRQ_M_EXT) / 4, rv32::MRET);
+
+    Rv32Iss iss(mem);
+    EXPECT_FALSE(iss.interrupt(Rv32Iss::IRQ_M_EXT));  // mstatus.MIE = 0
+    EXPECT_EQ(iss.run(6), 6u);
+    EXPECT_FALSE(iss.interrupt(Rv32Iss::IRQ_M_TIMER));  // not enabled in mie
+    EXPECT_EQ(iss.pc(), 24u);
+
+    ASSERT_TRUE(iss.interrupt(Rv32Iss::IRQ_M_EXT));
+    EXPECT_EQ(iss.pc(), 0x40u + 4 * Rv32Iss::IRQ_M_EXT);
+    EXPECT_EQ(iss.csr(Rv32Iss::MCAUSE), Rv32Iss::CAUSE_INTERRUPT | Rv32Iss::IRQ_M_EXT);
+    EXPECT_EQ(iss.csr(Rv32Iss::MEPC), 24u);
+    EXPECT_EQ(iss.csr(Rv32Iss::MSTATUS), Rv32Iss::MSTATUS_MPIE);
+    EXPECT_FALSE(iss.interrupt(Rv32Iss::IRQ_M_EXT));  // no nesting
+
+    iss.step();  // mret
+    EXPECT_EQ(iss.pc(), 24u);
+    EXPECT_EQ(iss.csr(Rv32Iss::MSTATUS), Rv32Iss::MSTATUS_MIE | Rv32Iss::MSTATUS_MPIE);
+
+    iss.step();
+    iss.step();  // ecall goes to the base in vectored mode
+    EXPECT_EQ(iss.pc(), 0x40u);
+    EXPECT_EQ(iss.csr(Rv32Iss::MCAUSE), Rv32Iss::CAUSE_ECALL);
+    EXPECT_EQ(iss.csr(Rv32Iss::MEPC), 28u);
+    EXPECT_EQ(iss.csr(Rv32Iss::MSTATUS), Rv32Iss::MSTATUS_MPIE);
+
+    iss.run(100);
+    EXPECT_TRUE(iss.finished());
+    EXPECT_EQ(iss.reg(3), 1u);
+    EXPECT_EQ(iss.csr(Rv32Iss::MSTATUS), Rv32Iss::MSTATUS_MIE | Rv32Iss::MSTATUS_MPIE);
+}
+
+TEST(TestIss, GeneratedProgramsTerminate) {
+    for (uint64_t seed = 0; seed < 20; seed++) {
+        FuzzProgram program = RandomProgramGenerator(seed).generate(200);
+        EXPECT_EQ(program.body.size(), 200u);
+
+        SparseMemory mem;
+        program.load(mem);
+        Rv32Iss iss(mem);
+        // straight-line code; a word holds up to two compressed instructions
+        iss.run(2 * program.size() + 1);
+        EXPECT_TRUE(iss.finished()) << "seed " << seed;
+        EXPECT_EQ(iss.reg(FuzzProgram::BASE_REG), FuzzProgram::DATA_BASE);
+    }
+}
+
+TEST(TestIss, GeneratorIsDeterministic) {
+    FuzzProgram a = RandomProgramGenerator(42).generate(100);
+    FuzzProgram b = RandomProgramGenerator(42).generate(100);
+    EXPECT_EQ(a.code(), b.code());
+    EXPECT_EQ(a.data, b.data);
+}
+
+}  // namespace
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <verilated.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Vcore.h"
+#include "mailbox_host.hpp"
+#include "rv32_gen.hpp"
+#include "sim_runner.hpp"
+
+namespace {
+
+using namespace rv32;
+
+constexpr uint32_t OP_MATH = 0;  // val0 = arg0 + arg1, val1 = arg0 * arg1
+constexpr uint32_t OP_STOP = 1;  // answers, then ends the program
+
+constexpr uint64_t MAX_CYCLES = 200000;
+
+// ring slot of index `rs1` in the ring at `base`: rd = base + (rs1 % ENTRIES) * ENTRY_SIZE
+std::vector<uint32_t> slot(uint32_t rd, uint32_t rs1, uint32_t base) {
+    return {
+        rv32::i_type(RIP_MBOX_ENTRIES - 1, rs1, 0b111, rd, OP_IMM),  // andi
+        rv32::i_type(4, rd, 0b001, rd, OP_IMM),                      // slli (ENTRY_SIZE = 16)
+        rv32::r_type(0, base, rd, 0b000, rd, OP),                    // add
+    };
+}
+
+// The core side of the mailbox as a flat loop (what rip_mailbox.h's helpers
+// compile to): wait for a command, wait for a result slot, answer, bump both
+// indices. It never returns to the host between requests.
+std::vector<uint32_t> service_loop() {
+    std::vector<uint32_t> code = {
+        lui(8, RIP_MBOX_CMD_RING),
+        addi(9, 8, RIP_MBOX_RES_RING - RIP_MBOX_CMD_RING),
+    };
+    const size_t loop = code.size();
+    code.insert(code.end(), {
+                                csrr(RIP_MBOX_CSR_CMD_HEAD, 5),
+                                csrr(RIP_MBOX_CSR_CMD_TAIL, 6),
+                                rv32::b_type(-8, 6, 5, 0b000),  // beq x5, x6, loop
+                            });
+    for (uint32_t inst : slot(7, 5, 8)) {
+        code.push_back(inst);
+    }
+    code.insert(code.end(), {
+                                lw(10, 7, 0),   // tag
+                                lw(11, 7, 4),   // op
+                                lw(12, 7, 8),   // arg0
+                                lw(13, 7, 12),  // arg1
+                                csrr(RIP_MBOX_CSR_RES_TAIL, 28),
+                                csrr(RIP_MBOX_CSR_RES_HEAD, 29),
+                                rv32::r_type(0x20, 29, 28, 0b000, 30, OP),  // sub
+                                rv32::i_type(RIP_MBOX_ENTRIES, 30, 0b011, 30, OP_IMM),  // sltiu
+                                rv32::b_type(-12, 0, 30, 0b000),  // full: beq x30, x0, RES_HEAD
+                            });
+    for (uint32_t inst : slot(7, 28, 9)) {
+        code.push_back(inst);
+    }
+    code.insert(code.end(), {
+                                rv32::r_type(0, 13, 12, 0b000, 14, OP),  // add
+                                rv32::r_type(1, 13, 12, 0b000, 15, OP),  // mul
+                                sw(10, 7, 0),
+                                sw(0, 7, 4),  // status
+                                sw(14, 7, 8),
+                                sw(15, 7, 12),
+                                addi(28, 28, 1),
+                                csrw(RIP_MBOX_CSR_RES_TAIL, 28),
+                                addi(5, 5, 1),
+                                csrw(RIP_MBOX_CSR_CMD_HEAD, 5),
+                            });
+    int32_t back = 4 * (static_cast<int32_t>(loop) - static_cast<int32_t>(code.size()));
+    code.push_back(rv32::b_type(back, 0, 11, 0b000));  // beq x11, x0, loop
+    code.push_back(rv32::EXT);
+    return code;
+}
+
+class TestMailbox : public ::testing::Test {
+   protected:
+    SimRunner runner;
+    MailboxHost host{runner};
+    std::mt19937 rng{1};
+    uint32_t posted = 0, received = 0;
+    std::vector<rip_mbox_cmd_t> sent;
+
+    void SetUp() override {
+        std::vector<uint32_t> code = service_loop();
+        runner.load_code(code);
+        host.reset();
+        runner.reset();
+        runner.start(0, 0);
+    }
+
+    bool post(uint32_t op) {
+        rip_mbox_cmd_t cmd = {posted + 1, op, rng(), rng()};
+        if (!host.post(cmd)) {
+            return false;
+        }
+        sent.push_back(cmd);
+        posted++;
+        return true;
+    }
+
+    bool poll() {
+        rip_mbox_res_t res;
+        if (!host.poll(res)) {
+            return false;
+        }
+        const rip_mbox_cmd_t& cmd = sent.at(received++);
+        EXPECT_EQ(res.tag, cmd.tag);
+        EXPECT_EQ(res.status, 0u);
+        EXPECT_EQ(res.val0, cmd.arg0 + cmd.arg1);
+        EXPECT_EQ(res.val1, cmd.arg0 * cmd.arg1);
+        return true;
+    }
+};
+
+// more requests than ring entries, so both rings wrap, in a single run
+TEST_F(TestMailbox, Stream) {
+    constexpr uint32_t REQUESTS = 5 * RIP_MBOX_ENTRIES + 3;
+    constexpr uint64_t MAX_CYCLES_PER_REQUEST = 160;  // 8 uncached accesses and ~30 instructions
+
+    Vcore& dut = runner.dut();
+    uint64_t cycles = 0;
+    while (dut.busy && cycles < MAX_CYCLES) {
+        if (posted < REQUESTS) {
+            post(posted + 1 == REQUESTS ? OP_STOP : OP_MATH);
+        }
+        poll();
+        runner.tick();
+        cycles++;
+    }
+    while (poll()) {
+    }
+    ASSERT_FALSE(dut.busy);
+    EXPECT_EQ(posted, REQUESTS);
+    EXPECT_EQ(received, REQUESTS);
+    EXPECT_EQ(dut.mbox_cmd_head, REQUESTS);
+    EXPECT_LE(cycles, REQUESTS * MAX_CYCLES_PER_REQUEST);
+}
+
+// the core stops taking commands while the host leaves the result ring full
+TEST_F(TestMailbox, Backpressure) {
+    Vcore& dut = runner.dut();
+    uint64_t cycles = 0;
+    while (host.res_pending() < RIP_MBOX_ENTRIES && cycles < MAX_CYCLES) {
+        post(OP_MATH);
+        runner.tick();
+        cycles++;
+    }
+    ASSERT_EQ(host.res_pending(), RIP_MBOX_ENTRIES);
+    for (int i = 0; i < 1000; i++) {
+        post(OP_MATH);
+        runner.tick();
+    }
+    EXPECT_TRUE(dut.busy);
+    EXPECT_EQ(host.res_pending(), RIP_MBOX_ENTRIES);
+    EXPECT_EQ(dut.mbox_cmd_head, RIP_MBOX_ENTRIES);
+    EXPECT_EQ(host.cmd_in_flight(), RIP_MBOX_ENTRIES);
+
+    while (poll()) {
+    }
+    while (host.cmd_in_flight() > 0 && cycles < MAX_CYCLES) {
+        poll();
+        runner.tick();
+        cycles++;
+    }
+    EXPECT_EQ(host.cmd_in_flight(), 0u);
+    while (!post(OP_STOP)) {
+        poll();
+        runner.tick();
+    }
+    while (dut.busy && cycles < MAX_CYCLES) {
+        poll();
+        runner.tick();
+        cycles++;
+    }
+    while (poll()) {
+    }
+    ASSERT_FALSE(dut.busy);
+    EXPECT_EQ(received, posted);
+}
+
+}  // namespace
@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include <verilated.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../sw/rip_predictor.h"
+#include "Vcore.h"
+#include "rv32_gen.hpp"
+#include "sim_runner.hpp"
+
+namespace {
+
+using namespace rv32;
+
+constexpr uint32_t RESULT = 0x1000;  // x12
+constexpr uint32_t IMAGE = 0x10000;
+constexpr uint32_t DUMP = 0x20000;
+constexpr uint64_t MAX_CYCLES = 100000;
+
+void append(std::vector<uint32_t>& code, const std::vector<uint32_t>& more) {
+    code.insert(code.end(), more.begin(), more.end());
+}
+
+// rip_bp_select(): select the word in bpidx value `rs` and wait until bpdat holds it
+std::vector<uint32_t> bp_select(uint32_t rs) {
+    return {
+        csrrw(RIP_BP_CSR_IDX, 0, rs),
+        csrr(RIP_BP_CSR_IDX, 11),
+        rv32::b_type(-4, 0, 11, 0b101),  // bge x11, x0: RIP_BP_IDX_VALID is not set yet
+    };
+}
+
+// the loop over the entries of rip_bp_dump() and rip_bp_load(); x10 is the
+// entry, x20 walks the image and `access` moves word x16 between bpdat and x20
+std::vector<uint32_t> bp_walk(uint32_t image, const std::vector<uint32_t>& access) {
+    std::vector<uint32_t> body;
+    for (uint32_t w = 0; w < RIP_BP_WORDS; w++) {
+        append(body, {lui(15, RIP_BP_IDX(0, w)), add(16, 10, 15)});
+        append(body, bp_select(16));
+        append(body, access);
+        body.push_back(addi(20, 20, 4));
+    }
+    append(body, {addi(10, 10, 1), addi(21, 21, -1)});
+    body.push_back(rv32::b_type(-4 * static_cast<int32_t>(body.size()), 0, 21, 0b001));  // bne
+
+    std::vector<uint32_t> code = {
+        lui(20, image),
+        addi(20, 20, 4),  // entries follow the history
+        lui(10, RIP_BP_IDX_FREEZE),
+        addi(21, 0, RIP_BP_ENTRIES),
+    };
+    append(code, body);
+    return code;
+}
+
+// rip_bp_dump(image)
+std::vector<uint32_t> bp_dump(uint32_t image) {
+    std::vector<uint32_t> code = {
+        lui(20, image),
+        csrr(RIP_BP_CSR_HIST, 14),
+        sw(14, 20, 0),
+    };
+    append(code, bp_walk(image, {csrr(RIP_BP_CSR_DAT, 14), sw(14, 20, 0)}));
+    code.push_back(csrw(RIP_BP_CSR_IDX, 0));
+    return code;
+}
+
+// rip_bp_load(image)
+std::vector<uint32_t> bp_load(uint32_t image) {
+    std::vector<uint32_t> code = bp_walk(image, {lw(14, 20, 0), csrw(RIP_BP_CSR_DAT, 14)});
+    append(code, {
+                     lui(20, image),
+                     lw(14, 20, 0),
+                     csrw(RIP_BP_CSR_HIST, 14),
+                     csrw(RIP_BP_CSR_IDX, 0),
+                 });
+    return code;
+}
+
+class TestPredictor : public ::testing::Test {
+   protected:
+    SimRunner runner;
+
+    void load(std::vector<uint32_t> code) {
+        code.insert(code.begin(), lui(12, RESULT));
+        // drain the last store before EXT stops the core
+        code.insert(code.end(), 4, addi(0, 0, 0));
+        code.push_back(rv32::EXT);
+        runner.load_code(code);
+    }
+
+    void run() {
+        sim_result_t sim = runner.run_loaded({0, "", MAX_CYCLES, 0, 0});
+        ASSERT_EQ(sim.status, "finished");
+    }
+
+    void run(const std::vector<uint32_t>& code) {
+        load(code);
+        run();
+    }
+
+    uint32_t read(uint32_t addr) { return runner.memory().read(addr / 4); }
+    uint32_t result(int index) { return read(RESULT + 4 * index); }
+};
+
+// a predictor entry written through bpdat reads back after another entry was
+// selected, and is still there after the reset of the next run
+TEST_F(TestPredictor, EntrySurvivesRuns) {
+    runner.set_keep_predictor(true);
+    std::vector<uint32_t> write = {
+        lui(10, RIP_BP_IDX_FREEZE),
+        addi(10, 10, 5),
+    };
+    append(write, bp_select(10));
+    append(write, {addi(13, 0, 2), csrw(RIP_BP_CSR_DAT, 13), addi(10, 10, 1)});
+    append(write, bp_select(10));
+    append(write, {addi(13, 0, 1), csrw(RIP_BP_CSR_DAT, 13), addi(10, 10, -1)});
+    append(write, bp_select(10));
+    append(write, {csrr(RIP_BP_CSR_DAT, 14), sw(14, 12, 0)});
+    run(write);
+    EXPECT_EQ(result(0), 2u);
+
+    std::vector<uint32_t> check = {
+        lui(10, RIP_BP_IDX_FREEZE),
+        addi(10, 10, 6),
+    };
+    append(check, bp_select(10));
+    append(check, {csrr(RIP_BP_CSR_DAT, 14), sw(14, 12, 0), addi(10, 10, -1)});
+    append(check, bp_select(10));
+    append(check, {csrr(RIP_BP_CSR_DAT, 14), sw(14, 12, 4)});
+    run(check);
+    EXPECT_EQ(result(0), 1u);
+    EXPECT_EQ(result(1), 2u);
+}
+
+// an image loaded by rip_bp_load() in one run is what rip_bp_dump() finds in the next
+TEST_F(TestPredictor, ImageLoadsAndDumps) {
+    std::vector<uint32_t> image(RIP_BP_IMAGE_WORDS);
+    image[0] = 0x2A5;
+    runner.set_keep_predictor(true);
+    for (uint32_t i = 1; i < RIP_BP_IMAGE_WORDS; i++) {
+        // two bits: every predictor keeps at least a 2-bit counter per word
+        image[i] = (i * 7) % 4;
+    }
+
+    load(bp_load(IMAGE));
+    runner.write_code(IMAGE, image);
+    run();
+    run(bp_dump(DUMP));
+
+    // the history is not compared: BIMODAL keeps none and reads it as zero
+    for (uint32_t i = 1; i < RIP_BP_IMAGE_WORDS; i++) {
+        ASSERT_EQ(read(DUMP + 4 * i), image[i]) << "word " << i;
+    }
+}
+
+// 100 iterations of a loop around a branch that is always taken, or never
+std::vector<uint32_t> inner_branch(bool taken) {
+    std::vector<uint32_t> code = {
+        addi(6, 0, 100),
+        // beq x0, x0 / bne x0, x0 over the addi
+        rv32::b_type(8, 0, 0, taken ? 0b000 : 0b001),
+        addi(9, 9, 1),
+        addi(6, 6, -1),
+        rv32::b_type(-12, 0, 6, 0b001),  // bne x6, x0
+    };
+    return code;
+}
+
+// by default a job starts with an empty table, so what the job before it
+// trained does not change its counters
+TEST_F(TestPredictor, JobsDoNotShareTraining) {
+    const sim_job_t job = {0, "", MAX_CYCLES, 0, 0};
+    load(inner_branch(false));
+    sim_result_t first = runner.run_loaded(job);
+    run(inner_branch(true));
+    load(inner_branch(false));
+    sim_result_t second = runner.run_loaded(job);
+
+    ASSERT_EQ(first.status, "finished");
+    ASSERT_EQ(second.status, "finished");
+    EXPECT_GT(first.bptp + first.bptn, 0u);
+    EXPECT_EQ(first.bptp, second.bptp);
+    EXPECT_EQ(first.bptn, second.bptn);
+    EXPECT_EQ(first.bpfp, second.bpfp);
+    EXPECT_EQ(first.bpfn, second.bpfn);
+    EXPECT_EQ(first.bpmc, second.bpmc);
+    EXPECT_EQ(first.cycles, second.cycles);
+}
+
+// a job started with only the `run` pulse keeps what the one before it
+// trained, so the startup mispredictions of a repeated kernel are gone
+TEST_F(TestPredictor, RunPulseKeepsTraining) {
+    const sim_job_t job = {0, "", MAX_CYCLES, 0, 0};
+    load(inner_branch(true));
+    sim_result_t first = runner.run_loaded(job);
+    sim_result_t second = runner.rerun_loaded(job);
+
+    ASSERT_EQ(first.status, "finished");
+    ASSERT_EQ(second.status, "finished");
+    EXPECT_LT(second.bpfp + second.bpfn, first.bpfp + first.bpfn);
+}
+
+}  // namespace
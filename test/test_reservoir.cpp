@@ -0,0 +1,185 @@
+#include "test_reservoir.hpp"
+
+#include <gtest/gtest.h>
+#include <verilated.h>
+
+#include <random>
+#include <vector>
+
+void VreservoirForTest::reset() {
+    issue = 0;
+    rst_n = 0;
+    tick();
+    tick();
+    rst_n = 1;
+}
+
+void VreservoirForTest::tick() {
+    clk = 0;
+    eval();
+
+    // positive edge
+    clk = 1;
+    eval();
+}
+
+uint32_t VreservoirForTest::command(uint32_t op, uint32_t rs1_value, uint32_t rs2_value,
+                                    uint32_t* busy_cycles) {
+    issue = 1;
+    funct7 = op;
+    rs1 = rs1_value;
+    rs2 = rs2_value;
+    tick();
+    issue = 0;
+
+    uint32_t cycles = 0;
+    while (busy) {
+        tick();
+        // a broken pipeline would otherwise hang the test
+        if (++cycles > 1u << 16) {
+            ADD_FAILURE() << "command " << op << " did not finish";
+            break;
+        }
+    }
+    if (busy_cycles) {
+        *busy_cycles = cycles;
+    }
+    return dout;
+}
+
+class TestReservoir : public ::testing::Test {
+   protected:
+    VreservoirForTest* dut;
+    ReservoirModel model;
+
+    void SetUp() override {
+        dut = new VreservoirForTest();
+        dut->reset();
+    }
+
+    void TearDown() override {
+        dut->final();
+        delete dut;
+    }
+
+    // runs the same command on the DUT and on the model
+    uint32_t command(uint32_t op, uint32_t rs1, uint32_t rs2) {
+        uint32_t actual = dut->command(op, rs1, rs2);
+        EXPECT_EQ(actual, model.command(op, rs1, rs2))
+            << "op " << op << " rs1 " << rs1 << " rs2 " << rs2;
+        return actual;
+    }
+};
+
+namespace {
+
+using Rc = ReservoirModel;
+
+TEST_F(TestReservoir, TanhTable) {
+    EXPECT_EQ(Rc::tanh_entry(0), 0);
+    EXPECT_EQ(Rc::tanh_entry(128), 3119);   // tanh(1.0) = 0.76159
+    EXPECT_EQ(Rc::tanh_entry(-128), -3119);
+    EXPECT_EQ(Rc::tanh_entry(511), 4093);   // tanh(3.99) = 0.99931
+    EXPECT_EQ(Rc::tanh_entry(-512), -4093);
+}
+
+TEST_F(TestReservoir, Config) {
+    EXPECT_EQ(command(Rc::OP_CFG, 100, Rc::CFG_SIZE), 0u);
+    EXPECT_EQ(command(Rc::OP_CFG, 0x800, Rc::CFG_LEAK), 0x1000u);
+    EXPECT_EQ(command(Rc::OP_CFG, 0, Rc::CFG_SIZE), 100u);
+    EXPECT_EQ(command(Rc::OP_CFG, 0, Rc::CFG_LEAK), 0x800u);
+    EXPECT_EQ(command(Rc::OP_CFG, 0x123, Rc::CFG_BASE), 0u);
+    EXPECT_EQ(command(Rc::OP_CFG, 0, Rc::CFG_BASE), 0x123u);
+    // read only
+    EXPECT_EQ(command(Rc::OP_CFG, 42, Rc::CFG_CYCLES), 0u);
+    EXPECT_EQ(command(Rc::OP_CFG, 0, Rc::CFG_CYCLES), 0u);
+}
+
+TEST_F(TestReservoir, WriteReadState) {
+    command(Rc::OP_WS, 0, 0x1234);
+    command(Rc::OP_WS, 1, 0x8000);
+    command(Rc::OP_WS, 1023, 0xFFFF);
+
+    EXPECT_EQ(command(Rc::OP_RS, 0, 0), 0x1234u);
+    EXPECT_EQ(command(Rc::OP_RS, 1, 0), 0xFFFF8000u);
+    EXPECT_EQ(command(Rc::OP_RS, 1023, 0), 0xFFFFFFFFu);
+}
+
+TEST_F(TestReservoir, Readout) {
+    // y = 1.5 * s[0] - 0.25 * s[2] + 2.0 * s[3]
+    command(Rc::OP_WS, 0, 0x1000);   // 1.0
+    command(Rc::OP_WS, 2, 0xE000);   // -2.0
+    command(Rc::OP_WS, 3, 0x0400);   // 0.25
+    command(Rc::OP_WW, 10, Rc::weight_entry(false, 0, 0x1800));
+    command(Rc::OP_WW, 11, Rc::weight_entry(false, 2, -0x0400));
+    command(Rc::OP_WW, 12, Rc::weight_entry(true, 3, 0x2000));
+
+    // 1.5 + 0.5 + 0.5 = 2.5
+    EXPECT_EQ(command(Rc::OP_READ, 10, 0), 0x2800u);
+}
+
+// random sparse reservoir driven by random inputs, compared bit-exactly with the model
+TEST_F(TestReservoir, Step) {
+    const uint32_t UNITS = 64;
+    const uint32_t INPUTS = 4;
+    const uint32_t FAN_IN = 6;
+    const int STEPS = 8;
+
+    std::mt19937 engine(std::random_device{}());
+    std::uniform_int_distribution<int> weight(-0x1800, 0x1800);
+    std::uniform_int_distribution<int> value(-0x1000, 0x1000);
+    std::uniform_int_distribution<uint32_t> col(0, UNITS + INPUTS - 1);
+
+    for (uint32_t i = 0; i < UNITS + INPUTS; i++) {
+        command(Rc::OP_WS, i, static_cast<uint16_t>(value(engine)));
+    }
+
+    // rows of 1..FAN_IN nonzeros starting at 0x100, then the readout row
+    uint32_t addr = 0x100;
+    uint32_t nnz = 0;
+    for (uint32_t row = 0; row < UNITS; row++) {
+        uint32_t n = 1 + engine() % FAN_IN;
+        for (uint32_t j = 0; j < n; j++) {
+            command(Rc::OP_WW, addr++,
+                    Rc::weight_entry(j == n - 1, col(engine), static_cast<int16_t>(weight(engine))));
+        }
+        nnz += n;
+    }
+    uint32_t readout = addr;
+    for (uint32_t j = 0; j < UNITS; j++) {
+        command(Rc::OP_WW, addr++,
+                Rc::weight_entry(j == UNITS - 1, j, static_cast<int16_t>(weight(engine))));
+    }
+
+    command(Rc::OP_CFG, UNITS, Rc::CFG_SIZE);
+    command(Rc::OP_CFG, 0xC00, Rc::CFG_LEAK);  // 0.75
+    command(Rc::OP_CFG, 0x100, Rc::CFG_BASE);
+
+    for (int step = 0; step < STEPS; step++) {
+        for (uint32_t i = UNITS; i < UNITS + INPUTS; i++) {
+            command(Rc::OP_WS, i, static_cast<uint16_t>(value(engine)));
+        }
+        uint32_t busy_cycles = 0;
+        EXPECT_EQ(dut->command(Rc::OP_STEP, 0, 0, &busy_cycles), 0u);
+        model.command(Rc::OP_STEP, 0, 0);
+
+        // one nonzero per cycle plus the pipeline latency
+        EXPECT_EQ(command(Rc::OP_CFG, 0, Rc::CFG_CYCLES), nnz + 4);
+        EXPECT_EQ(busy_cycles, nnz + 4);
+
+        for (uint32_t i = 0; i < UNITS + INPUTS; i++) {
+            command(Rc::OP_RS, i, 0);
+        }
+        command(Rc::OP_READ, readout, 0);
+    }
+}
+
+TEST_F(TestReservoir, EmptyStep) {
+    command(Rc::OP_WS, 0, 0x0123);
+    uint32_t busy_cycles = 1;
+    EXPECT_EQ(dut->command(Rc::OP_STEP, 0, 0, &busy_cycles), 0u);
+    EXPECT_EQ(busy_cycles, 0u);
+    EXPECT_EQ(command(Rc::OP_RS, 0, 0), 0x0123u);
+}
+
+}  // namespace
@@ -0,0 +1,15 @@
+#include <cstdint>
+
+#include "Vreservoir.h"
+#include "reservoir_model.hpp"
+
+class VreservoirForTest : public Vreservoir {
+   public:
+    VreservoirForTest() : Vreservoir() {}
+    ~VreservoirForTest() {}
+
+    void reset();
+    void tick();
+    // issues one command and clocks until `busy` falls; returns rd and the busy cycles
+    uint32_t command(uint32_t, uint32_t, uint32_t, uint32_t* = nullptr);
+};
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <verilated.h>
+
+#include <cstdint>
+
+#include "Vrvc_expander.h"
+#include "rv32_iss.hpp"
+
+class TestRvcExpander : public ::testing::Test {
+   protected:
+    Vrvc_expander* dut;
+
+    void SetUp() override { dut = new Vrvc_expander(); }
+
+    void TearDown() override {
+        dut->final();
+        delete dut;
+    }
+
+    uint32_t expand(uint32_t fetch_code) {
+        dut->fetch_code = fetch_code;
+        dut->eval();
+        return dut->inst_code;
+    }
+};
+
+namespace {
+
+// encodings from the GNU/LLVM assemblers
+TEST_F(TestRvcExpander, Encodings) {
+    EXPECT_EQ(expand(0x0505), 0x00150513u);  // c.addi a0, 1 -> addi a0, a0, 1
+    EXPECT_EQ(expand(0x41C8), 0x0045A503u);  // c.lw a0, 4(a1) -> lw a0, 4(a1)
+    EXPECT_EQ(expand(0xDDE8), 0x06A5AE23u);  // c.sw a0, 124(a1) -> sw a0, 124(a1)
+    EXPECT_EQ(expand(0x2021), 0x008000EFu);  // c.jal 8 -> jal ra, 8
+    EXPECT_EQ(expand(0xBFF5), 0xFFDFF06Fu);  // c.j -4 -> jal x0, -4
+    EXPECT_EQ(expand(0xC501), 0x00050463u);  // c.beqz a0, 8 -> beq a0, x0, 8
+    EXPECT_EQ(expand(0xFCED), 0xFE049DE3u);  // c.bnez s1, -6 -> bne s1, x0, -6
+    EXPECT_EQ(expand(0x858D), 0x4035D593u);  // c.srai a1, 3 -> srai a1, a1, 3
+    EXPECT_EQ(expand(0x9A6D), 0xFFB67613u);  // c.andi a2, -5 -> andi a2, a2, -5
+    EXPECT_EQ(expand(0x8D0D), 0x40B50533u);  // c.sub a0, a1 -> sub a0, a0, a1
+    EXPECT_EQ(expand(0x8C7D), 0x00F47433u);  // c.and s0, a5 -> and s0, s0, a5
+    EXPECT_EQ(expand(0x852E), 0x00B00533u);  // c.mv a0, a1 -> add a0, x0, a1
+    EXPECT_EQ(expand(0x929A), 0x006282B3u);  // c.add t0, t1 -> add t0, t0, t1
+    EXPECT_EQ(expand(0x8382), 0x00038067u);  // c.jr t2 -> jalr x0, 0(t2)
+    EXPECT_EQ(expand(0x9382), 0x000380E7u);  // c.jalr t2 -> jalr ra, 0(t2)
+    EXPECT_EQ(expand(0x5681), 0xFE000693u);  // c.li a3, -32 -> addi a3, x0, -32
+    EXPECT_EQ(expand(0x677D), 0x0001F737u);  // c.lui a4, 31 -> lui a4, 31
+    EXPECT_EQ(expand(0x0E7E), 0x01FE1E13u);  // c.slli t3, 31 -> slli t3, t3, 31
+    EXPECT_EQ(expand(0x9002), 0x00100073u);  // c.ebreak
+    EXPECT_TRUE(dut->compressed);
+}
+
+TEST_F(TestRvcExpander, Reserved) {
+    EXPECT_EQ(expand(0x0000), 0u);  // c.addi4spn with a zero immediate
+    EXPECT_EQ(expand(0x6101), 0u);  // c.addi16sp with a zero immediate
+    EXPECT_EQ(expand(0x6501), 0u);  // c.lui a0, 0
+    EXPECT_EQ(expand(0x4002), 0u);  // c.lwsp x0
+    EXPECT_EQ(expand(0x8002), 0u);  // c.jr x0
+    EXPECT_EQ(expand(0x1502), 0u);  // c.slli with shamt[5] = 1
+    EXPECT_EQ(expand(0x2000), 0u);  // c.fld
+}
+
+TEST_F(TestRvcExpander, PassesThrough32Bit) {
+    for (uint32_t code : {0x00150513u, 0xFE049DE3u, 0x0010000Bu, 0xFFFFFFFFu}) {
+        EXPECT_EQ(expand(code), code);
+        EXPECT_FALSE(dut->compressed);
+    }
+}
+
+// every 16-bit encoding, and the upper half of the fetched word is ignored
+TEST_F(TestRvcExpander, MatchesIss) {
+    for (uint32_t c = 0; c < 0x10000; c++) {
+        if ((c & 0x3) == 0x3) {
+            continue;
+        }
+        uint32_t expected = Rv32Iss::expand(c);
+        ASSERT_EQ(expand(c), expected) << std::hex << c;
+        ASSERT_TRUE(dut->compressed);
+        ASSERT_EQ(expand((~c << 16) | c), expected) << std::hex << c;
+    }
+}
+
+}  // namespace
@@ -0,0 +1,76 @@
+#include "sparse_memory.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace {
+
+TEST(TestSparseMemory, UntouchedReadsZero) {
+    SparseMemory mem;
+
+    EXPECT_EQ(mem.read(0x0), 0u);
+    EXPECT_EQ(mem.read(0x3FFFFF), 0u);
+    EXPECT_EQ(mem.read(0xFFFFFFFF), 0u);
+    EXPECT_EQ(mem.page_count(), 0u);
+}
+
+TEST(TestSparseMemory, ByteStrobe) {
+    SparseMemory mem;
+
+    mem.write(0x10, 0x12345678);
+    EXPECT_EQ(mem.read(0x10), 0x12345678u);
+
+    mem.write(0x10, 0xAABBCCDD, 0b0001);
+    EXPECT_EQ(mem.read(0x10), 0x123456DDu);
+
+    mem.write(0x10, 0xAABBCCDD, 0b1100);
+    EXPECT_EQ(mem.read(0x10), 0xAABB56DDu);
+
+    mem.write(0x10, 0x0, 0b0000);
+    EXPECT_EQ(mem.read(0x10), 0xAABB56DDu);
+}
+
+TEST(TestSparseMemory, PageGranularity) {
+    SparseMemory mem;
+
+    mem.write(0x0, 1);
+    mem.write(SparseMemory::PAGE_WORDS - 1, 2);
+    EXPECT_EQ(mem.page_count(), 1u);
+
+    mem.write(SparseMemory::PAGE_WORDS, 3);
+    mem.write(0x00800000, 4);  // stack area (SP_ADDR >> 2)
+    EXPECT_EQ(mem.page_count(), 3u);
+
+    EXPECT_EQ(mem.read(0x0), 1u);
+    EXPECT_EQ(mem.read(SparseMemory::PAGE_WORDS - 1), 2u);
+    EXPECT_EQ(mem.read(SparseMemory::PAGE_WORDS), 3u);
+    EXPECT_EQ(mem.read(0x00800000), 4u);
+
+    mem.clear();
+    EXPECT_EQ(mem.page_count(), 0u);
+    EXPECT_EQ(mem.read(0x0), 0u);
+}
+
+TEST(TestSparseMemory, LoadHex) {
+    const char* HEX_FILE = "sparse_memory_test.hex";
+    {
+        std::ofstream ofs(HEX_FILE);
+        ofs << "0FC0006F\n34202F73\n// comment\n@400\nDEADBEEF\n";
+    }
+
+    SparseMemory mem;
+    ASSERT_TRUE(mem.load_hex(HEX_FILE));
+    EXPECT_EQ(mem.read(0x0), 0x0FC0006Fu);
+    EXPECT_EQ(mem.read(0x1), 0x34202F73u);
+    EXPECT_EQ(mem.read(0x2), 0u);
+    EXPECT_EQ(mem.read(0x400), 0xDEADBEEFu);
+    EXPECT_EQ(mem.page_count(), 2u);
+
+    EXPECT_FALSE(mem.load_hex("not_exist.hex"));
+    std::remove(HEX_FILE);
+}
+
+}  // namespace
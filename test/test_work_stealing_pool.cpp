@@ -0,0 +1,65 @@
+#include "work_stealing_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+namespace {
+
+TEST(TestWorkStealingPool, RunsAllTasks) {
+    constexpr int N = 1000;
+    std::atomic<int> sum(0);
+    {
+        WorkStealingPool pool(4);
+        for (int i = 0; i < N; i++) {
+            pool.submit([i, &sum](size_t) { sum += i; });
+        }
+        pool.wait();
+        EXPECT_EQ(sum, N * (N - 1) / 2);
+    }
+}
+
+TEST(TestWorkStealingPool, StealsFromBlockedWorker) {
+    constexpr int WORKERS = 4;
+    std::vector<std::atomic<int>> done_by(WORKERS);
+    WorkStealingPool pool(WORKERS);
+
+    // the first task keeps its worker busy; tasks queued behind it on the
+    // same deque must be stolen by the others
+    pool.submit([](size_t) { std::this_thread::sleep_for(std::chrono::milliseconds(200)); });
+    for (int i = 0; i < 4 * WORKERS; i++) {
+        pool.submit([&done_by](size_t worker) { done_by[worker]++; });
+    }
+    pool.wait();
+
+    int total = 0;
+    for (auto& n : done_by) {
+        total += n;
+    }
+    EXPECT_EQ(total, 4 * WORKERS);
+}
+
+// tasks that submit more tasks while the main thread waits: wait() returns
+// only after the last one, however the workers race with submit()
+TEST(TestWorkStealingPool, SubmitFromTasksDuringWait) {
+    constexpr int ROUNDS = 200;
+    constexpr int FANOUT = 8;
+    for (int round = 0; round < ROUNDS; round++) {
+        std::atomic<int> finished(0);
+        WorkStealingPool pool(4);
+        for (int i = 0; i < FANOUT; i++) {
+            pool.submit([&pool, &finished](size_t) {
+                for (int j = 0; j < FANOUT; j++) {
+                    pool.submit([&finished](size_t) { finished++; });
+                }
+                finished++;
+            });
+        }
+        pool.wait();
+        ASSERT_EQ(finished, FANOUT + FANOUT * FANOUT) << "round " << round;
+    }
+}
+
+}  // namespace
@@ -0,0 +1,143 @@
+#ifndef _WORK_STEALING_POOL_HPP_
+#define _WORK_STEALING_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Thread pool with one task deque per worker.
+// Workers pop their own deque from the back and steal from the front of the
+// others, so a worker stuck on a long simulation does not hold back the
+// jobs queued behind it.
+class WorkStealingPool {
+   public:
+    // tasks receive the index of the worker running them
+    typedef std::function<void(size_t)> Task;
+
+    explicit WorkStealingPool(size_t num_workers)
+        : _queued(0), _pending(0), _stop(false), _next(0) {
+        if (num_workers == 0) {
+            num_workers = 1;
+        }
+        for (size_t i = 0; i < num_workers; i++) {
+            _queues.emplace_back(new Queue());
+        }
+        for (size_t i = 0; i < num_workers; i++) {
+            _workers.emplace_back(&WorkStealingPool::worker_loop, this, i);
+        }
+    }
+
+    ~WorkStealingPool() {
+        wait();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _cv_task.notify_all();
+        for (auto& worker : _workers) {
+            worker.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    size_t size() const { return _workers.size(); }
+
+    void submit(Task task) {
+        Queue& queue = *_queues[_next++ % _queues.size()];
+        // counted before it becomes visible, so a worker that pops it at once
+        // cannot take the counters below zero or finish `wait()` early
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _queued++;
+            _pending++;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        _cv_task.notify_one();
+    }
+
+    // blocks until every submitted task has finished
+    void wait() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv_idle.wait(lock, [this] { return _pending == 0; });
+    }
+
+   private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::thread> _workers;
+
+    std::mutex _mutex;
+    std::condition_variable _cv_task;
+    std::condition_variable _cv_idle;
+    size_t _queued;   // tasks sitting in any deque
+    size_t _pending;  // tasks submitted but not finished
+    bool _stop;
+    std::atomic<size_t> _next;
+
+    bool pop(size_t id, Task& task) {
+        Queue& queue = *_queues[id];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t id, Task& task) {
+        for (size_t i = 1; i < _queues.size(); i++) {
+            Queue& queue = *_queues[(id + i) % _queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void worker_loop(size_t id) {
+        while (true) {
+            Task task;
+            if (pop(id, task) || steal(id, task)) {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _queued--;
+                }
+                task(id);
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if (--_pending == 0) {
+                        _cv_idle.notify_all();
+                    }
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv_task.wait(lock, [this] { return _queued > 0 || _stop; });
+            if (_stop && _queued == 0) {
+                return;
+            }
+        }
+    }
+};
+
+#endif